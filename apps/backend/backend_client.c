@@ -1301,6 +1301,29 @@ from_client_debug(clicon_handle h,
     return retval;
 }
 
+/*! Get datastore generation, used by clients to validate cached config
+ *
+ * @param[in]  h       Clixon handle
+ * @param[in]  xe      Request: <rpc><xn></rpc>
+ * @param[out] cbret   Return xml tree, eg <rpc-reply>..., <rpc-error..
+ * @param[in]  arg     client-entry
+ * @param[in]  regarg  User argument given at rpc_callback_register()
+ * @retval     0       OK
+ * @retval    -1       Error
+ * @see xmldb_generation_get
+ */
+static int
+from_client_datastore_generation(clicon_handle h,
+                                 cxobj        *xe,
+                                 cbuf         *cbret,
+                                 void         *arg,
+                                 void         *regarg)
+{
+    cprintf(cbret, "<rpc-reply xmlns=\"%s\"><generation xmlns=\"%s\">%u</generation></rpc-reply>",
+            NETCONF_BASE_NAMESPACE, CLIXON_LIB_NS, xmldb_generation_get(h));
+    return 0;
+}
+
 /*! Check liveness of backend daemon,  just send a reply
  *
  * @param[in]  h       Clixon handle
@@ -1347,6 +1370,7 @@ from_client_stats(clicon_handle h,
     yang_stmt *yspec;
     yang_stmt *ymodext;
     cxobj     *xt = NULL;
+    xpath_optimize_stats xos;
 
     if ((str = xml_find_body(xe, "modules")) != NULL)
         modules = strcmp(str, "true") == 0;
@@ -1359,6 +1383,16 @@ from_client_stats(clicon_handle h,
     nr=0;
     yang_stats_global(&nr);
     cprintf(cbret, "<yangnr>%" PRIu64 "</yangnr>", nr);
+    xpath_optimize_stats_get(&xos, 0);
+    cprintf(cbret, "<xpath-index>");
+    cprintf(cbret, "<keys>%" PRIu64 "</keys>", xos.xo_keys);
+    cprintf(cbret, "<prefix>%" PRIu64 "</prefix>", xos.xo_prefix);
+    cprintf(cbret, "<index>%" PRIu64 "</index>", xos.xo_index);
+    cprintf(cbret, "<leaf-list>%" PRIu64 "</leaf-list>", xos.xo_leaflist);
+    cprintf(cbret, "<nested>%" PRIu64 "</nested>", xos.xo_nested);
+    cprintf(cbret, "<state>%" PRIu64 "</state>", xos.xo_state);
+    cprintf(cbret, "<scan>%" PRIu64 "</scan>", xos.xo_scan);
+    cprintf(cbret, "</xpath-index>");
     cprintf(cbret, "</global>");
     cprintf(cbret, "<datastores xmlns=\"%s\">", CLIXON_LIB_NS);
     if (clixon_stats_datastore_get(h, "running", cbret) < 0)
@@ -1549,7 +1583,7 @@ from_client_hello(clicon_handle       h,
  *
  * @param[in]   h    Clixon handle
  * @param[in]   ce   Client entry (from)
- * @param[in]   msg  Incoming message
+ * @param[in,out] msgp Incoming message, freed and set to NULL when decoded
  * @retval      0    OK
  * @retval     -1    Error Terminates backend and is never called). Instead errors are
  *                   propagated back to client.
@@ -1557,7 +1591,7 @@ from_client_hello(clicon_handle       h,
 static int
 from_client_msg(clicon_handle        h,
                 struct client_entry *ce,
-                struct clicon_msg   *msg)
+                struct clicon_msg  **msgp)
 {
     int                  retval = -1;
     cxobj               *xt = NULL;
@@ -1593,7 +1627,12 @@ from_client_msg(clicon_handle        h,
     /* Decode msg from client -> xml top (ct) and session id 
      * Bind is a part of the decode function
      */
-    if ((ret = clicon_msg_decode(msg, yspec, &op_id, &xt, &xret)) < 0){
+    ret = clicon_msg_decode(*msgp, yspec, &op_id, &xt, &xret);
+    /* The message string is not used after decoding. Free it before the request is
+     * handled, since it may be large, eg edit-config */
+    free(*msgp);
+    *msgp = NULL;
+    if (ret < 0){
         if (netconf_malformed_message(cbret, "XML parse error") < 0)
             goto done;
         goto reply;
@@ -1852,7 +1891,7 @@ from_client(int   s,
         netconf_monitoring_counter_inc(h, "dropped-sessions");
     }
     else
-        if (from_client_msg(h, ce, msg) < 0)
+        if (from_client_msg(h, ce, &msg) < 0)
             goto done;
     retval = 0;
   done:
@@ -1937,6 +1976,9 @@ backend_rpc_init(clicon_handle h)
     if (rpc_callback_register(h, from_client_ping, NULL,
                               CLIXON_LIB_NS, "ping") < 0)
         goto done;
+    if (rpc_callback_register(h, from_client_datastore_generation, NULL,
+                              CLIXON_LIB_NS, "datastore-generation") < 0)
+        goto done;
     if (rpc_callback_register(h, from_client_stats, NULL,
                               CLIXON_LIB_NS, "stats") < 0)
         goto done;
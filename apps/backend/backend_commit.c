@@ -101,8 +101,15 @@ generic_validate(clicon_handle       h,
     int        ret;
     cbuf      *cb = NULL;
 
-    /* All entries */
-    if ((ret = xml_yang_validate_all_top(h, td->td_target, xret)) < 0)
+    /* Only changed entries and their dependents if source is valid, otherwise all entries */
+    if (td->td_src != NULL && clicon_option_bool(h, "CLICON_VALIDATE_INCREMENTAL")){
+        if ((ret = xml_yang_validate_incr(h, td->td_target,
+                                          td->td_avec, td->td_alen,
+                                          td->td_dvec, td->td_dlen,
+                                          td->td_tcvec, td->td_clen, xret)) < 0)
+            goto done;
+    }
+    else if ((ret = xml_yang_validate_all_top(h, td->td_target, xret)) < 0)
         goto done;
     if (ret == 0)
         goto fail;
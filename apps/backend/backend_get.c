@@ -553,6 +553,267 @@ list_pagination_hdr(clicon_handle h,
     return retval;
 }
 
+/*! Extract where, sort-by, direction and sublist-limit from get/list-pagination
+ *
+ * @param[in]  h         Clixon handle 
+ * @param[in]  xe        Request: <list-pagination> 
+ * @param[in]  yspec     Yang spec
+ * @param[in]  ylist     Yang spec of target list or leaf-list
+ * @param[out] where     XPath expression, or NULL if unfiltered
+ * @param[out] wnsc      Namespace context of where, free with xml_nsctx_free
+ * @param[out] sortby    Descendant node identifier, or NULL if none
+ * @param[out] backwards Set if direction is backwards
+ * @param[out] sublimit  Limit of descendant lists, 0 is unbounded
+ * @param[out] cbret     Return xml tree, eg <rpc-reply>..., <rpc-error.. 
+ * @retval     1         OK
+ * @retval     0         Invalid, netconf error in cbret
+ * @retval    -1         Error
+ * Unprefixed names in where refer to the module of the list. Prefixes are resolved using
+ * the namespace declarations in scope of the where element, or as YANG module names which
+ * is the RESTCONF convention.
+ */
+static int
+list_pagination_query_hdr(clicon_handle h,
+                          cxobj        *xe,
+                          yang_stmt    *yspec,
+                          yang_stmt    *ylist,
+                          char        **where,
+                          cvec        **wnsc,
+                          char        **sortby,
+                          int          *backwards,
+                          uint32_t     *sublimit,
+                          cbuf         *cbret)
+{
+    int         retval = -1;
+    cxobj      *x;
+    char       *str;
+    xpath_tree *xpt = NULL;
+    yang_stmt  *y;
+    yang_stmt  *ymod;
+    yang_stmt  *yns;
+    char      **vec = NULL;
+    int         nvec;
+    char       *p;
+    int         i;
+    int         ret;
+
+    *where = NULL;
+    *sortby = NULL;
+    *backwards = 0;
+    /* direction */
+    if ((str = xml_find_body(xe, "direction")) != NULL){
+        if (strcmp(str, "backwards") == 0)
+            *backwards = 1;
+        else if (strcmp(str, "forwards") != 0){
+            if (netconf_invalid_value(cbret, "application", "Unrecognized value of direction") < 0)
+                goto done;
+            goto fail;
+        }
+    }
+    /* sort-by */
+    if ((str = xml_find_body(xe, "sort-by")) != NULL && strcmp(str, "none") != 0){
+        if ((vec = clicon_strsep(str, "/", &nvec)) == NULL)
+            goto done;
+        y = ylist;
+        for (i=0; i<nvec; i++){
+            p = (p = strchr(vec[i], ':')) != NULL ? p + 1 : vec[i];
+            if (yang_keyword_get(ylist) == Y_LEAF_LIST){
+                if (nvec != 1 || strcmp(p, yang_argument_get(ylist)) != 0)
+                    y = NULL;
+                break;
+            }
+            if ((y = yang_find_datanode(y, p)) == NULL ||
+                (yang_keyword_get(y) == Y_LIST && i < nvec - 1))
+                break;
+        }
+        if (y == NULL ||
+            (yang_keyword_get(y) != Y_LEAF && yang_keyword_get(y) != Y_LEAF_LIST)){
+            if (netconf_invalid_value(cbret, "application", "sort-by does not identify a descendant leaf") < 0)
+                goto done;
+            goto fail;
+        }
+        *sortby = str;
+    }
+    /* where */
+    if ((x = xml_find_type(xe, NULL, "where", CX_ELMNT)) != NULL &&
+        (str = xml_body(x)) != NULL && strcmp(str, "unfiltered") != 0){
+        if (xpath_parse(str, &xpt) < 0){
+            if (netconf_invalid_value(cbret, "application", "where is not a valid XPath expression") < 0)
+                goto done;
+            goto fail;
+        }
+        if (xml_nsctx_node(x, wnsc) < 0)
+            goto done;
+        if (xml_nsctx_add(*wnsc, NULL, yang_find_mynamespace(ylist)) < 0)
+            goto done;
+        ymod = NULL;
+        while ((ymod = yn_each(yspec, ymod)) != NULL){
+            if (yang_keyword_get(ymod) != Y_MODULE ||
+                (yns = yang_find(ymod, Y_NAMESPACE, NULL)) == NULL ||
+                xml_nsctx_get(*wnsc, yang_argument_get(ymod)) != NULL)
+                continue;
+            if (xml_nsctx_add(*wnsc, yang_argument_get(ymod), yang_argument_get(yns)) < 0)
+                goto done;
+        }
+        *where = str;
+    }
+    /* sublist-limit */
+    if ((ret = element2value(h, xe, "sublist-limit", "unbounded", cbret, sublimit)) < 0)
+        goto done;
+    if (ret == 0)
+        goto fail;
+    retval = 1;
+ done:
+    if (vec)
+        free(vec);
+    if (xpt)
+        xpath_tree_free(xpt);
+    return retval;
+ fail:
+    retval = 0;
+    goto done;
+}
+
+/*! Apply where, sort-by, direction, offset and limit on list entries of a result tree
+ *
+ * Used when the list could not be queried directly from the datastore, see
+ * xmldb_get_list_query. Entries not in the result are removed from the tree, and the
+ * remaining entries are reordered in their parent in result order.
+ * @param[in,out] xvec      List or leaf-list entries, on exit the result entries
+ * @param[in,out] xlen      Length of xvec
+ * @param[in]     where     XPath boolean expression, or NULL
+ * @param[in]     wnsc      Namespace context of where
+ * @param[in]     sortby    Descendant node identifier, or NULL
+ * @param[in]     sortval   Sort on leaf-list value
+ * @param[in]     backwards Reverse working result-set
+ * @param[in]     offset    Number of entries to skip
+ * @param[in]     limit     Max number of entries, 0 means unbounded
+ * @param[out]    remaining Number of entries after the result
+ * @retval        0         OK
+ * @retval       -1         Error
+ */
+static int
+list_pagination_query(cxobj    **xvec,
+                      size_t    *xlen,
+                      char      *where,
+                      cvec      *wnsc,
+                      char      *sortby,
+                      int        sortval,
+                      int        backwards,
+                      uint32_t   offset,
+                      uint32_t   limit,
+                      uint32_t  *remaining)
+{
+    int     retval = -1;
+    size_t  n = *xlen;
+    size_t  i;
+    size_t  j;
+    size_t  low;
+    size_t  end;
+    cxobj  *x;
+    cxobj  *xp;
+    int     ret;
+
+    /* where */
+    if (where){
+        for (i=0, j=0; i<n; i++){
+            if ((ret = xpath_vec_bool(xvec[i], wnsc, "%s", where)) < 0)
+                goto done;
+            if (ret == 1)
+                xvec[j++] = xvec[i];
+            else
+                xml_purge(xvec[i]);
+        }
+        n = j;
+    }
+    /* sort-by */
+    if ((sortby || sortval) &&
+        clixon_xml_sort_by(xvec, n, sortval?NULL:sortby) < 0)
+        goto done;
+    /* direction */
+    if (backwards)
+        for (i=0; i<n/2; i++){
+            x = xvec[i]; xvec[i] = xvec[n-1-i]; xvec[n-1-i] = x;
+        }
+    /* offset and limit */
+    low = (n > offset) ? offset : n;
+    end = (limit && n - low > limit) ? low + limit : n;
+    for (i=0; i<n; i++)
+        if (i < low || i >= end)
+            xml_purge(xvec[i]);
+    /* Reorder in parent */
+    for (i=low; i<end; i++){
+        xp = xml_parent(xvec[i]);
+        if (xml_rm(xvec[i]) < 0)
+            goto done;
+        if (xml_addsub(xp, xvec[i]) < 0)
+            goto done;
+        xvec[i-low] = xvec[i];
+    }
+    *remaining = n - end;
+    *xlen = end - low;
+    retval = 0;
+ done:
+    return retval;
+}
+
+/*! Limit descendant lists and leaf-lists of a list entry
+ *
+ * The first entry of every limited list is annotated with the number of entries removed
+ * @param[in]  xn        XML list entry
+ * @param[in]  sublimit  Max number of entries of descendant lists
+ * @retval     0         OK
+ * @retval    -1         Error
+ * @see draft-ietf-netconf-list-pagination sublist-limit
+ */
+static int
+list_pagination_sublist(cxobj   *xn,
+                        uint32_t sublimit)
+{
+    int        retval = -1;
+    cxobj     *x;
+    cxobj     *xfirst = NULL;
+    yang_stmt *y;
+    yang_stmt *y0 = NULL;
+    uint32_t   nr = 0;
+    int        i;
+    char       buf[16];
+
+    i = 0;
+    while (1){
+        x = i < xml_child_nr(xn) ? xml_child_i(xn, i) : NULL;
+        y = (x && xml_type(x) == CX_ELMNT) ? xml_spec(x) : NULL;
+        if (y != y0 || x == NULL){ /* end of run */
+            if (nr > sublimit){
+                snprintf(buf, sizeof(buf), "%u", nr - sublimit);
+                if (xml_add_attr(xfirst, "remaining", buf, "lp", IETF_PAGINATON_NAMESPACE) < 0)
+                    goto done;
+                if (xml_sort(xfirst) < 0) /* Attributes first */
+                    goto done;
+            }
+            y0 = NULL;
+            nr = 0;
+            if (x == NULL)
+                break;
+            if (y && (yang_keyword_get(y) == Y_LIST || yang_keyword_get(y) == Y_LEAF_LIST)){
+                y0 = y;
+                xfirst = x;
+            }
+        }
+        if (y0 && ++nr > sublimit){
+            xml_purge(x);
+            continue;
+        }
+        if (xml_type(x) == CX_ELMNT &&
+            list_pagination_sublist(x, sublimit) < 0)
+            goto done;
+        i++;
+    }
+    retval = 0;
+ done:
+    return retval;
+}
+
 /*! Specialized get for list-pagination
  *
  * It is specialized enough to have its own function. Specifically, extra attributes as well
@@ -571,8 +832,14 @@ list_pagination_hdr(clicon_handle h,
  * @param[out] cbret   Return xml tree, eg <rpc-reply>..., <rpc-error.. 
  * @retval     0       OK
  * @retval    -1       Error
- * @note pagination uses appending xpath with predicate, eg [position()<limit], this may not work 
- *       if there is an existing predicate
+ * @note pagination of config lists in a cached datastore slices the sorted list directly, see
+ *       xmldb_get_list_range. Otherwise it appends xpath with predicate, eg [position()<limit], 
+ *       this may not work if there is an existing predicate
+ * A cl:cursor attribute on the list-pagination element requests keyset pagination: entries
+ * after the cursor are returned, and the first entry is annotated with lp:remaining and, if
+ * there are more entries, cl:next-cursor to be used in the next request.
+ * where, sort-by and direction are applied before offset and limit, see xmldb_get_list_query
+ * for config lists in a cached datastore, otherwise on the whole list, see list_pagination_query.
  * XXX Lots of this code (in particular at the end) is copy of get_common
  */
 static int
@@ -606,12 +873,18 @@ get_list_pagination(clicon_handle        h,
     cbuf           *cberr = NULL; 
     cxobj         **xvec = NULL;
     size_t          xlen;
-#ifdef NOTYET
-    cxobj          *x;
-    char           *direction = NULL;
-    char           *sort = NULL;
+    char           *cursor;
+    uint32_t        remaining = 0;
+    char           *next = NULL;
+    cbuf           *cba = NULL;
     char           *where = NULL;
-#endif
+    cvec           *wnsc = NULL;
+    char           *sortby = NULL;
+    int             backwards = 0;
+    uint32_t        sublimit = 0;
+    int             query;
+    int             queried = 0;
+    size_t          i;
 
     if (cbret == NULL){
         clicon_err(OE_PLUGIN, EINVAL, "cbret is NULL");
@@ -654,33 +927,53 @@ get_list_pagination(clicon_handle        h,
     }
     if ((ret = list_pagination_hdr(h, xe, &offset, &limit, cbret)) < 0)
         goto done;
-#ifdef NOTYET
-    /* direction */
-    if (ret && (x = xml_find_type(xe, NULL, "direction", CX_ELMNT)) != NULL){
-        direction = xml_body(x);
-        if (strcmp(direction, "forward") != 0 && strcmp(direction, "reverse") != 0){
-            if (netconf_bad_attribute(cbret, "application",
-                                      "direction", "Unrecognized value of direction attribute") < 0)
-                goto done;
-            goto ok;
-        }
-    }
-    /* sort */
-    if (ret && (x = xml_find_type(xe, NULL, "sort-by", CX_ELMNT)) != NULL)
-        sort = xml_body(x);
-    if (sort) {
-        /* XXX: nothing yet */
-    }
-    /* where */
-    if (ret && (x = xml_find_type(xe, NULL, "where", CX_ELMNT)) != NULL)
-        where = xml_body(x);
-#endif
+    if (ret && (ret = list_pagination_query_hdr(h, xe, yspec, ylist, &where, &wnsc, &sortby,
+                                                &backwards, &sublimit, cbret)) < 0)
+        goto done;
     if (ret == 0)
         goto ok;
+    query = (where != NULL || sortby != NULL || backwards);
+    cursor = xml_find_value(xe, "cursor");
+    if (cursor != NULL && query){
+        if (netconf_operation_not_supported(cbret, "application",
+                                            "cursor cannot be combined with where, sort-by or direction") < 0)
+            goto done;
+        goto ok;
+    }
     /* Read config */
     switch (content){
     case CONTENT_CONFIG:    /* config data only */
     case CONTENT_ALL:       /* both config and state */
+        if (query){
+            /* Query the list directly from the datastore cache if possible */
+            if (xmldb_get_list_query(h, db, nsc, xpath, ylist, wdef, where, wnsc,
+                                     sortby, backwards, offset, limit, &xret, &remaining) < 0)
+                goto done;
+            if (xret != NULL){
+                queried++;
+                break;
+            }
+        }
+        else {
+            /* Slice the list directly from the datastore cache if possible */
+            if ((ret = xmldb_get_list_range(h, db, nsc, xpath, ylist, wdef, offset, limit, cursor,
+                                            &xret, &remaining, &next)) < 0)
+                goto done;
+            if (ret == 0){
+                if (netconf_bad_attribute(cbret, "application",
+                                          "cursor", "Invalid or stale cursor") < 0)
+                    goto done;
+                goto ok;
+            }
+            if (xret != NULL)
+                break;
+        }
+        if (cursor != NULL){
+            if (netconf_operation_not_supported(cbret, "application",
+                                                "cursor is only supported on config lists in a cached datastore") < 0)
+                goto done;
+            goto ok;
+        }
         /* Build a "predicate" cbuf 
          * This solution uses xpath predicates to translate "limit" and "offset" to
          * relational operators <>.
@@ -694,11 +987,10 @@ get_list_pagination(clicon_handle        h,
             cprintf(cbpath, "%s", xpath);
         else
             cprintf(cbpath, "/");
-#ifdef NOTYET
-        if (where)
-            cprintf(cbpath, "[%s]", where);
-#endif
-        if (offset){
+        /* where and sort-by are applied on the whole list below */
+        if (query)
+            ;
+        else if (offset){
             cprintf(cbpath, "[%u <= position()", offset);
             if (limit)
                 cprintf(cbpath, " and position() < %u", limit+offset);
@@ -746,8 +1038,9 @@ get_list_pagination(clicon_handle        h,
             locked = 1;
         else
             locked = 0;
+        /* where and sort-by are applied on all entries below */
         if ((ret = clixon_pagination_cb_call(h, xpath, locked,
-                                             offset, limit,
+                                             query?0:offset, query?0:limit,
                                              xret)) < 0)
             goto done;
         if (ret == 0){
@@ -784,6 +1077,15 @@ get_list_pagination(clicon_handle        h,
     /* Help function to filter out anything that is outside of xpath */
     if (filter_xpath_again(h, yspec, xret, xvec, xlen, xpath, nsc) < 0)
         goto done;
+    if (query && !queried &&
+        list_pagination_query(xvec, &xlen, where, wnsc, sortby,
+                              sortby && yang_keyword_get(ylist) == Y_LEAF_LIST,
+                              backwards, offset, limit, &remaining) < 0)
+        goto done;
+    if (sublimit)
+        for (i=0; i<xlen; i++)
+            if (list_pagination_sublist(xvec[i], sublimit) < 0)
+                goto done;
 #ifdef LIST_PAGINATION_REMAINING
     /* Add remaining attribute Sec 3.1.5: 
        Any list or leaf-list that is limited includes, on the first element in the result set, 
@@ -804,6 +1106,21 @@ get_list_pagination(clicon_handle        h,
             cbuf_free(cba);
     }
 #endif /* LIST_PAGINATION_REMAINING */
+    /* Keyset pagination and queries: annotate first entry with remaining and next cursor */
+    if ((cursor != NULL || (query && limit)) && xlen > 0){
+        if ((cba = cbuf_new()) == NULL){
+            clicon_err(OE_UNIX, errno, "cbuf_new");
+            goto done;
+        }
+        cprintf(cba, "%u", remaining);
+        if (xml_add_attr(xvec[0], "remaining", cbuf_get(cba), "lp", IETF_PAGINATON_NAMESPACE) < 0)
+            goto done;
+        if (next &&
+            xml_add_attr(xvec[0], "next-cursor", next, CLIXON_LIB_PREFIX, CLIXON_LIB_NS) < 0)
+            goto done;
+        if (xml_sort(xvec[0]) < 0) /* Attributes first */
+            goto done;
+    }
     if (get_nacm_and_reply(h, xret, xvec, xlen, xpath, nsc, username, depth, cbret) < 0)
         goto done;
  ok:
@@ -811,6 +1128,12 @@ get_list_pagination(clicon_handle        h,
  done:
     if (xvec)
         free(xvec);
+    if (next)
+        free(next);
+    if (cba)
+        cbuf_free(cba);
+    if (wnsc)
+        xml_nsctx_free(wnsc);
     if (cbmsg)
         cbuf_free(cbmsg);
     if (cbpath)
@@ -870,6 +1193,9 @@ get_common(clicon_handle        h,
     uint32_t        limit = 0;
     withdefaults_type wdef;
     char             *wdefstr;
+    char             *ftype;
+    cxobj            *xsubtree = NULL; /* Subtree filter */
+    cbuf             *cbsubtree = NULL;
 
     wdef = WITHDEFAULTS_EXPLICIT;
     clixon_debug(CLIXON_DBG_DETAIL, "%s", __FUNCTION__);
@@ -879,7 +1205,22 @@ get_common(clicon_handle        h,
         goto done;
     }
     if ((xfilter = xml_find(xe, "filter")) != NULL){
-        if ((xpath0 = xml_find_value(xfilter, "select"))==NULL)
+        ftype = xml_find_value(xfilter, "type");
+        if ((ftype == NULL || strcmp(ftype, "subtree") == 0) &&
+            xml_child_nr_type(xfilter, CX_ELMNT) > 0){
+            /* Subtree filter: select a superset of the result with an xpath, which
+             * is pruned by the filter below
+             */
+            xsubtree = xfilter;
+            if ((cbsubtree = cbuf_new()) == NULL){
+                clicon_err(OE_UNIX, errno, "cbuf_new");
+                goto done;
+            }
+            if ((ret = xml_filter2xpath(xfilter, cbsubtree, &nsc0)) < 0)
+                goto done;
+            xpath0 = ret?cbuf_get(cbsubtree):"/";
+        }
+        else if ((xpath0 = xml_find_value(xfilter, "select"))==NULL)
             xpath0 = "/";
         /* Create namespace context for xpath from <filter>
          *  The set of namespace declarations are those in scope on the
@@ -891,10 +1232,17 @@ get_common(clicon_handle        h,
         if ((ret = xpath2canonical(xpath0, nsc0, yspec, &xpath, &nsc, &cbreason)) < 0)
             goto done;
         if (ret == 0){
-            if (netconf_bad_attribute(cbret, "application",
-                                      "select", cbuf_get(cbreason)) < 0)
-                goto done;
-            goto ok;
+            if (xsubtree == NULL){
+                if (netconf_bad_attribute(cbret, "application",
+                                          "select", cbuf_get(cbreason)) < 0)
+                    goto done;
+                goto ok;
+            }
+            /* Subtree filter with nodes not in yang: select all and prune */
+            if (cbreason){
+                cbuf_free(cbreason);
+                cbreason = NULL;
+            }
         }
     }
     /* Clixon extensions: depth */
@@ -926,7 +1274,12 @@ get_common(clicon_handle        h,
             goto done;
         if (ret == 0)
             goto ok;
-        list_pagination = (offset != 0 || limit != 0);
+        list_pagination = (offset != 0 || limit != 0 ||
+                           xml_find_value(xfind, "cursor") != NULL ||
+                           xml_find_type(xfind, NULL, "where", CX_ELMNT) != NULL ||
+                           xml_find_type(xfind, NULL, "sort-by", CX_ELMNT) != NULL ||
+                           xml_find_type(xfind, NULL, "direction", CX_ELMNT) != NULL ||
+                           xml_find_type(xfind, NULL, "sublist-limit", CX_ELMNT) != NULL);
     }
     /* Sanity check for list pagination: path must be a list/leaf-list, if it is,
      * check config/state
@@ -1040,6 +1393,9 @@ get_common(clicon_handle        h,
         if (xml_apply(xret, CX_ELMNT, (xml_applyfn_t*)xml_flag_reset, (void*)XML_FLAG_MARK) < 0)
             goto done;
     }
+    /* Prune result of subtree filter xpath, eg attribute and content match */
+    if (xsubtree && xml_filter(xsubtree, xret) < 0)
+        goto done;
     if (xpath_vec(xret, nsc, "%s", &xvec, &xlen, xpath?xpath:"/") < 0)
         goto done;
     if (filter_xpath_again(h, yspec, xret, xvec, xlen, xpath, nsc) < 0)
@@ -1050,6 +1406,8 @@ get_common(clicon_handle        h,
     retval = 0;
  done:
     clixon_debug(CLIXON_DBG_DETAIL, "%s retval:%d", __FUNCTION__, retval);
+    if (cbsubtree)
+        cbuf_free(cbsubtree);
     if (xvec)
         free(xvec);
     if (xret)
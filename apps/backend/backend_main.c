@@ -136,6 +136,7 @@ backend_terminate(clicon_handle h)
 
     xpath_optimize_exit();
     clixon_pagination_free(h);
+    validate_deps_free(h);
     
     if (pidfile)
         unlink(pidfile);   
@@ -518,7 +519,6 @@ main(int    argc,
     char         *nacm_mode;
     int           logdst = CLICON_LOG_SYSLOG|CLICON_LOG_STDERR;
     yang_stmt    *yspec = NULL;
-    char         *str;
     int           ss = -1; /* server socket */
     cbuf         *cbret = NULL; /* startup cbuf if invalid */
     enum startup_status status = STARTUP_ERR; /* Startup status */
@@ -824,20 +824,9 @@ main(int    argc,
                             clicon_option_str(h, "CLICON_BACKEND_REGEXP")) < 0)
         goto done;
 
-    /* Load Yang modules
-     * 1. Load a yang module as a specific absolute filename */
-    if ((str = clicon_yang_main_file(h)) != NULL)
-        if (yang_spec_parse_file(h, str, yspec) < 0)
-            goto done;
-    /* 2. Load a (single) main module */
-    if ((str = clicon_yang_module_main(h)) != NULL)
-        if (yang_spec_parse_module(h, str, clicon_yang_module_revision(h),
-                                   yspec) < 0)
-            goto done;
-    /* 3. Load all modules in a directory (will not overwrite file loaded ^) */
-    if ((str = clicon_yang_main_dir(h)) != NULL)
-        if (yang_spec_load_dir(h, str, yspec) < 0)
-            goto done;
+    /* Load main Yang modules, from cache if CLICON_YANG_CACHE_DIR is set */
+    if (yang_spec_load_main(h, yspec) < 0)
+        goto done;
     /* Load clixon lib yang module */
     if (yang_spec_parse_module(h, "clixon-lib", NULL, yspec) < 0)
         goto done;
@@ -87,9 +87,12 @@ You can see which CLISPEC it generates via clixon_cli -D 2:
 #include <string.h>
 #include <stdlib.h>
 #include <errno.h>
+#include <inttypes.h>
 #include <fcntl.h>
 #include <syslog.h>
 #include <signal.h>
+#include <unistd.h>
+#include <sys/stat.h>
 #include <sys/param.h>
 
 /* cligen */
@@ -1170,6 +1173,96 @@ yang2cli_choice(clicon_handle h,
  */
 static int yang2cli_grouping(clicon_handle h, yang_stmt *ys, char *treename);
 
+/*! Register grouping for lazy generation of its tree, see CLICON_CLI_AUTOCLI_LAZY
+ *
+ * @param[in]  h         Clixon handle
+ * @param[in]  treename  Name of grouping tree
+ * @param[in]  ygrouping YANG grouping statement
+ * @retval     0         OK
+ * @retval    -1         Error
+ */
+static int
+yang2cli_lazy_add(clicon_handle h,
+                  char         *treename,
+                  yang_stmt    *ygrouping)
+{
+    int            retval = -1;
+    clicon_hash_t *hash = NULL;
+
+    if (clicon_ptr_get(h, "autocli-lazy-groupings", (void**)&hash) < 0 || hash == NULL){
+        if ((hash = clicon_hash_init()) == NULL)
+            goto done;
+        if (clicon_ptr_set(h, "autocli-lazy-groupings", hash) < 0)
+            goto done;
+    }
+    if (clicon_hash_value(hash, treename, NULL) == NULL &&
+        clicon_hash_add(hash, treename, &ygrouping, sizeof(ygrouping)) == NULL)
+        goto done;
+    retval = 0;
+ done:
+    return retval;
+}
+
+/*! Ensure the tree of the grouping referred to by a uses statement exists
+ *
+ * Generate the grouping tree if it does not exist, or register it for generation on
+ * first reference, see CLICON_CLI_AUTOCLI_LAZY
+ * @param[in]  h       Clixon handle
+ * @param[in]  ys      Yang uses statement
+ * @param[out] cbtree  Name of grouping tree
+ * @retval     1       OK, tree exists or is registered
+ * @retval     0       OK, tree is empty
+ * @retval    -1       Error
+ */
+static int
+yang2cli_uses_tree(clicon_handle h,
+                   yang_stmt    *ys,
+                   cbuf         *cbtree)
+{
+    int        retval = -1;
+    char      *id = NULL;
+    char      *prefix = NULL;
+    char      *ns;
+    yang_stmt *ygrouping;
+    int        ret;
+
+    if (nodeid_split(yang_argument_get(ys), &prefix, &id) < 0)
+        goto done;
+    if (ys_grouping_resolve(ys, prefix, id, &ygrouping) < 0)
+        goto done;
+    if (ygrouping == NULL){
+        clicon_err(OE_YANG, 0, "grouping %s not found in \n", yang_argument_get(ys));
+        goto done;
+    }
+    /* prefix is not globally unique, need namespace */
+    if ((ns = yang_find_mynamespace(ygrouping)) == NULL)
+        goto done;
+    cprintf(cbtree, "grouping-%s-%s", ns, id);
+    if (cligen_ph_find(cli_cligen(h), cbuf_get(cbtree)) == NULL){
+        if (clicon_option_bool(h, "CLICON_CLI_AUTOCLI_LAZY")){
+            /* Defer generation until tree is referenced, see yang2cli_treeref_wrap */
+            if (yang2cli_lazy_add(h, cbuf_get(cbtree), ygrouping) < 0)
+                goto done;
+        }
+        else {
+            /* No such tree, generate it */
+            if ((ret = yang2cli_grouping(h, ygrouping, cbuf_get(cbtree))) < 0)
+                goto done;
+            if (ret == 0){ /* tree empty */
+                retval = 0;
+                goto done;
+            }
+        }
+    }
+    retval = 1;
+ done:
+    if (prefix)
+        free(prefix);
+    if (id)
+        free(id);
+    return retval;
+}
+
 /*! Generate CLI code for Yang uses statement
  *
  * @param[in]  h     Clixon handle
@@ -1186,38 +1279,19 @@ yang2cli_uses(clicon_handle h,
               cbuf         *cb)
 {
     int        retval = -1;
-    char      *id = NULL;
-    char      *prefix = NULL;
-    char      *ns;
-    yang_stmt *ygrouping;
     cbuf      *cbtree = NULL;
     char      *api_path_fmt = NULL;
     yang_stmt *yp;
     int        ret;
 
-    if (nodeid_split(yang_argument_get(ys), &prefix, &id) < 0)
-        goto done;
-    if (ys_grouping_resolve(ys, prefix, id, &ygrouping) < 0)
-        goto done;
-    if (ygrouping == NULL){
-        clicon_err(OE_YANG, 0, "grouping %s not found in \n", yang_argument_get(ys));
-        goto done;
-    }
     if ((cbtree = cbuf_new()) == NULL){
         clicon_err(OE_XML, errno, "cbuf_new");
         goto done;
     }
-    /* prefix is not globally unique, need namespace */
-    if ((ns = yang_find_mynamespace(ygrouping)) == NULL)
+    if ((ret = yang2cli_uses_tree(h, ys, cbtree)) < 0)
         goto done;
-    cprintf(cbtree, "grouping-%s-%s", ns, id);
-    if (cligen_ph_find(cli_cligen(h), cbuf_get(cbtree)) == NULL){
-        /* No such tree, generate it */
-        if ((ret = yang2cli_grouping(h, ygrouping, cbuf_get(cbtree))) < 0)
-            goto done;
-        if (ret == 0) /* tree empty */
-            goto ok;
-    }
+    if (ret == 0) /* tree empty */
+        goto ok;
     cprintf(cb, "%*s@%s", level*3, "", cbuf_get(cbtree));
     /* get api-path to parent, do not include "uses" argument since it is replaced */
     yp = yang_parent_get(ys);
@@ -1231,10 +1305,57 @@ yang2cli_uses(clicon_handle h,
  done:
     if (api_path_fmt)
         free(api_path_fmt);
-    if (prefix)
-        free(prefix);
-    if (id)
-        free(id);
+    if (cbtree)
+        cbuf_free(cbtree);
+    return retval;
+}
+
+/*! Create the grouping trees referred to by clispec read from the autocli cache
+ *
+ * A cached clispec contains @grouping-<ns>-<id> references but the trees are created
+ * as a side-effect of generation, see yang2cli_uses. Traverse the data nodes as
+ * yang2cli_stmt does and create the trees of all uses statements.
+ * @param[in]  h     Clixon handle
+ * @param[in]  ys    Yang statement
+ * @retval     0     OK
+ * @retval    -1     Error
+ * @see CLICON_CLI_AUTOCLI_CACHE_DIR
+ */
+static int
+yang2cli_cache_uses(clicon_handle h,
+                    yang_stmt    *ys)
+{
+    int        retval = -1;
+    yang_stmt *yc = NULL;
+    cbuf      *cbtree = NULL;
+
+    if ((cbtree = cbuf_new()) == NULL){
+        clicon_err(OE_XML, errno, "cbuf_new");
+        goto done;
+    }
+    while ((yc = yn_each(ys, yc)) != NULL){
+        switch (yang_keyword_get(yc)){
+        case Y_USES:
+            cbuf_reset(cbtree);
+            if (yang2cli_uses_tree(h, yc, cbtree) < 0)
+                goto done;
+            break;
+        case Y_CONTAINER:
+        case Y_LIST:
+        case Y_CHOICE:
+        case Y_CASE:
+            /* Nodes expanded from a grouping are in the grouping tree */
+            if (yang_flag_get(yc, YANG_FLAG_GROUPING))
+                break;
+            if (yang2cli_cache_uses(h, yc) < 0)
+                goto done;
+            break;
+        default:
+            break;
+        }
+    }
+    retval = 0;
+ done:
     if (cbtree)
         cbuf_free(cbtree);
     return retval;
@@ -1639,6 +1760,173 @@ yang2cli_grouping(clicon_handle      h,
     goto done;
 }
 
+/*! FNV-1a hash of a string, accumulated onto previous hash value
+ */
+static uint64_t
+yang2cli_cache_hash(uint64_t    hash,
+                    const char *str)
+{
+    if (str)
+        while (*str){
+            hash ^= (uint8_t)*str++;
+            hash *= 0x100000001b3ULL;
+        }
+    hash ^= 0xff; /* separator */
+    hash *= 0x100000001b3ULL;
+    return hash;
+}
+
+/*! Compute autocli cache key of a YANG spec
+ *
+ * The key covers everything that affects the generated clispec: all modules in the spec
+ * (name, revision, file and its mtime/size), the autocli config, relevant options
+ * including CLICON_FEATURE, and the names of CLI plugins with extension or yang-patch
+ * callbacks, as yang_cache_key.
+ * Note that all modules are included, not only the generated module, since augments and
+ * imports from other modules affect the result.
+ * @param[in]  h      Clixon handle
+ * @param[in]  yspec  Top-level Yang statement of type Y_SPEC
+ * @param[out] key    Hash key
+ * @retval     0      OK
+ * @retval    -1      Error
+ */
+static int
+yang2cli_cache_key(clicon_handle h,
+                   yang_stmt    *yspec,
+                   uint64_t     *key)
+{
+    int                retval = -1;
+    uint64_t           hash = 0xcbf29ce484222325ULL;
+    yang_stmt         *ymod = NULL;
+    yang_stmt         *yrev;
+    const char        *filename;
+    struct stat        st;
+    cbuf              *cb = NULL;
+    cxobj             *xautocli;
+    cxobj             *x = NULL;
+    char              *body;
+    clixon_plugin_t   *cp = NULL;
+    clixon_plugin_api *api;
+
+    if ((cb = cbuf_new()) == NULL){
+        clicon_err(OE_UNIX, errno, "cbuf_new");
+        goto done;
+    }
+    cprintf(cb, "%s %d", CLIXON_VERSION_STRING,
+            clicon_option_bool(h, "CLICON_YANG_SCHEMA_MOUNT"));
+    if ((xautocli = clicon_conf_autocli(h)) != NULL &&
+        clixon_xml2cbuf(cb, xautocli, 0, 0, NULL, -1, 0) < 0)
+        goto done;
+    hash = yang2cli_cache_hash(hash, cbuf_get(cb));
+    /* Features decide which nodes are in the spec */
+    while ((x = xml_child_each(clicon_conf_xml(h), x, CX_ELMNT)) != NULL){
+        if (strcmp(xml_name(x), "CLICON_FEATURE") != 0)
+            continue;
+        body = xml_body(x);
+        cbuf_reset(cb);
+        cprintf(cb, "CLICON_FEATURE=%s", body?body:"");
+        hash = yang2cli_cache_hash(hash, cbuf_get(cb));
+    }
+    /* Plugins may change the spec via extension and yang-patch callbacks */
+    while ((cp = clixon_plugin_each(h, cp)) != NULL){
+        api = clixon_plugin_api_get(cp);
+        if (api->ca_extension == NULL && api->ca_yang_patch == NULL)
+            continue;
+        hash = yang2cli_cache_hash(hash, clixon_plugin_name_get(cp));
+    }
+    while ((ymod = yn_each(yspec, ymod)) != NULL){
+        if (yang_keyword_get(ymod) != Y_MODULE && yang_keyword_get(ymod) != Y_SUBMODULE)
+            continue;
+        cbuf_reset(cb);
+        cprintf(cb, "%s", yang_argument_get(ymod));
+        if ((yrev = yang_find(ymod, Y_REVISION, NULL)) != NULL)
+            cprintf(cb, "@%s", yang_argument_get(yrev));
+        if ((filename = yang_filename_get(ymod)) != NULL){
+            cprintf(cb, " %s", filename);
+            if (stat(filename, &st) == 0)
+                cprintf(cb, " %lld %lld", (long long)st.st_mtime, (long long)st.st_size);
+        }
+        hash = yang2cli_cache_hash(hash, cbuf_get(cb));
+    }
+    *key = hash;
+    retval = 0;
+ done:
+    if (cb)
+        cbuf_free(cb);
+    return retval;
+}
+
+/*! Read cached generated clispec of a module, see CLICON_CLI_AUTOCLI_CACHE_DIR
+ *
+ * @param[in]  filename  Cache file
+ * @param[out] cb        Generated clispec
+ * @retval     1         OK, cb is filled in (may be empty)
+ * @retval     0         Not found in cache
+ * @retval    -1         Error
+ */
+static int
+yang2cli_cache_read(char *filename,
+                    cbuf *cb)
+{
+    int    retval = -1;
+    FILE  *f = NULL;
+    char   buf[BUFSIZ];
+    size_t len;
+
+    if ((f = fopen(filename, "r")) == NULL){
+        if (errno == ENOENT){
+            retval = 0;
+            goto done;
+        }
+        clicon_err(OE_UNIX, errno, "fopen(%s)", filename);
+        goto done;
+    }
+    while ((len = fread(buf, 1, sizeof(buf)-1, f)) > 0){
+        buf[len] = '\0';
+        cprintf(cb, "%s", buf);
+    }
+    if (ferror(f)){
+        clicon_err(OE_UNIX, errno, "fread(%s)", filename);
+        goto done;
+    }
+    retval = 1;
+ done:
+    if (f)
+        fclose(f);
+    return retval;
+}
+
+/*! Write generated clispec of a module to cache, see CLICON_CLI_AUTOCLI_CACHE_DIR
+ *
+ * Written to a temporary file which is renamed, so that concurrent CLIs never
+ * see a partial file.
+ * Failure to write is not fatal, the cache is then just not updated.
+ * @param[in]  filename  Cache file
+ * @param[in]  cb        Generated clispec
+ */
+static void
+yang2cli_cache_write(char *filename,
+                     cbuf *cb)
+{
+    FILE *f = NULL;
+    char  tmpfile[MAXPATHLEN];
+
+    snprintf(tmpfile, sizeof(tmpfile), "%s.%d", filename, getpid());
+    if ((f = fopen(tmpfile, "w")) == NULL){
+        clixon_debug(CLIXON_DBG_DEFAULT, "%s fopen(%s): %s", __FUNCTION__, tmpfile, strerror(errno));
+        return;
+    }
+    if (fwrite(cbuf_get(cb), 1, cbuf_len(cb), f) != cbuf_len(cb)){
+        fclose(f);
+        unlink(tmpfile);
+        return;
+    }
+    if (fclose(f) != 0 || rename(tmpfile, filename) < 0){
+        clixon_debug(CLIXON_DBG_DEFAULT, "%s %s: %s", __FUNCTION__, filename, strerror(errno));
+        unlink(tmpfile);
+    }
+}
+
 /*! Generate clispec for all modules in yspec (except excluded)
  * 
  * Called in cli main function for top-level yangs. But may also be called dynamically for
@@ -1666,6 +1954,11 @@ yang2cli_yspec(clicon_handle      h,
     cg_obj         *co;
     int             i;
     int             config;
+    char           *cachedir;
+    uint64_t        cachekey = 0;
+    char            cachefile[MAXPATHLEN];
+    int             ret;
+    int             grouping_treeref = 0;
 
     if ((pt0 = pt_new()) == NULL){
         clicon_err(OE_UNIX, errno, "pt_new");
@@ -1675,6 +1968,13 @@ yang2cli_yspec(clicon_handle      h,
         clicon_err(OE_XML, errno, "cbuf_new");
         goto done;
     }
+    if ((cachedir = clicon_option_str(h, "CLICON_CLI_AUTOCLI_CACHE_DIR")) != NULL){
+        if (yang2cli_cache_key(h, yspec, &cachekey) < 0)
+            goto done;
+        cachekey = yang2cli_cache_hash(cachekey, treename);
+    }
+    if (autocli_grouping_treeref(h, &grouping_treeref) < 0)
+        goto done;
     /* Traverse YANG, loop through all modules and generate CLI */
     ymod = NULL;
     while ((ymod = yn_each(yspec, ymod)) != NULL){
@@ -1686,8 +1986,23 @@ yang2cli_yspec(clicon_handle      h,
         if (!enable)
             continue;
         cbuf_reset(cb);
-        if (yang2cli_stmt(h, ymod, 0, cb) < 0)
-            goto done;
+        ret = 0;
+        if (cachedir){
+            snprintf(cachefile, sizeof(cachefile), "%s/%016" PRIx64 "-%s.cli",
+                     cachedir, cachekey, yang_argument_get(ymod));
+            if ((ret = yang2cli_cache_read(cachefile, cb)) < 0)
+                goto done;
+        }
+        if (ret == 0){
+            if (yang2cli_stmt(h, ymod, 0, cb) < 0)
+                goto done;
+            if (cachedir)
+                yang2cli_cache_write(cachefile, cb);
+        }
+        else if (grouping_treeref){
+            if (yang2cli_cache_uses(h, ymod) < 0)
+                goto done;
+        }
         if (cbuf_len(cb) == 0)
             continue;
         /* Note Tie-break of same top-level symbol: prefix is NYI
@@ -1773,15 +2088,196 @@ yang2cli_yspec(clicon_handle      h,
     return retval;
 }
 
+/*! Find grouping whose tree name is treename by scanning all YANG groupings recursively
+ *
+ * Used if a grouping tree reference has not been registered, eg if the referring clispec
+ * was read from cache, see CLICON_CLI_AUTOCLI_CACHE_DIR
+ * @param[in]  yn        YANG node
+ * @param[in]  treename  Name of grouping tree, "grouping-<ns>-<id>"
+ * @param[out] ygp       YANG grouping, or NULL if not found
+ * @retval     0         OK
+ * @retval    -1         Error
+ */
+static int
+yang2cli_grouping_scan(yang_stmt  *yn,
+                       char       *treename,
+                       yang_stmt **ygp)
+{
+    int        retval = -1;
+    yang_stmt *yc = NULL;
+    char      *ns;
+    size_t     len;
+
+    while ((yc = yn_each(yn, yc)) != NULL){
+        if (yang_keyword_get(yc) == Y_GROUPING &&
+            (ns = yang_find_mynamespace(yc)) != NULL){
+            len = strlen(ns);
+            if (strncmp(treename, "grouping-", 9) == 0 &&
+                strncmp(treename+9, ns, len) == 0 &&
+                treename[9+len] == '-' &&
+                strcmp(treename+9+len+1, yang_argument_get(yc)) == 0){
+                *ygp = yc;
+                break;
+            }
+        }
+        if (yang_keyword_get(yc) == Y_TYPE ||
+            yang_keyword_get(yc) == Y_DESCRIPTION)
+            continue;
+        if (yang2cli_grouping_scan(yc, treename, ygp) < 0)
+            goto done;
+        if (*ygp != NULL)
+            break;
+    }
+    retval = 0;
+ done:
+    return retval;
+}
+
+/*! Tree reference wrapper installed by yang2cli_init, and the wrapper it replaced
+ */
+struct yang2cli_treeref{
+    clicon_handle                   yt_h;       /* Clixon handle */
+    cligen_tree_resolve_wrapper_fn *yt_fn0;     /* Previous wrapper, eg from a plugin, or NULL */
+    void                           *yt_arg0;    /* Argument of previous wrapper */
+};
+
+/*! CLIgen tree reference wrapper: generate grouping trees on first reference
+ *
+ * Called by CLIgen when resolving a tree reference, eg @grouping-urn:example:clixon-pg1,
+ * at the point where a command path enters the node with the reference.
+ * If the tree is a grouping tree not yet generated, it is generated here. This makes it
+ * possible to defer grouping generation, see CLICON_CLI_AUTOCLI_LAZY
+ * A wrapper set before yang2cli_init, eg by a plugin, is then called.
+ * @param[in]  ch      CLIgen handle
+ * @param[in]  name    Base tree name
+ * @param[in]  cvt     Tokenized string: vector of tokens
+ * @param[in]  arg     Wrapper struct, see struct yang2cli_treeref
+ * @param[out] namep   New (malloced) name, from previous wrapper
+ * @retval     1       OK and new name assigned
+ * @retval     0       OK but no new name assigned
+ * @retval    -1       Error
+ */
+static int
+yang2cli_treeref_wrap(cligen_handle ch,
+                      char         *name,
+                      cvec         *cvt,
+                      void         *arg,
+                      char        **namep)
+{
+    int                      retval = -1;
+    struct yang2cli_treeref *yt = (struct yang2cli_treeref *)arg;
+    clicon_handle            h = yt->yt_h;
+    clicon_hash_t           *hash = NULL;
+    yang_stmt    **ygp;
+    yang_stmt     *ygrouping = NULL;
+    yang_stmt     *ymod = NULL;
+    pt_head       *ph;
+    parse_tree    *pt;
+    int            ret;
+
+    if (name == NULL || strncmp(name, "grouping-", 9) != 0 ||
+        cligen_ph_find(ch, name) != NULL)
+        goto ok;
+    if (clicon_ptr_get(h, "autocli-lazy-groupings", (void**)&hash) == 0 && hash != NULL &&
+        (ygp = clicon_hash_value(hash, name, NULL)) != NULL)
+        ygrouping = *ygp;
+    while (ygrouping == NULL &&
+           (ymod = yn_each(clicon_dbspec_yang(h), ymod)) != NULL)
+        if (yang2cli_grouping_scan(ymod, name, &ygrouping) < 0)
+            goto done;
+    if (ygrouping == NULL)
+        goto ok;
+    if ((ret = yang2cli_grouping(h, ygrouping, name)) < 0)
+        goto done;
+    if (ret == 0){ /* Empty tree: add empty tree to avoid regenerating */
+        if ((pt = pt_new()) == NULL){
+            clicon_err(OE_UNIX, errno, "pt_new");
+            goto done;
+        }
+        if ((ph = cligen_ph_add(ch, name)) == NULL){
+            clicon_err(OE_UNIX, 0, "cligen_ph_add");
+            pt_free(pt, 1);
+            goto done;
+        }
+        if (cligen_ph_parsetree_set(ph, pt) < 0){
+            clicon_err(OE_UNIX, 0, "cligen_ph_parsetree_set");
+            goto done;
+        }
+    }
+    if (hash)
+        clicon_hash_del(hash, name);
+ ok:
+    if (yt->yt_fn0)
+        retval = yt->yt_fn0(ch, name, cvt, yt->yt_arg0, namep);
+    else
+        retval = 0;
+ done:
+    return retval;
+}
+
 /*! Init yang2cli
  *
  * Initialize CLIgen generation from YANG models.
- * Nothing now
- *
+ * If lazy or cached autocli is enabled, register tree reference wrapper so that grouping
+ * trees may be generated on demand. A wrapper already set, eg by a plugin, is kept and
+ * called from the new wrapper.
  * @param[in]  h      Clixon handle
+ * @retval     0      OK
+ * @retval    -1      Error
+ * @see CLICON_CLI_AUTOCLI_LAZY
+ * @see CLICON_CLI_AUTOCLI_CACHE_DIR
  */
 int
 yang2cli_init(clicon_handle h)
 {
+    int                      retval = -1;
+    cligen_handle            ch = cli_cligen(h);
+    struct yang2cli_treeref *yt = NULL;
+
+    if (!clicon_option_bool(h, "CLICON_CLI_AUTOCLI_LAZY") &&
+        clicon_option_str(h, "CLICON_CLI_AUTOCLI_CACHE_DIR") == NULL)
+        goto ok;
+    if (clicon_ptr_get(h, "autocli-treeref", (void**)&yt) == 0 && yt != NULL)
+        goto ok; /* Already installed */
+    if ((yt = malloc(sizeof(*yt))) == NULL){
+        clicon_err(OE_UNIX, errno, "malloc");
+        goto done;
+    }
+    memset(yt, 0, sizeof(*yt));
+    yt->yt_h = h;
+    yt->yt_fn0 = cligen_tree_resolve_wrapper_get(ch);
+    yt->yt_arg0 = cligen_tree_resolve_wrapper_arg_get(ch);
+    if (clicon_ptr_set(h, "autocli-treeref", yt) < 0){
+        free(yt);
+        goto done;
+    }
+    cligen_tree_resolve_wrapper_set(ch, yang2cli_treeref_wrap, yt);
+ ok:
+    retval = 0;
+ done:
+    return retval;
+}
+
+/*! Exit yang2cli
+ *
+ * Free lazy grouping registry and restore tree reference wrapper
+ * @param[in]  h      Clixon handle
+ */
+int
+yang2cli_exit(clicon_handle h)
+{
+    clicon_hash_t           *hash = NULL;
+    struct yang2cli_treeref *yt = NULL;
+
+    if (clicon_ptr_get(h, "autocli-lazy-groupings", (void**)&hash) == 0 && hash != NULL){
+        clicon_hash_free(hash);
+        clicon_ptr_del(h, "autocli-lazy-groupings");
+    }
+    if (clicon_ptr_get(h, "autocli-treeref", (void**)&yt) == 0 && yt != NULL){
+        /* Restore previous wrapper */
+        cligen_tree_resolve_wrapper_set(cli_cligen(h), yt->yt_fn0, yt->yt_arg0);
+        free(yt);
+        clicon_ptr_del(h, "autocli-treeref");
+    }
     return 0;
 }
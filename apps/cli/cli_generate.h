@@ -63,5 +63,6 @@
  */
 int yang2cli_yspec(clicon_handle h, yang_stmt *yspec, char *treename);
 int yang2cli_init(clicon_handle h);
+int yang2cli_exit(clicon_handle h);
 
 #endif  /* _CLI_GENERATE_H_ */
@@ -188,6 +188,8 @@ cli_terminate(clicon_handle h)
         xml_free(x);
     clicon_data_cvec_del(h, "cli-edit-cvv");;
     clicon_data_cvec_del(h, "cli-edit-filter");;
+    cli_config_cache_free(h);
+    yang2cli_exit(h);
     xpath_optimize_exit();
     /* Delete all plugins, and RPC callbacks */
     clixon_plugin_module_exit(h);
@@ -525,7 +527,6 @@ main(int    argc,
     char          *restarg = NULL; /* what remains after options */
     yang_stmt     *yspec;
     struct passwd *pw;
-    char          *str;
     int            tabmode;
     cvec          *nsctx_global = NULL; /* Global namespace context */
     size_t         cligen_buflen;
@@ -782,23 +783,9 @@ main(int    argc,
         goto done;
     clicon_dbspec_yang_set(h, yspec);
 
-    /* Load Yang modules
-     * 1. Load a yang module as a specific absolute filename */
-    if ((str = clicon_yang_main_file(h)) != NULL){
-        if (yang_spec_parse_file(h, str, yspec) < 0)
-            goto done;
-    }
-    /* 2. Load a (single) main module */
-    if ((str = clicon_yang_module_main(h)) != NULL){
-        if (yang_spec_parse_module(h, str, clicon_yang_module_revision(h),
-                                   yspec) < 0)
-            goto done;
-    }
-    /* 3. Load all modules in a directory */
-    if ((str = clicon_yang_main_dir(h)) != NULL){
-        if (yang_spec_load_dir(h, str, yspec) < 0)
-            goto done;
-    }
+    /* Load main Yang modules, from cache if CLICON_YANG_CACHE_DIR is set */
+    if (yang_spec_load_main(h, yspec) < 0)
+        goto done;
 
     /* Load clixon lib yang module */
     if (yang_spec_parse_module(h, "clixon-lib", NULL, yspec) < 0)
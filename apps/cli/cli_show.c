@@ -186,6 +186,145 @@ xpath_append(cbuf      *cb0,
     return retval;
 }
 
+/* Max number of entries in CLI config cache, if reached the cache is flushed */
+#define CLI_CONFIG_CACHE_MAX 64
+
+/*! Entry in CLI config cache, see CLICON_CLI_CONFIG_CACHE
+ */
+struct cli_config_cache_entry{
+    uint32_t  cce_gen; /* Datastore generation when read */
+    cxobj    *cce_xt;  /* Config tree as returned by clicon_rpc_get_config */
+};
+
+/*! Flush and free all entries of the CLI config cache
+ *
+ * @param[in]  h    Clixon handle
+ * @retval     0    OK
+ * @retval    -1    Error
+ */
+int
+cli_config_cache_free(clicon_handle h)
+{
+    int                            retval = -1;
+    clicon_hash_t                 *hash = NULL;
+    struct cli_config_cache_entry *ce;
+    char                         **keys = NULL;
+    size_t                         klen;
+    int                            i;
+
+    if (clicon_ptr_get(h, "cli-config-cache", (void**)&hash) < 0 || hash == NULL)
+        goto ok;
+    if (clicon_hash_keys(hash, &keys, &klen) < 0)
+        goto done;
+    for (i = 0; i < klen; i++){
+        if ((ce = clicon_hash_value(hash, keys[i], NULL)) != NULL && ce->cce_xt)
+            xml_free(ce->cce_xt);
+    }
+    clicon_hash_free(hash);
+    clicon_ptr_del(h, "cli-config-cache");
+ ok:
+    retval = 0;
+ done:
+    if (keys)
+        free(keys);
+    return retval;
+}
+
+/*! Get config from backend, or from local cache if datastores are unchanged
+ *
+ * If CLICON_CLI_CONFIG_CACHE is set, replies are cached keyed by datastore, xpath,
+ * namespace context and with-defaults. A cached reply is used as long as the backend
+ * datastore generation is unchanged, which costs a small RPC instead of a full
+ * get-config.
+ * @param[in]  h        Clixon handle
+ * @param[in]  db       Name of datastore
+ * @param[in]  xpath    XPath (or "")
+ * @param[in]  nsc      Namespace context for xpath
+ * @param[in]  defaults Value of the with-defaults mode, rfc6243, or NULL
+ * @param[out] xt       XML tree, either <config> or <rpc-error>
+ * @retval     1        OK, xt is owned by the cache, do not modify or free
+ * @retval     0        OK, cache not enabled, free xt with xml_free
+ * @retval    -1        Error
+ * @see clicon_rpc_get_config
+ */
+int
+cli_config_cache_get(clicon_handle h,
+                     char         *db,
+                     char         *xpath,
+                     cvec         *nsc,
+                     char         *defaults,
+                     cxobj       **xt)
+{
+    int                            retval = -1;
+    clicon_hash_t                 *hash = NULL;
+    struct cli_config_cache_entry *ce;
+    struct cli_config_cache_entry  ce0 = {0,};
+    cbuf                          *cb = NULL;
+    cg_var                        *cv = NULL;
+    uint32_t                       gen;
+    size_t                         len = 0;
+    char                         **keys = NULL;
+
+    if (!clicon_option_bool(h, "CLICON_CLI_CONFIG_CACHE")){
+        if (clicon_rpc_get_config(h, NULL, db, xpath, nsc, defaults, xt) < 0)
+            goto done;
+        retval = 0;
+        goto done;
+    }
+    if (clicon_rpc_datastore_generation(h, &gen) < 0)
+        goto done;
+    if ((cb = cbuf_new()) == NULL){
+        clicon_err(OE_UNIX, errno, "cbuf_new");
+        goto done;
+    }
+    cprintf(cb, "%s %s %s", db, defaults?defaults:"", xpath?xpath:"");
+    while ((cv = cvec_each(nsc, cv)) != NULL)
+        cprintf(cb, " %s=%s", cv_name_get(cv)?cv_name_get(cv):"", cv_string_get(cv));
+    if (clicon_ptr_get(h, "cli-config-cache", (void**)&hash) == 0 && hash != NULL){
+        if ((ce = clicon_hash_value(hash, cbuf_get(cb), NULL)) != NULL &&
+            ce->cce_gen == gen){
+            *xt = ce->cce_xt;
+            retval = 1;
+            goto done;
+        }
+        if (clicon_hash_keys(hash, &keys, &len) < 0)
+            goto done;
+        /* Stale entry means all entries are from older generations: flush all */
+        if (ce != NULL || len >= CLI_CONFIG_CACHE_MAX){
+            if (cli_config_cache_free(h) < 0)
+                goto done;
+            hash = NULL;
+        }
+    }
+    if (hash == NULL){
+        if ((hash = clicon_hash_init()) == NULL)
+            goto done;
+        if (clicon_ptr_set(h, "cli-config-cache", hash) < 0)
+            goto done;
+    }
+    if (clicon_rpc_get_config(h, NULL, db, xpath, nsc, defaults, &ce0.cce_xt) < 0)
+        goto done;
+    /* Errors are not cached */
+    if (xpath_first(ce0.cce_xt, NULL, "/rpc-error") != NULL){
+        *xt = ce0.cce_xt;
+        retval = 0;
+        goto done;
+    }
+    ce0.cce_gen = gen;
+    if (clicon_hash_add(hash, cbuf_get(cb), &ce0, sizeof(ce0)) == NULL){
+        xml_free(ce0.cce_xt);
+        goto done;
+    }
+    *xt = ce0.cce_xt;
+    retval = 1;
+ done:
+    if (keys)
+        free(keys);
+    if (cb)
+        cbuf_free(cb);
+    return retval;
+}
+
 /*! Completion callback intended for automatically generated data model
  *
  * Returns an expand-type list of commands as used by cligen 'expand' 
@@ -228,12 +367,11 @@ expand_dbvar(void   *h,
     cxobj           *x;
     char            *bodystr;
     int              i;
-    char            *bodystr0 = NULL; /* previous */
+    leafref_set     *values = NULL; /* to detect duplicates */
     cg_var          *cv;
     cxobj           *xtop = NULL; /* xpath root */
     cxobj           *xbot = NULL; /* xpath, NULL if datastore */
     yang_stmt       *y = NULL; /* yang spec of xpath */
-    yang_stmt       *yp;
     cvec            *nsc = NULL;
     int              ret;
     int              cvvi = 0;
@@ -248,6 +386,7 @@ expand_dbvar(void   *h,
     char            *str;
     int              grouping_treeref;
     cvec            *callback_cvv;
+    int              cached = 0;
 
     if (argv == NULL || (cvec_len(argv) != 2 && cvec_len(argv) != 3)){
         clicon_err(OE_PLUGIN, EINVAL, "requires arguments: <db> <apipathfmt> [<mountpt>]");
@@ -380,8 +519,8 @@ expand_dbvar(void   *h,
         if (xpath_append(cbxpath, yang_argument_get(ypath), y, nsc) < 0)
             goto done;
     }
-    /* Get configuration based on cbxpath */
-    if (clicon_rpc_get_config(h, NULL, dbstr, cbuf_get(cbxpath), nsc, NULL, &xt) < 0)
+    /* Get configuration based on cbxpath, possibly from local cache */
+    if ((cached = cli_config_cache_get(h, dbstr, cbuf_get(cbxpath), nsc, NULL, &xt)) < 0)
         goto done;
     if ((xe = xpath_first(xt, NULL, "/rpc-error")) != NULL){
         clixon_netconf_error(h, xe, "Get configuration", NULL);
@@ -390,11 +529,11 @@ expand_dbvar(void   *h,
     if (xpath_vec(xt, nsc, "%s", &xvec, &xlen, cbuf_get(cbxpath)) < 0)
         goto done;
     /* Loop for inserting into commands cvec. 
-     * Detect duplicates: for ordered-by system assume list is ordered, so you need
-     * just remember previous
-     * but for ordered-by system, check the whole list
+     * Detect duplicates with a hashed set since values may be unordered, eg in
+     * ordered-by user lists or leafref targets in several lists
      */
-    bodystr0 = NULL;
+    if ((values = leafref_set_new()) == NULL)
+        goto done;
     for (i = 0; i < xlen; i++) {
         x = xvec[i];
         if (xml_type(x) == CX_BODY)
@@ -403,31 +542,18 @@ expand_dbvar(void   *h,
             bodystr = xml_body(x);
         if (bodystr == NULL)
             continue; /* no body, cornercase */
-        if ((y = xml_spec(x)) != NULL &&
-            (yp = yang_parent_get(y)) != NULL &&
-            yang_keyword_get(yp) == Y_LIST &&
-            yang_find(yp, Y_ORDERED_BY, "user") != NULL){
-            /* Detect duplicates linearly in existing values */
-            {
-                cg_var *cv = NULL;
-                while ((cv = cvec_each(commands, cv)) != NULL)
-                    if (strcmp(cv_string_get(cv), bodystr) == 0)
-                        break;
-                if (cv == NULL)
-                    cvec_add_string(commands, NULL, bodystr);
-            }
-        }
-        else{
-            if (bodystr0 && strcmp(bodystr, bodystr0) == 0)
-                continue; /* duplicate, assume sorted */
-            bodystr0 = bodystr;
-            /* RFC3986 decode */
-            cvec_add_string(commands, NULL, bodystr);
-        }
+        if ((ret = leafref_set_add(values, bodystr)) < 0)
+            goto done;
+        if (ret == 0)
+            continue; /* duplicate */
+        /* RFC3986 decode */
+        cvec_add_string(commands, NULL, bodystr);
     }
  ok:
     retval = 0;
  done:
+    if (values)
+        leafref_set_free(values);
     if (nsc0)
         cvec_free(nsc0);
     if (api_path_fmt_cb)
@@ -446,7 +572,7 @@ expand_dbvar(void   *h,
         free(xvec);
     if (xtop)
         xml_free(xtop);
-    if (xt)
+    if (xt && !cached)
         xml_free(xt);
     if (xpath)
         free(xpath);
@@ -529,12 +655,17 @@ cli_show_common(clicon_handle    h,
     size_t        veclen;
     cxobj        *xp;
     int           i;
+    int           cached = 0;
 
     if (state && strcmp(db, "running") != 0){
         clicon_err(OE_FATAL, 0, "Show state only for running database, not %s", db);
         goto done;
     }
-    if (state == 0){     /* Get configuration-only from a database */
+    if (state == 0 && extdefault == NULL){ /* Get configuration-only, possibly from cache */
+        if ((cached = cli_config_cache_get(h, db, xpath, nsc, withdefault, &xt)) < 0)
+            goto done;
+    }
+    else if (state == 0){     /* Get configuration-only from a database */
         if (clicon_rpc_get_config(h, NULL, db, xpath, nsc, withdefault, &xt) < 0)
             goto done;
     }
@@ -617,7 +748,7 @@ cli_show_common(clicon_handle    h,
 done:
     if (vec)
         free(vec);
-    if (xt)
+    if (xt && !cached)
         xml_free(xt);
     return retval;
 }
@@ -1309,7 +1440,9 @@ cli_pagination(clicon_handle h,
                                          NULL,     /* with-default */
                                          limit*i,  /* offset */
                                          limit,    /* limit */
-                                         NULL, NULL, NULL, /* nyi */
+                                         NULL, NULL, NULL, /* direction, sort-by, where */
+                                         0,        /* sublist-limit */
+                                         NULL,     /* cursor */
                                          &xret) < 0){
             goto done;
         }
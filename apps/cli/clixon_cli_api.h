@@ -120,6 +120,8 @@ int expand_dbvar(void *h, char *name, cvec *cvv, cvec *argv,
                   cvec *commands, cvec *helptexts);
 int clixon_cli2file(clicon_handle h, FILE *f, cxobj *xn, char *prepend, clicon_output_cb *fn, int skiptop);
 int clixon_cli2cbuf(clicon_handle h, cbuf *cb, cxobj *xn, char *prepend, int skiptop);
+int cli_config_cache_free(clicon_handle h);
+int cli_config_cache_get(clicon_handle h, char *db, char *xpath, cvec *nsc, char *defaults, cxobj **xt);
 /* cli_show.c: CLIgen new vector arg callbacks */
 int cli_show_common(clicon_handle h, char *db, enum format_enum format, int pretty, int state, char *withdefault, char *extdefault, char *prepend, char *xpath, int fromroot, cvec *nsc, int skiptop);
 
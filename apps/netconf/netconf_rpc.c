@@ -70,7 +70,6 @@
 /* clicon */
 #include <clixon/clixon.h>
 
-#include "netconf_filter.h"
 #include "netconf_rpc.h"
 
 /*
@@ -79,33 +78,6 @@
     </rpc> 
  */
 
-static int
-netconf_get_config_subtree(clicon_handle h,
-                           cxobj        *xfilter,
-                           cxobj       **xret)
-{
-    int    retval = -1;
-    cxobj *xdata;
-
-    /* a subtree filter is comprised of zero or more element subtrees*/
-    if ((xdata = xpath_first(*xret, NULL, "/rpc-reply/data")) == NULL)
-        goto ok;
-    if (xml_filter(xfilter, xdata) < 0){
-        clixon_xml_parse_va(YB_NONE, NULL, xret, NULL, "<rpc-reply xmlns=\"%s\"><rpc-error>"
-                            "<error-tag>operation-failed</error-tag>"
-                            "<error-type>application</error-type>"
-                            "<error-severity>error</error-severity>"
-                            "<error-info>filtering</error-info>"
-                            "</rpc-error></rpc-reply>",
-                            NETCONF_BASE_NAMESPACE
-                            );
-    }
-ok:
-    retval = 0;
-    // done:
-    return retval;
-}
-
 /*! Get configuration
  *
  * @param[in]  h       Clixon handle
@@ -113,8 +85,8 @@ ok:
  * @param[out] xret    Return XML, error or OK
  * @retval     0       OK
  * @retval    -1       Error
- * @note filter type subtree and xpath is supported, but xpath is preferred, and
- *              better performance and tested. Please use xpath.
+ * @note filter type subtree and xpath is supported. A subtree filter is translated by
+ *       the backend to an xpath, see xml_filter2xpath
  *
  *     <get-config> 
  *       <source> 
@@ -179,18 +151,11 @@ netconf_get_config(clicon_handle h,
      /* ie <filter>...</filter> */
     if ((xfilter = xpath_first(xn, nsc, "%s%sfilter", prefix ? prefix : "", prefix ? ":" : "")) != NULL)
         ftype = xml_find_value(xfilter, "type");
-    if (xfilter == NULL || ftype == NULL || strcmp(ftype, "subtree") == 0) {
-        /* Get whole config first, then filter. This is suboptimal
-         */
+    if (xfilter == NULL || ftype == NULL ||
+        strcmp(ftype, "subtree") == 0 || strcmp(ftype, "xpath") == 0) {
+        /* Subtree and xpath filters are applied by the backend */
         if (clicon_rpc_netconf_xml(h, xml_parent(xn), xret, NULL) < 0)
             goto done;
-        /* Now filter on whole tree */
-        if (netconf_get_config_subtree(h, xfilter, xret) < 0)
-            goto done;
-    } else if (strcmp(ftype, "xpath") == 0) {
-        if (clicon_rpc_netconf_xml(h, xml_parent(xn), xret, NULL) < 0) {
-            goto done;
-        }
     } else {
         clixon_xml_parse_va(YB_NONE, NULL, xret, NULL, "<rpc-reply xmlns=\"%s\"><rpc-error>"
                                                        "<error-tag>operation-failed</error-tag>"
@@ -363,8 +328,8 @@ netconf_edit_config(clicon_handle h,
  * @param[out] xret    Return XML, error or OK
  * @retval     0       OK
  * @retval    -1       Error
- * @note filter type subtree and xpath is supported, but xpath is preferred, and
- *              better performance and tested. Please use xpath.
+ * @note filter type subtree and xpath is supported. A subtree filter is translated by
+ *       the backend to an xpath, see xml_filter2xpath
  *
  * @example
  *    <rpc><get><filter type="xpath" select="//SenderTwampIpv4"/>
@@ -392,15 +357,9 @@ netconf_get(clicon_handle h,
        /* ie <filter>...</filter> */
     if ((xfilter = xpath_first(xn, nsc, "%s%sfilter", prefix ? prefix : "", prefix ? ":" : "")) != NULL)
         ftype = xml_find_value(xfilter, "type");
-    if (xfilter == NULL || ftype == NULL || strcmp(ftype, "subtree") == 0) {
-        /* Get whole config + state first, then filter. This is suboptimal
-         */
-        if (clicon_rpc_netconf_xml(h, xml_parent(xn), xret, NULL) < 0)
-            goto done;
-        /* Now filter on whole tree */
-        if (netconf_get_config_subtree(h, xfilter, xret) < 0)
-            goto done;
-    } else if (strcmp(ftype, "xpath") == 0) {
+    if (xfilter == NULL || ftype == NULL ||
+        strcmp(ftype, "subtree") == 0 || strcmp(ftype, "xpath") == 0) {
+        /* Subtree and xpath filters are applied by the backend */
         if (clicon_rpc_netconf_xml(h, xml_parent(xn), xret, NULL) < 0)
             goto done;
     } else {
@@ -84,6 +84,15 @@ static const map_str2str mime_map[] = {
     { NULL,    NULL} /* if not found: application/octet-stream */
 };
 
+/* HTTP content-coding <-> Suffix of precompressed file variant
+ * In order of preference
+ */
+static const map_str2str encoding_map[] = {
+    {"br",    ".br"},
+    {"gzip",  ".gz"},
+    { NULL,    NULL}
+};
+
 /*! Check if uri path denotes a data path
  *
  * @param[in]  h      Clixon handle
@@ -166,9 +175,8 @@ api_http_data_err(clicon_handle  h,
  * @param[in]      req     Generic Www handle (can be part of clixon handle)
  * @param[in]      prefix  Prefix of path0, where to start file check
  * @param[in,out]  cbpath  Filepath as cbuf, internal redirection may change it
- * @param[out]     fp      Open file, if retval = 1
- * @param[out]     fsz     Size of file, if retval = 1
- * @retval         1       OK, fp,fsz set
+ * @param[out]     fdp     Open file, if retval = 1
+ * @retval         1       OK, fdp set
  * @retval         0       Invalid
  * @retval        -1       Error
  */
@@ -177,18 +185,17 @@ http_data_check_file_path(clicon_handle h,
                           void         *req,
                           char         *prefix,
                           cbuf         *cbpath,
-                          FILE        **fp,
-                          off_t        *fsz)
+                          int          *fdp)
 {
     int         retval = -1;
     struct stat fstat;
     char       *p;
     int         i;
     int         code = 0;
-    FILE       *f;
+    int         fd;
 
-    if (prefix == NULL || cbpath == NULL || fp == NULL){
-        clicon_err(OE_UNIX, EINVAL, "prefix, cbpath0 or fp is NULL");
+    if (prefix == NULL || cbpath == NULL || fdp == NULL){
+        clicon_err(OE_UNIX, EINVAL, "prefix, cbpath0 or fdp is NULL");
         goto done;
     }
     p = cbuf_get(cbpath);
@@ -248,13 +255,12 @@ http_data_check_file_path(clicon_handle h,
         code = 403;
         goto invalid;
     }
-    *fsz = fstat.st_size;
-    if ((f = fopen(p, "rb")) == NULL){
-        clixon_debug(CLIXON_DBG_DEFAULT, "%s Error fopen(%s) %s", __FUNCTION__, p, strerror(errno));
+    if ((fd = open(p, O_RDONLY)) < 0){
+        clixon_debug(CLIXON_DBG_DEFAULT, "%s Error open(%s) %s", __FUNCTION__, p, strerror(errno));
         code = 403;
         goto invalid;
     }
-    *fp = f;
+    *fdp = fd;
     retval = 1; /* OK */
  done:
     return retval;
@@ -265,16 +271,56 @@ http_data_check_file_path(clicon_handle h,
     goto done;
 }
 
+/*! Check if an entity tag matches an If-None-Match header
+ *
+ * Weak comparison, ie W/ prefixes are ignored
+ * @param[in]  inm   If-None-Match header value: "*" or comma-separated entity tags
+ * @param[in]  etag  Entity tag including quotes
+ * @retval     1     Match
+ * @retval     0     No match
+ * @see RFC 7232 Sec 3.2
+ */
+static int
+http_data_etag_match(char *inm,
+                     char *etag)
+{
+    int    retval = 0;
+    char  *p = inm;
+    size_t len = strlen(etag);
+
+    while (*p != '\0'){
+        while (*p == ' ' || *p == '\t' || *p == ',')
+            p++;
+        if (*p == '*'){
+            retval = 1;
+            break;
+        }
+        if (strncmp(p, "W/", 2) == 0)
+            p += 2;
+        if (strncmp(p, etag, len) == 0 &&
+            (p[len] == '\0' || p[len] == ',' || p[len] == ' ' || p[len] == '\t')){
+            retval = 1;
+            break;
+        }
+        p += strcspn(p, ",");
+    }
+    return retval;
+}
+
 /*! Read file data request
  *
+ * The file is not read here, it is sent as an open file with restconf_reply_send_file
+ * which writes it to the socket with sendfile(2) where possible.
+ * Precompressed variants of a file, eg index.html.gz, are sent instead of the file if the
+ * client accepts the encoding, see encoding_map.
+ * ETag and Last-Modified headers are sent, and 304 Not Modified is returned on a matching
+ * If-None-Match or If-Modified-Since request header.
  * @param[in]  h         Clixon handle
  * @param[in]  req       Generic Www handle (can be part of clixon handle)
  * @param[in]  pathname  With stripped prefix (eg /data), ultimately a filename
  * @param[in]  head      HEAD not GET
  * @retval     0         OK
  * @retval    -1         Error
- * @note: primitive file handling, just check if file exists and read it all
- * XXX 1: Buffer copying once too many, see #if 0 below
  */
 static int
 api_http_data_file(clicon_handle h,
@@ -282,19 +328,27 @@ api_http_data_file(clicon_handle h,
                    char         *pathname,
                    int           head)
 {
-    int         retval = -1;
-    cbuf       *cbfile = NULL;
-    char       *filename = NULL;
-    cbuf       *cbdata = NULL;
-    FILE       *f = NULL;
-    off_t       fsz = 0;
-    long        fsize;
-    char       *www_data_root = NULL;
-    char       *suffix;
-    char       *media;
-    int         ret;
-    char       *buf = NULL;
-    size_t      sz;
+    int                retval = -1;
+    cbuf              *cbfile = NULL;
+    cbuf              *cbvar = NULL;
+    char              *filename = NULL;
+    int                fd = -1;
+    int                fdvar;
+    struct stat        st;
+    struct stat        stvar;
+    char              *www_data_root = NULL;
+    char              *suffix;
+    char              *media;
+    char              *accept;
+    char              *str;
+    const map_str2str *ms;
+    char              *encoding = NULL;
+    int                vary = 0;
+    int                notmod = 0;
+    char               etag[64];
+    char               lastmod[64];
+    struct tm          tm;
+    int                ret;
 
     clixon_debug(CLIXON_DBG_DEFAULT, "%s", __FUNCTION__);
     if ((cbfile = cbuf_new()) == NULL){
@@ -317,7 +371,7 @@ api_http_data_file(clicon_handle h,
         }
         cprintf(cbfile, "%s", pathname); /* Assume pathname starts with '/' */
     }
-    if ((ret = http_data_check_file_path(h, req, www_data_root, cbfile, &f, &fsz)) < 0)
+    if ((ret = http_data_check_file_path(h, req, www_data_root, cbfile, &fd)) < 0)
         goto done;
     if (ret == 0) /* Invalid, return code set */
         goto ok;
@@ -331,64 +385,77 @@ api_http_data_file(clicon_handle h,
         if ((media = clicon_str2str(mime_map, suffix)) == NULL)
             media = "application/octet-stream";
     }
-    /* Size could have been taken from stat() but this reduces the race condition interval 
-     * There is still one without flock
-     */
-    fseek(f, 0, SEEK_END);
-    fsize = ftell(f);
-    /* Extra sanity check, had some problems with wrong file types */
-    if (fsz != fsize){
-        clixon_debug(CLIXON_DBG_DEFAULT, "%s Error file %s size mismatch sz:%zu vs %li",
-                     __FUNCTION__, filename, (size_t)fsz, fsize);
-        if (api_http_data_err(h, req, 500) < 0) /* Internal error? */
-            goto done;
-        goto ok;
-    }
-    fseek(f, 0, SEEK_SET);  /* same as rewind(f); */
-    if ((cbdata = cbuf_new_alloc(fsize+1)) == NULL){
-        clicon_err(OE_UNIX, errno, "cbuf_new_alloc");
+    /* Size and time of the open file, it may have been replaced since the path check */
+    if (fstat(fd, &st) < 0){
+        clicon_err(OE_UNIX, errno, "fstat");
         goto done;
     }
-    /* Unoptimized, no direct read but requires an extra copy,
-     * the cligen buf API should have some mechanism for this case without the extra copy.
-     */
-    if ((buf = malloc(fsize)) == NULL){
-        clicon_err(OE_UNIX, errno, "malloc");
-        goto done;
-    }
-    if ((ret = fread(buf, fsize, 1, f)) < 0){
-        clicon_err(OE_UNIX, errno, "fread");
+    /* Precompressed variants in same dir, in order of preference */
+    if ((cbvar = cbuf_new()) == NULL){
+        clicon_err(OE_UNIX, errno, "cbuf_new");
         goto done;
     }
-    sz = (size_t)ret;
-    if (sz != 1){
-        clixon_debug(CLIXON_DBG_DEFAULT, "%s Error fread(%s) sz:%zu", __FUNCTION__, filename, sz);
-        if (api_http_data_err(h, req, 500) < 0) /* Internal error? */
-            goto done;
-        goto ok;
+    accept = restconf_param_get(h, "HTTP_ACCEPT_ENCODING");
+    for (ms = encoding_map; ms->ms_s0; ms++){
+        cbuf_reset(cbvar);
+        cprintf(cbvar, "%s%s", filename, ms->ms_s1);
+        /* Ensure regular file, not soft link */
+        if (lstat(cbuf_get(cbvar), &stvar) < 0 || !S_ISREG(stvar.st_mode))
+            continue;
+        vary++;
+        if (encoding != NULL || accept == NULL ||
+            !restconf_accept_encoding(accept, ms->ms_s0))
+            continue;
+        if ((fdvar = open(cbuf_get(cbvar), O_RDONLY)) < 0)
+            continue;
+        if (fstat(fdvar, &stvar) < 0 || !S_ISREG(stvar.st_mode)){
+            close(fdvar);
+            continue;
+        }
+        close(fd);
+        fd = fdvar;
+        st = stvar;
+        encoding = ms->ms_s0;
+        clixon_debug(CLIXON_DBG_DEFAULT, "%s %s encoding:%s", __FUNCTION__, cbuf_get(cbvar), encoding);
     }
-    if (cbuf_append_buf(cbdata, buf, fsize) < 0){
-        clicon_err(OE_UNIX, errno, "cbuf_append_str");
+    /* Validators of the sent file */
+    snprintf(etag, sizeof(etag), "\"%lx-%llx\"",
+             (unsigned long)st.st_mtime, (unsigned long long)st.st_size);
+    gmtime_r(&st.st_mtime, &tm);
+    strftime(lastmod, sizeof(lastmod), "%a, %d %b %Y %H:%M:%S GMT", &tm);
+    /* If-None-Match has precedence, If-Modified-Since is compared exactly as eg nginx does */
+    if ((str = restconf_param_get(h, "HTTP_IF_NONE_MATCH")) != NULL)
+        notmod = http_data_etag_match(str, etag);
+    else if ((str = restconf_param_get(h, "HTTP_IF_MODIFIED_SINCE")) != NULL)
+        notmod = (strcmp(str, lastmod) == 0);
+    if (!notmod &&
+        restconf_reply_header(req, "Content-Type", "%s", media) < 0)
         goto done;
-    }
-    if (restconf_reply_header(req, "Content-Type", "%s", media) < 0)
+    if (!notmod && encoding &&
+        restconf_reply_header(req, "Content-Encoding", "%s", encoding) < 0)
         goto done;
-    if (restconf_reply_send(req, 200, cbdata, head) < 0)
+    if (vary &&
+        restconf_reply_header(req, "Vary", "Accept-Encoding") < 0)
+        goto done;
+    if (restconf_reply_header(req, "ETag", "%s", etag) < 0)
+        goto done;
+    if (restconf_reply_header(req, "Last-Modified", "%s", lastmod) < 0)
+        goto done;
+    ret = restconf_reply_send_file(req, notmod?304:200, fd, st.st_size, head || notmod);
+    fd = -1; /* consumed by reply-send */
+    if (ret < 0)
         goto done;
-    cbdata = NULL; /* consumed by reply-send */
     clixon_debug(CLIXON_DBG_DEFAULT, "%s Read %s OK", __FUNCTION__, filename);
  ok:
     retval = 0;
  done:
-    if (buf)
-        free(buf);
-    if (f)
-        fclose(f);
+    if (fd != -1)
+        close(fd);
     if (cbfile)
         cbuf_free(cbfile);
-    if (cbdata)
-        cbuf_free(cbdata);
- return retval;
+    if (cbvar)
+        cbuf_free(cbvar);
+    return retval;
 }
 
 /*! Get data request
@@ -38,6 +38,23 @@
 #ifndef _RESTCONF_API_H_
 #define _RESTCONF_API_H_
 
+/*
+ * Types
+ */
+/*! Produce next part of a reply body, see restconf_reply_send_stream
+ *
+ * @param[in]  arg   Argument given to restconf_reply_send_stream
+ * @param[out] cb    Append approximately len bytes of body to this cbuf
+ * @param[in]  len   Requested length
+ * @retval     1     OK, more body to come
+ * @retval     0     OK, body done
+ * @retval    -1     Error
+ */
+typedef int (restconf_body_fn)(void *arg, cbuf *cb, size_t len);
+
+/*! Free argument of body producer, see restconf_reply_send_stream */
+typedef int (restconf_body_free_fn)(void *arg);
+
 /*
  * Prototypes
  */
@@ -46,6 +63,12 @@ int restconf_reply_header(void *req, const char *name, const char *vfmt, ...)  _
 /* note cb is consumed dont free */
 int restconf_reply_send(void *req, int code, cbuf *cb, int head);
 
+/* note fd is consumed dont close */
+int restconf_reply_send_file(void *req, int code, int fd, size_t len, int head);
+
+/* note arg is consumed by freefn dont free */
+int restconf_reply_send_stream(void *req, int code, restconf_body_fn *fn, restconf_body_free_fn *freefn, void *arg, int head);
+
 cbuf *restconf_get_indata(void *req);
 
 #endif /* _RESTCONF_API_H_ */
@@ -230,6 +230,110 @@ restconf_reply_send(void  *req0,
     return retval;
 }
 
+/*! Send HTTP reply with an open file as message body
+ *
+ * Prerequisites: status code set, headers given
+ * @param[in]  req   Fastcgi request handle
+ * @param[in]  code  Status code
+ * @param[in]  fd    Open file, body is read from offset 0. Note is consumed
+ * @param[in]  len   Length of body
+ * @param[in]  head  Only send headers, dont send body.
+ * @retval     0     OK
+ * @retval    -1     Error
+ * @note fcgi output is buffered by libfcgi, the file is read in chunks into its stream
+ */
+int
+restconf_reply_send_file(void  *req0,
+                         int    code,
+                         int    fd,
+                         size_t len,
+                         int    head)
+{
+    FCGX_Request *req = (FCGX_Request *)req0;
+    int           retval = -1;
+    const char   *reason_phrase;
+    char          buf[BUFSIZ];
+    ssize_t       n;
+
+    FCGX_SetExitStatus(code, req->out);
+    if ((reason_phrase = restconf_code2reason(code)) == NULL)
+        reason_phrase="";
+    if (restconf_reply_header(req, "Status", "%d %s", code, reason_phrase) < 0)
+        goto done;
+    FCGX_FPrintF(req->out, "\r\n");
+    while (!head && len > 0){
+        if ((n = read(fd, buf, len<sizeof(buf)?len:sizeof(buf))) < 0){
+            clicon_err(OE_UNIX, errno, "read");
+            goto done;
+        }
+        if (n == 0) /* File truncated */
+            break;
+        FCGX_PutStr(buf, n, req->out);
+        len -= n;
+    }
+    FCGX_FFlush(req->out);
+    retval = 0;
+ done:
+    close(fd);
+    return retval;
+}
+
+/*! Send HTTP reply with message body produced in parts
+ *
+ * Prerequisites: status code set, headers given
+ * @param[in]  req    Fastcgi request handle
+ * @param[in]  code   Status code
+ * @param[in]  fn     Body producer, called until body is done
+ * @param[in]  freefn Free function of arg, called when body is done
+ * @param[in]  arg    Argument to fn and freefn. Note is consumed
+ * @param[in]  head   Only send headers, dont send body.
+ * @retval     0      OK
+ * @retval    -1      Error
+ * @note fcgi output is buffered by libfcgi, each part is written into its stream
+ */
+int
+restconf_reply_send_stream(void                  *req0,
+                           int                    code,
+                           restconf_body_fn      *fn,
+                           restconf_body_free_fn *freefn,
+                           void                  *arg,
+                           int                    head)
+{
+    FCGX_Request *req = (FCGX_Request *)req0;
+    int           retval = -1;
+    const char   *reason_phrase;
+    cbuf         *cb = NULL;
+    size_t        len = 0;
+    int           ret = 1;
+
+    FCGX_SetExitStatus(code, req->out);
+    if ((reason_phrase = restconf_code2reason(code)) == NULL)
+        reason_phrase="";
+    if (restconf_reply_header(req, "Status", "%d %s", code, reason_phrase) < 0)
+        goto done;
+    FCGX_FPrintF(req->out, "\r\n");
+    if ((cb = cbuf_new()) == NULL){
+        clicon_err(OE_UNIX, errno, "cbuf_new");
+        goto done;
+    }
+    while (!head && ret == 1){
+        if ((ret = fn(arg, cb, BUFSIZ)) < 0)
+            goto done;
+        FCGX_PutStr(cbuf_get(cb), cbuf_len(cb), req->out);
+        len += cbuf_len(cb);
+        cbuf_reset(cb);
+    }
+    if (len)
+        FCGX_FPrintF(req->out, "\r\n");
+    FCGX_FFlush(req->out);
+    retval = 0;
+ done:
+    if (cb)
+        cbuf_free(cb);
+    freefn(arg);
+    return retval;
+}
+
 /*! Get input data from http request, eg such as curl -X PUT http://... <indata>
  *
  * @param[in]  req        Fastcgi request handle
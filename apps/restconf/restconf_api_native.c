@@ -171,6 +171,115 @@ restconf_reply_send(void  *req0,
     return retval;
 }
 
+/*! Send HTTP reply with an open file as message body
+ *
+ * The file is not read here, the descriptor is kept in the stream and the file is written
+ * directly to the socket when the reply is sent, with sendfile(2) where possible.
+ * @param[in]  req   http request handle
+ * @param[in]  code  Status code
+ * @param[in]  fd    Open file, body is read from offset 0. Note: is consumed
+ * @param[in]  len   Length of body
+ * @param[in]  head  Only send headers, dont send body.
+ * @retval     0     OK
+ * @retval    -1     Error
+ * @see restconf_reply_send  Body as cbuf
+ */
+int
+restconf_reply_send_file(void  *req0,
+                         int    code,
+                         int    fd,
+                         size_t len,
+                         int    head)
+{
+    int                   retval = -1;
+    restconf_stream_data *sd = (restconf_stream_data *)req0;
+
+    clixon_debug(CLIXON_DBG_DEFAULT, "%s code:%d len:%zu", __FUNCTION__, code, len);
+    if (sd == NULL){
+        clicon_err(OE_CFG, EINVAL, "sd is NULL");
+        goto done;
+    }
+    sd->sd_code = code;
+    sd->sd_body_len = len;
+    if (sd->sd_fd != -1){
+        close(sd->sd_fd);
+        sd->sd_fd = -1;
+    }
+    if (head || len == 0)
+        close(fd);
+    else{
+        sd->sd_fd = fd;
+        sd->sd_body_offset = 0;
+    }
+    fd = -1;
+    retval = 0;
+ done:
+    if (fd != -1)
+        close(fd);
+    return retval;
+}
+
+/*! Send HTTP reply with message body produced in parts
+ *
+ * The body is not produced here, only its first part. The rest is produced when the reply
+ * is sent: with http/2 one part at a time as the flow control window of the stream allows,
+ * with http/1 all at once for Content-Length.
+ * @param[in]  req    http request handle
+ * @param[in]  code   Status code
+ * @param[in]  fn     Body producer
+ * @param[in]  freefn Free function of arg, called when body is done or stream is freed
+ * @param[in]  arg    Argument to fn and freefn. Note: is consumed
+ * @param[in]  head   Only send headers, dont send body.
+ * @retval     0      OK
+ * @retval    -1      Error
+ * @see restconf_reply_send  Body as cbuf
+ */
+int
+restconf_reply_send_stream(void                  *req0,
+                           int                    code,
+                           restconf_body_fn      *fn,
+                           restconf_body_free_fn *freefn,
+                           void                  *arg,
+                           int                    head)
+{
+    int                   retval = -1;
+    restconf_stream_data *sd = (restconf_stream_data *)req0;
+    size_t                len = 0;
+    int                   ret;
+
+    clixon_debug(CLIXON_DBG_DEFAULT, "%s code:%d", __FUNCTION__, code);
+    if (sd == NULL){
+        clicon_err(OE_CFG, EINVAL, "sd is NULL");
+        freefn(arg);
+        goto done;
+    }
+    sd->sd_code = code;
+    sd->sd_body_fn = fn;
+    sd->sd_body_free = freefn;
+    sd->sd_body_arg = arg;
+    if (head){ /* Only length is needed */
+        do {
+            if ((ret = restconf_stream_body_next(sd)) < 0)
+                goto done;
+            len += cbuf_len(sd->sd_body);
+        } while (ret == 1);
+        cbuf_free(sd->sd_body);
+        sd->sd_body = NULL;
+    }
+    else {
+        if (restconf_stream_body_next(sd) < 0)
+            goto done;
+        if ((len = cbuf_len(sd->sd_body)) == 0){
+            cbuf_free(sd->sd_body);
+            sd->sd_body = NULL;
+        }
+    }
+    sd->sd_body_len = len;
+    retval = 0;
+ done:
+    return retval;
+}
+
 /*! Get input data from http request, eg such as curl -X PUT http://... <indata>
  *
  * @param[in]  req        Request handle
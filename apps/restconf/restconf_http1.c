@@ -303,6 +303,12 @@ restconf_http1_reply(restconf_conn        *rc,
     cg_var *cv;
 
     clixon_debug(CLIXON_DBG_DEFAULT, "%s", __FUNCTION__);
+    /* Produce rest of streamed body, no chunked transfer-coding */
+    if (restconf_stream_body_all(sd) < 0)
+        goto done;
+    /* Compress body before its length is known */
+    if (restconf_compress_body(sd) < 0)
+        goto done;
     /* If body, add a content-length header 
      *    A server MUST NOT send a Content-Length header field in any response
      * with a status code of 1xx (Informational) or 204 (No Content).  A
@@ -453,7 +459,10 @@ restconf_http1_path_root(clicon_handle  h,
     else
         sd->sd_code = 404; /* catch all without body/media */
  fail:
-   if (restconf_param_del_all(h) < 0)
+    /* Needs Accept-Encoding request header */
+    if (restconf_compress_select(h, sd) < 0)
+        goto done;
+    if (restconf_param_del_all(h) < 0)
         goto done;
 #ifdef HAVE_LIBNGHTTP2
  upgrade:
@@ -44,6 +44,7 @@
 
 #include <stdlib.h>
 #include <string.h>
+#include <strings.h>
 #include <unistd.h>
 #include <errno.h>
 #include <signal.h>
@@ -317,6 +318,50 @@ restconf_convert_hdr(clicon_handle h,
     return retval;
 }
 
+/*! Check if a content-coding is acceptable according to an Accept-Encoding header
+ *
+ * @param[in]  accept  Accept-Encoding header value, eg "gzip, deflate, br;q=0.5"
+ * @param[in]  coding  Content-coding, eg "gzip"
+ * @retval     1       Acceptable
+ * @retval     0       Not acceptable: not listed or q=0
+ * @see RFC 7231 Sec 5.3.4
+ */
+int
+restconf_accept_encoding(char       *accept,
+                         const char *coding)
+{
+    int    retval = 0;
+    char  *p = accept;
+    char  *q;
+    size_t len;
+    size_t ilen;
+    int    star = 0;
+
+    while (*p != '\0'){
+        while (*p == ' ' || *p == '\t' || *p == ',')
+            p++;
+        len = strcspn(p, " \t;,");
+        ilen = strcspn(p, ",");
+        if ((len == strlen(coding) && strncasecmp(p, coding, len) == 0) ||
+            (len == 1 && *p == '*')){
+            /* Only parameter is weight: q=0 means not acceptable */
+            for (q = p + len; q < p + ilen; q++)
+                if (*q == 'q' && q[1] == '=')
+                    break;
+            if (*p == '*')
+                star = (q == p + ilen || strtod(q+2, NULL) > 0.0);
+            else {
+                retval = (q == p + ilen || strtod(q+2, NULL) > 0.0);
+                goto done;
+            }
+        }
+        p += ilen;
+    }
+    retval = star;
+ done:
+    return retval;
+}
+
 /*! Parse a cookie string and return value of cookie attribute
  *
  * @param[in]  cookiestr  cookie string according to rfc6265 (modified)
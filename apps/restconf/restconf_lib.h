@@ -89,6 +89,7 @@ int   restconf_str2proto(char *str);
 const char *restconf_proto2str(int proto);
 restconf_media restconf_content_type(clicon_handle h);
 int   restconf_convert_hdr(clicon_handle h, char *name, char *val);
+int   restconf_accept_encoding(char *accept, const char *coding);
 int   get_user_cookie(char *cookiestr, char  *attribute, char **val);
 int   restconf_terminate(clicon_handle h);
 int   restconf_insert_attributes(cxobj *xdata, cvec *qvec);
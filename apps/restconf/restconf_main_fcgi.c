@@ -309,7 +309,6 @@ main(int    argc,
     char          *query;
     cvec          *qvec;
     int            finish = 0;
-    char          *str;
     clixon_plugin_t *cp = NULL;
     cvec          *nsctx_global = NULL; /* Global namespace context */
     size_t         cligen_buflen;
@@ -487,23 +486,9 @@ main(int    argc,
         goto done;
     clixon_plugin_api_get(cp)->ca_extension = restconf_main_extension_cb;
 
-    /* Load Yang modules
-     * 1. Load a yang module as a specific absolute filename */
-    if ((str = clicon_yang_main_file(h)) != NULL){
-        if (yang_spec_parse_file(h, str, yspec) < 0)
-            goto done;
-    }
-    /* 2. Load a (single) main module */
-    if ((str = clicon_yang_module_main(h)) != NULL){
-        if (yang_spec_parse_module(h, str, clicon_yang_module_revision(h),
-                                   yspec) < 0)
-            goto done;
-    }
-    /* 3. Load all modules in a directory */
-    if ((str = clicon_yang_main_dir(h)) != NULL){
-        if (yang_spec_load_dir(h, str, yspec) < 0)
-            goto done;
-    }
+    /* Load main Yang modules, from cache if CLICON_YANG_CACHE_DIR is set */
+    if (yang_spec_load_main(h, yspec) < 0)
+        goto done;
 
     /* Load clixon lib yang module */
     if (yang_spec_parse_module(h, "clixon-lib", NULL, yspec) < 0)
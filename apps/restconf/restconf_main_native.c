@@ -919,7 +919,6 @@ restconf_clixon_init(clicon_handle h,
     size_t         cligen_bufthreshold;
     yang_stmt     *yspec = NULL;
     clixon_plugin_t *cp = NULL;
-    char          *str;
     cvec          *nsctx_global = NULL; /* Global namespace context */
     cxobj         *xrestconf = NULL;
     cxobj         *xerr = NULL;
@@ -961,23 +960,9 @@ restconf_clixon_init(clicon_handle h,
         goto done;
     clixon_plugin_api_get(cp)->ca_extension = restconf_main_extension_cb;
 
-    /* Load Yang modules
-     * 1. Load a yang module as a specific absolute filename */
-    if ((str = clicon_yang_main_file(h)) != NULL){
-        if (yang_spec_parse_file(h, str, yspec) < 0)
-            goto done;
-    }
-    /* 2. Load a (single) main module */
-    if ((str = clicon_yang_module_main(h)) != NULL){
-        if (yang_spec_parse_module(h, str, clicon_yang_module_revision(h),
-                                   yspec) < 0)
-            goto done;
-    }
-    /* 3. Load all modules in a directory */
-    if ((str = clicon_yang_main_dir(h)) != NULL){
-        if (yang_spec_load_dir(h, str, yspec) < 0)
-            goto done;
-    }
+    /* Load main Yang modules, from cache if CLICON_YANG_CACHE_DIR is set */
+    if (yang_spec_load_main(h, yspec) < 0)
+        goto done;
     /* Load clixon lib yang module */
     if (yang_spec_parse_module(h, "clixon-lib", NULL, yspec) < 0)
         goto done;
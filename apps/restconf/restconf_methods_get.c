@@ -66,6 +66,60 @@
 /* Forward */
 static int api_data_pagination(clicon_handle h, void *req, char *api_path, int pi, cvec *qvec, int pretty, restconf_media media_out);
 
+/*! Streamed GET reply body, owns the backend reply while it is sent, see api_data_get2
+ */
+typedef struct {
+    cxobj       *gs_xret;  /* Backend reply */
+    cxobj      **gs_xvec;  /* Objects of reply to print, or NULL for data root */
+    json_stream *gs_js;    /* JSON output, or NULL */
+    xml_stream  *gs_xs;    /* XML output, or NULL */
+} api_data_stream;
+
+/*! Produce next part of GET reply body
+ *
+ * @param[in]  arg   GET reply stream
+ * @param[out] cb    Append body to this cbuf
+ * @param[in]  len   Requested length
+ * @retval     1     OK, more body to come
+ * @retval     0     OK, body done
+ * @retval    -1     Error
+ * @see restconf_body_fn
+ */
+static int
+api_data_stream_read(void  *arg,
+                     cbuf  *cb,
+                     size_t len)
+{
+    api_data_stream *gs = (api_data_stream *)arg;
+
+    if (gs->gs_js)
+        return clixon_json_stream_read(gs->gs_js, cb, len);
+    else if (gs->gs_xs)
+        return clixon_xml_stream_read(gs->gs_xs, cb, len);
+    return 0;
+}
+
+/*! Free GET reply stream including the backend reply
+ *
+ * @param[in]  arg   GET reply stream
+ */
+static int
+api_data_stream_free(void *arg)
+{
+    api_data_stream *gs = (api_data_stream *)arg;
+
+    if (gs->gs_js)
+        clixon_json_stream_free(gs->gs_js);
+    if (gs->gs_xs)
+        clixon_xml_stream_free(gs->gs_xs);
+    if (gs->gs_xvec)
+        free(gs->gs_xvec);
+    if (gs->gs_xret)
+        xml_free(gs->gs_xret);
+    free(gs);
+    return 0;
+}
+
 /*! Generic GET (both HEAD and GET)
  * According to restconf 
  * @param[in]  h        Clixon handle
@@ -108,12 +162,10 @@ api_data_get2(clicon_handle  h,
 {
     int        retval = -1;
     char      *xpath = NULL;
-    cbuf      *cbx = NULL;
     yang_stmt *yspec;
     cxobj     *xret = NULL;
     cxobj     *xerr = NULL; /* malloced */
     cxobj     *xe = NULL;   /* not malloced */
-    cxobj    **xvec = NULL;
     size_t     xlen;
     int        i;
     cxobj     *x;
@@ -127,6 +179,7 @@ api_data_get2(clicon_handle  h,
     yang_stmt *y = NULL;
     char      *defaults = NULL;
     cvec      *nscd = NULL;
+    api_data_stream *gs = NULL;
 
     clixon_debug(CLIXON_DBG_DEFAULT, "%s", __FUNCTION__);
     if ((yspec = clicon_dbspec_yang(h)) == NULL){
@@ -160,7 +213,8 @@ api_data_get2(clicon_handle  h,
             (yang_keyword_get(y) == Y_LIST || yang_keyword_get(y) == Y_LEAF_LIST) &&
             (cvec_find(qvec, "where")     || cvec_find(qvec, "sort-by") ||
              cvec_find(qvec, "direction") || cvec_find(qvec, "offset") ||
-             cvec_find(qvec, "limit")     || cvec_find(qvec, "sublist-limit"))){
+             cvec_find(qvec, "limit")     || cvec_find(qvec, "sublist-limit") ||
+             cvec_find(qvec, "cursor"))){
             if (api_data_pagination(h, req, api_path, 0, qvec, pretty, media_out) < 0)
                 goto done;
             goto ok;
@@ -225,19 +279,24 @@ api_data_get2(clicon_handle  h,
             goto done;
         goto ok;
     }
-    /* Normal return, no error */
-    if ((cbx = cbuf_new()) == NULL){
-        clicon_err(OE_UNIX, errno, "cbuf_new");
+    /* Normal return, no error
+     * The reply body is produced in parts when it is sent, the reply is kept until then */
+    if ((gs = malloc(sizeof(*gs))) == NULL){
+        clicon_err(OE_UNIX, errno, "malloc");
         goto done;
     }
+    memset(gs, 0, sizeof(*gs));
+    /* The streams below refer to the reply tree and vector, which gs owns from here on */
+    gs->gs_xret = xret;
+    xret = NULL;
     if (xpath==NULL || strcmp(xpath,"/")==0){ /* Special case: data root */
         switch (media_out){
         case YANG_DATA_XML:
-            if (clixon_xml2cbuf(cbx, xret, 0, pretty, NULL, -1, 0) < 0) /* Dont print top object?  */
+            if ((gs->gs_xs = clixon_xml_stream_new(&gs->gs_xret, 1, pretty)) == NULL)
                 goto done;
             break;
         case YANG_DATA_JSON:
-            if (clixon_json2cbuf(cbx, xret, pretty, 0, 0) < 0)
+            if ((gs->gs_js = clixon_json_stream_new(gs->gs_xret, pretty)) == NULL)
                 goto done;
             break;
         default:
@@ -245,7 +304,7 @@ api_data_get2(clicon_handle  h,
         }
     }
     else{
-        if (xpath_vec(xret, nsc, "%s", &xvec, &xlen, xpath) < 0){
+        if (xpath_vec(gs->gs_xret, nsc, "%s", &gs->gs_xvec, &xlen, xpath) < 0){
             if (netconf_operation_failed_xml(&xerr, "application", clicon_err_reason) < 0)
                 goto done;
             if (api_return_err0(h, req, xerr, pretty, media_out, 0) < 0)
@@ -268,7 +327,7 @@ api_data_get2(clicon_handle  h,
         switch (media_out){
         case YANG_DATA_XML:
             for (i=0; i<xlen; i++){
-                x = xvec[i];
+                x = gs->gs_xvec[i];
                 if (xml_nsctx_node(x, &nscd) < 0)
                     goto done;
                 if (xmlns_set_all(x, nscd) < 0)
@@ -277,29 +336,29 @@ api_data_get2(clicon_handle  h,
                     cvec_free(nscd);
                     nscd = NULL;
                 }
-                if (clixon_xml2cbuf(cbx, x, 0, pretty, NULL, -1, 0) < 0) /* Dont print top object?  */
-                    goto done;
             }
+            if ((gs->gs_xs = clixon_xml_stream_new(gs->gs_xvec, xlen, pretty)) == NULL)
+                goto done;
             break;
         case YANG_DATA_JSON:
             /* In: <x xmlns="urn:example:clixon">0</x>
              * Out: {"example:x": {"0"}}
              */
-            if (xml2json_cbuf_vec(cbx, xvec, xlen, pretty, 0) < 0)
+            if ((gs->gs_js = clixon_json_stream_vec_new(gs->gs_xvec, xlen, pretty)) == NULL)
                 goto done;
             break;
         default:
             break;
         }
     }
-    clixon_debug(CLIXON_DBG_DEFAULT, "%s cbuf:%s", __FUNCTION__, cbuf_get(cbx));
     if (restconf_reply_header(req, "Content-Type", "%s", restconf_media_int2str(media_out)) < 0)
         goto done;
     if (restconf_reply_header(req, "Cache-Control", "no-cache") < 0)
         goto done;
-    if (restconf_reply_send(req, 200, cbx, head) < 0)
+    ret = restconf_reply_send_stream(req, 200, api_data_stream_read, api_data_stream_free, gs, head);
+    gs = NULL; /* consumed */
+    if (ret < 0)
         goto done;
-    cbx = NULL;
  ok:
     retval = 0;
  done:
@@ -312,14 +371,12 @@ api_data_get2(clicon_handle  h,
         xml_nsctx_free(nsc);
     if (xtop)
         xml_free(xtop);
-    if (cbx)
-        cbuf_free(cbx);
+    if (gs)
+        api_data_stream_free(gs);
     if (xret)
         xml_free(xret);
     if (xerr)
         xml_free(xerr);
-    if (xvec)
-        free(xvec);
     return retval;
 }
 
@@ -376,9 +433,11 @@ api_data_pagination(clicon_handle  h,
     int32_t    depth = -1;  /* Nr of levels to print, -1 is all, 0 is none */
     uint32_t   limit = 0;
     uint32_t   offset = 0;
+    uint32_t   sublimit = 0;
     char      *direction;
     char      *sort;
     char      *where;
+    char      *cursor;
     char      *ns;
 
     clixon_debug(CLIXON_DBG_DEFAULT, "%s", __FUNCTION__);
@@ -487,12 +546,22 @@ api_data_pagination(clicon_handle  h,
             goto ok;
         }
     }
+    if ((attr = cvec_find_str(qvec, "sublist-limit")) != NULL){   /* 1-uint32 or "unbounded" */
+        if ((ret = netconf_parse_uint32_xml("sublist-limit", attr, "unbounded", 0, &xerr, &sublimit)) < 0)
+            goto done;
+        if (ret == 0){
+            if (api_return_err0(h, req, xerr, pretty, media_out, 0) < 0)
+                goto done;
+            goto ok;
+        }
+    }
     direction = cvec_find_str(qvec, "direction");
     sort = cvec_find_str(qvec, "sort-by");
     where = cvec_find_str(qvec, "where");
+    cursor = cvec_find_str(qvec, "cursor"); /* Clixon extension: keyset pagination */
     if (clicon_rpc_get_pageable_list(h, "running", xpath, nsc, content,
                                      depth, NULL, offset, limit, direction, sort, where,
-                                     &xret) < 0){
+                                     sublimit, cursor, &xret) < 0){
         if (netconf_operation_failed_xml(&xerr, "protocol", clicon_err_reason) < 0)
             goto done;
         if ((xe = xpath_first(xerr, NULL, "rpc-error")) == NULL){
@@ -540,15 +540,18 @@ yang_patch_do_value(clicon_handle  h,
                     )
 {
     int     retval = -1;
-    cxobj **values_child_vec;
+    cxobj  *xvalue;
     char   *key_node_id;
     cbuf   *patch_header = NULL;
     cxobj  *x_simple_patch = NULL;
     int     value_vec_len;
     cxobj **value_vec;
 
-    values_child_vec = xml_childvec_get(xn);
-    key_node_id = xml_name(*values_child_vec);
+    if ((xvalue = xml_child_i(xn, 0)) == NULL){
+        clicon_err(OE_XML, 0, "yang-patch value has no child");
+        goto done;
+    }
+    key_node_id = xml_name(xvalue);
     /* Create cbufs:s */
     if ((patch_header = cbuf_new()) == NULL){
         clicon_err(OE_UNIX, errno, "cbuf_new");
@@ -557,8 +560,8 @@ yang_patch_do_value(clicon_handle  h,
     cprintf(patch_header, "%s:%s", modname, key_node_id);
     if ((x_simple_patch = xml_new(cbuf_get(patch_header), NULL, CX_ELMNT)) == NULL)
         goto done;
-    value_vec_len = xml_child_nr(*values_child_vec);
-    value_vec = xml_childvec_get(*values_child_vec);
+    value_vec_len = xml_child_nr(xvalue);
+    value_vec = xml_childvec_get(xvalue);
     switch (operation){
     case YANG_PATCH_OP_REPLACE:
         if (yang_patch_do_replace(h, req, pi, qvec, pretty, media_out, ds, simple_patch_request_uri, target_val, value_vec_len, value_vec, x_simple_patch) < 0)
@@ -626,7 +629,6 @@ yang_patch_do_edit(clicon_handle  h,
     char      *point_val = NULL;
     char      *target_val = NULL;
     char      *modname;
-    cxobj    **key_vec = NULL;
     cxobj     *key_xn = NULL;
     int        i;
     cxobj     *x; /* general purpose xml-tree pointer */
@@ -696,8 +698,7 @@ yang_patch_do_edit(clicon_handle  h,
         goto done;
     modname = yang_argument_get(ymod);
     // XXX this seems to be hardcoded to a yang list?
-    if ((key_vec = xml_childvec_get(xbot)) != NULL)
-        key_xn = key_vec[0];
+    key_xn = xml_child_i(xbot, 0);
     // Get values (for "delete" and "remove", there are no values)
     xpath_vec(xn, NULL, "value", &vec, &veclen);
 
@@ -49,6 +49,12 @@
 #include <sys/socket.h>
 #include <arpa/inet.h>
 #include <sys/resource.h>
+#ifdef HAVE_SYS_SENDFILE_H
+#include <sys/sendfile.h>
+#endif
+#ifdef HAVE_LIBZ
+#include <zlib.h>
+#endif
 
 #include <openssl/ssl.h>
 #include <openssl/rand.h>
@@ -68,6 +74,7 @@
 #include "restconf_lib.h"       /* generic shared with plugins */
 #include "restconf_handle.h"
 #include "restconf_err.h"
+#include "restconf_api.h"
 #include "restconf_native.h"    /* Restconf-openssl mode specific headers*/
 #ifdef HAVE_LIBNGHTTP2
 #include <nghttp2/nghttp2.h>
@@ -77,8 +84,18 @@
 #include "restconf_http1.h"
 #endif
 
+/* Chunk size when a file body cannot be sent with sendfile, eg over TLS without kTLS
+ * Same as max TLS record size
+ */
+#define NATIVE_FILE_CHUNK 16384
+
+/* Size of each part of a streamed reply body, see restconf_reply_send_stream */
+#define NATIVE_BODY_CHUNK 16384
+
 /* Forward */
 static int restconf_idle_cb(int fd, void *arg);
+static int restconf_compress_free(restconf_stream_data *sd);
+static int restconf_stream_body_free(restconf_stream_data *sd);
 
 /*! Create restconf stream
  *
@@ -164,6 +181,10 @@ restconf_stream_free(restconf_stream_data *sd)
         free(sd->sd_settings2);
     if (sd->sd_qvec)
         cvec_free(sd->sd_qvec);
+    if (sd->sd_zstream)
+        restconf_compress_free(sd);
+    if (sd->sd_body_fn)
+        restconf_stream_body_free(sd);
     free(sd);
     return 0;
 }
@@ -373,6 +394,280 @@ restconf_connection_sanity(clicon_handle         h,
     return retval;
 }
 
+/*! Free producer of streamed reply body
+ *
+ * @param[in]  sd   Restconf stream data
+ */
+static int
+restconf_stream_body_free(restconf_stream_data *sd)
+{
+    if (sd->sd_body_free && sd->sd_body_arg)
+        sd->sd_body_free(sd->sd_body_arg);
+    sd->sd_body_fn = NULL;
+    sd->sd_body_free = NULL;
+    sd->sd_body_arg = NULL;
+    return 0;
+}
+
+/*! Replace reply body with next part of a streamed body
+ *
+ * The producer is called once and is freed when the body is done
+ * @param[in]  sd   Restconf stream data
+ * @retval     1    OK, sd_body has next part, more to come
+ * @retval     0    OK, sd_body has last part (may be empty)
+ * @retval    -1    Error
+ * @see restconf_reply_send_stream
+ */
+int
+restconf_stream_body_next(restconf_stream_data *sd)
+{
+    int retval = -1;
+    int ret;
+
+    if (sd->sd_body == NULL &&
+        (sd->sd_body = cbuf_new()) == NULL){
+        clicon_err(OE_UNIX, errno, "cbuf_new");
+        goto done;
+    }
+    cbuf_reset(sd->sd_body);
+    sd->sd_body_offset = 0;
+    if (sd->sd_body_fn == NULL)
+        goto ok;
+    if ((ret = sd->sd_body_fn(sd->sd_body_arg, sd->sd_body, NATIVE_BODY_CHUNK)) < 0)
+        goto done;
+    if (ret == 1){
+        retval = 1;
+        goto done;
+    }
+    restconf_stream_body_free(sd);
+ ok:
+    retval = 0;
+ done:
+    return retval;
+}
+
+/*! Append the rest of a streamed body to the reply body
+ *
+ * For replies where the size must be known before sending, ie http/1 Content-Length.
+ * @param[in]  sd   Restconf stream data
+ * @retval     0    OK
+ * @retval    -1    Error
+ */
+int
+restconf_stream_body_all(restconf_stream_data *sd)
+{
+    int retval = -1;
+    int ret;
+
+    if (sd->sd_body_fn == NULL)
+        goto ok;
+    if (sd->sd_body == NULL &&
+        (sd->sd_body = cbuf_new()) == NULL){
+        clicon_err(OE_UNIX, errno, "cbuf_new");
+        goto done;
+    }
+    while ((ret = sd->sd_body_fn(sd->sd_body_arg, sd->sd_body, NATIVE_BODY_CHUNK)) == 1)
+        ;
+    if (ret < 0)
+        goto done;
+    restconf_stream_body_free(sd);
+    sd->sd_body_len = cbuf_len(sd->sd_body);
+ ok:
+    retval = 0;
+ done:
+    return retval;
+}
+
+/*! Select compression of reply body according to Accept-Encoding of request
+ *
+ * If selected, Content-Encoding is added and the body is compressed when sent, either
+ * all at once with restconf_compress_body (http/1) or streamed with restconf_compress_read
+ * (http/2). The body is thus not kept both uncompressed and compressed in memory.
+ * Must be called before the request parameters are removed.
+ * @param[in]  h    Clixon handle
+ * @param[in]  sd   Restconf stream data with reply body
+ * @retval     0    OK, compression selected if sd_zstream is set
+ * @retval    -1    Error
+ * @see CLICON_RESTCONF_COMPRESS_LEVEL and CLICON_RESTCONF_COMPRESS_MIN_SIZE
+ */
+int
+restconf_compress_select(clicon_handle         h,
+                         restconf_stream_data *sd)
+{
+#ifdef HAVE_LIBZ
+    int       retval = -1;
+    int       level;
+    char     *accept;
+    char     *coding;
+    int       wbits;
+    z_stream *z = NULL;
+
+    level = clicon_option_int(h, "CLICON_RESTCONF_COMPRESS_LEVEL");
+    if (level <= 0 ||
+        sd->sd_body == NULL ||
+        sd->sd_zstream != NULL ||
+        (sd->sd_body_fn == NULL && /* Streamed body is at least one part */
+         sd->sd_body_len < clicon_option_int(h, "CLICON_RESTCONF_COMPRESS_MIN_SIZE")) ||
+        cvec_find(sd->sd_outp_hdrs, "Content-Encoding") != NULL)
+        goto ok;
+    if (restconf_reply_header(sd, "Vary", "Accept-Encoding") < 0)
+        goto done;
+    if ((accept = restconf_param_get(h, "HTTP_ACCEPT_ENCODING")) == NULL)
+        goto ok;
+    if (restconf_accept_encoding(accept, "gzip")){
+        coding = "gzip";
+        wbits = MAX_WBITS + 16; /* gzip header and trailer */
+    }
+    else if (restconf_accept_encoding(accept, "deflate")){
+        coding = "deflate";
+        wbits = MAX_WBITS;      /* zlib header and trailer */
+    }
+    else
+        goto ok;
+    if ((z = calloc(1, sizeof(*z))) == NULL){
+        clicon_err(OE_UNIX, errno, "calloc");
+        goto done;
+    }
+    if (deflateInit2(z, level, Z_DEFLATED, wbits, 8, Z_DEFAULT_STRATEGY) != Z_OK){
+        clicon_err(OE_RESTCONF, 0, "deflateInit2: %s", z->msg?z->msg:"");
+        free(z);
+        goto done;
+    }
+    sd->sd_zstream = z;
+    if (restconf_reply_header(sd, "Content-Encoding", "%s", coding) < 0)
+        goto done;
+    clixon_debug(CLIXON_DBG_DEFAULT, "%s %s level:%d len:%zu", __FUNCTION__, coding, level, sd->sd_body_len);
+ ok:
+    retval = 0;
+ done:
+    return retval;
+#else
+    return 0;
+#endif /* HAVE_LIBZ */
+}
+
+/*! Free body compression state
+ *
+ * @param[in]  sd   Restconf stream data
+ */
+static int
+restconf_compress_free(restconf_stream_data *sd)
+{
+#ifdef HAVE_LIBZ
+    z_stream *z = (z_stream *)sd->sd_zstream;
+
+    if (z != NULL){
+        deflateEnd(z);
+        free(z);
+        sd->sd_zstream = NULL;
+    }
+#endif
+    return 0;
+}
+
+/*! Read next part of compressed reply body
+ *
+ * Compresses body from sd_body_offset into buf until buf is full or the body is done
+ * If the body is streamed, next part of body is produced when the current is consumed
+ * @param[in]  sd      Restconf stream data, compression selected with restconf_compress_select
+ * @param[out] buf     Buffer for compressed data
+ * @param[in]  buflen  Size of buf
+ * @param[out] eof     Set to 1 when last compressed data is in buf, then sd_zstream is freed
+ * @retval     n       Number of bytes written to buf
+ * @retval    -1       Error
+ */
+ssize_t
+restconf_compress_read(restconf_stream_data *sd,
+                       uint8_t              *buf,
+                       size_t                buflen,
+                       int                  *eof)
+{
+#ifdef HAVE_LIBZ
+    ssize_t   retval = -1;
+    z_stream *z = (z_stream *)sd->sd_zstream;
+    int       ret;
+
+    if (z == NULL || sd->sd_body == NULL){
+        clicon_err(OE_RESTCONF, EINVAL, "No compression state or body");
+        goto done;
+    }
+    z->next_out = buf;
+    z->avail_out = buflen;
+    while (1){
+        z->next_in = (Bytef*)cbuf_get(sd->sd_body) + sd->sd_body_offset;
+        z->avail_in = cbuf_len(sd->sd_body) - sd->sd_body_offset;
+        /* Finish when the whole (rest of) body is available */
+        ret = deflate(z, sd->sd_body_fn?Z_NO_FLUSH:Z_FINISH);
+        if (ret != Z_OK && ret != Z_STREAM_END && ret != Z_BUF_ERROR){
+            clicon_err(OE_RESTCONF, 0, "deflate: %d", ret);
+            goto done;
+        }
+        sd->sd_body_offset = cbuf_len(sd->sd_body) - z->avail_in;
+        if (ret == Z_STREAM_END || z->avail_out == 0 || sd->sd_body_fn == NULL)
+            break;
+        /* Part consumed, produce next */
+        if (restconf_stream_body_next(sd) < 0)
+            goto done;
+    }
+    retval = buflen - z->avail_out;
+    if (ret == Z_STREAM_END){
+        *eof = 1;
+        restconf_compress_free(sd);
+    }
+ done:
+    return retval;
+#else
+    clicon_err(OE_RESTCONF, ENOTSUP, "Not built with zlib");
+    return -1;
+#endif /* HAVE_LIBZ */
+}
+
+/*! Compress the whole reply body if compression is selected
+ *
+ * For replies where the size must be known before sending, ie http/1 Content-Length.
+ * The body is replaced by the compressed body.
+ * @param[in]  sd   Restconf stream data
+ * @retval     0    OK
+ * @retval    -1    Error
+ * @see restconf_compress_read  Streaming alternative
+ */
+int
+restconf_compress_body(restconf_stream_data *sd)
+{
+    int     retval = -1;
+    cbuf   *cb = NULL;
+    uint8_t buf[NATIVE_FILE_CHUNK];
+    ssize_t n;
+    int     eof = 0;
+
+    if (sd->sd_zstream == NULL)
+        goto ok;
+    if ((cb = cbuf_new()) == NULL){
+        clicon_err(OE_UNIX, errno, "cbuf_new");
+        goto done;
+    }
+    while (!eof){
+        if ((n = restconf_compress_read(sd, buf, sizeof(buf), &eof)) < 0)
+            goto done;
+        if (cbuf_append_buf(cb, buf, n) < 0){
+            clicon_err(OE_UNIX, errno, "cbuf_append_buf");
+            goto done;
+        }
+    }
+    clixon_debug(CLIXON_DBG_DEFAULT, "%s %zu -> %zu", __FUNCTION__, sd->sd_body_len, cbuf_len(cb));
+    cbuf_free(sd->sd_body);
+    sd->sd_body = cb;
+    cb = NULL;
+    sd->sd_body_len = cbuf_len(sd->sd_body);
+    sd->sd_body_offset = 0;
+ ok:
+    retval = 0;
+ done:
+    if (cb)
+        cbuf_free(cb);
+    return retval;
+}
+
 /* Write buf to socket
  * see also this function in restcont_api_openssl.c
  * @param[in]  h        Clixon handle
@@ -478,6 +773,97 @@ native_buf_write(clicon_handle    h,
     goto done;
 }
 
+/*! Write file to socket
+ *
+ * Plain sockets use sendfile(2) and TLS sockets with kernel TLS use SSL_sendfile, the file
+ * is then not copied via user space. Otherwise the file is read in chunks and written with
+ * native_buf_write.
+ * @param[in]  h        Clixon handle
+ * @param[in]  fd       Open file, written from offset 0
+ * @param[in]  len      Number of bytes to write
+ * @param[in]  rc       Connection struct
+ * @param[in]  callfn   For debug
+ * @retval  1  OK
+ * @retval  0  OK, but socket write returned error or file was truncated, caller should close rc
+ * @retval -1  Error
+ * @see restconf_reply_send_file
+ */
+static int
+native_file_write(clicon_handle    h,
+                  int              fd,
+                  size_t           len,
+                  restconf_conn   *rc,
+                  const char      *callfn)
+{
+    int     retval = -1;
+    off_t   offset = 0;
+    ssize_t n;
+    char   *buf = NULL;
+    int     ret;
+
+    clixon_debug(CLIXON_DBG_DEFAULT, "%s %s len:%zu", __FUNCTION__, callfn, len);
+#ifdef HAVE_SYS_SENDFILE_H
+    while (rc->rc_ssl == NULL && offset < len){
+        if ((n = sendfile(rc->rc_s, fd, &offset, len - offset)) < 0){
+            if (errno == EAGAIN){
+                clixon_debug(CLIXON_DBG_DEFAULT, "%s sendfile EAGAIN", __FUNCTION__);
+                usleep(10000);
+                continue;
+            }
+            if (errno == ECONNRESET || errno == EPIPE)
+                goto closed;
+            if (errno == EINVAL || errno == ENOSYS) /* Not supported for this file, copy */
+                break;
+            clicon_err(OE_UNIX, errno, "sendfile");
+            goto done;
+        }
+        if (n == 0) /* File truncated after Content-Length was sent */
+            goto closed;
+    }
+#endif
+#ifdef HAVE_SSL_SENDFILE
+    while (rc->rc_ssl != NULL && BIO_get_ktls_send(SSL_get_wbio(rc->rc_ssl)) && offset < len){
+        if ((n = SSL_sendfile(rc->rc_ssl, fd, offset, len - offset, 0)) <= 0){
+            if (SSL_get_error(rc->rc_ssl, n) == SSL_ERROR_WANT_WRITE){
+                usleep(10000);
+                continue;
+            }
+            if (errno == ECONNRESET || errno == EPIPE)
+                goto closed;
+            break; /* Copy the rest with SSL_write */
+        }
+        offset += n;
+    }
+#endif
+    if (offset < len &&
+        (buf = malloc(NATIVE_FILE_CHUNK)) == NULL){
+        clicon_err(OE_UNIX, errno, "malloc");
+        goto done;
+    }
+    while (offset < len){
+        if ((n = pread(fd, buf, (len-offset)<NATIVE_FILE_CHUNK?(len-offset):NATIVE_FILE_CHUNK, offset)) < 0){
+            clicon_err(OE_UNIX, errno, "pread");
+            goto done;
+        }
+        if (n == 0) /* File truncated after Content-Length was sent */
+            goto closed;
+        if ((ret = native_buf_write(h, buf, n, rc, callfn)) < 0)
+            goto done;
+        if (ret == 0)
+            goto closed;
+        offset += n;
+    }
+    retval = 1;
+ done:
+    clixon_debug(CLIXON_DBG_DEFAULT, "%s retval:%d", __FUNCTION__, retval);
+    if (buf)
+        free(buf);
+    return retval;
+ closed:
+    retval = 0;
+    goto done;
+}
+
 /*! Send early handcoded bad request reply before actual packet received, just after accept
  *
  * @param[in]  h    Clixon handle
@@ -776,6 +1162,14 @@ restconf_http1_process(restconf_conn *rc,
     if ((ret = native_buf_write(h, cbuf_get(sd->sd_outp_buf), cbuf_len(sd->sd_outp_buf),
                                 rc, __FUNCTION__)) < 0)
         goto done;
+    /* Body as file, see restconf_reply_send_file */
+    if (sd->sd_fd != -1){
+        if (ret == 1 &&
+            (ret = native_file_write(h, sd->sd_fd, sd->sd_body_len, rc, __FUNCTION__)) < 0)
+            goto done;
+        close(sd->sd_fd);
+        sd->sd_fd = -1;
+    }
     cvec_reset(sd->sd_outp_hdrs); /* Can be done in native_send_reply */
     cbuf_reset(sd->sd_outp_buf);
     cbuf_reset(sd->sd_inbuf);
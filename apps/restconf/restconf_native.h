@@ -76,12 +76,12 @@ struct restconf_conn;
 typedef struct  {
     qelem_t               sd_qelem;     /* List header */
     int32_t               sd_stream_id;
-    int                   sd_fd;        /* XXX Is this used? */
+    int                   sd_fd;        /* Output body as open file, or -1, see restconf_reply_send_file */
     cvec                 *sd_outp_hdrs; /* List of output headers */
     cbuf                 *sd_outp_buf;  /* Output buffer */
     cbuf                 *sd_body;      /* http output body as cbuf terminated with \r\n */
     size_t                sd_body_len;  /* Content-Length, note for HEAD body body can be NULL and this non-zero */
-    size_t                sd_body_offset; /* Offset into body */
+    size_t                sd_body_offset; /* Offset into body (or sd_fd) */
     cbuf                 *sd_inbuf;     /* Receive/input buf (whole message) */
     cbuf                 *sd_indata;    /* Receive/input data body */
     char                 *sd_path;      /* Uri path, uri-encoded, without args (eg ?) */
@@ -92,6 +92,10 @@ typedef struct  {
     void                 *sd_req;       /* Lib-specific request */
     int                   sd_upgrade2;  /* Upgrade to http/2 */
     uint8_t              *sd_settings2; /* Settings for upgrade to http/2 request */
+    void                 *sd_zstream;   /* Body compression state, see restconf_compress_select */
+    int                 (*sd_body_fn)(void*, cbuf*, size_t); /* Streamed body, see restconf_reply_send_stream */
+    int                 (*sd_body_free)(void*); /* Free sd_body_arg */
+    void                 *sd_body_arg;  /* Argument of sd_body_fn */
 } restconf_stream_data;
 
 typedef struct restconf_socket restconf_socket;
@@ -179,6 +183,11 @@ int               ssl_x509_name_oneline(SSL *ssl, char **oneline);
 
 int               restconf_close_ssl_socket(restconf_conn *rc, const char *callfn, int sslerr0);
 int               restconf_connection_sanity(clicon_handle h, restconf_conn *rc, restconf_stream_data *sd);
+int               restconf_stream_body_next(restconf_stream_data *sd);
+int               restconf_stream_body_all(restconf_stream_data *sd);
+int               restconf_compress_select(clicon_handle h, restconf_stream_data *sd);
+ssize_t           restconf_compress_read(restconf_stream_data *sd, uint8_t *buf, size_t buflen, int *eof);
+int               restconf_compress_body(restconf_stream_data *sd);
 restconf_native_handle *restconf_native_handle_get(clicon_handle h);
 int               restconf_connection(int s, void *arg);
 int               restconf_ssl_accept_client(clicon_handle h, int s, restconf_socket *rsock, restconf_conn  **rcp);
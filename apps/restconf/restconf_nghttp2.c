@@ -356,7 +356,11 @@ restconf_nghttp2_path(restconf_stream_data *sd)
 
 /*! data callback, just pass pointer to cbuf
  *
- * XXX handle several chunks with cbuf 
+ * If body is a file (sd_fd), read it directly into the nghttp2 buffer
+ * If body is compressed (sd_zstream), compress it directly into the nghttp2 buffer
+ * If body is streamed (sd_body_fn), produce next part when current is consumed.
+ * nghttp2 only calls this when the flow control window of the stream is open, so only one
+ * part at a time is kept per stream.
  */
 static ssize_t
 restconf_sd_read(nghttp2_session     *session,
@@ -371,7 +375,36 @@ restconf_sd_read(nghttp2_session     *session,
     cbuf                 *cb;
     size_t                len = 0;
     size_t                remain;
-
+    ssize_t               n;
+    int                   eof;
+
+    if (sd->sd_fd != -1){ /* Body as file, see restconf_reply_send_file */
+        remain = sd->sd_body_len - sd->sd_body_offset;
+        len = remain <= length ? remain : length;
+        if ((n = pread(sd->sd_fd, buf, len, sd->sd_body_offset)) < 0){
+            clicon_err(OE_UNIX, errno, "pread");
+            return NGHTTP2_ERR_TEMPORAL_CALLBACK_FAILURE;
+        }
+        if (n == 0) /* File truncated after content-length was sent */
+            return NGHTTP2_ERR_TEMPORAL_CALLBACK_FAILURE;
+        sd->sd_body_offset += n;
+        if (sd->sd_body_offset == sd->sd_body_len){
+            *data_flags |= NGHTTP2_DATA_FLAG_EOF;
+            close(sd->sd_fd);
+            sd->sd_fd = -1;
+        }
+        clixon_debug(CLIXON_DBG_DEFAULT, "%s file retval:%zd", __FUNCTION__, n);
+        return n;
+    }
+    if (sd->sd_zstream != NULL){ /* Compressed body, see restconf_compress_select */
+        eof = 0;
+        if ((n = restconf_compress_read(sd, buf, length, &eof)) < 0)
+            return NGHTTP2_ERR_TEMPORAL_CALLBACK_FAILURE;
+        if (eof)
+            *data_flags |= NGHTTP2_DATA_FLAG_EOF;
+        clixon_debug(CLIXON_DBG_DEFAULT, "%s compressed retval:%zd", __FUNCTION__, n);
+        return n;
+    }
     if ((cb = sd->sd_body) == NULL){ /* shouldnt happen */
         *data_flags |= NGHTTP2_DATA_FLAG_EOF;
         return 0;
@@ -388,7 +421,11 @@ restconf_sd_read(nghttp2_session     *session,
     *data_flags |= NGHTTP2_DATA_FLAG_EOF;
     return len;
 #endif
-    assert(cbuf_len(cb) > sd->sd_body_offset);
+    while (sd->sd_body_fn != NULL && sd->sd_body_offset == cbuf_len(cb)){
+        if (restconf_stream_body_next(sd) < 0)
+            return NGHTTP2_ERR_TEMPORAL_CALLBACK_FAILURE;
+    }
+    assert(cbuf_len(cb) >= sd->sd_body_offset);
     remain = cbuf_len(cb) - sd->sd_body_offset;
     clixon_debug(CLIXON_DBG_DEFAULT, "%s length:%zu totlen:%zu, offset:%zu remain:%zu",
                  __FUNCTION__,
@@ -399,7 +436,8 @@ restconf_sd_read(nghttp2_session     *session,
 
     if (remain <= length){
         len = remain;
-        *data_flags |= NGHTTP2_DATA_FLAG_EOF;
+        if (sd->sd_body_fn == NULL)
+            *data_flags |= NGHTTP2_DATA_FLAG_EOF;
     }
     else{
         len = length;
@@ -492,6 +530,9 @@ http2_exec(restconf_conn        *rc,
     else{
         sd->sd_code = 404;    /* not found */
     }
+    /* Needs Accept-Encoding request header */
+    if (restconf_compress_select(rc->rc_h, sd) < 0)
+        goto done;
     if (restconf_param_del_all(rc->rc_h) < 0) // XXX
         goto done;
 
@@ -501,8 +542,10 @@ http2_exec(restconf_conn        *rc,
      * server MUST NOT send a Content-Length header field in any 2xx
      * (Successful) response to a CONNECT request (Section 4.3.6 of
      * [RFC7231]).
+     * A compressed or streamed body is sent in parts and its length is not known in advance
      */
-    if (sd->sd_code != 204 && sd->sd_code > 199 && sd->sd_body_len)
+    if (sd->sd_code != 204 && sd->sd_code > 199 && sd->sd_body_len &&
+        sd->sd_zstream == NULL && sd->sd_body_fn == NULL)
         if (restconf_reply_header(sd, "Content-Length", "%zu", sd->sd_body_len) < 0)
             goto done;
     if (sd->sd_code){
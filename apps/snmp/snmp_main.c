@@ -341,7 +341,6 @@ main(int    argc,
     int            logdst = CLICON_LOG_STDERR;
     struct passwd *pw;
     yang_stmt     *yspec = NULL;
-    char          *str;
     uint32_t       id;
     cvec          *nsctx_global = NULL; /* Global namespace context */
     size_t         cligen_buflen;
@@ -497,23 +496,9 @@ main(int    argc,
         goto done;
     clicon_dbspec_yang_set(h, yspec);
 
-    /* Load Yang modules
-     * 1. Load a yang module as a specific absolute filename */
-    if ((str = clicon_yang_main_file(h)) != NULL){
-        if (yang_spec_parse_file(h, str, yspec) < 0)
-            goto done;
-    }
-    /* 2. Load a (single) main module */
-    if ((str = clicon_yang_module_main(h)) != NULL){
-        if (yang_spec_parse_module(h, str, clicon_yang_module_revision(h),
-                                   yspec) < 0)
-            goto done;
-    }
-    /* 3. Load all modules in a directory */
-    if ((str = clicon_yang_main_dir(h)) != NULL){
-        if (yang_spec_load_dir(h, str, yspec) < 0)
-            goto done;
-    }
+    /* Load main Yang modules, from cache if CLICON_YANG_CACHE_DIR is set */
+    if (yang_spec_load_main(h, yspec) < 0)
+        goto done;
     /* Load clixon lib yang module */
     if (yang_spec_parse_module(h, "clixon-lib", NULL, yspec) < 0)
         goto done;
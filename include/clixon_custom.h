@@ -63,9 +63,11 @@
 
 /*! Optimize special list key searches in XPath finds
  *
- * Identify xpaths that search for exactly a list key, eg: "y[k='3']" and then call
- * binary search. This only works if "y" has proper yang binding and is sorted by system
- * Dont optimize on "hierarchical" lists such as: a/y[k='3'], where a is another list.
+ * Identify xpaths that search for list keys, eg: "y[k='3']", leading keys, explicit
+ * indexes or leaf-list values "c[.='3']" and then call binary search. 
+ * This only works if "y" has proper yang binding. Lists within lists are included, and
+ * state data if STATE_ORDERED_BY_SYSTEM. Leading keys require lists sorted by system
+ * @see xpath_optimize_stats_get
  */
 #define XPATH_LIST_OPTIMIZE
 
@@ -78,6 +80,25 @@
  */
 #define XML_EXPLICIT_INDEX
 
+/*! Store children of XML nodes with many children in chunks instead of one flat vector
+ *
+ * Above a threshold (eg a large list), a flat vector is converted to a sequence of chunks
+ * with position offsets on the next insert that is not an append, so that inserting or
+ * removing a child moves at most one chunk instead of all following children.
+ * Access by position (xml_child_i), iteration (xml_child_each) and sorting remain,
+ * xml_childvec_get() converts back to a flat vector.
+ * See test/test_xml_chunk.sh
+ */
+#define XML_CHILDVEC_CHUNKED
+
+/*! Hashed index of children of YANG nodes with many children
+ *
+ * Built for the whole YANG spec after parsing, see yang_index_build(), and used by
+ * yang_find() and yang_find_datanode() instead of a linear search. Choice/case and
+ * input/output are flattened in the data node index.
+ */
+#define YANG_CHILD_INDEX
+
 /*! Let state data be ordered-by system
  *
  * RFC 7950 is cryptic about this
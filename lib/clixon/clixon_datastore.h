@@ -53,6 +53,13 @@ int xmldb_get(clicon_handle h, const char *db, cvec *nsc, char *xpath, cxobj **x
 int xmldb_get0(clicon_handle h, const char *db, yang_bind yb,
                cvec *nsc, const char *xpath, int copy, withdefaults_type wdef,
                cxobj **xtop, modstate_diff_t *msd, cxobj **xerr);
+int xmldb_get_list_range(clicon_handle h, const char *db, cvec *nsc, const char *xpath,
+                         yang_stmt *ylist, withdefaults_type wdef, uint32_t offset, uint32_t limit,
+                         const char *cursor, cxobj **xtop, uint32_t *remaining, char **next);
+int xmldb_get_list_query(clicon_handle h, const char *db, cvec *nsc, const char *xpath,
+                         yang_stmt *ylist, withdefaults_type wdef, const char *where, cvec *wnsc,
+                         const char *sortby, int backwards, uint32_t offset, uint32_t limit,
+                         cxobj **xtop, uint32_t *remaining);
 int xmldb_get0_clear(clicon_handle h, cxobj *x);
 int xmldb_get0_free(clicon_handle h, cxobj **xp);
 int xmldb_put(clicon_handle h, const char *db, enum operation_type op, cxobj *xt, char *username, cbuf *cbret); /* in clixon_datastore_write.[ch] */
@@ -74,6 +81,8 @@ cxobj *xmldb_cache_get(clicon_handle h, const char *db);
 int xmldb_modified_get(clicon_handle h, const char *db);
 int xmldb_modified_set(clicon_handle h, const char *db, int value);
 int xmldb_empty_get(clicon_handle h, const char *db);
+uint32_t xmldb_generation_get(clicon_handle h);
+int xmldb_generation_inc(clicon_handle h);
 int xmldb_dump(clicon_handle h, FILE *f, cxobj *xt);
 int xmldb_print(clicon_handle h, FILE *f);
 int xmldb_rename(clicon_handle h, const char *db, const char *newdb, const char *suffix);
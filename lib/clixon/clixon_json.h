@@ -40,15 +40,25 @@
 #ifndef _CLIXON_JSON_H
 #define _CLIXON_JSON_H
 
+/*
+ * Types
+ */
+typedef struct json_stream json_stream; /* Incremental XML to JSON, see clixon_json_stream_new */
+
 /*
  * Prototypes
  */
 int json2xml_decode(cxobj *x, cxobj **xerr);
 int clixon_json2cbuf(cbuf *cb, cxobj *x, int pretty, int skiptop, int autocliext);
 int xml2json_cbuf_vec(cbuf *cb, cxobj **vec, size_t veclen, int pretty, int skiptop);
+json_stream *clixon_json_stream_new(cxobj *x, int pretty);
+json_stream *clixon_json_stream_vec_new(cxobj **vec, size_t veclen, int pretty);
+int clixon_json_stream_read(json_stream *js, cbuf *cb, size_t len);
+int clixon_json_stream_free(json_stream *js);
 int clixon_json2file(FILE *f, cxobj *x, int pretty, clicon_output_cb *fn, int skiptop, int autocliext);
 int json_print(FILE *f, cxobj *x);
 int xml2json_vec(FILE *f, cxobj **vec, size_t veclen, int pretty, clicon_output_cb *fn, int skiptop);
+int clixon_json_parse_fast_set(int val);
 int clixon_json_parse_string(char *str, int rfc7951, yang_bind yb, yang_stmt *yspec, cxobj **xt, cxobj **xret);
 int clixon_json_parse_file(FILE *fp, int rfc7951, yang_bind yb, yang_stmt *yspec, cxobj **xt, cxobj **xret);
 
@@ -59,7 +59,8 @@ int clicon_rpc_get(clicon_handle h, char *xpath, cvec *nsc, netconf_content cont
 int clicon_rpc_get_pageable_list(clicon_handle h, char *datastore, char *xpath,
                                  cvec *nsc, netconf_content content, int32_t depth, char *defaults,
                                  uint32_t offset, uint32_t limit,
-                                 char *direction, char *sort, char *where,
+                                 char *direction, char *sort, char *where, uint32_t sublimit,
+                                 char *cursor,
                                  cxobj **xt);
 int clicon_rpc_close_session(clicon_handle h);
 int clicon_rpc_kill_session(clicon_handle h, uint32_t session_id);
@@ -67,6 +68,7 @@ int clicon_rpc_validate(clicon_handle h, char *db);
 int clicon_rpc_commit(clicon_handle h, int confirmed, int cancel, uint32_t timeout, char *persist, char *persist_id);
 int clicon_rpc_discard_changes(clicon_handle h);
 int clicon_rpc_create_subscription(clicon_handle h, char *stream, char *filter, int *s);
+int clicon_rpc_datastore_generation(clicon_handle h, uint32_t *gen);
 int clicon_rpc_debug(clicon_handle h, int level);
 int clicon_rpc_restconf_debug(clicon_handle h, int level);
 int clicon_hello_req(clicon_handle h, char *transport, char *source_host, uint32_t *id);
@@ -72,6 +72,9 @@ struct stream_replay{
     cxobj         *r_xml; /* event in xml form */
 };
 
+/* On-disk replay log, internal, see CLICON_STREAM_REPLAY_DIR */
+struct stream_replay_log;
+
 /* See RFC8040 9.3, stream list, no replay support for now
  */
 struct event_stream{
@@ -81,8 +84,8 @@ struct event_stream{
     struct stream_subscription *es_subscription;
     int                  es_replay_enabled; /* set if replay is enables */
     struct timeval       es_retention; /* replay retention - how much to save */
-    struct stream_replay *es_replay;
-
+    struct stream_replay *es_replay; /* In-memory replay buffer */
+    struct stream_replay_log *es_replay_log; /* On-disk replay log, if set es_replay is not used */
 };
 typedef struct event_stream event_stream_t;
 
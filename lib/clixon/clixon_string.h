@@ -96,6 +96,9 @@ int    uri_str2cvec(char *string, char delim1, char delim2, int decode, cvec **c
 int    uri_percent_encode(char **encp, const char *fmt, ...) __attribute__ ((format (printf, 2, 3)));
 int    xml_chardata_encode(char **escp, const char *fmt, ... ) __attribute__ ((format (printf, 2, 3)));
 int    xml_chardata_cbuf_append(cbuf *cb, char *str);
+size_t xml_chardata_span(const char *str);
+size_t json_str_span(const char *str);
+int    json_str_escape_cbuf_append(cbuf *cb, char *str);
 int    xml_chardata_decode(char **escp, const char *fmt,...);
 int    uri_percent_decode(char *enc, char **str);
 
@@ -202,6 +202,10 @@ enum format_enum{
 #define XML_FLAG_DEFAULT   0x40 /* Added when a value is set as default @see xml_default */
 #define XML_FLAG_TOP       0x80 /* Top datastore symbol */
 #define XML_FLAG_BODYKEY  0x100 /* Text parsing key to be translated from body to key */
+#define XML_FLAG_BULK     0x200 /* Bulk merge: on parent, children are appended unsorted,
+                                 * on child, appended but not yet merged @see xml_sort_merge */
+#define XML_FLAG_CACHEDEFAULT 0x400 /* Default added to datastore cache during one read,
+                                     * @see xmldb_defaults_scoped */
 
 /*
  * Prototypes
@@ -254,6 +258,7 @@ cxobj    *xml_child_each_attr(cxobj *xparent, cxobj *xprev);
 int       xml_child_insert_pos(cxobj *x, cxobj *xc, int i);
 int       xml_childvec_set(cxobj *x, int len);
 cxobj   **xml_childvec_get(cxobj *x);
+int       xml_childvec_sort(cxobj *x, int (*cmp)(const void *, const void *));
 int       clixon_child_xvec_append(cxobj *x, clixon_xvec *xv);
 cxobj    *xml_new(char *name, cxobj *xn_parent, enum cxobj_type type);
 cxobj    *xml_new_body(char *name, cxobj *parent, char *val);
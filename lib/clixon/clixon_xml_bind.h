@@ -49,6 +49,8 @@ int xml_bind_yang_rpc(clicon_handle h, cxobj *xrpc, yang_stmt *yspec, cxobj **xe
 int xml_bind_yang_rpc_reply(clicon_handle h, cxobj *xrpc, char *name, yang_stmt *yspec, cxobj **xerr);
 int xml_bind_yang0(clicon_handle h, cxobj *xt, yang_bind yb, yang_stmt *yspec, cxobj **xerr);
 int xml_bind_yang(clicon_handle h, cxobj *xt, yang_bind yb, yang_stmt *yspec, cxobj **xerr);
+int xml_bind_yang_start(cxobj *xt, yang_bind yb, yang_stmt *yspec, cxobj *xsibling, cxobj **xerr);
+int xml_bind_yang_end(cxobj *xt, yang_bind yb);
 int xml_bind_special(cxobj *xd, yang_stmt *yspec, char *schema_nodeid);
 
 #endif  /* _CLIXON_XML_BIND_H_ */
@@ -34,14 +34,15 @@
   ***** END LICENSE BLOCK *****
 
  *
- *  netconf match & selection: get and edit operations
- *****************************************************************************/
-#ifndef _NETCONF_FILTER_H_
-#define _NETCONF_FILTER_H_
+ * NETCONF subtree filtering, RFC 6241 Section 6
+ */
+#ifndef _CLIXON_XML_FILTER_H_
+#define _CLIXON_XML_FILTER_H_
 
 /*
  * Prototypes
  */
 int xml_filter(cxobj *xf, cxobj *xn);
+int xml_filter2xpath(cxobj *xfilter, cbuf *cb, cvec **nscp);
 
-#endif  /* _NETCONF_FILTER_H_ */
+#endif  /* _CLIXON_XML_FILTER_H_ */
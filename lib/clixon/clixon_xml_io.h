@@ -40,6 +40,11 @@
 #ifndef _CLIXON_XML_IO_H_
 #define _CLIXON_XML_IO_H_
 
+/*
+ * Types
+ */
+typedef struct xml_stream xml_stream; /* Incremental XML printing, see clixon_xml_stream_new */
+
 /*
  * Prototypes
  */
@@ -47,7 +52,11 @@ int   clixon_xml2file(FILE *f, cxobj *xn, int level, int pretty, char *prefix, c
 int   xml_print(FILE *f, cxobj *xn);
 int   xml_dump(FILE  *f, cxobj *x);
 int   clixon_xml2cbuf(cbuf *cb, cxobj *x, int level, int prettyprint, char *prefix, int32_t depth, int skiptop);
+xml_stream *clixon_xml_stream_new(cxobj **vec, size_t veclen, int pretty);
+int   clixon_xml_stream_read(xml_stream *xs, cbuf *cb, size_t len);
+int   clixon_xml_stream_free(xml_stream *xs);
 int   xmltree2cbuf(cbuf *cb, cxobj *x, int level);
+int   clixon_xml_parse_fast_set(int val);
 int   clixon_xml_parse_file(FILE *f, yang_bind yb, yang_stmt *yspec, cxobj **xt, cxobj **xerr);
 int   clixon_xml_parse_string(const char *str, yang_bind yb, yang_stmt *yspec, cxobj **xt, cxobj **xerr);
 int   clixon_xml_parse_va(yang_bind yb, yang_stmt *yspec, cxobj **xt, cxobj **xerr,
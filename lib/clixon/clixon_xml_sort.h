@@ -43,6 +43,7 @@
  */
 int xml_cmp(cxobj *x1, cxobj *x2, int same, int skip1, char *expl);
 int xml_sort(cxobj *x0);
+int xml_sort_merge(cxobj *xp);
 int xml_sort_recurse(cxobj *xn);
 int xml_insert(cxobj *xp, cxobj *xc, enum insert_type ins, char *key_val, cvec *nsckey);
 int xml_sort_verify(cxobj *x, void *arg);
@@ -54,5 +55,7 @@ int match_base_child(cxobj *x0, cxobj *x1c, yang_stmt *yc, cxobj **x0cp);
 int clixon_xml_find_index(cxobj *xp, yang_stmt *yp, char *ns, char *name,
                           cvec *cvk, clixon_xvec *xvec);
 int clixon_xml_find_pos(cxobj *xp, yang_stmt *yc, uint32_t pos, clixon_xvec *xvec);
+int clixon_xml_find_range(cxobj *xp, yang_stmt *yc, int *lowp, int *upperp);
+int clixon_xml_sort_by(cxobj **xvec, size_t xlen, const char *nodeid);
 
 #endif /* _CLIXON_XML_SORT_H */
@@ -38,8 +38,27 @@
 #ifndef _CLIXON_XPATH_OPTIMIZE_H
 #define _CLIXON_XPATH_OPTIMIZE_H
 
+/*
+ * Types
+ */
+/*! XPath index planner statistics, see xpath_optimize_stats_get
+ */
+typedef struct {
+    uint64_t xo_keys;     /* List searches with all keys */
+    uint64_t xo_prefix;   /* List searches with leading keys */
+    uint64_t xo_index;    /* List searches with explicit index variable */
+    uint64_t xo_leaflist; /* Leaf-list searches with value */
+    uint64_t xo_nested;   /* Searches in lists within lists */
+    uint64_t xo_state;    /* Searches in state data */
+    uint64_t xo_scan;     /* List predicates where no search was possible */
+} xpath_optimize_stats;
+
+/*
+ * Prototypes
+ */
 
 int  xpath_list_optimize_stats(int *hits);
+int  xpath_optimize_stats_get(xpath_optimize_stats *xos, int reset);
 int  xpath_list_optimize_set(int enable);
 void xpath_optimize_exit(void);
 int  xpath_optimize_check(xpath_tree *xs, cxobj *xv, cxobj ***xvec0, int *xlen0);
@@ -270,6 +270,10 @@ int        ys_module_by_xml(yang_stmt *ysp, struct xml *xt, yang_stmt **ymodp);
 yang_stmt *ys_module(yang_stmt *ys);
 int        ys_real_module(yang_stmt *ys, yang_stmt **ymod);
 yang_stmt *ys_spec(yang_stmt *ys);
+#ifdef YANG_CHILD_INDEX
+int        yang_index_build(yang_stmt *yn);
+int        yang_index_invalidate(yang_stmt *ys);
+#endif
 yang_stmt *yang_find(yang_stmt *yn, int keyword, const char *argument);
 int        yang_match(yang_stmt *yn, int keyword, char *argument);
 yang_stmt *yang_find_datanode(yang_stmt *yn, char *argument);
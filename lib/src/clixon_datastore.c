@@ -131,6 +131,14 @@ xmldb_db2file(clicon_handle  h,
 int
 xmldb_connect(clicon_handle h)
 {
+    struct timeval tv;
+    uint32_t       seed;
+
+    /* Seed datastore generation so that it does not repeat values after a restart */
+    gettimeofday(&tv, NULL);
+    seed = ((uint32_t)tv.tv_sec * 1000000 + (uint32_t)tv.tv_usec) ^ ((uint32_t)getpid() << 16);
+    if (clicon_data_int_set(h, "xmldb_generation", (int)(seed & 0x7fffffff)) < 0)
+        return -1;
     return 0;
 }
 
@@ -234,6 +242,7 @@ xmldb_copy(clicon_handle h,
         goto done;
     if (clicon_file_copy(fromfile, tofile) < 0)
         goto done;
+    xmldb_generation_inc(h);
     retval = 0;
  done:
     if (fromfile)
@@ -451,6 +460,7 @@ xmldb_delete(clicon_handle h,
             clicon_err(OE_DB, errno, "truncate %s", filename);
             goto done;
         }
+    xmldb_generation_inc(h);
     retval = 0;
  done:
     if (filename)
@@ -488,6 +498,7 @@ xmldb_create(clicon_handle h,
         clicon_err(OE_UNIX, errno, "open(%s)", filename);
         goto done;
     }
+    xmldb_generation_inc(h);
    retval = 0;
  done:
     if (filename)
@@ -604,6 +615,42 @@ xmldb_modified_set(clicon_handle h,
     return 0;
 }
 
+/*! Get datastore generation
+ *
+ * The generation is a counter incremented on every change of any datastore. It does not
+ * say which datastore changed, only that something did. It is not persistent but seeded
+ * from the time and pid in xmldb_connect, so that a restarted backend does not repeat
+ * the values of a previous instance.
+ * Clients may use it to check whether cached configuration is still valid, see
+ * clicon_rpc_datastore_generation
+ * @param[in]  h     Clixon handle
+ * @retval     gen   Current generation
+ */
+uint32_t
+xmldb_generation_get(clicon_handle h)
+{
+    int gen;
+
+    if ((gen = clicon_data_int_get(h, "xmldb_generation")) < 0)
+        gen = 0;
+    return (uint32_t)gen;
+}
+
+/*! Increment datastore generation, called when a datastore is changed
+ *
+ * @param[in]  h     Clixon handle
+ * @retval     0     OK
+ * @see xmldb_generation_get
+ */
+int
+xmldb_generation_inc(clicon_handle h)
+{
+    uint32_t gen;
+
+    gen = (xmldb_generation_get(h) + 1) & 0x7fffffff;
+    return clicon_data_int_set(h, "xmldb_generation", (int)gen);
+}
+
 /* Print the datastore meta-info to file
  */
 int
@@ -670,6 +717,7 @@ xmldb_rename(clicon_handle h,
         clicon_err(OE_UNIX, errno, "rename: %s", strerror(errno));
         goto done;
     };
+    xmldb_generation_inc(h);
     retval = 0;
  done:
     if (cb)
@@ -41,6 +41,8 @@
 #include <stdlib.h>
 #include <unistd.h>
 #include <errno.h>
+#include <ctype.h>
+#include <stdarg.h>
 #include <string.h>
 #include <limits.h>
 #include <stdint.h>
@@ -65,6 +67,7 @@
 #include "clixon_file.h"
 #include "clixon_yang.h"
 #include "clixon_xml.h"
+#include "clixon_xml_vec.h"
 #include "clixon_xml_sort.h"
 #include "clixon_xml_bind.h"
 #include "clixon_options.h"
@@ -661,6 +664,451 @@ xmldb_readfile(clicon_handle    h,
     goto done;
 }
 
+/*! Descend a chain of xpath tree nodes that each have only a first child
+ *
+ * In a parsed xpath, an expression without operators is a chain of nodes with one child
+ * each, eg XP_EXP, XP_AND, XP_RELEX, ... down to the location path.
+ * @param[in]  xt   XPath tree
+ * @param[in]  ...  Expected node types, terminated by -1
+ * @retval     xt   Child of the last node of the chain
+ * @retval     NULL Tree does not have this shape
+ */
+static xpath_tree *
+xpath_simple_chain(xpath_tree *xt,
+                   ...)
+{
+    va_list ap;
+    int     type;
+
+    va_start(ap, xt);
+    while (xt != NULL && (type = va_arg(ap, int)) != -1){
+        if (xt->xs_type != type || xt->xs_c1 != NULL)
+            xt = NULL;
+        else
+            xt = xt->xs_c0;
+    }
+    va_end(ap);
+    return xt;
+}
+
+/*! Get the child compared in a simple predicate expression: [name op literal]
+ *
+ * The predicate only compares a child of the context node with a string or number
+ * literal, eg [k='v'], [ex:a=7] or [a<10]. op is one of = != < <= > >=
+ * @param[in]  xe   XPath tree of the predicate expression
+ * @retval     xn   Name test (XP_NODE) of the child
+ * @retval     NULL Not a simple predicate
+ */
+static xpath_tree *
+xpath_simple_predicate(xpath_tree *xe)
+{
+    xpath_tree *xr;
+    xpath_tree *xs;
+    xpath_tree *xv;
+
+    if ((xr = xpath_simple_chain(xe, XP_EXP, XP_AND, -1)) == NULL ||
+        xr->xs_type != XP_RELEX || xr->xs_c1 == NULL)
+        return NULL;
+    switch (xr->xs_int){
+    case XO_EQ:
+    case XO_NE:
+    case XO_GE:
+    case XO_LE:
+    case XO_LT:
+    case XO_GT:
+        break;
+    default:
+        return NULL;
+    }
+    /* Left: child step without predicates */
+    if ((xs = xpath_simple_chain(xr->xs_c0, XP_RELEX, XP_ADD, XP_UNION, XP_PATHEXPR,
+                                 XP_LOCPATH, XP_RELLOCPATH, -1)) == NULL ||
+        xs->xs_type != XP_STEP || xs->xs_int != A_CHILD ||
+        xs->xs_c1 == NULL || xs->xs_c1->xs_c1 != NULL ||
+        xs->xs_c0 == NULL || xs->xs_c0->xs_type != XP_NODE ||
+        xs->xs_c0->xs_s1 == NULL || strcmp(xs->xs_c0->xs_s1, "*") == 0)
+        return NULL;
+    /* Right: literal. Strings with quotes are not printed back verbatim */
+    if ((xv = xpath_simple_chain(xr->xs_c1, XP_ADD, XP_UNION, XP_PATHEXPR,
+                                 XP_FILTEREXPR, -1)) == NULL)
+        return NULL;
+    if (xv->xs_type == XP_PRIME_STR){
+        if (xv->xs_s0 && strpbrk(xv->xs_s0, "'\"") != NULL)
+            return NULL;
+    }
+    else if (xv->xs_type != XP_PRIME_NR)
+        return NULL;
+    return xs->xs_c0;
+}
+
+/*! Check if an xpath step is a child step on a name with only simple predicates
+ *
+ * @param[in]  xs   XPath tree of step
+ * @retval     1    Simple step
+ * @retval     0    Not a simple step, eg wildcard, other axis, function or predicate
+ * @see xpath_simple_predicate
+ */
+static int
+xpath_simple_step(xpath_tree *xs)
+{
+    xpath_tree *xp;
+
+    if (xs == NULL || xs->xs_type != XP_STEP || xs->xs_int != A_CHILD ||
+        xs->xs_c0 == NULL || xs->xs_c0->xs_type != XP_NODE ||
+        xs->xs_c0->xs_s1 == NULL || strcmp(xs->xs_c0->xs_s1, "*") == 0)
+        return 0;
+    for (xp = xs->xs_c1; xp != NULL && xp->xs_c1 != NULL; xp = xp->xs_c0)
+        if (xpath_simple_predicate(xp->xs_c1) == NULL)
+            return 0;
+    return 1;
+}
+
+/*! Split a simple absolute location path into its steps
+ *
+ * A simple path only consists of child steps on names with optional predicates comparing
+ * a child with a literal, such as /a/b[k='v']/c. For such a path, all matching nodes are on
+ * the same level, the nodes matching each prefix of the path are ancestors of the nodes
+ * matching the next step, and a predicate only depends on the children of its step.
+ * The decision is made on the parsed xpath, as in xpath_optimize_check.
+ * @param[in]  xpath  XPath string
+ * @param[out] xtopp  Parsed xpath. Free with xpath_tree_free()
+ * @param[out] stepsp Vector of steps (XP_STEP) in xtop, first step first. Free with free()
+ * @param[out] nrp    Number of steps
+ * @retval     1      Simple path, xtopp, stepsp and nrp set
+ * @retval     0      Not a simple path
+ * @retval    -1      Error
+ * @see xpath_simple_prefix
+ */
+static int
+xpath_simple_steps(const char   *xpath,
+                   xpath_tree  **xtopp,
+                   xpath_tree ***stepsp,
+                   int          *nrp)
+{
+    int          retval = -1;
+    xpath_tree  *xtop = NULL;
+    xpath_tree  *xa;
+    xpath_tree  *xr;
+    xpath_tree **steps = NULL;
+    int          nr = 0;
+    int          i;
+
+    if (xpath == NULL || xpath[0] != '/')
+        goto fail;
+    if (xpath_parse(xpath, &xtop) < 0)
+        goto done;
+    if ((xa = xpath_simple_chain(xtop, XP_EXP, XP_AND, XP_RELEX, XP_ADD, XP_UNION,
+                                 XP_PATHEXPR, XP_LOCPATH, -1)) == NULL ||
+        xa->xs_type != XP_ABSPATH || xa->xs_int != A_ROOT)
+        goto fail;
+    /* Count steps: rellocpath is left-recursive, the last step is at the top */
+    for (xr = xa->xs_c0; xr != NULL; xr = xr->xs_c1 ? xr->xs_c0 : NULL){
+        if (xr->xs_type != XP_RELLOCPATH || xr->xs_int != A_NAN)
+            goto fail;
+        nr++;
+    }
+    if (nr == 0)
+        goto fail;
+    if ((steps = calloc(nr, sizeof(*steps))) == NULL){
+        clicon_err(OE_UNIX, errno, "calloc");
+        goto done;
+    }
+    i = nr;
+    for (xr = xa->xs_c0; xr != NULL; xr = xr->xs_c1 ? xr->xs_c0 : NULL){
+        steps[--i] = xr->xs_c1 ? xr->xs_c1 : xr->xs_c0;
+        if (!xpath_simple_step(steps[i]))
+            goto fail;
+    }
+    *xtopp = xtop;
+    xtop = NULL;
+    *stepsp = steps;
+    steps = NULL;
+    *nrp = nr;
+    retval = 1;
+ done:
+    if (xtop)
+        xpath_tree_free(xtop);
+    if (steps)
+        free(steps);
+    return retval;
+ fail:
+    retval = 0;
+    goto done;
+}
+
+/*! Print the prefix of a simple xpath up to and including a step
+ *
+ * @param[in]  steps  Steps of simple xpath, see xpath_simple_steps
+ * @param[in]  i      Last step of prefix
+ * @param[in]  preds  If set, include the predicates of the last step
+ * @param[out] cb     XPath prefix, eg /a/b[k="v"]/c
+ * @retval     0      OK
+ * @retval    -1      Error
+ */
+static int
+xpath_simple_prefix(xpath_tree **steps,
+                    int          i,
+                    int          preds,
+                    cbuf        *cb)
+{
+    int k;
+
+    cbuf_reset(cb);
+    for (k=0; k<=i; k++){
+        cprintf(cb, "/");
+        if (xpath_tree2cbuf((k < i || preds) ? steps[k] : steps[k]->xs_c0, cb) < 0)
+            return -1;
+    }
+    return 0;
+}
+
+/*! Check if a simple xpath step has predicates
+ *
+ * @param[in]  xs   Step of simple xpath, see xpath_simple_steps
+ */
+static int
+xpath_simple_haspreds(xpath_tree *xs)
+{
+    return xs->xs_c1 != NULL && xs->xs_c1->xs_c1 != NULL;
+}
+
+/*! Check if all predicates of a simple xpath step only compare keys of a list
+ *
+ * Keys cannot have defaults, so such a predicate does not need defaults to be evaluated.
+ * @param[in]  y      Yang of nodes matched by step
+ * @param[in]  xs     Step of simple xpath, see xpath_simple_steps
+ * @retval     1      All predicates compare list keys
+ * @retval     0      Not a list or a predicate compares a non-key
+ * @retval    -1      Error
+ * @see xpath_simple_predicate
+ */
+static int
+xpath_simple_keys(yang_stmt  *y,
+                  xpath_tree *xs)
+{
+    xpath_tree *xp;
+    xpath_tree *xn;
+    int         ret;
+
+    if (yang_keyword_get(y) != Y_LIST)
+        return 0;
+    for (xp = xs->xs_c1; xp != NULL && xp->xs_c1 != NULL; xp = xp->xs_c0){
+        if ((xn = xpath_simple_predicate(xp->xs_c1)) == NULL)
+            return 0;
+        if ((ret = yang_key_match(y, xn->xs_s1, NULL)) <= 0)
+            return ret;
+    }
+    return 1;
+}
+
+/*! Check if all top-level nodes of a cached datastore tree are bound to YANG
+ *
+ * Nodes are bound when read from file or when added by edit-config, so a cached tree
+ * only needs to be re-bound if it has unbound top-level nodes.
+ * @param[in]  x0t  Top of cached tree
+ * @retval     1    All top-level nodes are bound
+ * @retval     0    At least one top-level node is not bound
+ */
+static int
+xmldb_cache_bound(cxobj *x0t)
+{
+    cxobj *x = NULL;
+
+    while ((x = xml_child_each(x0t, x, CX_ELMNT)) != NULL)
+        if (xml_spec(x) == NULL)
+            return 0;
+    return 1;
+}
+
+/*! Add default values to the children of the nodes matching an xpath
+ *
+ * @param[in]  x0t    Top of cached tree
+ * @param[in]  nsc    XML namespace context for XPath
+ * @param[in]  xpath  Prefix of simple xpath, see xpath_simple_prefix
+ * @param[in]  xs     Next step whose predicates are checked, skip if only list keys, or NULL
+ * @param[out] xvc    Created nodes
+ * @retval     0      OK
+ * @retval    -1      Error
+ */
+static int
+xmldb_defaults_step(cxobj       *x0t,
+                    cvec        *nsc,
+                    const char  *xpath,
+                    xpath_tree  *xs,
+                    clixon_xvec *xvc)
+{
+    int        retval = -1;
+    cxobj    **xvec = NULL;
+    size_t     xlen;
+    cxobj     *x;
+    yang_stmt *y;
+    int        j;
+    int        len0;
+    int        ret;
+
+    if (xpath_vec(x0t, nsc, "%s", &xvec, &xlen, xpath) < 0)
+        goto done;
+    len0 = clixon_xvec_len(xvc);
+    for (j=0; j<xlen; j++){
+        x = xvec[j];
+        if ((y = xml_spec(x)) == NULL || !yang_config_ancestor(y))
+            continue;
+        if (xs){
+            /* All matching nodes have the same yang, so check the predicate once */
+            if ((ret = xpath_simple_keys(y, xs)) < 0)
+                goto done;
+            if (ret == 1)
+                break;
+            xs = NULL;
+        }
+        if (xml_default_node(x, 0, xvc) < 0)
+            goto done;
+    }
+    for (j=len0; j<clixon_xvec_len(xvc); j++)
+        xml_flag_set(clixon_xvec_i(xvc, j), XML_FLAG_CACHEDEFAULT);
+    retval = 0;
+ done:
+    if (xvec)
+        free(xvec);
+    return retval;
+}
+
+/*! Add default values to a cached tree along the prefixes of a simple xpath
+ *
+ * Instead of adding defaults to the whole tree, add them one level down from the nodes
+ * matching each strict prefix of the path, so that the next step may select default nodes.
+ * If a step has predicates on non-keys, also add them one level down from the nodes
+ * matching the step without predicates, so that the predicates see default children.
+ * The nodes matching the whole path are expanded recursively by the caller.
+ * Nodes created are appended to xvc and marked with XML_FLAG_CACHEDEFAULT.
+ * @param[in]  x0t    Top of cached tree
+ * @param[in]  nsc    XML namespace context for XPath
+ * @param[in]  steps  Steps of simple xpath, see xpath_simple_steps
+ * @param[in]  nr     Number of steps
+ * @param[out] xvc    Created nodes
+ * @retval     0      OK
+ * @retval    -1      Error
+ * @see xmldb_defaults_purge_scoped  Remove the defaults again
+ */
+static int
+xmldb_defaults_scoped(cxobj       *x0t,
+                      cvec        *nsc,
+                      xpath_tree **steps,
+                      int          nr,
+                      clixon_xvec *xvc)
+{
+    int   retval = -1;
+    cbuf *cb = NULL;
+    int   i;
+
+    if ((cb = cbuf_new()) == NULL){
+        clicon_err(OE_UNIX, errno, "cbuf_new");
+        goto done;
+    }
+    for (i=0; i<nr; i++){
+        if (!xpath_simple_haspreds(steps[i]) && i == nr-1)
+            break;
+        /* Step without predicates, ie the nodes the predicates are evaluated on */
+        if (xpath_simple_prefix(steps, i, 0, cb) < 0)
+            goto done;
+        if (xmldb_defaults_step(x0t, nsc, cbuf_get(cb),
+                                xpath_simple_haspreds(steps[i]) ? steps[i] : NULL, xvc) < 0)
+            goto done;
+    }
+    retval = 0;
+ done:
+    if (cb)
+        cbuf_free(cb);
+    return retval;
+}
+
+/*! Remove node and the empty non-presence containers above it
+ *
+ * @param[in]  x0t  Top of cached tree, never removed
+ * @param[in]  x    XML node to remove
+ * @retval     0    OK
+ * @retval    -1    Error
+ * @note Containers marked with XML_FLAG_MARK are not removed
+ */
+static int
+xmldb_purge_upwards(cxobj *x0t,
+                    cxobj *x)
+{
+    int        retval = -1;
+    cxobj     *xp;
+    yang_stmt *y;
+
+    xp = xml_parent(x);
+    if (xml_purge(x) < 0)
+        goto done;
+    while (xp != NULL && xp != x0t &&
+           !xml_flag(xp, XML_FLAG_MARK) &&
+           (y = xml_spec(xp)) != NULL &&
+           yang_keyword_get(y) == Y_CONTAINER &&
+           yang_find(y, Y_PRESENCE, NULL) == NULL &&
+           xml_child_nr_type(xp, CX_ELMNT) == 0){
+        x = xp;
+        xp = xml_parent(x);
+        if (xml_purge(x) < 0)
+            goto done;
+    }
+    retval = 0;
+ done:
+    return retval;
+}
+
+/*! Remove defaults added by xmldb_defaults_scoped and global defaults from a cached tree
+ *
+ * Only the result subtrees, their ancestors and the nodes created on the xpath prefixes
+ * are visited, the rest of the tree is assumed not to contain defaults.
+ * @param[in]  x0t   Top of cached tree
+ * @param[in]  xvec  Nodes matching the xpath
+ * @param[in]  xlen  Length of xvec
+ * @param[in]  xvc   Nodes created on the xpath prefixes
+ * @retval     0     OK
+ * @retval    -1     Error
+ * @see xml_defaults_nopresence  Corresponding full-tree function
+ */
+static int
+xmldb_defaults_purge_scoped(cxobj       *x0t,
+                            cxobj      **xvec,
+                            size_t       xlen,
+                            clixon_xvec *xvc)
+{
+    int    retval = -1;
+    cxobj *x;
+    cxobj *xp;
+    int    i;
+    int    ret;
+
+    /* Mark matches, except those in created nodes which are removed with them */
+    for (i=0; i<xlen; i++){
+        x = xvec[i];
+        for (xp = x; xp != x0t; xp = xml_parent(xp))
+            if (xml_flag(xp, XML_FLAG_CACHEDEFAULT))
+                break;
+        if (xp == x0t)
+            xml_flag_set(x, XML_FLAG_MARK);
+    }
+    /* Remove created nodes first, they may be children of matches */
+    for (i=0; i<clixon_xvec_len(xvc); i++)
+        if (xmldb_purge_upwards(x0t, clixon_xvec_i(xvc, i)) < 0)
+            goto done;
+    for (i=0; i<xlen; i++){
+        x = xvec[i];
+        if (!xml_flag(x, XML_FLAG_MARK))
+            continue;
+        xml_flag_reset(x, XML_FLAG_MARK);
+        if ((ret = xml_defaults_nopresence(x, 2)) < 0)
+            goto done;
+        if (ret == 1 && xmldb_purge_upwards(x0t, x) < 0)
+            goto done;
+    }
+    retval = 0;
+ done:
+    return retval;
+}
+
 /*! Get content of database using xpath. return a set of matching sub-trees
  *
  * The function returns a minimal tree that includes all sub-trees that match
@@ -863,6 +1311,12 @@ xmldb_get_cache(clicon_handle     h,
     cxobj     *x1t = NULL;
     db_elmnt   de0 = {0,};
     int        ret;
+    xpath_tree  *xptop = NULL;
+    xpath_tree **steps = NULL;
+    int        nr = 0;
+    int        scoped = 0;
+    clixon_xvec *xvc = NULL;
+    cxobj     *xp;
 
     if ((yspec = clicon_dbspec_yang(h)) == NULL){
         clicon_err(OE_YANG, ENOENT, "No yang spec");
@@ -888,7 +1342,9 @@ xmldb_get_cache(clicon_handle     h,
         x0t = de->de_xml;
 
     if (yb == YB_MODULE && !xml_spec(x0t)){
-        if ((ret = xml_bind_yang(h, x0t, YB_MODULE, yspec, xerr)) < 0)
+        if (xmldb_cache_bound(x0t))
+            ret = 1;
+        else if ((ret = xml_bind_yang(h, x0t, YB_MODULE, yspec, xerr)) < 0)
             goto done;
         if (ret == 0)
             ; /* XXX */
@@ -896,8 +1352,16 @@ xmldb_get_cache(clicon_handle     h,
             /* Add default global values (to make xpath below include defaults) */
             if (xml_global_defaults(h, x0t, nsc, xpath, yspec, 0) < 0)
                 goto done;
-            /* Add default recursive values */
-            if (xml_default_recurse(x0t, 0) < 0)
+            /* Add default values only along a simple xpath, otherwise in the whole tree */
+            if ((scoped = xpath_simple_steps(xpath, &xptop, &steps, &nr)) < 0)
+                goto done;
+            if (scoped){
+                if ((xvc = clixon_xvec_new()) == NULL)
+                    goto done;
+                if (xmldb_defaults_scoped(x0t, nsc, steps, nr, xvc) < 0)
+                    goto done;
+            }
+            else if (xml_default_recurse(x0t, 0) < 0)
                 goto done;
         }
     }
@@ -912,7 +1376,16 @@ xmldb_get_cache(clicon_handle     h,
      */
     if (xpath_vec(x0t, nsc, "%s", &xvec, &xlen, xpath?xpath:"/") < 0)
         goto done;
-
+    if (scoped){
+        /* Add default recursive values to result subtrees */
+        for (i=0; i<xlen; i++){
+            x0 = xvec[i];
+            if (xml_spec(x0) && !yang_config_ancestor(xml_spec(x0)))
+                continue;
+            if (xml_default_recurse(x0, 0) < 0)
+                goto done;
+        }
+    }
     /* Make new tree by copying top-of-tree from x0t to x1t */
     if ((x1t = xml_new(xml_name(x0t), NULL, CX_ELMNT)) == NULL)
         goto done;
@@ -941,13 +1414,23 @@ xmldb_get_cache(clicon_handle     h,
         }
         if (xml_copy_marked(x0t, x1t) < 0) /* config */
             goto done;
-        if (xml_apply(x0t, CX_ELMNT, (xml_applyfn_t*)xml_flag_reset, (void*)(XML_FLAG_MARK|XML_FLAG_CHANGE)) < 0)
-            goto done;
+        /* Reset only the flags set above, not the whole cache */
+        for (i=0; i<xlen; i++){
+            x0 = xvec[i];
+            xml_flag_reset(x0, XML_FLAG_MARK);
+            xp = x0;
+            while ((xp = xml_parent(xp)) != NULL && xml_flag(xp, XML_FLAG_CHANGE))
+                xml_flag_reset(xp, XML_FLAG_CHANGE);
+        }
         if (xml_apply(x1t, CX_ELMNT, (xml_applyfn_t*)xml_flag_reset, (void*)(XML_FLAG_MARK|XML_FLAG_CHANGE)) < 0)
             goto done;
     }
     /* Original tree: Remove global defaults and empty non-presence containers */
-    if (xml_defaults_nopresence(x0t, 2) < 0)
+    if (scoped){
+        if (xmldb_defaults_purge_scoped(x0t, xvec, xlen, xvc) < 0)
+            goto done;
+    }
+    else if (xml_defaults_nopresence(x0t, 2) < 0)
         goto done;
     switch (wdef){
     case WITHDEFAULTS_REPORT_ALL:
@@ -1005,6 +1488,12 @@ xmldb_get_cache(clicon_handle     h,
     clixon_debug(CLIXON_DBG_DETAIL, "%s retval:%d", __FUNCTION__, retval);
     if (xvec)
         free(xvec);
+    if (xptop)
+        xpath_tree_free(xptop);
+    if (steps)
+        free(steps);
+    if (xvc)
+        clixon_xvec_free(xvc);
     return retval;
  fail:
     retval = 0;
@@ -1289,6 +1778,845 @@ xmldb_get0(clicon_handle    h,
     return retval;
 }
 
+/*! Encode the keys of a list or leaf-list entry as an opaque pagination cursor
+ *
+ * The cursor is the percent-encoded key values of the entry separated by ','
+ * @param[in]  x       List or leaf-list entry
+ * @param[in]  ylist   Yang spec of x
+ * @param[out] cursor  Cursor string, free with free()
+ * @retval     0       OK
+ * @retval    -1       Error
+ * @see xmldb_cursor_decode
+ */
+static int
+xmldb_cursor_encode(cxobj     *x,
+                    yang_stmt *ylist,
+                    char     **cursor)
+{
+    int     retval = -1;
+    cbuf   *cb = NULL;
+    cg_var *cvi = NULL;
+    char   *body;
+    char   *enc = NULL;
+
+    if ((cb = cbuf_new()) == NULL){
+        clicon_err(OE_UNIX, errno, "cbuf_new");
+        goto done;
+    }
+    if (yang_keyword_get(ylist) == Y_LEAF_LIST){
+        if ((body = xml_body(x)) != NULL){
+            if (uri_percent_encode(&enc, "%s", body) < 0)
+                goto done;
+            cprintf(cb, "%s", enc);
+        }
+    }
+    else {
+        while ((cvi = cvec_each(yang_cvec_get(ylist), cvi)) != NULL) {
+            if (cvi != cvec_i(yang_cvec_get(ylist), 0))
+                cprintf(cb, ",");
+            if ((body = xml_find_body(x, cv_string_get(cvi))) == NULL)
+                continue;
+            if (enc){
+                free(enc);
+                enc = NULL;
+            }
+            if (uri_percent_encode(&enc, "%s", body) < 0)
+                goto done;
+            cprintf(cb, "%s", enc);
+        }
+    }
+    if ((*cursor = strdup(cbuf_get(cb))) == NULL){
+        clicon_err(OE_UNIX, errno, "strdup");
+        goto done;
+    }
+    retval = 0;
+ done:
+    if (enc)
+        free(enc);
+    if (cb)
+        cbuf_free(cb);
+    return retval;
+}
+
+/*! Decode a pagination cursor into a search object for xml_cmp
+ *
+ * @param[in]  ylist   Yang spec of list or leaf-list
+ * @param[in]  cursor  Cursor string, see xmldb_cursor_encode
+ * @param[out] xp      Search object with key values, free with xml_free()
+ * @retval     1       OK
+ * @retval     0       Invalid cursor
+ * @retval    -1       Error
+ */
+static int
+xmldb_cursor_decode(yang_stmt  *ylist,
+                    const char *cursor,
+                    cxobj     **xp)
+{
+    int        retval = -1;
+    cxobj     *x = NULL;
+    cxobj     *xk;
+    cxobj     *xb;
+    cvec      *cvk;
+    char     **vec = NULL;
+    int        nvec;
+    char      *str = NULL;
+    yang_stmt *yk;
+    int        i;
+
+    if ((vec = clicon_strsep((char*)cursor, ",", &nvec)) == NULL)
+        goto done;
+    if ((x = xml_new(yang_argument_get(ylist), NULL, CX_ELMNT)) == NULL)
+        goto done;
+    xml_spec_set(x, ylist);
+    if (yang_keyword_get(ylist) == Y_LEAF_LIST){
+        if (nvec != 1)
+            goto fail;
+        if (uri_percent_decode(vec[0], &str) < 0)
+            goto done;
+        if ((xb = xml_new("body", x, CX_BODY)) == NULL)
+            goto done;
+        if (xml_value_set(xb, str) < 0)
+            goto done;
+    }
+    else {
+        cvk = yang_cvec_get(ylist);
+        if (nvec != cvec_len(cvk))
+            goto fail;
+        for (i=0; i<nvec; i++){
+            if ((yk = yang_find(ylist, Y_LEAF, cv_string_get(cvec_i(cvk, i)))) == NULL)
+                goto fail;
+            if ((xk = xml_new(yang_argument_get(yk), x, CX_ELMNT)) == NULL)
+                goto done;
+            xml_spec_set(xk, yk);
+            if (str){
+                free(str);
+                str = NULL;
+            }
+            if (uri_percent_decode(vec[i], &str) < 0)
+                goto done;
+            if ((xb = xml_new("body", xk, CX_BODY)) == NULL)
+                goto done;
+            if (xml_value_set(xb, str) < 0)
+                goto done;
+        }
+    }
+    *xp = x;
+    x = NULL;
+    retval = 1;
+ done:
+    if (str)
+        free(str);
+    if (vec)
+        free(vec);
+    if (x)
+        xml_free(x);
+    return retval;
+ fail:
+    retval = 0;
+    goto done;
+}
+
+/*! Find the position after a cursor among list entries [low, upper) of xp
+ *
+ * For lists ordered by system, binary search finds the first entry after the cursor key,
+ * also if that entry has been removed. Lists ordered by user are searched linearly, and
+ * the cursor entry must exist.
+ * @param[in]  xp      Parent of list entries
+ * @param[in]  ylist   Yang spec of list or leaf-list
+ * @param[in]  cursor  Cursor string, see xmldb_cursor_encode
+ * @param[in]  low     Index of first entry
+ * @param[in]  upper   Index after last entry
+ * @param[out] posp    Index of first entry after cursor
+ * @retval     1       OK
+ * @retval     0       Invalid cursor
+ * @retval    -1       Error
+ */
+static int
+xmldb_cursor_pos(cxobj      *xp,
+                 yang_stmt  *ylist,
+                 const char *cursor,
+                 int         low,
+                 int         upper,
+                 int        *posp)
+{
+    int    retval = -1;
+    cxobj *x1 = NULL;
+    int    mid;
+    int    i;
+    int    ret;
+
+    if ((ret = xmldb_cursor_decode(ylist, cursor, &x1)) < 0)
+        goto done;
+    if (ret == 0)
+        goto fail;
+    if (yang_find(ylist, Y_ORDERED_BY, "user") != NULL){
+        for (i=low; i<upper; i++)
+            if (xml_cmp(x1, xml_child_i(xp, i), 0, 0, NULL) == 0)
+                break;
+        if (i == upper)
+            goto fail;
+        low = i + 1;
+    }
+    else {
+        while (low < upper){
+            mid = (low + upper) / 2;
+            if (xml_cmp(x1, xml_child_i(xp, mid), 0, 0, NULL) >= 0)
+                low = mid + 1;
+            else
+                upper = mid;
+        }
+    }
+    *posp = low;
+    retval = 1;
+ done:
+    if (x1)
+        xml_free(x1);
+    return retval;
+ fail:
+    retval = 0;
+    goto done;
+}
+
+/*! Find the parent of a config list or leaf-list in a cached datastore
+ *
+ * Common preconditions for reading list entries directly from the cache
+ * @param[in]  h      Clixon handle
+ * @param[in]  db     Name of datastore, eg "running"
+ * @param[in]  nsc    XML namespace context for XPath
+ * @param[in]  xpath  XPath to list or leaf-list
+ * @param[in]  ylist  Yang spec of list or leaf-list
+ * @param[in]  wdef   With-defaults parameter, only report-all and explicit
+ * @param[out] x0tp   Top of cached tree
+ * @param[out] x0pp   Parent of list entries, or NULL if it does not exist
+ * @retval     1      OK, list can be read from cache
+ * @retval     0      Not applicable, use xmldb_get0
+ * @retval    -1      Error
+ */
+static int
+xmldb_list_parent(clicon_handle     h,
+                  const char       *db,
+                  cvec             *nsc,
+                  const char       *xpath,
+                  yang_stmt        *ylist,
+                  withdefaults_type wdef,
+                  cxobj           **x0tp,
+                  cxobj           **x0pp)
+{
+    int        retval = -1;
+    db_elmnt  *de;
+    cxobj     *x0t;
+    cxobj      **xvec = NULL;
+    size_t       xlen;
+    xpath_tree  *xptop = NULL;
+    xpath_tree **steps = NULL;
+    int          nr;
+    cbuf        *cb = NULL;
+    cxobj       *xp;
+    int          i;
+    int          ret;
+
+    if (wdef != WITHDEFAULTS_REPORT_ALL && wdef != WITHDEFAULTS_EXPLICIT)
+        goto fail;
+    if (!yang_config_ancestor(ylist))
+        goto fail;
+    if ((de = clicon_db_elmnt_get(h, db)) == NULL || (x0t = de->de_xml) == NULL)
+        goto fail;
+    if (!xmldb_cache_bound(x0t))
+        goto fail;
+    if ((ret = xpath_simple_steps(xpath, &xptop, &steps, &nr)) < 0)
+        goto done;
+    if (ret == 0)
+        goto fail;
+    if (xpath_simple_haspreds(steps[nr-1]))
+        goto fail;
+    *x0tp = x0t;
+    *x0pp = NULL;
+    if (nr == 1)
+        *x0pp = x0t;
+    else {
+        if ((cb = cbuf_new()) == NULL){
+            clicon_err(OE_UNIX, errno, "cbuf_new");
+            goto done;
+        }
+        if (xpath_simple_prefix(steps, nr-2, 1, cb) < 0)
+            goto done;
+        if (xpath_vec(x0t, nsc, "%s", &xvec, &xlen, cbuf_get(cb)) < 0)
+            goto done;
+        if (xlen > 1)
+            goto fail;
+        /* The cache has no defaults, so ancestor predicates may only compare list keys */
+        xp = xlen ? xvec[0] : NULL;
+        for (i=nr-2; i>=0; i--){
+            if (xpath_simple_haspreds(steps[i])){
+                if (xp == NULL || xml_spec(xp) == NULL)
+                    goto fail;
+                if ((ret = xpath_simple_keys(xml_spec(xp), steps[i])) < 0)
+                    goto done;
+                if (ret == 0)
+                    goto fail;
+            }
+            if (xp)
+                xp = xml_parent(xp);
+        }
+        if (xlen == 1)
+            *x0pp = xvec[0];
+    }
+    retval = 1;
+ done:
+    if (xptop)
+        xpath_tree_free(xptop);
+    if (steps)
+        free(steps);
+    if (cb)
+        cbuf_free(cb);
+    if (xvec)
+        free(xvec);
+    return retval;
+ fail:
+    retval = 0;
+    goto done;
+}
+
+/*! Copy a vector of list entries from the cache into a new tree, in vector order
+ *
+ * @param[in]  x0t   Top of cached tree
+ * @param[in]  x0p   Parent of list entries in cached tree
+ * @param[in]  vec   Vector of list entries (children of x0p)
+ * @param[in]  n     Length of vec
+ * @param[in]  wdef  With-defaults parameter, report-all or explicit
+ * @param[out] x1tp  New tree, free with xml_free()
+ * @retval     0     OK
+ * @retval    -1     Error
+ */
+static int
+xmldb_list_copy(cxobj            *x0t,
+                cxobj            *x0p,
+                cxobj           **vec,
+                size_t            n,
+                withdefaults_type wdef,
+                cxobj           **x1tp)
+{
+    int        retval = -1;
+    cxobj     *x1t = NULL;
+    cxobj     *x1p;
+    cxobj     *x0;
+    cxobj     *x1;
+    size_t     i;
+
+    if ((x1t = xml_new(xml_name(x0t), NULL, CX_ELMNT)) == NULL)
+        goto done;
+    xml_flag_set(x1t, XML_FLAG_TOP);
+    if (n > 0){
+        if (xml_copy_bottom_recurse(x0t, x0p, x1t, &x1p) < 0)
+            goto done;
+        for (i=0; i<n; i++){
+            x0 = vec[i];
+            if ((x1 = xml_new(xml_name(x0), x1p, CX_ELMNT)) == NULL)
+                goto done;
+            if (xml_copy(x0, x1) < 0)
+                goto done;
+            if (wdef == WITHDEFAULTS_REPORT_ALL &&
+                xml_default_recurse(x1, 0) < 0)
+                goto done;
+        }
+        if (wdef == WITHDEFAULTS_EXPLICIT &&
+            xml_defaults_nopresence(x1t, 2) < 0)
+            goto done;
+    }
+    *x1tp = x1t;
+    x1t = NULL;
+    retval = 0;
+ done:
+    if (x1t)
+        xml_free(x1t);
+    return retval;
+}
+
+/*! Get a range of entries of a config list or leaf-list from a cached datastore
+ *
+ * The entries are sliced directly from the sorted child vector of the list parent, so the
+ * cost is proportional to the size of the range, not the size of the list.
+ * The xpath must be a simple path to the list, see xpath_simple_steps, with at most
+ * one matching parent and no predicate on the list itself. If these conditions are not
+ * met, or the datastore is not cached, xtop is returned as NULL and the caller should use
+ * xmldb_get0 with position() predicates instead.
+ * @param[in]  h         Clixon handle
+ * @param[in]  db        Name of datastore, eg "running"
+ * @param[in]  nsc       XML namespace context for XPath
+ * @param[in]  xpath     XPath to list or leaf-list
+ * @param[in]  ylist     Yang spec of list or leaf-list
+ * @param[in]  wdef      With-defaults parameter, only report-all and explicit
+ * @param[in]  offset    Number of entries to skip (after cursor, if given)
+ * @param[in]  limit     Max number of entries, 0 means unbounded
+ * @param[in]  cursor    Return entries after this cursor, or NULL
+ * @param[out] xtop      XML tree with entries, or NULL. Free with xml_free()
+ * @param[out] remaining Number of entries after the range
+ * @param[out] next      Cursor of last entry if remaining, or NULL. Free with free()
+ * @retval     1         OK, see xtop
+ * @retval     0         Invalid cursor
+ * @retval    -1         Error
+ * @see xmldb_get0
+ * @see xmldb_get_list_query  For where and sort-by
+ */
+int
+xmldb_get_list_range(clicon_handle     h,
+                     const char       *db,
+                     cvec             *nsc,
+                     const char       *xpath,
+                     yang_stmt        *ylist,
+                     withdefaults_type wdef,
+                     uint32_t          offset,
+                     uint32_t          limit,
+                     const char       *cursor,
+                     cxobj           **xtop,
+                     uint32_t         *remaining,
+                     char            **next)
+{
+    int        retval = -1;
+    cxobj     *x0t = NULL;
+    cxobj     *x0p = NULL;
+    cxobj     *x1t = NULL;
+    cxobj    **vec = NULL;
+    int        low;
+    int        upper;
+    int        end;
+    int        i;
+    int        ret;
+
+    *xtop = NULL;
+    *remaining = 0;
+    *next = NULL;
+    if ((ret = xmldb_list_parent(h, db, nsc, xpath, ylist, wdef, &x0t, &x0p)) < 0)
+        goto done;
+    if (ret == 0)
+        goto ok;
+    if (x0p != NULL){
+        if ((ret = clixon_xml_find_range(x0p, ylist, &low, &upper)) < 0)
+            goto done;
+        if (ret == 0)
+            goto ok;
+    }
+    else
+        low = upper = 0;
+    if (cursor && *cursor && x0p != NULL){
+        if ((ret = xmldb_cursor_pos(x0p, ylist, cursor, low, upper, &low)) < 0)
+            goto done;
+        if (ret == 0)
+            goto fail;
+    }
+    low = (upper - low > offset) ? low + offset : upper;
+    end = (limit && upper - low > limit) ? low + limit : upper;
+    /* Not xml_childvec_get(): it would flatten a chunked child vector */
+    if (low < end){
+        if ((vec = malloc((end - low)*sizeof(cxobj *))) == NULL){
+            clicon_err(OE_UNIX, errno, "malloc");
+            goto done;
+        }
+        for (i=low; i<end; i++)
+            vec[i-low] = xml_child_i(x0p, i);
+    }
+    if (xmldb_list_copy(x0t, x0p, vec, low < end ? end - low : 0, wdef, &x1t) < 0)
+        goto done;
+    if (low < end && end < upper &&
+        xmldb_cursor_encode(xml_child_i(x0p, end-1), ylist, next) < 0)
+        goto done;
+    *remaining = upper - end;
+    *xtop = x1t;
+    x1t = NULL;
+ ok:
+    retval = 1;
+ done:
+    if (vec)
+        free(vec);
+    if (x1t)
+        xml_free(x1t);
+    return retval;
+ fail:
+    retval = 0;
+    goto done;
+}
+
+/*! Check if a where expression is an equality on an indexed leaf, eg "es:name = 'bob'"
+ *
+ * Indexed leafs are single list keys and leafs with the clixon-config search_index extension.
+ * @param[in]  ylist  Yang spec of list
+ * @param[in]  where  XPath boolean expression
+ * @param[out] cvk    Index variable and value, to be used in clixon_xml_find_index. Free with cvec_free
+ * @retval     1      Yes, see cvk
+ * @retval     0      No
+ * @retval    -1      Error
+ */
+static int
+xmldb_where_index(yang_stmt  *ylist,
+                  const char *where,
+                  cvec      **cvk)
+{
+    int         retval = -1;
+    const char *s = where;
+    const char *name;
+    size_t      nlen;
+    const char *val;
+    size_t      vlen;
+    char        q;
+    char       *str = NULL;
+    yang_stmt  *yk;
+    cvec       *cvv;
+    cg_var     *cv;
+
+    if (yang_keyword_get(ylist) != Y_LIST)
+        goto fail;
+    while (isspace((unsigned char)*s))
+        s++;
+    name = s;
+    while (isalnum((unsigned char)*s) || *s == '_' || *s == '-' || *s == '.' || *s == ':'){
+        if (*s == ':')
+            name = s + 1;
+        s++;
+    }
+    if ((nlen = s - name) == 0)
+        goto fail;
+    while (isspace((unsigned char)*s))
+        s++;
+    if (*s++ != '=')
+        goto fail;
+    while (isspace((unsigned char)*s))
+        s++;
+    if (*s == '\'' || *s == '"'){
+        q = *s++;
+        val = s;
+        if ((s = strchr(s, q)) == NULL)
+            goto fail;
+        vlen = s++ - val;
+    }
+    else {
+        val = s;
+        while (isdigit((unsigned char)*s) || *s == '-' || *s == '.')
+            s++;
+        if ((vlen = s - val) == 0)
+            goto fail;
+    }
+    while (isspace((unsigned char)*s))
+        s++;
+    if (*s != '\0')
+        goto fail;
+    if ((str = strndup(name, nlen)) == NULL){
+        clicon_err(OE_UNIX, errno, "strndup");
+        goto done;
+    }
+    if ((yk = yang_find(ylist, Y_LEAF, str)) == NULL)
+        goto fail;
+    cvv = yang_cvec_get(ylist);
+#ifdef XML_EXPLICIT_INDEX
+    if (yang_flag_get(yk, YANG_FLAG_INDEX) == 0)
+#endif
+        if (cvec_len(cvv) != 1 || strcmp(cv_string_get(cvec_i(cvv, 0)), str) != 0)
+            goto fail;
+    if ((*cvk = cvec_new(0)) == NULL){
+        clicon_err(OE_UNIX, errno, "cvec_new");
+        goto done;
+    }
+    if ((cv = cvec_add(*cvk, CGV_STRING)) == NULL){
+        clicon_err(OE_UNIX, errno, "cvec_add");
+        goto done;
+    }
+    cv_name_set(cv, str);
+    free(str);
+    if ((str = strndup(val, vlen)) == NULL){
+        clicon_err(OE_UNIX, errno, "strndup");
+        goto done;
+    }
+    cv_string_set(cv, str);
+    retval = 1;
+ done:
+    if (str)
+        free(str);
+    return retval;
+ fail:
+    retval = 0;
+    goto done;
+}
+
+/*! Check if a list entry has a default value for a descendant node
+ *
+ * @param[in]  ylist   Yang spec of list or leaf-list
+ * @param[in]  nodeid  Descendant node identifier, prefixes are ignored
+ * @retval     1       Node has a default value, or cannot be resolved
+ * @retval     0       No default value
+ */
+static int
+xmldb_nodeid_default(yang_stmt  *ylist,
+                     const char *nodeid)
+{
+    yang_stmt  *y = ylist;
+    char      **vec = NULL;
+    int         nvec;
+    char       *p;
+    int         i;
+    int         retval = 1;
+
+    if ((vec = clicon_strsep((char*)nodeid, "/", &nvec)) == NULL)
+        goto done;
+    for (i=0; i<nvec; i++){
+        p = (p = strchr(vec[i], ':')) != NULL ? p + 1 : vec[i];
+        if ((y = yang_find_datanode(y, p)) == NULL)
+            goto done;
+    }
+    if (yang_keyword_get(y) == Y_LEAF &&
+        yang_cv_get(y) != NULL && !cv_flag(yang_cv_get(y), V_UNSET))
+        goto done;
+    retval = 0;
+ done:
+    if (vec)
+        free(vec);
+    return retval;
+}
+
+/*! qsort comparison of list entries on key values */
+static int
+xmldb_key_qsort(const void *arg1,
+                const void *arg2)
+{
+    return xml_cmp(*(cxobj **)arg1, *(cxobj **)arg2, 0, 0, NULL);
+}
+
+/*! qsort comparison of list entries on position, see xml_enumerate_children */
+static int
+xmldb_position_qsort(const void *arg1,
+                     const void *arg2)
+{
+    return xml_enumerate_get(*(cxobj **)arg1) - xml_enumerate_get(*(cxobj **)arg2);
+}
+
+/*! Check if any descendant of a yang node may get a default value
+ *
+ * @param[in]  y   Yang node
+ * @retval     1   Yes, a descendant leaf or choice has a default
+ * @retval     0   No
+ */
+static int
+xmldb_yang_defaults(yang_stmt *y)
+{
+    yang_stmt *yc = NULL;
+
+    while ((yc = yn_each(y, yc)) != NULL) {
+        switch (yang_keyword_get(yc)){
+        case Y_LEAF:
+            if (yang_cv_get(yc) != NULL && !cv_flag(yang_cv_get(yc), V_UNSET))
+                return 1;
+            break;
+        case Y_CHOICE:
+            if (yang_find(yc, Y_DEFAULT, NULL) != NULL)
+                return 1;
+            /* fall through */
+        case Y_CASE:
+        case Y_CONTAINER:
+        case Y_LIST:
+            if (xmldb_yang_defaults(yc))
+                return 1;
+            break;
+        default:
+            break;
+        }
+    }
+    return 0;
+}
+
+/*! Get entries of a config list from a cached datastore filtered by where and sorted by sort-by
+ *
+ * Implements the list-pagination where, sort-by, direction, offset and limit parameters
+ * (in that order) without copying the whole list. Only the returned entries are copied.
+ * Index structures of the cached tree are used when possible:
+ * - A where expression of the form <leaf> = <value> on a single list key or on a leaf with
+ *   the search_index extension is looked up with binary search
+ * - A sort-by on a leaf with the search_index extension uses its sorted index vector
+ * Other where expressions are evaluated on each entry, and other sort-by nodes are sorted.
+ * If the preconditions of xmldb_get_list_range are not met, or the where expression or
+ * sort-by node may depend on default values, xtop is returned as NULL and the caller should
+ * use xmldb_get0 instead.
+ * @param[in]  h         Clixon handle
+ * @param[in]  db        Name of datastore, eg "running"
+ * @param[in]  nsc       XML namespace context for XPath
+ * @param[in]  xpath     XPath to list or leaf-list
+ * @param[in]  ylist     Yang spec of list or leaf-list
+ * @param[in]  wdef      With-defaults parameter, only report-all and explicit
+ * @param[in]  where     XPath boolean expression relative to list entry, or NULL
+ * @param[in]  wnsc      XML namespace context for where
+ * @param[in]  sortby    Descendant node identifier to sort on, or NULL. For leaf-lists the
+ *                       leaf-list name sorts on the values
+ * @param[in]  backwards Traverse working result-set from last to first
+ * @param[in]  offset    Number of entries to skip
+ * @param[in]  limit     Max number of entries, 0 means unbounded
+ * @param[out] xtop      XML tree with entries, or NULL. Free with xml_free()
+ * @param[out] remaining Number of entries after the returned entries
+ * @retval     0         OK, see xtop
+ * @retval    -1         Error
+ * @see xmldb_get_list_range
+ */
+int
+xmldb_get_list_query(clicon_handle     h,
+                     const char       *db,
+                     cvec             *nsc,
+                     const char       *xpath,
+                     yang_stmt        *ylist,
+                     withdefaults_type wdef,
+                     const char       *where,
+                     cvec             *wnsc,
+                     const char       *sortby,
+                     int               backwards,
+                     uint32_t          offset,
+                     uint32_t          limit,
+                     cxobj           **xtop,
+                     uint32_t         *remaining)
+{
+    int          retval = -1;
+    cxobj       *x0t = NULL;
+    cxobj       *x0p = NULL;
+    cxobj       *x1t = NULL;
+    cxobj       *x;
+    cxobj      **vec = NULL;
+    size_t       n = 0;
+    size_t       i;
+    size_t       j;
+    size_t       first;
+    size_t       end;
+    int          low = 0;
+    int          upper = 0;
+    int          sorted = 0;
+    int          sortval = 0;
+    cvec        *cvk = NULL;
+    clixon_xvec *xv = NULL;
+    int          ret;
+
+    *xtop = NULL;
+    *remaining = 0;
+    if ((ret = xmldb_list_parent(h, db, nsc, xpath, ylist, wdef, &x0t, &x0p)) < 0)
+        goto done;
+    if (ret == 0)
+        goto ok;
+    if (yang_keyword_get(ylist) == Y_LEAF_LIST){
+        /* Sort on entry value, which is the order of leaf-lists ordered-by system */
+        if (sortby && yang_find(ylist, Y_ORDERED_BY, "user") != NULL)
+            sortval++;
+        sortby = NULL;
+    }
+    else if (sortby && xmldb_nodeid_default(ylist, sortby))
+        goto ok;
+    if (x0p != NULL){
+        if ((ret = clixon_xml_find_range(x0p, ylist, &low, &upper)) < 0)
+            goto done;
+        if (ret == 0)
+            goto ok;
+    }
+    if ((vec = calloc(upper - low + 1, sizeof(cxobj *))) == NULL){
+        clicon_err(OE_UNIX, errno, "calloc");
+        goto done;
+    }
+    /* 1. where: index lookup if possible, otherwise below */
+    if (where && x0p != NULL){
+        if ((ret = xmldb_where_index(ylist, where, &cvk)) < 0)
+            goto done;
+        if (ret == 1){
+            if ((xv = clixon_xvec_new()) == NULL)
+                goto done;
+            if (clixon_xml_find_index(x0p, xml_spec(x0p)?NULL:ys_module(ylist), NULL,
+                                      yang_argument_get(ylist), cvk, xv) < 0)
+                goto done;
+            for (i=0; i<clixon_xvec_len(xv); i++)
+                vec[n++] = clixon_xvec_i(xv, i);
+            where = NULL;
+            /* Lookup order is index order, restore list order */
+            if (!sortby && n > 1){
+                if (yang_find(ylist, Y_ORDERED_BY, "user") != NULL){
+                    xml_enumerate_children(x0p);
+                    qsort(vec, n, sizeof(cxobj *), xmldb_position_qsort);
+                }
+                else
+                    qsort(vec, n, sizeof(cxobj *), xmldb_key_qsort);
+            }
+        }
+    }
+    /* Other where expressions are evaluated on cached entries, which lack default values */
+    if (where && xmldb_yang_defaults(ylist))
+        goto ok;
+    /* 2. sort-by: index vector if possible */
+    if (cvk == NULL && x0p != NULL){
+#ifdef XML_EXPLICIT_INDEX
+        yang_stmt   *yi;
+        clixon_xvec *ivec = NULL;
+        char        *sortname;
+        char        *p;
+
+        if (sortby && strchr(sortby, '/') == NULL){
+            sortname = (p = strchr(sortby, ':')) != NULL ? p + 1 : (char*)sortby;
+            if ((yi = yang_find(ylist, Y_LEAF, sortname)) != NULL &&
+                yang_flag_get(yi, YANG_FLAG_INDEX) != 0){
+                if (xml_search_vector_get(x0p, sortname, &ivec) < 0)
+                    goto done;
+                for (i=0; ivec && i<clixon_xvec_len(ivec); i++){
+                    x = clixon_xvec_i(ivec, i);
+                    if (xml_spec(x) == ylist)
+                        vec[n++] = x;
+                }
+                /* Entries without the index leaf are not in the index vector: add last */
+                if (n < (size_t)(upper - low))
+                    for (i=low; i<upper; i++){
+                        x = xml_child_i(x0p, i);
+                        if (xml_find_type(x, NULL, sortname, CX_ELMNT) == NULL)
+                            vec[n++] = x;
+                    }
+                if (n == (size_t)(upper - low))
+                    sorted++;
+                else /* Index not complete, sort below */
+                    n = 0;
+            }
+        }
+#endif
+        if (!sorted)
+            for (i=low; i<upper; i++)
+                vec[n++] = xml_child_i(x0p, i);
+    }
+    /* 1b. where: evaluate on each entry */
+    if (where){
+        for (i=0, j=0; i<n; i++){
+            if ((ret = xpath_vec_bool(vec[i], wnsc, "%s", where)) < 0)
+                goto done;
+            if (ret == 1)
+                vec[j++] = vec[i];
+        }
+        n = j;
+    }
+    /* 2b. sort-by: sort remaining working set */
+    if ((sortby || sortval) && !sorted){
+        if (clixon_xml_sort_by(vec, n, sortby) < 0)
+            goto done;
+    }
+    /* 3. direction */
+    if (backwards)
+        for (i=0; i<n/2; i++){
+            x = vec[i]; vec[i] = vec[n-1-i]; vec[n-1-i] = x;
+        }
+    /* 4. offset and 5. limit */
+    first = (n > offset) ? offset : n;
+    end = (limit && n - first > limit) ? first + limit : n;
+    if (xmldb_list_copy(x0t, x0p, vec + first, end - first, wdef, &x1t) < 0)
+        goto done;
+    *remaining = n - end;
+    *xtop = x1t;
+    x1t = NULL;
+ ok:
+    retval = 0;
+ done:
+    if (x1t)
+        xml_free(x1t);
+    if (vec)
+        free(vec);
+    if (cvk)
+        cvec_free(cvk);
+    if (xv)
+        clixon_xvec_free(xv);
+    return retval;
+}
+
 /*! Clear cached xml tree obtained with xmldb_get0, if zerocopy
  *
  * @param[in]  h    Clixon handle
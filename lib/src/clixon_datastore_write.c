@@ -491,6 +491,8 @@ text_modify(clicon_handle       h,
     int        ismount = 0;
     yang_stmt *mount_yspec = NULL;
     char      *creator = NULL;
+    int        nx1;     /* Number of x1 element children */
+    int        bulk = 0; /* Add new children of x0 in bulk, see xml_sort_merge */
 
     if (x1 == NULL){
         clicon_err(OE_XML, EINVAL, "x1 is missing");
@@ -864,10 +866,15 @@ text_modify(clicon_handle       h,
             /* First pass: Loop through children of the x1 modification tree 
              * collect matching nodes from x0 in x0vec (no changes to x0 children)
              */
-            if ((x0vec = calloc(xml_child_nr_type(x1, CX_ELMNT), sizeof(x1))) == NULL){
+            nx1 = xml_child_nr_type(x1, CX_ELMNT);
+            if ((x0vec = calloc(nx1, sizeof(x1))) == NULL){
                 clicon_err(OE_UNIX, errno, "calloc");
                 goto done;
             }
+            /* Bulk mode if many children are added compared to existing, eg an empty
+             * target or replace: new children are sorted once and merged, instead of
+             * inserted one by one. */
+            bulk = nx1 > 1 && nx1 >= xml_child_nr(x0);
             x1c = NULL;
             i = 0;
             while ((x1c = xml_child_each(x1, x1c, CX_ELMNT)) != NULL) {
@@ -902,6 +909,12 @@ text_modify(clicon_handle       h,
                                x1cname, yang_find_mynamespace(y0));
                     goto done;
                 }
+                /* Insert attributes and when conditions need a sorted x0 */
+                if (bulk &&
+                    (yang_when_xpath_get(yc) != NULL ||
+                     yang_find(yc, Y_WHEN, NULL) != NULL ||
+                     xml_find_type(x1c, NULL, "insert", CX_ATTR) != NULL))
+                    bulk = 0;
                 /* Check if existing choice/case should be deleted */
                 if (choice_delete_other(x0, yc) < 0)
                     goto done;
@@ -915,6 +928,8 @@ text_modify(clicon_handle       h,
              * Now potentially modify x0:s children 
              * Here x0vec contains one-to-one matching nodes of x1:s children.
              */
+            if (bulk)
+                xml_flag_set(x0, XML_FLAG_BULK);
             x1c = NULL;
             i = 0;
             while ((x1c = xml_child_each(x1, x1c, CX_ELMNT)) != NULL) {
@@ -946,6 +961,11 @@ text_modify(clicon_handle       h,
                 if (ret == 0)
                     goto fail;
             }
+            if (bulk){
+                bulk = 0;
+                if (xml_sort_merge(x0) < 0)
+                    goto done;
+            }
             if (creator){
                 if (xml_creator_add(x0, creator) < 0)
                     goto done;
@@ -997,6 +1017,9 @@ text_modify(clicon_handle       h,
         free(createstr);
     if (nscx1)
         xml_nsctx_free(nscx1);
+    /* Keep x0 sorted also if a child failed */
+    if (bulk && xml_sort_merge(x0) < 0)
+        retval = -1;
     /* Remove dangling added objects */
     if (changed && x0 && xml_parent(x0)==NULL)
         xml_purge(x0);
@@ -1274,6 +1297,8 @@ xmldb_put(clicon_handle       h,
      */
     if ((ret = text_modify_top(h, x0, x1, yspec, op, username, xnacm, permit, cbret)) < 0)
         goto done;
+    /* Also on failure since x0 may have been partially modified */
+    xmldb_generation_inc(h);
     /* If xml return - ie netconf error xml tree, then stop and return OK */
     if (ret == 0){
         /* If first time and quit here, x0 is not written back into cache and leaks */
@@ -88,6 +88,12 @@
 /* Name of xml top object created by parse functions */
 #define JSON_TOP_SYMBOL "top"
 
+/*
+ * Local variables
+ */
+/* Use hand-written JSON parser instead of yacc parser, see CLICON_JSON_FAST_PARSER */
+static int _json_parse_fast = 0;
+
 enum array_element_type{
     NO_ARRAY=0,
     FIRST_ARRAY,  /* [a, */
@@ -241,53 +247,6 @@ array_eval(cxobj *xprev,
     return arraytype;
 }
 
-/*! Escape a json string as well as decode xml cdata
- *
- * @param[out] cb   cbuf   (encoded)
- * @param[in]  str  string (unencoded)
- * @retval     0    OK
- */
-static int
-json_str_escape_cdata(cbuf *cb,
-                      char *str)
-{
-    int    retval = -1;
-    size_t len;
-    int    i;
-
-    len = strlen(str);
-    for (i=0; i<len; i++)
-        switch (str[i]){
-        case '\"':
-            cprintf(cb, "\\\"");
-            break;
-        case '\\':
-            cprintf(cb, "\\\\");
-            break;
-        case '\b':
-            cprintf(cb, "\\b");
-            break;
-        case '\f':
-            cprintf(cb, "\\f");
-            break;
-        case '\n':
-            cprintf(cb, "\\n");
-            break;
-        case '\r':
-            cprintf(cb, "\\r");
-            break;
-        case '\t':
-            cprintf(cb, "\\t");
-            break;
-        default: /* fall thru */
-            cprintf(cb, "%c", str[i]);
-            break;
-        }
-    retval = 0;
-    // done:
-    return retval;
-}
-
 /*! Decode types from JSON to XML identityrefs
  *
  * Assume an xml tree where prefix:name have been split into "module":"name"
@@ -391,27 +350,22 @@ json2xml_decode_identityref(cxobj     *x,
     goto done;
 }
 
-/*! Decode leaf/leaf_list types from JSON to XML after parsing and yang
+/*! Decode leaf/leaf_list type of single XML node from JSON to XML
  *
- * Assume an xml tree where prefix:name have been split into "module":"name"
- * In other words, from JSON RFC7951 to XML namespace trees
- * 
- * @param[in]     x     XML tree. Must be yang populated. After json parsing
- * @param[in]     yspec Yang spec
+ * @param[in]     x     XML node. Must be yang populated.
  * @param[out]    xerr  Reason for invalid tree returned as netconf err msg or NULL
  * @retval        1     OK 
  * @retval        0     Invalid, wrt namespace.  xerr set
  * @retval       -1     Error
- * @see RFC7951 Sec 4 and 6.8
+ * @see json2xml_decode  Recursive variant
  */
-int
-json2xml_decode(cxobj     *x,
-                cxobj    **xerr)
+static int
+json2xml_decode1(cxobj     *x,
+                 cxobj    **xerr)
 {
     int           retval = -1;
     yang_stmt    *y;
     enum rfc_6020 keyword;
-    cxobj        *xc;
     int           ret;
     yang_stmt    *ytype = NULL;
 
@@ -433,6 +387,39 @@ json2xml_decode(cxobj     *x,
             }
         }
     }
+    retval = 1;
+ done:
+    return retval;
+ fail:
+    retval = 0;
+    goto done;
+}
+
+/*! Decode leaf/leaf_list types from JSON to XML after parsing and yang
+ *
+ * Assume an xml tree where prefix:name have been split into "module":"name"
+ * In other words, from JSON RFC7951 to XML namespace trees
+ * 
+ * @param[in]     x     XML tree. Must be yang populated. After json parsing
+ * @param[in]     yspec Yang spec
+ * @param[out]    xerr  Reason for invalid tree returned as netconf err msg or NULL
+ * @retval        1     OK 
+ * @retval        0     Invalid, wrt namespace.  xerr set
+ * @retval       -1     Error
+ * @see RFC7951 Sec 4 and 6.8
+ */
+int
+json2xml_decode(cxobj     *x,
+                cxobj    **xerr)
+{
+    int           retval = -1;
+    cxobj        *xc;
+    int           ret;
+
+    if ((ret = json2xml_decode1(x, xerr)) < 0)
+        goto done;
+    if (ret == 0)
+        goto fail;
     xc = NULL;
     while ((xc = xml_child_each(x, xc, CX_ELMNT)) != NULL){
         if ((ret = json2xml_decode(xc, xerr)) < 0)
@@ -448,6 +435,51 @@ json2xml_decode(cxobj     *x,
     goto done;
 }
 
+/*! Decode leaf/leaf_list types of collected nodes within one top-level node
+ *
+ * The fast parser collects nodes whose values may be identityrefs, ie prefixed strings,
+ * in document order. Decode the ones belonging to xt, instead of traversing all of xt.
+ * @param[in]     xt    Top-level XML node. Must be yang populated.
+ * @param[in]     xvec  Vector of collected nodes in document order
+ * @param[in]     xlen  Length of xvec
+ * @param[in,out] i     Index in xvec, on return first node not within xt
+ * @param[out]    xerr  Reason for invalid tree returned as netconf err msg or NULL
+ * @retval        1     OK 
+ * @retval        0     Invalid, wrt namespace.  xerr set
+ * @retval       -1     Error
+ * @see json2xml_decode
+ */
+static int
+json2xml_decode_vec(cxobj     *xt,
+                    cxobj    **xvec,
+                    int        xlen,
+                    int       *i,
+                    cxobj    **xerr)
+{
+    int    retval = -1;
+    cxobj *x;
+    cxobj *xp;
+    int    ret;
+
+    for (; *i < xlen; (*i)++){
+        x = xvec[*i];
+        for (xp = x; xp != NULL && xp != xt; xp = xml_parent(xp))
+            ;
+        if (xp == NULL) /* Belongs to a later top-level node */
+            break;
+        if ((ret = json2xml_decode1(x, xerr)) < 0)
+            goto done;
+        if (ret == 0)
+            goto fail;
+    }
+    retval = 1;
+ done:
+    return retval;
+ fail:
+    retval = 0;
+    goto done;
+}
+
 /*! Encode leaf/leaf_list identityref type from XML to JSON
  *
  * @param[in]   x    XML body node
@@ -625,7 +657,7 @@ xml2json_encode_leafs(cxobj     *xb,
      */
     if (quote){
         cprintf(cb0, "\"");
-        json_str_escape_cdata(cb0, cbuf_get(cb));
+        json_str_escape_cbuf_append(cb0, cbuf_get(cb));
     }
     else
         cprintf(cb0, "%s", cbuf_get(cb));
@@ -712,6 +744,8 @@ json_metadata_encoding(cbuf  *cb,
                        char  *val,
                        int    list)
 {
+    char *digits;
+
     cprintf(cb, ",\"@");
     if (prefix)
         cprintf(cb, "%s:", prefix);
@@ -719,7 +753,17 @@ json_metadata_encoding(cbuf  *cb,
     if (list)
         cprintf(cb, "[");
     cprintf(cb, "%*s", pretty?((level+1)*PRETTYPRINT_INDENT):0, "{");
-    cprintf(cb, "\"%s:%s\":%s", modname2, name2, val);
+    cprintf(cb, "\"%s:%s\":", modname2, name2);
+    /* Integers and booleans as is, other values as strings, eg clixon-lib:next-cursor */
+    digits = (*val == '-') ? val+1 : val;
+    if ((*digits != '\0' && strspn(digits, "0123456789") == strlen(digits)) ||
+        strcmp(val, "true") == 0 || strcmp(val, "false") == 0)
+        cprintf(cb, "%s", val);
+    else {
+        cprintf(cb, "\"");
+        json_str_escape_cbuf_append(cb, val);
+        cprintf(cb, "\"");
+    }
     cprintf(cb, "%*s", pretty?((level+1)*PRETTYPRINT_INDENT):0, "}");
     if (list)
         cprintf(cb, "%*s", pretty?(level*PRETTYPRINT_INDENT):0, "]");
@@ -796,70 +840,60 @@ xml2json_encode_attr(cxobj     *xa,
     return retval;
 }
 
-/*! Do the actual work of translating XML to JSON 
+/*! State of one XML node while it is translated to JSON
  *
- * @param[out]  cb        Cligen text buffer containing json on exit
- * @param[in]   x         XML tree structure containing XML to translate
- * @param[in]   arraytype Does x occur in a array (of its parent) and how?
- * @param[in]   level     Indentation level
- * @param[in]   pretty    Pretty-print output (2 means debug)
- * @param[in]   flat      Dont print NO_ARRAY object name (for _vec call)
- * @param[in]   modname0
- * @param[out]  metacbp   Meta encoding of attribute
- * @retval      0         OK
- * @retval     -1         Error
+ * Used as stack frame both by the recursive xml2json1_cbuf and by the explicit stack of
+ * json_stream.
+ */
+struct json_frame{
+    cxobj                  *jf_x;         /* XML node, NULL for pseudo-object of jf_vec */
+    cxobj                 **jf_vec;       /* Children of pseudo-object (if jf_x is NULL) */
+    size_t                  jf_veclen;    /* Length of jf_vec */
+    enum array_element_type jf_arraytype; /* Does x occur in a array (of its parent) and how? */
+    enum childtype          jf_childt;    /* Type of children of x */
+    int                     jf_level;     /* Indentation level of x */
+    yang_stmt              *jf_ys;        /* Yang spec of x */
+    char                   *jf_modname;   /* Module name of x if differs from ancestor */
+    char                   *jf_modname0;  /* Ancestor module name passed to children */
+    cbuf                   *jf_metacbp;   /* Meta encoding of attributes of x (of parent) */
+    cbuf                   *jf_metacbc;   /* Meta encoding of attributes of children */
+    int                     jf_commas;    /* Number of commas left to print between children */
+    int                     jf_i;         /* Index of next child of x (or jf_vec) */
+};
+
+/*! Translate start of XML node to JSON, before its children
  *
- * @note Does not work with XML attributes
- * The following matrix explains how the mapping is done.
- * You need to understand what arraytype means (no/first/middle/last)
- * and what childtype is (null,body,any)
-  +----------+--------------+--------------+--------------+
-  |array,leaf| null         | body         | any          |
-  +----------+--------------+--------------+--------------+
-  |no        | <a/>         |<a>1</a>      |<a><b/></a>   |
-  |          |              |              |              |
-  |  json:   |\ta:null      |\ta:          |\ta:{\n       |
-  |          |              |              |\n}           |
-  +----------+--------------+--------------+--------------+
-  |first     |<a/><a..      |<a>1</a><a..  |<a><b/></a><a.|
-  |          |              |              |              |
-  |  json:   |\ta:[\n\tnull |\ta:[\n\t     |\ta:[\n\t{\n  |
-  |          |              |              |\n\t}         |
-  +----------+--------------+--------------+--------------+
-  |middle    |..a><a/><a..  |.a><a>1</a><a.|              |
-  |          |              |              |              |
-  |  json:   |\tnull        |\t            |\t{a          |
-  |          |              |              |\n\t}         |
-  +----------+--------------+--------------+--------------+
-  |last      |..a></a>      |..a><a>1</a>  |              |
-  |          |              |              |              |
-  |  json:   |\tnull        |\t            |\t{a          |
-  |          |\n\t]         |\n\t]         |\n\t}\t]      |
-  +----------+--------------+--------------+--------------+
+ * @param[out]    cb        Cligen text buffer
+ * @param[in,out] jf        Frame, jf_x or jf_vec set by caller, rest is set here
+ * @param[in]     arraytype Does x occur in a array (of its parent) and how?
+ * @param[in]     level     Indentation level
+ * @param[in]     pretty    Pretty-print output (2 means debug)
+ * @param[in]     flat      Dont print NO_ARRAY object name (for _vec call)
+ * @param[in]     modname0  Ancestor module name
+ * @param[out]    metacbp   Meta encoding of attribute
+ * @retval        0         OK
+ * @retval       -1         Error
+ * @see xml2json1_cbuf for translation matrix
  */
 static int
-xml2json1_cbuf(cbuf                   *cb,
-               cxobj                  *x,
-               enum array_element_type arraytype,
-               int                     level,
-               int                     pretty,
-               int                     flat,
-               char                   *modname0,
-               cbuf                   *metacbp)
+json_frame_init(cbuf                   *cb,
+                struct json_frame      *jf,
+                enum array_element_type arraytype,
+                int                     level,
+                int                     pretty,
+                int                     flat,
+                char                   *modname0,
+                cbuf                   *metacbp)
 {
     int              retval = -1;
-    int              i;
-    cxobj           *xc;
-    cxobj           *xp;
+    cxobj           *x = jf->jf_x;
     enum childtype   childt;
-    enum array_element_type xc_arraytype;
-    yang_stmt       *ys;
+    yang_stmt       *ys = NULL;
     yang_stmt       *ymod = NULL; /* yang module */
-    int              commas;
     char            *modname = NULL;
-    cbuf            *metacbc = NULL;
+    cxobj           *xp;
 
-    if ((ys = xml_spec(x)) != NULL){
+    if (x != NULL && (ys = xml_spec(x)) != NULL){
         if (ys_real_module(ys, &ymod) < 0)
             goto done;
         modname = yang_argument_get(ymod);
@@ -874,7 +908,10 @@ xml2json1_cbuf(cbuf                   *cb,
         else
             modname0 = modname; /* modname0 is ancestor ns passed to child */
     }
-    childt = child_type(x);
+    if (x != NULL)
+        childt = child_type(x);
+    else
+        childt = jf->jf_veclen ? ANY_CHILD : NULL_CHILD;
     if (pretty==2)
         cprintf(cb, "#%s_array, %s_child ",
                 arraytype2str(arraytype),
@@ -952,46 +989,120 @@ xml2json1_cbuf(cbuf                   *cb,
     default:
         break;
     }
-    if ((metacbc = cbuf_new()) == NULL){
+    if ((jf->jf_metacbc = cbuf_new()) == NULL){
         clicon_err(OE_UNIX, errno, "cbuf_new");
         goto done;
     }
+    jf->jf_arraytype = arraytype;
+    jf->jf_childt = childt;
+    jf->jf_level = level;
+    jf->jf_ys = ys;
+    jf->jf_modname = modname;
+    jf->jf_modname0 = modname0;
+    jf->jf_metacbp = metacbp;
+    if (x != NULL)
+        jf->jf_commas = xml_child_nr_notype(x, CX_ATTR) - 1;
+    else
+        jf->jf_commas = jf->jf_veclen - 1;
+    jf->jf_i = 0;
+    retval = 0;
+ done:
+    return retval;
+}
+
+/*! Get next child of XML node to translate to JSON
+ *
+ * Attributes are encoded as meta-data on the way
+ * @param[in,out] jf        Frame
+ * @param[in]     pretty    Pretty-print output
+ * @param[out]    xcp       Next child
+ * @param[out]    arraytype Does child occur in a array and how?
+ * @retval        1         Next child in xcp
+ * @retval        0         No more children
+ * @retval       -1         Error
+ */
+static int
+json_frame_next(struct json_frame       *jf,
+                int                      pretty,
+                cxobj                  **xcp,
+                enum array_element_type *arraytype)
+{
+    cxobj  *x = jf->jf_x;
+    cxobj **vec = jf->jf_vec;
+    cxobj  *xc;
+    int     i;
+
+    if (x == NULL){
+        if (jf->jf_i >= jf->jf_veclen)
+            return 0;
+        i = jf->jf_i++;
+        *xcp = vec[i];
+        *arraytype = array_eval(i?vec[i-1]:NULL,
+                                vec[i],
+                                i+1<jf->jf_veclen?vec[i+1]:NULL);
+        return 1;
+    }
     /* Check for typed sub-body if:
      * arraytype=* but child-type is BODY_CHILD 
      * This is code for writing <a>42</a> as "a":42 and not "a":"42"
      */
-    commas = xml_child_nr_notype(x, CX_ATTR) - 1;
-    for (i=0; i<xml_child_nr(x); i++){
+    while (jf->jf_i < xml_child_nr(x)){
+        i = jf->jf_i++;
         xc = xml_child_i(x, i);
         if (xml_type(xc) == CX_ATTR){
-            if (metacbp &&
-                xml2json_encode_attr(xc, x, ys, level, pretty, modname, metacbp) < 0)
-                goto done;
+            if (jf->jf_metacbp &&
+                xml2json_encode_attr(xc, x, jf->jf_ys, jf->jf_level, pretty,
+                                     jf->jf_modname, jf->jf_metacbp) < 0)
+                return -1;
             continue;
         }
-        xc_arraytype = array_eval(i?xml_child_i(x,i-1):NULL,
+        *xcp = xc;
+        *arraytype = array_eval(i?xml_child_i(x,i-1):NULL,
                                 xc,
                                 xml_child_i(x, i+1));
-        if (xml2json1_cbuf(cb,
-                           xc,
-                           xc_arraytype,
-                           level+1, pretty, 0, modname0,
-                           metacbc) < 0)
-            goto done;
-        if (commas > 0) {
-            cprintf(cb, ",%s", pretty?"\n":"");
-            --commas;
-        }
+        return 1;
     }
-    if (cbuf_len(metacbc)){
-        cprintf(cb, "%s", cbuf_get(metacbc));
+    return 0;
+}
+
+/*! Print comma after a child of XML node translated to JSON, unless it is the last
+ *
+ * @param[out]    cb        Cligen text buffer
+ * @param[in,out] jf        Frame
+ * @param[in]     pretty    Pretty-print output
+ */
+static void
+json_frame_comma(cbuf              *cb,
+                 struct json_frame *jf,
+                 int                pretty)
+{
+    if (jf->jf_commas > 0) {
+        cprintf(cb, ",%s", pretty?"\n":"");
+        jf->jf_commas--;
     }
+}
+
+/*! Translate end of XML node to JSON, after its children
+ *
+ * @param[out]    cb        Cligen text buffer
+ * @param[in,out] jf        Frame, meta-data buffer is freed
+ * @param[in]     pretty    Pretty-print output
+ */
+static void
+json_frame_done(cbuf              *cb,
+                struct json_frame *jf,
+                int                pretty)
+{
+    int level = jf->jf_level;
 
-    switch (arraytype){
+    if (cbuf_len(jf->jf_metacbc)){
+        cprintf(cb, "%s", cbuf_get(jf->jf_metacbc));
+    }
+    switch (jf->jf_arraytype){
     case BODY_ARRAY:
         break;
     case NO_ARRAY:
-        switch (childt){
+        switch (jf->jf_childt){
         case NULL_CHILD:
         case BODY_CHILD:
             break;
@@ -1003,11 +1114,10 @@ xml2json1_cbuf(cbuf                   *cb,
         default:
             break;
         }
-        level--;
         break;
     case FIRST_ARRAY:
     case MIDDLE_ARRAY:
-        switch (childt){
+        switch (jf->jf_childt){
         case NULL_CHILD:
         case BODY_CHILD:
             break;
@@ -1015,7 +1125,6 @@ xml2json1_cbuf(cbuf                   *cb,
             cprintf(cb, "%s%*s}",
                     pretty?"\n":"",
                     pretty?(level*PRETTYPRINT_INDENT):0, "");
-            level--;
             break;
         default:
             break;
@@ -1023,7 +1132,7 @@ xml2json1_cbuf(cbuf                   *cb,
         break;
     case SINGLE_ARRAY:
     case LAST_ARRAY:
-        switch (childt){
+        switch (jf->jf_childt){
         case NULL_CHILD:
         case BODY_CHILD:
             cprintf(cb, "%s",pretty?"\n":"");
@@ -1044,10 +1153,87 @@ xml2json1_cbuf(cbuf                   *cb,
     default:
         break;
     }
+    cbuf_free(jf->jf_metacbc);
+    jf->jf_metacbc = NULL;
+}
+
+/*! Do the actual work of translating XML to JSON 
+ *
+ * @param[out]  cb        Cligen text buffer containing json on exit
+ * @param[in]   x         XML tree structure containing XML to translate
+ * @param[in]   arraytype Does x occur in a array (of its parent) and how?
+ * @param[in]   level     Indentation level
+ * @param[in]   pretty    Pretty-print output (2 means debug)
+ * @param[in]   flat      Dont print NO_ARRAY object name (for _vec call)
+ * @param[in]   modname0
+ * @param[out]  metacbp   Meta encoding of attribute
+ * @retval      0         OK
+ * @retval     -1         Error
+ *
+ * @note Does not work with XML attributes
+ * @see json_stream  Same translation made incrementally
+ * The following matrix explains how the mapping is done.
+ * You need to understand what arraytype means (no/first/middle/last)
+ * and what childtype is (null,body,any)
+  +----------+--------------+--------------+--------------+
+  |array,leaf| null         | body         | any          |
+  +----------+--------------+--------------+--------------+
+  |no        | <a/>         |<a>1</a>      |<a><b/></a>   |
+  |          |              |              |              |
+  |  json:   |\ta:null      |\ta:          |\ta:{\n       |
+  |          |              |              |\n}           |
+  +----------+--------------+--------------+--------------+
+  |first     |<a/><a..      |<a>1</a><a..  |<a><b/></a><a.|
+  |          |              |              |              |
+  |  json:   |\ta:[\n\tnull |\ta:[\n\t     |\ta:[\n\t{\n  |
+  |          |              |              |\n\t}         |
+  +----------+--------------+--------------+--------------+
+  |middle    |..a><a/><a..  |.a><a>1</a><a.|              |
+  |          |              |              |              |
+  |  json:   |\tnull        |\t            |\t{a          |
+  |          |              |              |\n\t}         |
+  +----------+--------------+--------------+--------------+
+  |last      |..a></a>      |..a><a>1</a>  |              |
+  |          |              |              |              |
+  |  json:   |\tnull        |\t            |\t{a          |
+  |          |\n\t]         |\n\t]         |\n\t}\t]      |
+  +----------+--------------+--------------+--------------+
+ */
+static int
+xml2json1_cbuf(cbuf                   *cb,
+               cxobj                  *x,
+               enum array_element_type arraytype,
+               int                     level,
+               int                     pretty,
+               int                     flat,
+               char                   *modname0,
+               cbuf                   *metacbp)
+{
+    int                     retval = -1;
+    struct json_frame       jf = {0,};
+    cxobj                  *xc;
+    enum array_element_type xc_arraytype;
+    int                     ret;
+
+    jf.jf_x = x;
+    if (json_frame_init(cb, &jf, arraytype, level, pretty, flat, modname0, metacbp) < 0)
+        goto done;
+    while ((ret = json_frame_next(&jf, pretty, &xc, &xc_arraytype)) == 1){
+        if (xml2json1_cbuf(cb,
+                           xc,
+                           xc_arraytype,
+                           jf.jf_level+1, pretty, 0, jf.jf_modname0,
+                           jf.jf_metacbc) < 0)
+            goto done;
+        json_frame_comma(cb, &jf, pretty);
+    }
+    if (ret < 0)
+        goto done;
+    json_frame_done(cb, &jf, pretty);
     retval = 0;
  done:
-    if (metacbc)
-        cbuf_free(metacbc);
+    if (jf.jf_metacbc)
+        cbuf_free(jf.jf_metacbc);
     return retval;
 }
 
@@ -1250,6 +1436,218 @@ xml2json_cbuf_vec(cbuf      *cb,
     return retval;
 }
 
+/*! Incremental translation of XML to JSON
+ *
+ * The XML tree is traversed with an explicit stack of frames instead of recursion, so that
+ * translation can be suspended when enough JSON is produced and resumed later.
+ * @see clixon_json_stream_new
+ */
+struct json_stream{
+    cxobj             *js_x;        /* Top-level object, or NULL for js_vec */
+    cxobj            **js_vec;      /* Vector of top-level objects, as xml2json_cbuf_vec */
+    size_t             js_veclen;   /* Length of js_vec */
+    int                js_pretty;   /* Set if output is pretty-printed */
+    int                js_state;    /* 0: not started, 1: translating, 2: done */
+    struct json_frame *js_stack;    /* Stack of frames, one per level of XML tree */
+    int                js_depth;    /* Number of frames on stack */
+    int                js_maxdepth; /* Allocated frames */
+};
+
+/*! Push a new frame on json stream stack and translate start of XML node
+ *
+ * @param[in]  js        JSON stream
+ * @param[out] cb        Cligen text buffer
+ * @param[in]  x         XML node, or NULL for pseudo-object of js_vec
+ * @param[in]  arraytype Does x occur in a array (of its parent) and how?
+ * @param[in]  level     Indentation level
+ * @param[in]  flat      Dont print NO_ARRAY object name
+ * @param[in]  modname0  Ancestor module name
+ * @param[out] metacbp   Meta encoding of attribute
+ * @retval     0         OK
+ * @retval    -1         Error
+ */
+static int
+json_stream_push(json_stream            *js,
+                 cbuf                   *cb,
+                 cxobj                  *x,
+                 enum array_element_type arraytype,
+                 int                     level,
+                 int                     flat,
+                 char                   *modname0,
+                 cbuf                   *metacbp)
+{
+    int                retval = -1;
+    struct json_frame *jf;
+    struct json_frame *stack;
+    int                maxdepth;
+
+    if (js->js_depth == js->js_maxdepth){
+        maxdepth = js->js_maxdepth ? 2*js->js_maxdepth : 16;
+        if ((stack = realloc(js->js_stack, maxdepth*sizeof(*stack))) == NULL){
+            clicon_err(OE_UNIX, errno, "realloc");
+            goto done;
+        }
+        js->js_stack = stack;
+        js->js_maxdepth = maxdepth;
+    }
+    jf = &js->js_stack[js->js_depth++];
+    memset(jf, 0, sizeof(*jf));
+    jf->jf_x = x;
+    if (x == NULL){
+        jf->jf_vec = js->js_vec;
+        jf->jf_veclen = js->js_veclen;
+    }
+    if (json_frame_init(cb, jf, arraytype, level, js->js_pretty, flat, modname0, metacbp) < 0)
+        goto done;
+    retval = 0;
+ done:
+    return retval;
+}
+
+/*! Create an incremental translation of an XML tree to JSON
+ *
+ * Gives the same JSON as clixon_json2cbuf(cb, x, pretty, 0, 0), but in parts using
+ * clixon_json_stream_read, so that large trees can be sent without the whole JSON text
+ * in memory.
+ * @param[in]  x       XML tree to translate from, must remain until stream is freed
+ * @param[in]  pretty  Set if output is pretty-printed
+ * @retval     js      JSON stream, free with clixon_json_stream_free
+ * @retval     NULL    Error
+ * @code
+ *   json_stream *js;
+ *   if ((js = clixon_json_stream_new(x, 0)) == NULL)
+ *     goto err;
+ *   while ((ret = clixon_json_stream_read(js, cb, 16384)) == 1){
+ *     send(cb); cbuf_reset(cb);
+ *   }
+ *   clixon_json_stream_free(js);
+ * @endcode
+ * @see clixon_json_stream_vec_new
+ */
+json_stream *
+clixon_json_stream_new(cxobj *x,
+                       int    pretty)
+{
+    json_stream *js;
+
+    if ((js = malloc(sizeof(*js))) == NULL){
+        clicon_err(OE_UNIX, errno, "malloc");
+        return NULL;
+    }
+    memset(js, 0, sizeof(*js));
+    js->js_x = x;
+    js->js_pretty = pretty;
+    return js;
+}
+
+/*! Create an incremental translation of a vector of XML objects to JSON
+ *
+ * Gives the same JSON as xml2json_cbuf_vec(cb, vec, veclen, pretty, 0), but the objects
+ * are translated in place without first being copied to a pseudo-object.
+ * @param[in]  vec     Vector of xml objects, must remain until stream is freed
+ * @param[in]  veclen  Length of vector
+ * @param[in]  pretty  Set if output is pretty-printed
+ * @retval     js      JSON stream, free with clixon_json_stream_free
+ * @retval     NULL    Error
+ * @see clixon_json_stream_new
+ */
+json_stream *
+clixon_json_stream_vec_new(cxobj **vec,
+                           size_t  veclen,
+                           int     pretty)
+{
+    json_stream *js;
+
+    if ((js = clixon_json_stream_new(NULL, pretty)) == NULL)
+        return NULL;
+    js->js_vec = vec;
+    js->js_veclen = veclen;
+    return js;
+}
+
+/*! Translate next part of XML to JSON
+ *
+ * Translation stops after the XML node where at least len bytes have been added to cb
+ * @param[in]  js      JSON stream
+ * @param[out] cb      Cligen buffer to append JSON to
+ * @param[in]  len     Number of bytes to translate (approximately)
+ * @retval     1       OK, more to translate
+ * @retval     0       OK, translation done
+ * @retval    -1       Error
+ */
+int
+clixon_json_stream_read(json_stream *js,
+                        cbuf        *cb,
+                        size_t       len)
+{
+    int                     retval = -1;
+    size_t                  len0 = cbuf_len(cb);
+    int                     pretty = js->js_pretty;
+    struct json_frame      *jf;
+    cxobj                  *xc;
+    enum array_element_type arraytype;
+    yang_stmt              *y;
+    int                     ret;
+
+    while (js->js_state != 2 && cbuf_len(cb) - len0 < len){
+        if (js->js_state == 0){
+            if (js->js_x != NULL){ /* As xml2json_cbuf1 */
+                cprintf(cb, "{%s", pretty?"\n":"");
+                arraytype = NO_ARRAY;
+                if ((y = xml_spec(js->js_x)) != NULL &&
+                    (yang_keyword_get(y) == Y_LEAF_LIST || yang_keyword_get(y) == Y_LIST))
+                    arraytype = SINGLE_ARRAY;
+                if (json_stream_push(js, cb, js->js_x, arraytype, 1, 0, NULL, NULL) < 0)
+                    goto done;
+            }
+            else if (json_stream_push(js, cb, NULL, NO_ARRAY, 0, 1, NULL, NULL) < 0)
+                goto done;
+            js->js_state = 1;
+            continue;
+        }
+        if (js->js_depth == 0){
+            if (js->js_x != NULL)
+                cprintf(cb, "%s}%s", pretty?"\n":"", pretty?"\n":"");
+            js->js_state = 2;
+            break;
+        }
+        jf = &js->js_stack[js->js_depth-1];
+        if ((ret = json_frame_next(jf, pretty, &xc, &arraytype)) < 0)
+            goto done;
+        if (ret == 1){
+            if (json_stream_push(js, cb, xc, arraytype, jf->jf_level+1, 0,
+                                 jf->jf_modname0, jf->jf_metacbc) < 0)
+                goto done;
+            continue;
+        }
+        json_frame_done(cb, jf, pretty);
+        js->js_depth--;
+        if (js->js_depth > 0)
+            json_frame_comma(cb, &js->js_stack[js->js_depth-1], pretty);
+    }
+    retval = js->js_state != 2;
+ done:
+    return retval;
+}
+
+/*! Free incremental translation of XML to JSON, the XML tree is not freed
+ *
+ * @param[in]  js      JSON stream
+ */
+int
+clixon_json_stream_free(json_stream *js)
+{
+    int i;
+
+    for (i=0; i<js->js_depth; i++)
+        if (js->js_stack[i].jf_metacbc)
+            cbuf_free(js->js_stack[i].jf_metacbc);
+    if (js->js_stack)
+        free(js->js_stack);
+    free(js);
+    return 0;
+}
+
 /*! Translate from xml tree to JSON and print to file using a callback
  *
  * @param[in]  f       File to print to
@@ -1287,7 +1685,14 @@ clixon_json2file(FILE             *f,
     }
     if (clixon_json2cbuf(cb, xn, pretty, skiptop, autocliext) < 0)
         goto done;
-    (*fn)(f, "%s", cbuf_get(cb));
+    if (fn == fprintf){ /* Plain stdio: write in one chunk */
+        if (fwrite(cbuf_get(cb), 1, cbuf_len(cb), f) != cbuf_len(cb)){
+            clicon_err(OE_UNIX, errno, "fwrite");
+            goto done;
+        }
+    }
+    else
+        (*fn)(f, "%s", cbuf_get(cb));
     retval = 0;
  done:
     if (cb)
@@ -1348,32 +1753,26 @@ xml2json_vec(FILE             *f,
     return retval;
 }
 
-/*! Translate from JSON module:name to XML default ns: xmlns="uri" recursively
+/*! Translate from JSON module:name to XML default ns: xmlns="uri" of a single node
  *
- * Assume an xml tree where prefix:name have been split into "module":"name"
- * In other words, from JSON to XML namespace trees
- * 
  * @param[in]     yspec Yang spec
- * @param[in,out] x     XML tree. Translate it in-line
+ * @param[in,out] x     XML node. Translate it in-line
  * @param[out]    xerr  Reason for invalid tree returned as netconf err msg or NULL
  * @retval        1     OK 
  * @retval        0     Invalid, wrt namespace.  xerr set
  * @retval       -1     Error
- * @note the opposite - xml2ns is made inline in xml2json1_cbuf
- * Example: <top><module:input> --> <top><input xmlns="">
- * @see RFC7951 Sec 4
+ * @note Only x and its ancestors are accessed, therefore this can be made while parsing
+ * @see json_xmlns_translate  Recursive variant
  */
-static int
-json_xmlns_translate(yang_stmt *yspec,
-                     cxobj     *x,
-                     cxobj    **xerr)
+int
+json_xmlns_translate1(yang_stmt *yspec,
+                      cxobj     *x,
+                      cxobj    **xerr)
 {
     int        retval = -1;
     yang_stmt *ymod;
     char      *namespace;
     char      *modname = NULL;
-    cxobj     *xc;
-    int        ret;
 
     if ((modname = xml_prefix(x)) != NULL){ /* prefix is here module name */
         /* Special case for ietf-netconf -> ietf-restconf translation
@@ -1400,6 +1799,42 @@ json_xmlns_translate(yang_stmt *yspec,
         if (xml_namespace_change(x, namespace, NULL) < 0)
             goto done;
     }
+    retval = 1;
+ done:
+    return retval;
+ fail:
+    retval = 0;
+    goto done;
+}
+
+/*! Translate from JSON module:name to XML default ns: xmlns="uri" recursively
+ *
+ * Assume an xml tree where prefix:name have been split into "module":"name"
+ * In other words, from JSON to XML namespace trees
+ * 
+ * @param[in]     yspec Yang spec
+ * @param[in,out] x     XML tree. Translate it in-line
+ * @param[out]    xerr  Reason for invalid tree returned as netconf err msg or NULL
+ * @retval        1     OK 
+ * @retval        0     Invalid, wrt namespace.  xerr set
+ * @retval       -1     Error
+ * @note the opposite - xml2ns is made inline in xml2json1_cbuf
+ * Example: <top><module:input> --> <top><input xmlns="">
+ * @see RFC7951 Sec 4
+ */
+static int
+json_xmlns_translate(yang_stmt *yspec,
+                     cxobj     *x,
+                     cxobj    **xerr)
+{
+    int        retval = -1;
+    cxobj     *xc;
+    int        ret;
+
+    if ((ret = json_xmlns_translate1(yspec, x, xerr)) < 0)
+        goto done;
+    if (ret == 0)
+        goto fail;
     xc = NULL;
     while ((xc = xml_child_each(x, xc, CX_ELMNT)) != NULL){
         if ((ret = json_xmlns_translate(yspec, xc, xerr)) < 0)
@@ -1415,6 +1850,63 @@ json_xmlns_translate(yang_stmt *yspec,
     goto done;
 }
 
+/*! Check that a top-level JSON member is namespace-qualified
+ *
+ * RFC 7951 Section 4: A namespace-qualified member name MUST be used for all 
+ * members of a top-level JSON object 
+ * @param[in]  x       Top-level XML node, before namespace translation
+ * @param[in]  rfc7951 Do sanity checks according to RFC 7951
+ * @param[in]  yb      How to bind yang to XML top-level when parsing
+ * @param[out] xerr    Reason for invalid returned as netconf err msg or NULL
+ * @retval     1       OK
+ * @retval     0       Invalid, xerr set
+ * @retval    -1       Error
+ */
+int
+json_top_check(cxobj     *x,
+               int        rfc7951,
+               yang_bind  yb,
+               cxobj    **xerr)
+{
+    int   retval = -1;
+    cbuf *cberr = NULL;
+
+    if (rfc7951 && xml_prefix(x) == NULL){
+        /* XXX: For top-level config file: */
+        if (yb != YB_NONE || strcmp(xml_name(x),DATASTORE_TOP_SYMBOL)!=0){
+            if ((cberr = cbuf_new()) == NULL){
+                clicon_err(OE_UNIX, errno, "cbuf_new");
+                goto done;
+            }
+            cprintf(cberr, "Top-level JSON object %s is not qualified with namespace which is a MUST according to RFC 7951", xml_name(x));
+            if (xerr && netconf_malformed_message_xml(xerr, cbuf_get(cberr)) < 0)
+                goto done;
+            goto fail;
+        }
+    }
+    retval = 1;
+ done:
+    if (cberr)
+        cbuf_free(cberr);
+    return retval;
+ fail:
+    retval = 0;
+    goto done;
+}
+
+/*! Kludge to select the hand-written JSON parser instead of the yacc parser
+ *
+ * The problem with this is that its global and should be bound to a handle
+ * @param[in] val  If set, use clixon_json_parse_fast
+ * @see CLICON_JSON_FAST_PARSER
+ */
+int
+clixon_json_parse_fast_set(int val)
+{
+    _json_parse_fast = val;
+    return 0;
+}
+
 /*! Parse a string containing JSON and return an XML tree
  *
  * Parsing using yacc according to JSON syntax. Names with <prefix>:<id>
@@ -1446,49 +1938,58 @@ _json_parse(char      *str,
     clixon_json_yacc jy = {0,};
     int              ret;
     cxobj           *x;
-    cbuf            *cberr = NULL;
     int              i;
+    int              j = 0;
     int              failed = 0; /* yang assignment */
 
     clixon_debug(CLIXON_DBG_DEFAULT, "%s %d %s", __FUNCTION__, yb, str);
-    jy.jy_parse_string = str;
+    if (!_json_parse_fast)
+        jy.jy_parse_string = str;
     jy.jy_linenum = 1;
     jy.jy_current = xt;
     jy.jy_xtop = xt;
-    if (json_scan_init(&jy) < 0)
-        goto done;
-    if (json_parse_init(&jy) < 0)
-        goto done;
-    if (clixon_json_parseparse(&jy) != 0) { /* yacc returns 1 on error */
-        clicon_log(LOG_NOTICE, "JSON error: line %d", jy.jy_linenum);
-        if (clicon_errno == 0)
-            clicon_err(OE_JSON, 0, "JSON parser error with no error code (should not happen)");
-        goto done;
+    if (_json_parse_fast){
+        /* The fast parser works in place, the caller's string is not modified */
+        if ((jy.jy_parse_string = strdup(str)) == NULL){
+            clicon_err(OE_JSON, errno, "strdup");
+            goto done;
+        }
+        jy.jy_yspec = yspec;
+        jy.jy_rfc7951 = rfc7951;
+        jy.jy_yb = yb;
+        if ((ret = clixon_json_parse_fast(&jy, xerr)) < 0){
+            clicon_log(LOG_NOTICE, "JSON error: line %d", jy.jy_linenum);
+            goto done;
+        }
+        if (ret == 0)
+            goto fail;
+    }
+    else {
+        if (json_scan_init(&jy) < 0)
+            goto done;
+        if (json_parse_init(&jy) < 0)
+            goto done;
+        if (clixon_json_parseparse(&jy) != 0) { /* yacc returns 1 on error */
+            clicon_log(LOG_NOTICE, "JSON error: line %d", jy.jy_linenum);
+            if (clicon_errno == 0)
+                clicon_err(OE_JSON, 0, "JSON parser error with no error code (should not happen)");
+            goto done;
+        }
     }
     /* Traverse new objects */
     for (i = 0; i < jy.jy_xlen; i++) {
         x = jy.jy_xvec[i];
-        /* RFC 7951 Section 4: A namespace-qualified member name MUST be used for all 
-         * members of a top-level JSON object 
-         */
-        if (rfc7951 && xml_prefix(x) == NULL){
-            /* XXX: For top-level config file: */
-            if (yb != YB_NONE || strcmp(xml_name(x),DATASTORE_TOP_SYMBOL)!=0){
-                if ((cberr = cbuf_new()) == NULL){
-                    clicon_err(OE_UNIX, errno, "cbuf_new");
-                    goto done;
-                }
-                cprintf(cberr, "Top-level JSON object %s is not qualified with namespace which is a MUST according to RFC 7951", xml_name(x));
-                if (xerr && netconf_malformed_message_xml(xerr, cbuf_get(cberr)) < 0)
-                    goto done;
+        if (!_json_parse_fast){ /* Made while parsing by fast parser */
+            if ((ret = json_top_check(x, rfc7951, yb, xerr)) < 0)
+                goto done;
+            if (ret == 0)
+                goto fail;
+            /* Names are split into name/prefix, but now add namespace info */
+            if ((ret = json_xmlns_translate(yspec, x, xerr)) < 0)
+                goto done;
+            if (ret == 0)
                 goto fail;
-            }
         }
-        /* Names are split into name/prefix, but now add namespace info */
-        if ((ret = json_xmlns_translate(yspec, x, xerr)) < 0)
-            goto done;
-        if (ret == 0)
-            goto fail;
         /* Now assign yang stmts to each XML node 
          * XXX should be xml_bind_yang0_parent() sometimes.
          */
@@ -1522,7 +2023,12 @@ _json_parse(char      *str,
         }
         /* Now find leafs with identityrefs (+transitive) and translate 
          * prefixes in values to XML namespaces */
-        if ((ret = json2xml_decode(x, xerr)) < 0)
+        if (_json_parse_fast){
+            /* Only prefixed string values collected by the parser can be identityrefs */
+            if ((ret = json2xml_decode_vec(x, jy.jy_xidvec, jy.jy_xidlen, &j, xerr)) < 0)
+                goto done;
+        }
+        else if ((ret = json2xml_decode(x, xerr)) < 0)
             goto done;
         if (ret == 0) /* XXX necessary? */
             goto fail;
@@ -1537,12 +2043,16 @@ _json_parse(char      *str,
     retval = 1;
  done:
     clixon_debug(CLIXON_DBG_DEFAULT, "%s retval:%d", __FUNCTION__, retval);
-    if (cberr)
-        cbuf_free(cberr);
-    json_parse_exit(&jy);
-    json_scan_exit(&jy);
+    if (jy.jy_lexbuf){
+        json_parse_exit(&jy);
+        json_scan_exit(&jy);
+    }
+    if (_json_parse_fast && jy.jy_parse_string)
+        free(jy.jy_parse_string);
     if (jy.jy_xvec)
         free(jy.jy_xvec);
+    if (jy.jy_xidvec)
+        free(jy.jy_xidvec);
     return retval;
  fail: /* invalid */
     retval = 0;
@@ -1639,7 +2149,6 @@ clixon_json_parse_file(FILE      *fp,
     int       jsonbuflen = BUFLEN; /* start size */
     int       oldjsonbuflen;
     char     *ptr;
-    char      ch;
     int       len = 0;
 
     if (xt==NULL){
@@ -1653,12 +2162,12 @@ clixon_json_parse_file(FILE      *fp,
     memset(jsonbuf, 0, jsonbuflen);
     ptr = jsonbuf;
     while (1){
-        if ((ret = fread(&ch, 1, 1, fp)) < 0){
-            clicon_err(OE_JSON, errno, "read");
-            break;
+        ret = fread(jsonbuf+len, 1, jsonbuflen-1-len, fp);
+        len += ret;
+        if (ret == 0 && ferror(fp)){
+            clicon_err(OE_JSON, errno, "fread");
+            goto done;
         }
-        if (ret != 0)
-            jsonbuf[len++] = ch;
         if (ret == 0){
             if (*xt == NULL)
                 if ((*xt = xml_new(JSON_TOP_SYMBOL, NULL, CX_ELMNT)) == NULL)
@@ -49,6 +49,12 @@ struct clixon_json_yacc {
     cxobj    **jy_xvec;         /* Vector of created top-level nodes (to know which are created) */
     int        jy_xlen;         /* Length of jy_xvec */
     cbuf      *jy_cbuf_str;     /* cbuf used for strings, if error needs to be deallocated */
+    yang_stmt *jy_yspec;        /* Yang spec for namespace translation (fast parser) */
+    int        jy_rfc7951;      /* Check top-level namespaces according to RFC 7951 (fast parser) */
+    yang_bind  jy_yb;           /* How to bind yang to top-level (fast parser) */
+    int        jy_invalid;      /* Namespace invalid, xerr set, parsing continues (fast parser) */
+    cxobj    **jy_xidvec;       /* Nodes with prefixed string values, ie identityref candidates */
+    int        jy_xidlen;       /* Length of jy_xidvec */
 };
 typedef struct clixon_json_yacc clixon_json_yacc;
 
@@ -66,6 +72,11 @@ int json_scan_exit(clixon_json_yacc *jy);
 int json_parse_init(clixon_json_yacc *jy);
 int json_parse_exit(clixon_json_yacc *jy);
 
+int clixon_json_parse_fast(clixon_json_yacc *jy, cxobj **xerr);
+
+int json_xmlns_translate1(yang_stmt *yspec, cxobj *x, cxobj **xerr);
+int json_top_check(cxobj *x, int rfc7951, yang_bind yb, cxobj **xerr);
+
 int clixon_json_parselex(void *);
 int clixon_json_parseparse(void *);
 void clixon_json_parseerror(void *, char*);
@@ -0,0 +1,534 @@
+/*
+ *
+  ***** BEGIN LICENSE BLOCK *****
+ 
+  Copyright (C) 2009-2019 Olof Hagsand
+  Copyright (C) 2020-2022 Olof Hagsand and Rubicon Communications, LLC(Netgate)
+
+  This file is part of CLIXON.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  Alternatively, the contents of this file may be used under the terms of
+  the GNU General Public License Version 3 or later (the "GPL"),
+  in which case the provisions of the GPL are applicable instead
+  of those above. If you wish to allow use of your version of this file only
+  under the terms of the GPL, and not to allow others to
+  use your version of this file under the terms of Apache License version 2, 
+  indicate your decision by deleting the provisions above and replace them with
+  the  notice and other provisions required by the GPL. If you do not delete
+  the provisions above, a recipient may use your version of this file under
+  the terms of any one of the Apache License version 2 or the GPL.
+
+  ***** END LICENSE BLOCK *****
+
+ * Hand-written JSON parser, alternative to the flex/bison parser in clixon_json_parse.[ly]
+ * The parse string is parsed by recursive descent in a single pass and in place: strings are
+ * unescaped by compacting them within the parse string and NUL-terminated where they are, and
+ * numbers are terminated temporarily. No per-token strings are allocated.
+ * String contents are scanned with json_str_span, which is vectorized where supported.
+ * The resulting XML tree, and the accepted syntax, are the same as with the yacc parser.
+ * In addition, the following is made while parsing instead of in separate passes in _json_parse:
+ * - RFC 7951 check of top-level member names, see json_top_check
+ * - JSON module name to XML namespace translation, see json_xmlns_translate1
+ * - Nodes with prefixed string values are collected, they are the only possible identityrefs
+ *   that need to be decoded after yang binding, see json2xml_decode_vec
+ * @see http://www.ecma-international.org/publications/files/ECMA-ST/ECMA-404.pdf
+ *      RFC 7951 JSON Encoding of Data Modeled with YANG
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <stdlib.h>
+
+/* cligen */
+#include <cligen/cligen.h>
+
+/* clicon */
+#include "clixon_err.h"
+#include "clixon_log.h"
+#include "clixon_queue.h"
+#include "clixon_hash.h"
+#include "clixon_string.h"
+#include "clixon_handle.h"
+#include "clixon_yang.h"
+#include "clixon_xml.h"
+#include "clixon_json_parse.h"
+
+#define JF_WHITESPACE(c) ((c)==' ' || (c)=='\t' || (c)=='\n' || (c)=='\r')
+#define JF_DIGIT(c)      ((c)>='0' && (c)<='9')
+#define JF_HEX(c)        (JF_DIGIT(c) || ((c)>='a' && (c)<='f') || ((c)>='A' && (c)<='F'))
+
+/* Max nesting of objects and arrays, same as the default bison stack depth */
+#define JF_DEPTH_MAX 10000
+
+static int jf_value(clixon_json_yacc *jy, char **sp, char *prefix, char *id, int depth, cxobj **xerr);
+
+/*! Report parse error with line number, same format as yacc parser
+ *
+ * @param[in]  jy   JSON parser handler struct
+ * @param[in]  s    Position in parse string
+ * @param[in]  msg  Error message
+ */
+static void
+jf_error(clixon_json_yacc *jy,
+         char             *s,
+         char             *msg)
+{
+    char *p;
+
+    jy->jy_linenum = 1;
+    for (p = jy->jy_parse_string; p < s && *p; p++)
+        if (*p == '\n')
+            jy->jy_linenum++;
+    clicon_err(OE_JSON, 0, "json_parse: line %d: %s at or before: '%.16s'",
+               jy->jy_linenum, msg, s);
+}
+
+static char *
+jf_skipws(char *s)
+{
+    while (JF_WHITESPACE(*s))
+        s++;
+    return s;
+}
+
+/*! Parse and unescape string in place
+ *
+ * @param[in]     jy   JSON parser handler struct
+ * @param[in,out] sp   Parse position, on entry at opening quote, on exit after closing quote
+ * @param[out]    str  Unescaped and NUL-terminated string within the parse string
+ * @retval        0    OK
+ * @retval       -1    Error
+ */
+static int
+jf_string(clixon_json_yacc *jy,
+          char            **sp,
+          char            **str)
+{
+    int    retval = -1;
+    char  *r;        /* read position */
+    char  *w;        /* write position */
+    size_t n;
+    char   hex[5];
+    char   utf[5];
+
+    r = w = *str = *sp + 1;
+    while (1){
+        if ((n = json_str_span(r)) > 0){
+            if (w != r)
+                memmove(w, r, n);
+            w += n;
+            r += n;
+        }
+        if (*r == '\"')
+            break;
+        if (*r != '\\'){ /* Control character or end of string */
+            jf_error(jy, r, "syntax error");
+            goto done;
+        }
+        r++;
+        switch (*r){
+        case '\"':
+        case '\\':
+        case '/':
+            *w++ = *r++;
+            break;
+        case 'b':
+            *w++ = '\b'; r++;
+            break;
+        case 'f':
+            *w++ = '\f'; r++;
+            break;
+        case 'n':
+            *w++ = '\n'; r++;
+            break;
+        case 'r':
+            *w++ = '\r'; r++;
+            break;
+        case 't':
+            *w++ = '\t'; r++;
+            break;
+        case 'u':
+            r++;
+            if (!JF_HEX(r[0]) || !JF_HEX(r[1]) || !JF_HEX(r[2]) || !JF_HEX(r[3])){
+                jf_error(jy, r, "syntax error");
+                goto done;
+            }
+            memcpy(hex, r, 4);
+            hex[4] = '\0';
+            if (clixon_unicode2utf8(hex, utf, sizeof(utf)) < 0)
+                goto done;
+            n = strlen(utf);
+            memcpy(w, utf, n); /* utf-8 is never longer than \uXXXX */
+            w += n;
+            r += 4;
+            break;
+        default:
+            jf_error(jy, r, "syntax error");
+            goto done;
+        }
+    }
+    *w = '\0';
+    *sp = r + 1;
+    retval = 0;
+ done:
+    return retval;
+}
+
+/*! Scan number, same syntax as yacc parser
+ *
+ * @param[in]  s    Start of number
+ * @retval     e    End of number (first char after)
+ * @retval     NULL Not a number
+ */
+static char *
+jf_number(char *s)
+{
+    char *d;
+    char *f;
+
+    if (*s == '-')
+        s++;
+    for (d = s; JF_DIGIT(*s); s++)
+        ;
+    if (*s == '.'){
+        for (f = ++s; JF_DIGIT(*s); s++)
+            ;
+        if (s == f && f-1 == d) /* Only a dot */
+            return NULL;
+    }
+    else if (s == d)
+        return NULL;
+    if ((*s == 'e' || *s == 'E') && (s[1] == '+' || s[1] == '-') && JF_DIGIT(s[2]))
+        for (s += 2; JF_DIGIT(*s); s++)
+            ;
+    return s;
+}
+
+/*! Add body to current node
+ *
+ * Nodes with prefixed string values are collected since they may be identityrefs
+ * @param[in]  jy     JSON parser handler struct
+ * @param[in]  value  Body value, or NULL
+ * @param[in]  str    Value is a string
+ * @retval     0      OK
+ * @retval    -1      Error
+ */
+static int
+jf_body(clixon_json_yacc *jy,
+        char             *value,
+        int               str)
+{
+    int    retval = -1;
+    cxobj *xn;
+    cxobj *xp;
+
+    xp = jy->jy_current;
+    if ((xn = xml_new("body", xp, CX_BODY)) == NULL)
+        goto done;
+    if (value && xml_value_append(xn, value) < 0)
+        goto done;
+    if (str && xp != jy->jy_xtop && strchr(value, ':') != NULL &&
+        (jy->jy_xidlen == 0 || jy->jy_xidvec[jy->jy_xidlen-1] != xp)){
+        if (cxvec_append(xp, &jy->jy_xidvec, &jy->jy_xidlen) < 0)
+            goto done;
+    }
+    retval = 0;
+ done:
+    return retval;
+}
+
+/*! Create XML node from JSON member name and make it current
+ *
+ * Top-level names are checked and JSON module names are translated to XML namespaces.
+ * On the first invalid name, xerr is set and further checks are skipped, but parsing
+ * continues so that syntax errors are reported as with the yacc parser.
+ * @param[in]  jy     JSON parser handler struct
+ * @param[in]  prefix Prefix (module name) or NULL
+ * @param[in]  id     Name
+ * @param[out] xerr   Reason for invalid returned as netconf err msg
+ * @retval     0      OK
+ * @retval    -1      Error
+ */
+static int
+jf_member(clixon_json_yacc *jy,
+          char             *prefix,
+          char             *id,
+          cxobj           **xerr)
+{
+    int    retval = -1;
+    cxobj *x;
+    int    ret;
+
+    if ((x = xml_new(id, jy->jy_current, CX_ELMNT)) == NULL)
+        goto done;
+    if (prefix && xml_prefix_set(x, prefix) < 0)
+        goto done;
+    if (jy->jy_current == jy->jy_xtop){
+        if (cxvec_append(x, &jy->jy_xvec, &jy->jy_xlen) < 0)
+            goto done;
+        if (!jy->jy_invalid){
+            if ((ret = json_top_check(x, jy->jy_rfc7951, jy->jy_yb, xerr)) < 0)
+                goto done;
+            if (ret == 0)
+                jy->jy_invalid = 1;
+        }
+    }
+    if (!jy->jy_invalid){
+        if ((ret = json_xmlns_translate1(jy->jy_yspec, x, xerr)) < 0)
+            goto done;
+        if (ret == 0)
+            jy->jy_invalid = 1;
+    }
+    jy->jy_current = x;
+    retval = 0;
+ done:
+    return retval;
+}
+
+/*! Parse object: { "name" : value , ... }
+ *
+ * @param[in]     jy    JSON parser handler struct
+ * @param[in,out] sp    Parse position, on entry at '{'
+ * @param[in]     depth Nesting depth
+ * @param[out]    xerr  Reason for invalid returned as netconf err msg
+ * @retval        0     OK
+ * @retval       -1     Error
+ */
+static int
+jf_object(clixon_json_yacc *jy,
+          char            **sp,
+          int               depth,
+          cxobj           **xerr)
+{
+    int   retval = -1;
+    char *s = *sp;
+    char *name;
+    char *prefix;
+    char *id;
+
+    s = jf_skipws(s+1);
+    if (*s == '}')
+        goto ok;
+    while (1){
+        if (*s != '\"'){
+            jf_error(jy, s, "syntax error");
+            goto done;
+        }
+        if (jf_string(jy, &s, &name) < 0)
+            goto done;
+        s = jf_skipws(s);
+        if (*s != ':'){
+            jf_error(jy, s, "syntax error");
+            goto done;
+        }
+        s++;
+        /* Split name into prefix:id (extended JSON RFC7951) */
+        if ((id = strchr(name, ':')) != NULL){
+            *id++ = '\0';
+            prefix = name;
+        }
+        else{
+            id = name;
+            prefix = NULL;
+        }
+        if (jf_member(jy, prefix, id, xerr) < 0)
+            goto done;
+        if (jf_value(jy, &s, prefix, id, depth, xerr) < 0)
+            goto done;
+        jy->jy_current = xml_parent(jy->jy_current);
+        s = jf_skipws(s);
+        if (*s == '}')
+            break;
+        if (*s != ','){
+            jf_error(jy, s, "syntax error");
+            goto done;
+        }
+        s = jf_skipws(s+1);
+    }
+ ok:
+    *sp = s + 1;
+    retval = 0;
+ done:
+    return retval;
+}
+
+/*! Parse array: [ value , ... ]
+ *
+ * The first value is added to the current node, a copy of the current node is created
+ * for each following value, as with the yacc parser.
+ * @param[in]     jy     JSON parser handler struct
+ * @param[in,out] sp     Parse position, on entry at '['
+ * @param[in]     prefix Prefix of current node or NULL
+ * @param[in]     id     Name of current node or NULL if top-level
+ * @param[in]     depth  Nesting depth
+ * @param[out]    xerr   Reason for invalid returned as netconf err msg
+ * @retval        0      OK
+ * @retval       -1      Error
+ */
+static int
+jf_array(clixon_json_yacc *jy,
+         char            **sp,
+         char             *prefix,
+         char             *id,
+         int               depth,
+         cxobj           **xerr)
+{
+    int   retval = -1;
+    char *s = *sp;
+
+    s = jf_skipws(s+1);
+    if (*s == ']')
+        goto ok;
+    while (1){
+        if (jf_value(jy, &s, prefix, id, depth, xerr) < 0)
+            goto done;
+        s = jf_skipws(s);
+        if (*s == ']')
+            break;
+        if (*s != ','){
+            jf_error(jy, s, "syntax error");
+            goto done;
+        }
+        s++;
+        if (jy->jy_current != jy->jy_xtop && id != NULL){
+            jy->jy_current = xml_parent(jy->jy_current);
+            if (jf_member(jy, prefix, id, xerr) < 0)
+                goto done;
+        }
+    }
+ ok:
+    *sp = s + 1;
+    retval = 0;
+ done:
+    return retval;
+}
+
+/*! Parse value and add it to current node
+ *
+ * @param[in]     jy     JSON parser handler struct
+ * @param[in,out] sp     Parse position, on exit after value
+ * @param[in]     prefix Prefix of current node or NULL
+ * @param[in]     id     Name of current node or NULL if top-level
+ * @param[in]     depth  Nesting depth
+ * @param[out]    xerr   Reason for invalid returned as netconf err msg
+ * @retval        0      OK
+ * @retval       -1      Error
+ */
+static int
+jf_value(clixon_json_yacc *jy,
+         char            **sp,
+         char             *prefix,
+         char             *id,
+         int               depth,
+         cxobj           **xerr)
+{
+    int   retval = -1;
+    char *s;
+    char *e;
+    char *str;
+    char  c;
+
+    s = jf_skipws(*sp);
+    switch (*s){
+    case '{':
+    case '[':
+        if (depth >= JF_DEPTH_MAX){
+            jf_error(jy, s, "memory exhausted");
+            goto done;
+        }
+        if (*s == '{'){
+            if (jf_object(jy, &s, depth+1, xerr) < 0)
+                goto done;
+        }
+        else if (jf_array(jy, &s, prefix, id, depth+1, xerr) < 0)
+            goto done;
+        break;
+    case '\"':
+        if (jf_string(jy, &s, &str) < 0)
+            goto done;
+        if (jf_body(jy, str, 1) < 0)
+            goto done;
+        break;
+    case 't':
+        if (strncmp(s, "true", 4) != 0)
+            goto syntax;
+        if (jf_body(jy, "true", 0) < 0)
+            goto done;
+        s += 4;
+        break;
+    case 'f':
+        if (strncmp(s, "false", 5) != 0)
+            goto syntax;
+        if (jf_body(jy, "false", 0) < 0)
+            goto done;
+        s += 5;
+        break;
+    case 'n':
+        if (strncmp(s, "null", 4) != 0)
+            goto syntax;
+        if (jf_body(jy, NULL, 0) < 0)
+            goto done;
+        s += 4;
+        break;
+    default:
+        if ((e = jf_number(s)) == NULL)
+            goto syntax;
+        c = *e;
+        *e = '\0';
+        if (jf_body(jy, s, 0) < 0)
+            goto done;
+        *e = c;
+        s = e;
+        break;
+    }
+    *sp = s;
+    retval = 0;
+ done:
+    return retval;
+ syntax:
+    jf_error(jy, s, "syntax error");
+    goto done;
+}
+
+/*! Parse JSON string in jy_parse_string into jy_xtop
+ *
+ * The parse string is modified.
+ * @param[in]  jy    JSON parser handler struct
+ * @param[out] xerr  Reason for invalid returned as netconf err msg
+ * @retval     1     OK
+ * @retval     0     Invalid namespace or top-level name, xerr set
+ * @retval    -1     Error with clicon_err called
+ */
+int
+clixon_json_parse_fast(clixon_json_yacc *jy,
+                       cxobj           **xerr)
+{
+    int   retval = -1;
+    char *s;
+
+    s = jy->jy_parse_string;
+    if (jf_value(jy, &s, NULL, NULL, 0, xerr) < 0)
+        goto done;
+    s = jf_skipws(s);
+    if (*s != '\0'){
+        jf_error(jy, s, "syntax error");
+        goto done;
+    }
+    retval = jy->jy_invalid ? 0 : 1;
+ done:
+    return retval;
+}
@@ -0,0 +1,533 @@
+/*
+ *
+  ***** BEGIN LICENSE BLOCK *****
+ 
+  Copyright (C) 2009-2016 Olof Hagsand and Benny Holmgren
+  Copyright (C) 2017-2019 Olof Hagsand
+  Copyright (C) 2020-2022 Olof Hagsand and Rubicon Communications, LLC(Netgate)
+
+  This file is part of CLIXON.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  Alternatively, the contents of this file may be used under the terms of
+  the GNU General Public License Version 3 or later (the "GPL"),
+  in which case the provisions of the GPL are applicable instead
+  of those above. If you wish to allow use of your version of this file only
+  under the terms of the GPL, and not to allow others to
+  use your version of this file under the terms of Apache License version 2, 
+  indicate your decision by deleting the provisions above and replace them with
+  the  notice and other provisions required by the GPL. If you do not delete
+  the provisions above, a recipient may use your version of this file under
+  the terms of any one of the Apache License version 2 or the GPL.
+
+  ***** END LICENSE BLOCK *****
+
+ *
+ * Index of leafref target values used by validation.
+ * Validating a leafref evaluates its path and scans the result for the value of the
+ * referring node, which is O(n*m) for n references to m targets. Instead, the target
+ * values of a path are evaluated once into a hashed string set, and each reference is a
+ * lookup in that set.
+ * A path is indexed if its result is the same for all referring nodes with a common
+ * ancestor, ie it uses no current(), deref() or "..", except as leading steps. Other paths
+ * are evaluated from each referring node.
+ * The index refers to bodies in the data tree and is only valid while the tree is unchanged.
+ * It therefore only exists during one validation, see leafref_index_begin/end.
+ */
+#ifdef HAVE_CONFIG_H
+#include "clixon_config.h" /* generated by config & autoconf */
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <errno.h>
+#include <ctype.h>
+#include <string.h>
+#include <syslog.h>
+
+/* cligen */
+#include <cligen/cligen.h>
+
+/* clicon */
+#include "clixon_string.h"
+#include "clixon_queue.h"
+#include "clixon_hash.h"
+#include "clixon_handle.h"
+#include "clixon_err.h"
+#include "clixon_log.h"
+#include "clixon_yang.h"
+#include "clixon_xml.h"
+#include "clixon_data.h"
+#include "clixon_xml_nsctx.h"
+#include "clixon_xpath_ctx.h"
+#include "clixon_xpath.h"
+#include "clixon_leafref.h"
+
+/* Name of leafref index in clixon handle */
+#define LEAFREF_INDEX_NAME "leafref_index"
+
+/* Initial size of hash tables, must be a power of two */
+#define LEAFREF_HASH_INIT 16
+
+/* Set of strings, open addressing with linear probing. Strings are not copied */
+struct leafref_set{
+    char   **ls_tab;
+    uint32_t ls_mask;   /* Table size minus one, size is a power of two */
+    uint32_t ls_len;    /* Number of strings */
+};
+
+/* Target values of a leafref path evaluated from a context node */
+struct leafref_target{
+    char        *lt_path;   /* Path argument after leading ".." steps */
+    yang_stmt   *lt_ymod;   /* Module of referring node, defines prefixes of path */
+    cxobj       *lt_xctx;   /* Context node of path */
+    leafref_set *lt_set;    /* Target values */
+};
+
+/* Index of leafref targets, open addressing with linear probing */
+struct leafref_index{
+    struct leafref_target **li_tab;
+    uint32_t                li_mask;
+    uint32_t                li_len;
+};
+
+/*! FNV-1a hash of string
+ */
+static uint32_t
+leafref_hash(const char *str)
+{
+    uint32_t h = 2166136261U;
+
+    while (*str){
+        h ^= (uint8_t)*str++;
+        h *= 16777619U;
+    }
+    return h;
+}
+
+/*! FNV-1a hash of leafref target key
+ */
+static uint32_t
+leafref_target_hash(char      *path,
+                    yang_stmt *ymod,
+                    cxobj     *xctx)
+{
+    uintptr_t key[3];
+    uint8_t  *b = (uint8_t*)key;
+    uint32_t  h = 2166136261U;
+    size_t    i;
+
+    key[0] = (uintptr_t)path;
+    key[1] = (uintptr_t)ymod;
+    key[2] = (uintptr_t)xctx;
+    for (i = 0; i < sizeof(key); i++){
+        h ^= b[i];
+        h *= 16777619U;
+    }
+    return h;
+}
+
+/*! Create a new empty string set
+ *
+ * @retval     ls    String set, free with leafref_set_free
+ * @retval     NULL  Error
+ */
+leafref_set *
+leafref_set_new(void)
+{
+    leafref_set *ls;
+
+    if ((ls = malloc(sizeof(*ls))) == NULL){
+        clicon_err(OE_UNIX, errno, "malloc");
+        return NULL;
+    }
+    memset(ls, 0, sizeof(*ls));
+    if ((ls->ls_tab = calloc(LEAFREF_HASH_INIT, sizeof(char*))) == NULL){
+        clicon_err(OE_UNIX, errno, "calloc");
+        free(ls);
+        return NULL;
+    }
+    ls->ls_mask = LEAFREF_HASH_INIT - 1;
+    return ls;
+}
+
+/*! Double size of string set hash table
+ */
+static int
+leafref_set_grow(leafref_set *ls)
+{
+    char   **tab;
+    uint32_t mask;
+    uint32_t i;
+    uint32_t j;
+
+    mask = 2*(ls->ls_mask + 1) - 1;
+    if ((tab = calloc(mask + 1, sizeof(char*))) == NULL){
+        clicon_err(OE_UNIX, errno, "calloc");
+        return -1;
+    }
+    for (i = 0; i <= ls->ls_mask; i++){
+        if (ls->ls_tab[i] == NULL)
+            continue;
+        j = leafref_hash(ls->ls_tab[i]) & mask;
+        while (tab[j] != NULL)
+            j = (j + 1) & mask;
+        tab[j] = ls->ls_tab[i];
+    }
+    free(ls->ls_tab);
+    ls->ls_tab = tab;
+    ls->ls_mask = mask;
+    return 0;
+}
+
+/*! Add string to set
+ *
+ * @param[in]  ls     String set
+ * @param[in]  value  String, not copied, must exist as long as the set
+ * @retval     1      Added
+ * @retval     0      Already in set
+ * @retval    -1      Error
+ */
+int
+leafref_set_add(leafref_set *ls,
+                char        *value)
+{
+    uint32_t i;
+
+    i = leafref_hash(value) & ls->ls_mask;
+    while (ls->ls_tab[i] != NULL){
+        if (strcmp(ls->ls_tab[i], value) == 0)
+            return 0;
+        i = (i + 1) & ls->ls_mask;
+    }
+    ls->ls_tab[i] = value;
+    /* Keep load below one half */
+    if (2*(++ls->ls_len) > ls->ls_mask)
+        if (leafref_set_grow(ls) < 0)
+            return -1;
+    return 1;
+}
+
+/*! Check if string is in set
+ *
+ * @param[in]  ls     String set
+ * @param[in]  value  String
+ * @retval     1      Found
+ * @retval     0      Not found
+ */
+int
+leafref_set_find(leafref_set *ls,
+                 const char  *value)
+{
+    uint32_t i;
+
+    i = leafref_hash(value) & ls->ls_mask;
+    while (ls->ls_tab[i] != NULL){
+        if (strcmp(ls->ls_tab[i], value) == 0)
+            return 1;
+        i = (i + 1) & ls->ls_mask;
+    }
+    return 0;
+}
+
+/*! Free string set, not the strings
+ */
+int
+leafref_set_free(leafref_set *ls)
+{
+    if (ls->ls_tab)
+        free(ls->ls_tab);
+    free(ls);
+    return 0;
+}
+
+/*! Lookup leafref target in index
+ */
+static struct leafref_target *
+leafref_index_lookup(struct leafref_index *li,
+                     char                 *path,
+                     yang_stmt            *ymod,
+                     cxobj                *xctx)
+{
+    struct leafref_target *lt;
+    uint32_t               i;
+
+    i = leafref_target_hash(path, ymod, xctx) & li->li_mask;
+    while ((lt = li->li_tab[i]) != NULL){
+        if (lt->lt_path == path && lt->lt_ymod == ymod && lt->lt_xctx == xctx)
+            return lt;
+        i = (i + 1) & li->li_mask;
+    }
+    return NULL;
+}
+
+/*! Insert leafref target in index table, no duplicate check
+ */
+static void
+leafref_index_insert1(struct leafref_target **tab,
+                      uint32_t                mask,
+                      struct leafref_target  *lt)
+{
+    uint32_t i;
+
+    i = leafref_target_hash(lt->lt_path, lt->lt_ymod, lt->lt_xctx) & mask;
+    while (tab[i] != NULL)
+        i = (i + 1) & mask;
+    tab[i] = lt;
+}
+
+/*! Add leafref target to index, grow table if needed
+ */
+static int
+leafref_index_add(struct leafref_index  *li,
+                  struct leafref_target *lt)
+{
+    struct leafref_target **tab;
+    uint32_t                mask;
+    uint32_t                i;
+
+    leafref_index_insert1(li->li_tab, li->li_mask, lt);
+    if (2*(++li->li_len) > li->li_mask){
+        mask = 2*(li->li_mask + 1) - 1;
+        if ((tab = calloc(mask + 1, sizeof(*tab))) == NULL){
+            clicon_err(OE_UNIX, errno, "calloc");
+            return -1;
+        }
+        for (i = 0; i <= li->li_mask; i++)
+            if (li->li_tab[i] != NULL)
+                leafref_index_insert1(tab, mask, li->li_tab[i]);
+        free(li->li_tab);
+        li->li_tab = tab;
+        li->li_mask = mask;
+    }
+    return 0;
+}
+
+/*! Evaluate leafref path from context node and add target values to index
+ *
+ * @param[in]  li     Leafref index
+ * @param[in]  ys     Referring yang node, for path prefixes
+ * @param[in]  path   Path argument after leading ".." steps
+ * @param[in]  xctx   Context node
+ * @retval     lt     Leafref target
+ * @retval     NULL   Error
+ */
+static struct leafref_target *
+leafref_target_create(struct leafref_index *li,
+                      yang_stmt            *ys,
+                      char                 *path,
+                      cxobj                *xctx)
+{
+    struct leafref_target *retval = NULL;
+    struct leafref_target *lt = NULL;
+    cvec                  *nsc = NULL;
+    cxobj                **xvec = NULL;
+    size_t                 xlen = 0;
+    char                  *body;
+    int                    i;
+
+    if ((lt = malloc(sizeof(*lt))) == NULL){
+        clicon_err(OE_UNIX, errno, "malloc");
+        goto done;
+    }
+    memset(lt, 0, sizeof(*lt));
+    lt->lt_path = path;
+    lt->lt_ymod = ys_module(ys);
+    lt->lt_xctx = xctx;
+    if ((lt->lt_set = leafref_set_new()) == NULL)
+        goto done;
+    if (xml_nsctx_yang(ys, &nsc) < 0)
+        goto done;
+    if (xpath_vec(xctx, nsc, "%s", &xvec, &xlen, path) < 0)
+        goto done;
+    for (i = 0; i < xlen; i++){
+        if ((body = xml_body(xvec[i])) == NULL)
+            continue;
+        if (leafref_set_add(lt->lt_set, body) < 0)
+            goto done;
+    }
+    if (leafref_index_add(li, lt) < 0)
+        goto done;
+    retval = lt;
+    lt = NULL;
+ done:
+    if (lt){
+        if (lt->lt_set)
+            leafref_set_free(lt->lt_set);
+        free(lt);
+    }
+    if (nsc)
+        xml_nsctx_free(nsc);
+    if (xvec)
+        free(xvec);
+    return retval;
+}
+
+/*! Get context node of leafref path if the path can be indexed
+ *
+ * An absolute path has the root as context. Leading ".." steps of a relative path are
+ * replaced by the corresponding ancestor of the referring node.
+ * @param[in]  xt     Referring node
+ * @param[in]  path0  Path argument
+ * @param[out] path   Path argument after leading ".." steps
+ * @param[out] xctx   Context node
+ * @retval     1      Path can be indexed
+ * @retval     0      Path depends on referring node, or ancestor not found
+ */
+static int
+leafref_path_context(cxobj  *xt,
+                     char   *path0,
+                     char  **path,
+                     cxobj **xctx)
+{
+    char  *p = path0;
+    cxobj *x = xt;
+
+    while (isspace((unsigned char)*p))
+        p++;
+    if (*p == '/')
+        x = xml_root(xt);
+    else
+        while (strncmp(p, "../", 3) == 0){
+            if ((x = xml_parent(x)) == NULL)
+                return 0;
+            p += 3;
+        }
+    if (*p == '\0' ||
+        strstr(p, "..") != NULL ||
+        strstr(p, "current") != NULL ||
+        strstr(p, "deref") != NULL)
+        return 0;
+    *path = p;
+    *xctx = x;
+    return 1;
+}
+
+/*! Create leafref index for one validation, unless already created
+ *
+ * @param[in]  h   Clixon handle
+ * @retval     1   Created, caller should call leafref_index_end after validation
+ * @retval     0   Already exists
+ * @retval    -1   Error
+ */
+int
+leafref_index_begin(clicon_handle h)
+{
+    struct leafref_index *li = NULL;
+
+    if (clicon_ptr_get(h, LEAFREF_INDEX_NAME, (void**)&li) == 0 && li != NULL)
+        return 0;
+    if ((li = malloc(sizeof(*li))) == NULL){
+        clicon_err(OE_UNIX, errno, "malloc");
+        return -1;
+    }
+    memset(li, 0, sizeof(*li));
+    if ((li->li_tab = calloc(LEAFREF_HASH_INIT, sizeof(*li->li_tab))) == NULL){
+        clicon_err(OE_UNIX, errno, "calloc");
+        free(li);
+        return -1;
+    }
+    li->li_mask = LEAFREF_HASH_INIT - 1;
+    if (clicon_ptr_set(h, LEAFREF_INDEX_NAME, li) < 0){
+        free(li->li_tab);
+        free(li);
+        return -1;
+    }
+    return 1;
+}
+
+/*! Remove and free leafref index
+ *
+ * @param[in]  h   Clixon handle
+ */
+int
+leafref_index_end(clicon_handle h)
+{
+    struct leafref_index  *li = NULL;
+    struct leafref_target *lt;
+    uint32_t               i;
+
+    if (clicon_ptr_get(h, LEAFREF_INDEX_NAME, (void**)&li) == 0 && li != NULL){
+        for (i = 0; i <= li->li_mask; i++){
+            if ((lt = li->li_tab[i]) == NULL)
+                continue;
+            leafref_set_free(lt->lt_set);
+            free(lt);
+        }
+        free(li->li_tab);
+        free(li);
+        clicon_ptr_del(h, LEAFREF_INDEX_NAME);
+    }
+    return 0;
+}
+
+/*! Check if a leafref path from a referring node has a target with a given value
+ *
+ * Use the leafref index if it exists and the path can be indexed, otherwise evaluate the
+ * path from the referring node and scan the result.
+ * @param[in]  h         Clixon handle
+ * @param[in]  xt        Referring XML node, context of path
+ * @param[in]  ys        Yang node of referring node, for path prefixes
+ * @param[in]  path_arg  Leafref path argument
+ * @param[in]  value     Value of referring node
+ * @retval     1         Target found
+ * @retval     0         No target with value
+ * @retval    -1         Error
+ */
+int
+leafref_target_find(clicon_handle h,
+                    cxobj        *xt,
+                    yang_stmt    *ys,
+                    char         *path_arg,
+                    const char   *value)
+{
+    int                    retval = -1;
+    struct leafref_index  *li = NULL;
+    struct leafref_target *lt;
+    cvec                  *nsc = NULL;
+    cxobj                **xvec = NULL;
+    size_t                 xlen = 0;
+    cxobj                 *xctx;
+    char                  *path;
+    char                  *body;
+    int                    i;
+
+    if (h != NULL &&
+        clicon_ptr_get(h, LEAFREF_INDEX_NAME, (void**)&li) == 0 && li != NULL &&
+        leafref_path_context(xt, path_arg, &path, &xctx) == 1){
+        if ((lt = leafref_index_lookup(li, path, ys_module(ys), xctx)) == NULL &&
+            (lt = leafref_target_create(li, ys, path, xctx)) == NULL)
+            goto done;
+        retval = leafref_set_find(lt->lt_set, value);
+        goto done;
+    }
+    if (xml_nsctx_yang(ys, &nsc) < 0)
+        goto done;
+    if (xpath_vec(xt, nsc, "%s", &xvec, &xlen, path_arg) < 0)
+        goto done;
+    for (i = 0; i < xlen; i++){
+        if ((body = xml_body(xvec[i])) == NULL)
+            continue;
+        if (strcmp(body, value) == 0)
+            break;
+    }
+    retval = i < xlen;
+ done:
+    if (nsc)
+        xml_nsctx_free(nsc);
+    if (xvec)
+        free(xvec);
+    return retval;
+}
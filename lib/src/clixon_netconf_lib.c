@@ -69,6 +69,7 @@
 #include "clixon_xml_bind.h"
 #include "clixon_xml_map.h"
 #include "clixon_xml_io.h"
+#include "clixon_json.h"
 #include "clixon_xpath_ctx.h"
 #include "clixon_xpath.h"
 #include "clixon_yang_module.h"
@@ -1688,12 +1689,21 @@ netconf_module_load(clicon_handle h)
     /* Make message-id attribute optional */
     if (clicon_option_bool(h, "CLICON_NETCONF_MESSAGE_ID_OPTIONAL") == 1)
         xml_bind_netconf_message_id_optional(1);
+    /* Use hand-written XML parser */
+    if (clicon_option_bool(h, "CLICON_XML_FAST_PARSER") == 1)
+        clixon_xml_parse_fast_set(1);
+    /* Use hand-written JSON parser */
+    if (clicon_option_bool(h, "CLICON_JSON_FAST_PARSER") == 1)
+        clixon_json_parse_fast_set(1);
     /* Load ietf list pagination */
     if (yang_spec_parse_module(h, "ietf-list-pagination", NULL, yspec)< 0)
         goto done;
     /* Load ietf list pagination netconf */
     if (yang_spec_parse_module(h, "ietf-list-pagination-nc", NULL, yspec)< 0)
         goto done;
+    /* Clixon deviations of list pagination */
+    if (yang_spec_parse_module(h, "clixon-list-pagination", NULL, yspec)< 0)
+        goto done;
     /* RFC6243 With-defaults Capability for NETCONF */
     if (yang_spec_parse_module(h, "ietf-netconf-with-defaults", NULL, yspec)< 0)
         goto done;
@@ -1129,9 +1129,11 @@ clicon_rpc_get2(clicon_handle   h,
  * @param[in]  defaults  Value of the with-defaults mode, rfc6243, or NULL
  * @param[in]  offset    0 means none
  * @param[in]  limit     0 means unbounded
- * @param[in]  direction Collection/clixon extension
- * @param[in]  sort      Collection/clixon extension
- * @param[in]  where     Collection/clixon extension
+ * @param[in]  direction "forwards" or "backwards", or NULL
+ * @param[in]  sort      Descendant node to sort on (sort-by), or NULL
+ * @param[in]  where     XPath boolean expression on entries, or NULL
+ * @param[in]  sublimit  Limit of descendant lists, 0 means unbounded
+ * @param[in]  cursor    Keyset pagination: get entries after this cursor, "" is first, or NULL
  * @param[out] xt        XML tree. Free with xml_free. 
  *                       Either <config> or <rpc-error>. 
  * @retval     0         OK
@@ -1153,6 +1155,8 @@ clicon_rpc_get_pageable_list(clicon_handle   h,
                              char           *direction,
                              char           *sort,
                              char           *where,
+                             uint32_t        sublimit,
+                             char           *cursor,
                              cxobj         **xt)
 {
     int                retval = -1;
@@ -1166,6 +1170,7 @@ clicon_rpc_get_pageable_list(clicon_handle   h,
     int                ret;
     yang_stmt         *yspec;
     cvec              *nscd = NULL;
+    char              *enc = NULL;
 
     if (datastore == NULL){
         clicon_err(OE_XML, EINVAL, "datastore not given");
@@ -1214,7 +1219,14 @@ clicon_rpc_get_pageable_list(clicon_handle   h,
                 IETF_NETCONF_WITH_DEFAULTS_YANG_NAMESPACE,
                 defaults);
     /* Explicit use of list-pagination */
-    cprintf(cb, "<list-pagination xmlns=\"%s\">", IETF_PAGINATON_NC_NAMESPACE);
+    cprintf(cb, "<list-pagination xmlns=\"%s\"", IETF_PAGINATON_NC_NAMESPACE);
+    if (cursor){
+        if (xml_chardata_encode(&enc, "%s", cursor) < 0)
+            goto done;
+        cprintf(cb, " %s:cursor=\"%s\" xmlns:%s=\"%s\"",
+                CLIXON_LIB_PREFIX, enc, CLIXON_LIB_PREFIX, CLIXON_LIB_NS);
+    }
+    cprintf(cb, ">");
     if (offset != 0)
         cprintf(cb, "<offset>%u</offset>", offset);
     if (limit != 0)
@@ -1222,9 +1234,18 @@ clicon_rpc_get_pageable_list(clicon_handle   h,
     if (direction)
         cprintf(cb, "<direction>%s</direction>", direction);
     if (sort)
-        cprintf(cb, "<sort>%s</sort>", sort);
-    if (where)
-        cprintf(cb, "<where>%s</where>", where);
+        cprintf(cb, "<sort-by>%s</sort-by>", sort);
+    if (where){
+        if (enc){
+            free(enc);
+            enc = NULL;
+        }
+        if (xml_chardata_encode(&enc, "%s", where) < 0)
+            goto done;
+        cprintf(cb, "<where>%s</where>", enc);
+    }
+    if (sublimit != 0)
+        cprintf(cb, "<sublist-limit>%u</sublist-limit>", sublimit);
     cprintf(cb, "</list-pagination>");
     cprintf(cb, "</get>");
     cprintf(cb, "</rpc>");
@@ -1271,6 +1292,8 @@ clicon_rpc_get_pageable_list(clicon_handle   h,
     }
     retval = 0;
   done:
+    if (enc)
+        free(enc);
     if (nscd)
         cvec_free(nscd);
     if (cb)
@@ -1743,6 +1766,80 @@ clicon_rpc_debug(clicon_handle h,
     return retval;
 }
 
+/*! Get datastore generation from backend server
+ *
+ * The generation changes whenever any datastore changes in the backend, a client can
+ * compare it with a previously read value to see if cached config is still valid.
+ * @param[in]  h    Clixon handle
+ * @param[out] gen  Datastore generation
+ * @retval     0    OK
+ * @retval    -1    Error and logged to syslog
+ * @see xmldb_generation_get
+ */
+int
+clicon_rpc_datastore_generation(clicon_handle h,
+                                uint32_t     *gen)
+{
+    int                retval = -1;
+    struct clicon_msg *msg = NULL;
+    cxobj             *xret = NULL;
+    cxobj             *xerr;
+    cxobj             *x;
+    char              *username;
+    uint32_t           session_id;
+    cbuf              *cb = NULL;
+    char              *reason = NULL;
+    int                ret;
+
+    if (session_id_check(h, &session_id) < 0)
+        goto done;
+    if ((cb = cbuf_new()) == NULL){
+        clicon_err(OE_XML, errno, "cbuf_new");
+        goto done;
+    }
+    cprintf(cb, "<rpc xmlns=\"%s\"", NETCONF_BASE_NAMESPACE);
+    cprintf(cb, " xmlns:%s=\"%s\"", NETCONF_BASE_PREFIX, NETCONF_BASE_NAMESPACE);
+    if ((username = clicon_username_get(h)) != NULL){
+        cprintf(cb, " %s:username=\"%s\"", CLIXON_LIB_PREFIX, username);
+        cprintf(cb, " xmlns:%s=\"%s\"", CLIXON_LIB_PREFIX, CLIXON_LIB_NS);
+    }
+    cprintf(cb, " %s", NETCONF_MESSAGE_ID_ATTR); /* XXX: use incrementing sequence */
+    cprintf(cb, ">");
+    cprintf(cb, "<datastore-generation xmlns=\"%s\"/>", CLIXON_LIB_NS);
+    cprintf(cb, "</rpc>");
+    if ((msg = clicon_msg_encode(session_id, "%s", cbuf_get(cb))) == NULL)
+        goto done;
+    if (clicon_rpc_msg(h, msg, &xret) < 0)
+        goto done;
+    if ((xerr = xpath_first(xret, NULL, "//rpc-error")) != NULL){
+        clixon_netconf_error(h, xerr, "Datastore generation", NULL);
+        goto done;
+    }
+    if ((x = xpath_first(xret, NULL, "//rpc-reply/generation")) == NULL){
+        clicon_err(OE_XML, 0, "rpc error: no generation in reply");
+        goto done;
+    }
+    if ((ret = parse_uint32(xml_body(x), gen, &reason)) < 0){
+        clicon_err(OE_XML, errno, "parse_uint32");
+        goto done;
+    }
+    if (ret == 0){
+        clicon_err(OE_XML, 0, "generation: %s", reason);
+        goto done;
+    }
+    retval = 0;
+ done:
+    if (reason)
+        free(reason);
+    if (cb)
+        cbuf_free(cb);
+    if (msg)
+        free(msg);
+    if (xret)
+        xml_free(xret);
+    return retval;
+}
+
 /*! Send a debug request to backend server to set restconf debug
  *
  * @param[in] h        Clixon handle
@@ -38,6 +38,8 @@
  * 1) Base stream handling: stream_find/register/delete_all/get_xml
  * 2) Stream subscription handling (stream_ss_add/delete/timeout, stream_notify, etc
  * 3) Stream replay: stream_replay/_add
+ *    The replay buffer is kept in memory, or on disk if CLICON_STREAM_REPLAY_DIR is set,
+ *    see clixon_stream_replay.c
  * 4) nginx/nchan publish code (use --enable-publish config option)
  *
  *
@@ -86,6 +88,7 @@
 #include "clixon_xpath_ctx.h"
 #include "clixon_xpath.h"
 #include "clixon_stream.h"
+#include "clixon_stream_replay.h"
 
 /* Go through and timeout subscription timers [s] */
 #define STREAM_TIMER_TIMEOUT_S 5
@@ -133,6 +136,8 @@ stream_add(clicon_handle   h,
 {
     int             retval = -1;
     event_stream_t *es;
+    char           *dir;
+    int             segment;
 
     if ((es = stream_find(h, name)) != NULL)
         goto ok;
@@ -152,6 +157,12 @@ stream_add(clicon_handle   h,
     es->es_replay_enabled = replay_enabled;
     if (retention)
         es->es_retention = *retention;
+    if (replay_enabled &&
+        (dir = clicon_option_str(h, "CLICON_STREAM_REPLAY_DIR")) != NULL){
+        segment = clicon_option_int(h, "CLICON_STREAM_REPLAY_SEGMENT");
+        if ((es->es_replay_log = replay_log_open(dir, name, segment)) == NULL)
+            goto done;
+    }
     clicon_stream_append(h, es);
  ok:
     retval = 0;
@@ -189,6 +200,8 @@ stream_delete_all(clicon_handle h,
                 xml_free(r->r_xml);
             free(r);
         }
+        if (es->es_replay_log)
+            replay_log_close(es->es_replay_log);
         free(es);
     }
     return 0;
@@ -287,7 +300,12 @@ stream_timer_setup(int   fd,
                         ss = NEXTQ(struct stream_subscription *, ss);
                 } while (ss && ss != es->es_subscription);
   /* 2) Go throughreplay buffer and remove entries with passed retention time */
-            if (timerisset(&es->es_retention) &&
+            if (timerisset(&es->es_retention) && es->es_replay_log){
+                timersub(&now, &es->es_retention, &tret);
+                if (replay_log_retention(es->es_replay_log, &tret) < 0)
+                    goto done;
+            }
+            else if (timerisset(&es->es_retention) &&
                 (r = es->es_replay) != NULL){
                 timersub(&now, &es->es_retention, &tret);
                 do {
@@ -732,6 +750,13 @@ stream_replay_notify(clicon_handle               h,
         goto ok;
     if (!es->es_replay_enabled)
         goto ok;
+    /* Seek in on-disk log using its time index */
+    if (es->es_replay_log){
+        if (replay_log_replay(h, es->es_replay_log, &ss->ss_starttime, &ss->ss_stoptime,
+                              ss->ss_fn, ss->ss_arg) < 0)
+            goto done;
+        goto ok;
+    }
     /* Get replay linked list */
     if ((r = es->es_replay) == NULL)
         goto ok;
@@ -762,7 +787,7 @@ stream_replay_notify(clicon_handle               h,
  *
  * @param[in] es   Stream
  * @param[in] tv   Timestamp
- * @param[in] xv   XML
+ * @param[in] xv   XML, consumed: stored in memory or freed after written to disk
  * @retval    0    OK
  * @retval   -1    Error
  */
@@ -774,6 +799,12 @@ stream_replay_add(event_stream_t *es,
     int                   retval = -1;
     struct stream_replay *new;
 
+    if (es->es_replay_log){
+        if (replay_log_append(es->es_replay_log, tv, xv) < 0)
+            goto done;
+        xml_free(xv);
+        goto ok;
+    }
     if ((new = malloc(sizeof *new)) == NULL){
         clicon_err(OE_UNIX, errno, "malloc");
         goto done;
@@ -782,6 +813,7 @@ stream_replay_add(event_stream_t *es,
     new->r_tv = *tv;
     new->r_xml = xv;
     ADDQ(new, es->es_replay);
+ ok:
     retval = 0;
  done:
     return retval;
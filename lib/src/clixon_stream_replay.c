@@ -0,0 +1,704 @@
+/*
+ *
+  ***** BEGIN LICENSE BLOCK *****
+
+  Copyright (C) 2009-2016 Olof Hagsand and Benny Holmgren
+  Copyright (C) 2017-2019 Olof Hagsand
+  Copyright (C) 2020-2022 Olof Hagsand and Rubicon Communications, LLC(Netgate)
+
+  This file is part of CLIXON.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  Alternatively, the contents of this file may be used under the terms of
+  the GNU General Public License Version 3 or later (the "GPL"),
+  in which case the provisions of the GPL are applicable instead
+  of those above. If you wish to allow use of your version of this file only
+  under the terms of the GPL, and not to allow others to
+  use your version of this file under the terms of Apache License version 2,
+  indicate your decision by deleting the provisions above and replace them with
+  the  notice and other provisions required by the GPL. If you do not delete
+  the provisions above, a recipient may use your version of this file under
+  the terms of any one of the Apache License version 2 or the GPL.
+
+  ***** END LICENSE BLOCK *****
+
+ * Disk-backed notification replay log
+ * Enabled with the CLICON_STREAM_REPLAY_DIR option as an alternative to the in-memory
+ * replay list of clixon_stream.c.
+ * Each stream has a directory <dir>/<stream> containing append-only segment files, one
+ * per CLICON_STREAM_REPLAY_SEGMENT seconds, named by their (aligned) start time:
+ *
+ *   <dir>/<stream>/0001697712000.log
+ *   <dir>/<stream>/0001697712600.log
+ *
+ * The stream name is percent-encoded, so that it is a single path component.
+ * A segment file is a sequence of records, each a fixed header followed by the
+ * notification serialized as XML:
+ *
+ *   +--------+---------+-------+------------------+
+ *   | sec:64 | usec:32 | len:32| <notification>.. |
+ *   +--------+---------+-------+------------------+
+ *
+ * Only a sparse in-memory index is kept: one (time, offset) entry per
+ * REPLAY_INDEX_INTERVAL records. A replay binary-searches the index for startTime and
+ * then reads, parses and delivers one event at a time.
+ * Retention drops whole segments.
+ * The files are in host byte order and are not intended to be moved between hosts.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "clixon_config.h" /* generated by config & autoconf */
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <syslog.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/param.h>
+#include <sys/time.h>
+
+/* cligen */
+#include <cligen/cligen.h>
+
+/* clicon */
+#include "clixon_queue.h"
+#include "clixon_err.h"
+#include "clixon_log.h"
+#include "clixon_string.h"
+#include "clixon_hash.h"
+#include "clixon_handle.h"
+#include "clixon_file.h"
+#include "clixon_yang.h"
+#include "clixon_xml.h"
+#include "clixon_xml_io.h"
+#include "clixon_xml_bind.h"
+#include "clixon_options.h"
+#include "clixon_data.h"
+#include "clixon_stream.h"
+#include "clixon_stream_replay.h"
+
+/* One sparse index entry per this many records in a segment */
+#define REPLAY_INDEX_INTERVAL 64
+
+/* Sanity limit of a single record, larger lengths are considered corrupt */
+#define REPLAY_RECORD_MAX (64*1024*1024)
+
+/* On-disk record header, followed by rh_len bytes of XML */
+struct replay_rec_hdr{
+    int64_t  rh_sec;
+    int32_t  rh_usec;
+    uint32_t rh_len;
+};
+
+/* Sparse time index entry: time and file offset of a record */
+struct replay_index{
+    struct timeval ri_tv;
+    off_t          ri_off;
+};
+
+/* Segment: one file covering a time span */
+struct replay_segment{
+    qelem_t              rs_q;     /* queue header */
+    char                *rs_path;  /* Segment filename */
+    time_t               rs_start; /* Aligned start time of segment */
+    struct timeval       rs_last;  /* Time of last record */
+    off_t                rs_size;  /* Size of file, ie end of last complete record */
+    uint64_t             rs_nrec;  /* Number of records */
+    struct replay_index *rs_index; /* Sparse index vector */
+    size_t               rs_ilen;  /* Length of index vector */
+    size_t               rs_imax;  /* Allocated length of index vector */
+};
+
+/* Replay log of one stream */
+struct stream_replay_log{
+    char                  *rl_dir;       /* Stream directory */
+    uint32_t               rl_segment_s; /* Time span of segment in seconds */
+    int                    rl_fd;        /* Append fd of last segment, or -1 */
+    struct replay_segment *rl_segments;  /* Segments, oldest first */
+};
+
+/*! Add an index entry to a segment
+ *
+ * @param[in]  rs   Segment
+ * @param[in]  tv   Timestamp of record
+ * @param[in]  off  File offset of record
+ * @retval     0    OK
+ * @retval    -1    Error
+ */
+static int
+replay_index_add(struct replay_segment *rs,
+                 struct timeval        *tv,
+                 off_t                  off)
+{
+    int    retval = -1;
+    size_t len;
+
+    if (rs->rs_ilen >= rs->rs_imax){
+        len = rs->rs_imax ? rs->rs_imax*2 : 16;
+        if ((rs->rs_index = realloc(rs->rs_index, len*sizeof(struct replay_index))) == NULL){
+            clicon_err(OE_UNIX, errno, "realloc");
+            goto done;
+        }
+        rs->rs_imax = len;
+    }
+    rs->rs_index[rs->rs_ilen].ri_tv = *tv;
+    rs->rs_index[rs->rs_ilen].ri_off = off;
+    rs->rs_ilen++;
+    retval = 0;
+ done:
+    return retval;
+}
+
+/*! Create a new in-memory segment object and append it to the log
+ *
+ * @param[in]  rl    Replay log
+ * @param[in]  start Aligned start time of segment
+ * @retval     rs    Segment
+ * @retval     NULL  Error
+ */
+static struct replay_segment *
+replay_segment_new(struct stream_replay_log *rl,
+                   time_t                    start)
+{
+    struct replay_segment *rs = NULL;
+    cbuf                  *cb = NULL;
+
+    if ((cb = cbuf_new()) == NULL){
+        clicon_err(OE_UNIX, errno, "cbuf_new");
+        goto done;
+    }
+    cprintf(cb, "%s/%013" PRId64 ".log", rl->rl_dir, (int64_t)start);
+    if ((rs = malloc(sizeof(*rs))) == NULL){
+        clicon_err(OE_UNIX, errno, "malloc");
+        goto done;
+    }
+    memset(rs, 0, sizeof(*rs));
+    rs->rs_start = start;
+    if ((rs->rs_path = strdup(cbuf_get(cb))) == NULL){
+        clicon_err(OE_UNIX, errno, "strdup");
+        free(rs);
+        rs = NULL;
+        goto done;
+    }
+    ADDQ(rs, rl->rl_segments);
+ done:
+    if (cb)
+        cbuf_free(cb);
+    return rs;
+}
+
+/*! Free segment object (not the file)
+ */
+static int
+replay_segment_free(struct replay_segment *rs)
+{
+    if (rs->rs_path)
+        free(rs->rs_path);
+    if (rs->rs_index)
+        free(rs->rs_index);
+    free(rs);
+    return 0;
+}
+
+/*! Scan an existing segment file and rebuild its index
+ *
+ * A trailing partial record, eg from a crash during write, is truncated.
+ * @param[in]  rs   Segment with rs_path set
+ * @retval     0    OK
+ * @retval    -1    Error
+ */
+static int
+replay_segment_scan(struct replay_segment *rs)
+{
+    int                   retval = -1;
+    FILE                 *f = NULL;
+    struct replay_rec_hdr hdr;
+    struct stat           st;
+    struct timeval        tv;
+    off_t                 off = 0;
+
+    if ((f = fopen(rs->rs_path, "r")) == NULL){
+        clicon_err(OE_UNIX, errno, "fopen(%s)", rs->rs_path);
+        goto done;
+    }
+    if (fstat(fileno(f), &st) < 0){
+        clicon_err(OE_UNIX, errno, "fstat(%s)", rs->rs_path);
+        goto done;
+    }
+    while (off + (off_t)sizeof(hdr) <= st.st_size){
+        if (fread(&hdr, sizeof(hdr), 1, f) != 1)
+            break;
+        if (hdr.rh_len > REPLAY_RECORD_MAX ||
+            off + (off_t)sizeof(hdr) + hdr.rh_len > st.st_size)
+            break;
+        tv.tv_sec = hdr.rh_sec;
+        tv.tv_usec = hdr.rh_usec;
+        if (rs->rs_nrec % REPLAY_INDEX_INTERVAL == 0)
+            if (replay_index_add(rs, &tv, off) < 0)
+                goto done;
+        rs->rs_nrec++;
+        rs->rs_last = tv;
+        off += sizeof(hdr) + hdr.rh_len;
+        if (fseeko(f, off, SEEK_SET) < 0){
+            clicon_err(OE_UNIX, errno, "fseeko(%s)", rs->rs_path);
+            goto done;
+        }
+    }
+    rs->rs_size = off;
+    if (off < st.st_size){
+        clicon_log(LOG_WARNING, "%s: %s: truncating partial record at offset %" PRId64,
+                   __FUNCTION__, rs->rs_path, (int64_t)off);
+        if (truncate(rs->rs_path, off) < 0){
+            clicon_err(OE_UNIX, errno, "truncate(%s)", rs->rs_path);
+            goto done;
+        }
+    }
+    retval = 0;
+ done:
+    if (f)
+        fclose(f);
+    return retval;
+}
+
+/*! Open replay log of a stream, create directory and index existing segments
+ *
+ * @param[in]  dir       Replay log base directory, see CLICON_STREAM_REPLAY_DIR
+ * @param[in]  stream    Name of stream, used percent-encoded as sub-directory
+ * @param[in]  segment_s Time span of each segment in seconds
+ * @retval     rl        Replay log, free with replay_log_close
+ * @retval     NULL      Error
+ */
+struct stream_replay_log *
+replay_log_open(const char *dir,
+                const char *stream,
+                uint32_t    segment_s)
+{
+    struct stream_replay_log *rl = NULL;
+    struct replay_segment    *rs;
+    struct dirent            *dp = NULL;
+    int                       ndp;
+    int                       i;
+    cbuf                     *cb = NULL;
+    long long                 start;
+    char                      ch;
+    char                     *enc = NULL;
+
+    if ((cb = cbuf_new()) == NULL){
+        clicon_err(OE_UNIX, errno, "cbuf_new");
+        goto err;
+    }
+    if ((rl = malloc(sizeof(*rl))) == NULL){
+        clicon_err(OE_UNIX, errno, "malloc");
+        goto err;
+    }
+    memset(rl, 0, sizeof(*rl));
+    rl->rl_fd = -1;
+    rl->rl_segment_s = segment_s?segment_s:1;
+    if (mkdir(dir, 0700) < 0 && errno != EEXIST){
+        clicon_err(OE_UNIX, errno, "mkdir(%s)", dir);
+        goto err;
+    }
+    /* The stream name is a path component: escape '/' and reject names that refer to
+     * the replay directory itself or its parent */
+    if (*stream == '\0' || strcmp(stream, ".") == 0 || strcmp(stream, "..") == 0){
+        clicon_err(OE_CFG, EINVAL, "Invalid stream name for replay log: \"%s\"", stream);
+        goto err;
+    }
+    if (uri_percent_encode(&enc, "%s", stream) < 0)
+        goto err;
+    cprintf(cb, "%s/%s", dir, enc);
+    if ((rl->rl_dir = strdup(cbuf_get(cb))) == NULL){
+        clicon_err(OE_UNIX, errno, "strdup");
+        goto err;
+    }
+    if (mkdir(rl->rl_dir, 0700) < 0 && errno != EEXIST){
+        clicon_err(OE_UNIX, errno, "mkdir(%s)", rl->rl_dir);
+        goto err;
+    }
+    /* Sorted by name, ie by start time */
+    if ((ndp = clicon_file_dirent(rl->rl_dir, &dp, "^[0-9]+\\.log$", S_IFREG)) < 0)
+        goto err;
+    for (i = 0; i < ndp; i++){
+        if (sscanf(dp[i].d_name, "%lld.lo%c", &start, &ch) != 2)
+            continue;
+        if ((rs = replay_segment_new(rl, (time_t)start)) == NULL)
+            goto err;
+        if (replay_segment_scan(rs) < 0)
+            goto err;
+    }
+    clixon_debug(CLIXON_DBG_DEFAULT, "%s %s: %d segments", __FUNCTION__, rl->rl_dir, ndp);
+    if (dp)
+        free(dp);
+    if (enc)
+        free(enc);
+    cbuf_free(cb);
+    return rl;
+ err:
+    if (dp)
+        free(dp);
+    if (enc)
+        free(enc);
+    if (cb)
+        cbuf_free(cb);
+    if (rl)
+        replay_log_close(rl);
+    return NULL;
+}
+
+/*! Close replay log and free memory. Segment files are kept.
+ *
+ * @param[in]  rl   Replay log
+ * @retval     0    OK
+ */
+int
+replay_log_close(struct stream_replay_log *rl)
+{
+    struct replay_segment *rs;
+
+    if (rl->rl_fd != -1)
+        close(rl->rl_fd);
+    while ((rs = rl->rl_segments) != NULL){
+        DELQ(rs, rl->rl_segments, struct replay_segment *);
+        replay_segment_free(rs);
+    }
+    if (rl->rl_dir)
+        free(rl->rl_dir);
+    free(rl);
+    return 0;
+}
+
+/*! Append notification event to replay log, switch segment if needed
+ *
+ * @param[in]  rl   Replay log
+ * @param[in]  tv   Timestamp of event
+ * @param[in]  xv   Event as XML. Not consumed
+ * @retval     0    OK
+ * @retval    -1    Error
+ * @note Timestamps are assumed to be non-decreasing
+ */
+int
+replay_log_append(struct stream_replay_log *rl,
+                  struct timeval           *tv,
+                  cxobj                    *xv)
+{
+    int                    retval = -1;
+    struct replay_segment *rs = NULL;
+    struct replay_rec_hdr  hdr;
+    cbuf                  *cb = NULL;
+    time_t                 start;
+    char                  *buf;
+    size_t                 len;
+    ssize_t                n;
+
+    if (rl->rl_segments)
+        rs = PREVQ(struct replay_segment *, rl->rl_segments);
+    if (rs == NULL || tv->tv_sec >= rs->rs_start + (time_t)rl->rl_segment_s){
+        if (rl->rl_fd != -1){
+            close(rl->rl_fd);
+            rl->rl_fd = -1;
+        }
+        start = tv->tv_sec - tv->tv_sec % rl->rl_segment_s;
+        if ((rs = replay_segment_new(rl, start)) == NULL)
+            goto done;
+    }
+    if (rl->rl_fd == -1){
+        if ((rl->rl_fd = open(rs->rs_path, O_WRONLY|O_CREAT|O_APPEND|O_CLOEXEC, 0600)) < 0){
+            clicon_err(OE_UNIX, errno, "open(%s)", rs->rs_path);
+            goto done;
+        }
+    }
+    if ((cb = cbuf_new()) == NULL){
+        clicon_err(OE_UNIX, errno, "cbuf_new");
+        goto done;
+    }
+    /* Reserve header space and serialize directly after it, so one write suffices */
+    memset(&hdr, 0, sizeof(hdr));
+    cbuf_append_buf(cb, &hdr, sizeof(hdr));
+    if (clixon_xml2cbuf(cb, xv, 0, 0, NULL, -1, 0) < 0)
+        goto done;
+    buf = cbuf_get(cb);
+    len = cbuf_len(cb);
+    hdr.rh_sec = tv->tv_sec;
+    hdr.rh_usec = tv->tv_usec;
+    hdr.rh_len = len - sizeof(hdr);
+    memcpy(buf, &hdr, sizeof(hdr));
+    while (len > 0){
+        if ((n = write(rl->rl_fd, buf, len)) < 0){
+            if (errno == EINTR)
+                continue;
+            clicon_err(OE_UNIX, errno, "write(%s)", rs->rs_path);
+            goto done;
+        }
+        buf += n;
+        len -= n;
+    }
+    if (rs->rs_nrec % REPLAY_INDEX_INTERVAL == 0)
+        if (replay_index_add(rs, tv, rs->rs_size) < 0)
+            goto done;
+    rs->rs_nrec++;
+    rs->rs_last = *tv;
+    rs->rs_size += sizeof(hdr) + hdr.rh_len;
+    retval = 0;
+ done:
+    if (cb)
+        cbuf_free(cb);
+    return retval;
+}
+
+/*! Remove all segments whose newest record is older than cutoff
+ *
+ * @param[in]  rl      Replay log
+ * @param[in]  cutoff  Drop segments with all records older than this
+ * @retval     0       OK
+ * @retval    -1       Error
+ */
+int
+replay_log_retention(struct stream_replay_log *rl,
+                     struct timeval           *cutoff)
+{
+    int                    retval = -1;
+    struct replay_segment *rs;
+
+    while ((rs = rl->rl_segments) != NULL){
+        /* Never remove the segment currently appended to */
+        if (NEXTQ(struct replay_segment *, rs) == rs)
+            break;
+        if (!timercmp(&rs->rs_last, cutoff, <))
+            break;
+        clixon_debug(CLIXON_DBG_DETAIL, "%s remove %s", __FUNCTION__, rs->rs_path);
+        if (unlink(rs->rs_path) < 0 && errno != ENOENT){
+            clicon_err(OE_UNIX, errno, "unlink(%s)", rs->rs_path);
+            goto done;
+        }
+        DELQ(rs, rl->rl_segments, struct replay_segment *);
+        replay_segment_free(rs);
+    }
+    retval = 0;
+ done:
+    return retval;
+}
+
+/*! Find offset in segment to start reading from given a start time
+ *
+ * Binary search of the sparse index for the last entry with time < start
+ * @param[in]  rs     Segment
+ * @param[in]  start  Start time
+ * @retval     off    Offset of a record at or before first record >= start
+ */
+static off_t
+replay_segment_seek(struct replay_segment *rs,
+                    struct timeval        *start)
+{
+    size_t lo = 0;
+    size_t hi = rs->rs_ilen;
+    size_t mid;
+
+    if (rs->rs_ilen == 0)
+        return 0;
+    while (hi - lo > 1){
+        mid = (lo + hi)/2;
+        if (timercmp(&rs->rs_index[mid].ri_tv, start, <))
+            lo = mid;
+        else
+            hi = mid;
+    }
+    return rs->rs_index[lo].ri_off;
+}
+
+/*! Bind yang to the body of a stored notification
+ *
+ * The <notification> wrapper and <eventTime> are not yang data nodes, only the event
+ * itself is bound, to its notification statement. Events not defined by any loaded
+ * yang, eg from other streams than NETCONF, are left unbound.
+ * @param[in]  h      Clixon handle
+ * @param[in]  xn     Notification XML: <notification><eventTime/><event/></notification>
+ * @param[in]  yspec  Yang spec
+ * @retval     0      OK
+ * @retval    -1      Error
+ */
+static int
+replay_notification_bind(clicon_handle h,
+                         cxobj        *xn,
+                         yang_stmt    *yspec)
+{
+    int        retval = -1;
+    cxobj     *xc = NULL;
+    yang_stmt *ymod;
+    yang_stmt *yn;
+
+    if (yspec == NULL)
+        goto ok;
+    while ((xc = xml_child_each(xn, xc, CX_ELMNT)) != NULL) {
+        if (strcmp(xml_name(xc), "eventTime") == 0)
+            continue;
+        ymod = NULL;
+        if (ys_module_by_xml(yspec, xc, &ymod) < 0)
+            goto done;
+        if (ymod == NULL ||
+            (yn = yang_find(ymod, Y_NOTIFICATION, xml_name(xc))) == NULL)
+            continue;
+        xml_spec_set(xc, yn);
+        if (xml_bind_yang(h, xc, YB_PARENT, NULL, NULL) < 0)
+            goto done;
+    }
+ ok:
+    retval = 0;
+ done:
+    return retval;
+}
+
+/*! Replay events from one segment in [start, stop]
+ *
+ * @param[in]  h      Clixon handle
+ * @param[in]  rs     Segment
+ * @param[in]  start  Start time
+ * @param[in]  stop   Stop time, or not set
+ * @param[in]  fn     Subscription callback
+ * @param[in]  arg    Subscription callback argument
+ * @retval     1      OK, continue with next segment
+ * @retval     0      OK, stop time reached
+ * @retval    -1      Error
+ */
+static int
+replay_segment_replay(clicon_handle          h,
+                      struct replay_segment *rs,
+                      struct timeval        *start,
+                      struct timeval        *stop,
+                      stream_fn_t            fn,
+                      void                  *arg)
+{
+    int                   retval = -1;
+    FILE                 *f = NULL;
+    struct replay_rec_hdr hdr;
+    struct timeval        tv;
+    off_t                 off;
+    off_t                 end;
+    char                 *buf = NULL;
+    size_t                buflen = 0;
+    cxobj                *xt = NULL;
+    cxobj                *xn;
+    yang_stmt            *yspec;
+
+    yspec = clicon_dbspec_yang(h);
+    /* Snapshot of end, records appended during replay are not included */
+    end = rs->rs_size;
+    off = replay_segment_seek(rs, start);
+    if ((f = fopen(rs->rs_path, "r")) == NULL){
+        clicon_err(OE_UNIX, errno, "fopen(%s)", rs->rs_path);
+        goto done;
+    }
+    if (fseeko(f, off, SEEK_SET) < 0){
+        clicon_err(OE_UNIX, errno, "fseeko(%s)", rs->rs_path);
+        goto done;
+    }
+    while (off + (off_t)sizeof(hdr) <= end){
+        if (fread(&hdr, sizeof(hdr), 1, f) != 1){
+            clicon_err(OE_UNIX, errno, "fread(%s)", rs->rs_path);
+            goto done;
+        }
+        off += sizeof(hdr) + hdr.rh_len;
+        tv.tv_sec = hdr.rh_sec;
+        tv.tv_usec = hdr.rh_usec;
+        if (timercmp(&tv, start, <)){
+            if (fseeko(f, off, SEEK_SET) < 0){
+                clicon_err(OE_UNIX, errno, "fseeko(%s)", rs->rs_path);
+                goto done;
+            }
+            continue;
+        }
+        if (timerisset(stop) && timercmp(&tv, stop, >)){
+            retval = 0; /* Stop time reached */
+            goto done;
+        }
+        if (hdr.rh_len + 1 > buflen){
+            buflen = hdr.rh_len + 1;
+            if ((buf = realloc(buf, buflen)) == NULL){
+                clicon_err(OE_UNIX, errno, "realloc");
+                goto done;
+            }
+        }
+        if (fread(buf, 1, hdr.rh_len, f) != hdr.rh_len){
+            clicon_err(OE_UNIX, errno, "fread(%s)", rs->rs_path);
+            goto done;
+        }
+        buf[hdr.rh_len] = '\0';
+        if (clixon_xml_parse_string(buf, YB_NONE, NULL, &xt, NULL) < 0)
+            goto done;
+        if ((xn = xml_child_i_type(xt, 0, CX_ELMNT)) != NULL){
+            if (replay_notification_bind(h, xn, yspec) < 0)
+                goto done;
+            if ((*fn)(h, 0, xn, arg) < 0)
+                goto done;
+        }
+        xml_free(xt);
+        xt = NULL;
+    }
+    retval = 1;
+ done:
+    if (xt)
+        xml_free(xt);
+    if (buf)
+        free(buf);
+    if (f)
+        fclose(f);
+    return retval;
+}
+
+/*! Replay a stream from disk to a subscription callback
+ *
+ * Events are read, parsed and delivered one at a time, they are not all materialized.
+ * @param[in]  h      Clixon handle
+ * @param[in]  rl     Replay log
+ * @param[in]  start  Replay events with time >= start
+ * @param[in]  stop   If set, replay events with time <= stop
+ * @param[in]  fn     Subscription callback
+ * @param[in]  arg    Subscription callback argument
+ * @retval     0      OK
+ * @retval    -1      Error
+ */
+int
+replay_log_replay(clicon_handle             h,
+                  struct stream_replay_log *rl,
+                  struct timeval           *start,
+                  struct timeval           *stop,
+                  stream_fn_t               fn,
+                  void                     *arg)
+{
+    int                    retval = -1;
+    struct replay_segment *rs;
+    int                    ret;
+
+    if ((rs = rl->rl_segments) != NULL)
+        do {
+            /* Skip segments where all records are older than start */
+            if (rs->rs_nrec && !timercmp(&rs->rs_last, start, <)){
+                if ((ret = replay_segment_replay(h, rs, start, stop, fn, arg)) < 0)
+                    goto done;
+                if (ret == 0)
+                    break;
+            }
+            rs = NEXTQ(struct replay_segment *, rs);
+        } while (rs && rs != rl->rl_segments);
+    retval = 0;
+ done:
+    return retval;
+}
@@ -44,6 +44,9 @@
 #include <stdlib.h>
 #include <errno.h>
 #include <ctype.h>
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
 
 #include <cligen/cligen.h>
 
@@ -389,6 +392,117 @@ uri_percent_decode(char  *enc,
     return retval;
 }
 
+/*
+ * Scan kernels for escaping: find the next character needing escaping so that
+ * clean runs before it can be copied in bulk.
+ * With AVX2 (32 bytes) or SSE2 (16 bytes), aligned vectors are compared with all stop
+ * characters and '\0' at once. Aligned loads never cross a page boundary, but may read
+ * beyond the terminating '\0' within the same vector.
+ * Otherwise, strcspn is used.
+ */
+#if defined(__AVX2__)
+#define STR_SPAN_VECLEN 32
+#elif defined(__SSE2__)
+#define STR_SPAN_VECLEN 16
+#endif
+
+#ifdef STR_SPAN_VECLEN
+/*! Return length of initial segment of str not containing '\0' or any stop character
+ *
+ * @param[in]  str    String
+ * @param[in]  stop   Stop characters, not including '\0'
+ * @param[in]  nstop  Number of stop characters, at most 8
+ * @retval     len    Length of initial segment
+ */
+#ifdef __SANITIZE_ADDRESS__
+__attribute__((no_sanitize_address))
+#endif
+static inline size_t
+str_span_vec(const char *str,
+             const char *stop,
+             int         nstop)
+{
+    const char *p = str;
+    int         i;
+    uint32_t    mask;
+#if STR_SPAN_VECLEN == 32
+    __m256i     vstop[8];
+    __m256i     v;
+    __m256i     m;
+#else
+    __m128i     vstop[8];
+    __m128i     v;
+    __m128i     m;
+#endif
+
+    /* Head: byte by byte until aligned */
+    while (((uintptr_t)p & (STR_SPAN_VECLEN-1)) != 0){
+        if (*p == '\0')
+            return p - str;
+        for (i=0; i<nstop; i++)
+            if (*p == stop[i])
+                return p - str;
+        p++;
+    }
+    for (i=0; i<nstop; i++)
+#if STR_SPAN_VECLEN == 32
+        vstop[i] = _mm256_set1_epi8(stop[i]);
+#else
+        vstop[i] = _mm_set1_epi8(stop[i]);
+#endif
+    for (;;){
+#if STR_SPAN_VECLEN == 32
+        v = _mm256_load_si256((const __m256i *)p);
+        m = _mm256_cmpeq_epi8(v, _mm256_setzero_si256());
+        for (i=0; i<nstop; i++)
+            m = _mm256_or_si256(m, _mm256_cmpeq_epi8(v, vstop[i]));
+        mask = (uint32_t)_mm256_movemask_epi8(m);
+#else
+        v = _mm_load_si128((const __m128i *)p);
+        m = _mm_cmpeq_epi8(v, _mm_setzero_si128());
+        for (i=0; i<nstop; i++)
+            m = _mm_or_si128(m, _mm_cmpeq_epi8(v, vstop[i]));
+        mask = (uint32_t)_mm_movemask_epi8(m);
+#endif
+        if (mask)
+            return p - str + __builtin_ctz(mask);
+        p += STR_SPAN_VECLEN;
+    }
+}
+#endif /* STR_SPAN_VECLEN */
+
+/*! Return length of initial segment of str not containing characters needing XML escaping
+ *
+ * @param[in]  str    String
+ * @retval     len    Number of characters before first of '&', '<', '>' or '\0'
+ * @see xml_chardata_cbuf_append
+ */
+size_t
+xml_chardata_span(const char *str)
+{
+#ifdef STR_SPAN_VECLEN
+    return str_span_vec(str, "&<>", 3);
+#else
+    return strcspn(str, "&<>");
+#endif
+}
+
+/*! Return length of initial segment of str not containing characters needing JSON escaping
+ *
+ * @param[in]  str    String
+ * @retval     len    Number of characters before first of '"', '\\', '\b', '\f', '\n', '\r', '\t' or '\0'
+ * @see json_str_escape_cbuf_append
+ */
+size_t
+json_str_span(const char *str)
+{
+#ifdef STR_SPAN_VECLEN
+    return str_span_vec(str, "\"\\\b\f\n\r\t", 7);
+#else
+    return strcspn(str, "\"\\\b\f\n\r\t");
+#endif
+}
+
 /*! Encode escape characters according to XML definition
  *
  * @param[out]  encp   Encoded malloced output string
@@ -423,12 +537,8 @@ xml_chardata_encode(char      **escp,
     char   *str = NULL;  /* Expanded format string w stdarg */
     int     fmtlen;
     char   *esc = NULL;
-    int     l;
-    int     len;
-    int     i, j;
-    int     cdata; /* when set, skip encoding */
+    cbuf   *cb = NULL;
     va_list args;
-    size_t  slen;
 
     /* Two steps: (1) read in the complete format string */
     va_start(args, fmt); /* dryrun */
@@ -445,99 +555,30 @@ xml_chardata_encode(char      **escp,
     /* Now str is the combined fmt + ... */
 
     /* Step (2) encode and expand str --> enc */
-    /* First compute length (do nothing) */
-    len = 0; cdata = 0;
-    slen = strlen(str);
-    for (i=0; i<slen; i++){
-        if (cdata){
-            if (strncmp(&str[i], "]]>", strlen("]]>")) == 0)
-                cdata = 0;
-            len++;
-        }
-        else
-            switch (str[i]){
-            case '&':
-                len += strlen("&amp;");
-                break;
-            case '<':
-                if (strncmp(&str[i], "<![CDATA[", strlen("<![CDATA[")) == 0){
-                    len++;
-                    cdata++;
-                }
-                else
-                    len += strlen("&lt;");
-                break;
-            case '>':
-                len += strlen("&gt;");
-                break;
-            default:
-                len++;
-            }
-    }
-    len++; /* trailing \0 */
-    /* We know length, allocate encoding buffer  */
-    if ((esc = malloc(len)) == NULL){
-        clicon_err(OE_UNIX, errno, "malloc");
+    if ((cb = cbuf_new_alloc(fmtlen + fmtlen/8 + 16)) == NULL){
+        clicon_err(OE_UNIX, errno, "cbuf_new_alloc");
         goto done;
     }
-    memset(esc, 0, len);
-
-    /* Same code again, but now actually encode into output buffer */
-    j = 0; cdata = 0;
-    slen = strlen(str);
-    for (i=0; i<slen; i++){
-        if (cdata){
-            if (strncmp(&str[i], "]]>", strlen("]]>")) == 0){
-                cdata = 0;
-                esc[j++] = str[i++];
-                esc[j++] = str[i++];
-            }
-            esc[j++] = str[i];
-        }
-        else
-        switch (str[i]){
-        case '&':
-            if ((l=snprintf(&esc[j], 6, "&amp;")) < 0){
-                clicon_err(OE_UNIX, errno, "snprintf");
-                goto done;
-            }
-            j += l;
-            break;
-        case '<':
-            if (strncmp(&str[i], "<![CDATA[", strlen("<![CDATA[")) == 0){
-                esc[j++] = str[i];
-                cdata++;
-                break;
-            }
-            if ((l=snprintf(&esc[j], 5, "&lt;")) < 0){
-                clicon_err(OE_UNIX, errno, "snprintf");
-                goto done;
-            }
-            j += l;
-            break;
-        case '>':
-            if ((l=snprintf(&esc[j], 5, "&gt;")) < 0){
-                clicon_err(OE_UNIX, errno, "snprintf");
-                goto done;
-            }
-            j += l;
-            break;
-        default:
-            esc[j++] = str[i];
-        }
+    if (xml_chardata_cbuf_append(cb, str) < 0)
+        goto done;
+    if ((esc = strdup(cbuf_get(cb))) == NULL){
+        clicon_err(OE_UNIX, errno, "strdup");
+        goto done;
     }
     *escp = esc;
     retval = 0;
  done:
     if (str)
         free(str);
-    if (retval < 0 && esc)
-        free(esc);
+    if (cb)
+        cbuf_free(cb);
     return retval;
 }
 
 /*! Escape characters according to XML definition and append to cbuf
  *
+ * Runs of characters not needing escaping are appended in bulk, CDATA sections are
+ * copied as is.
  * @param[in]   cb     CLIgen buf
  * @param[in]   str    Not-encoded input string
  * @retdata     0      OK
@@ -547,49 +588,94 @@ int
 xml_chardata_cbuf_append(cbuf *cb,
                          char *str)
 {
-    int  retval = -1;
-    int  i;
-    int  cdata; /* when set, skip encoding */
-    size_t len;
-
-    /* The orignal of this code is in xml_chardata_encode */
-    /* Step: encode and expand str --> enc */
-    /* Same code again, but now actually encode into output buffer */
-    cdata = 0;
-
-    len = strlen(str);
-    for (i=0; i<len; i++){
-        if (cdata){
-            if (strncmp(&str[i], "]]>", strlen("]]>")) == 0){
-                cdata = 0;
-                cbuf_append(cb, str[i++]);
-                cbuf_append(cb, str[i++]);
-            }
-            cbuf_append(cb, str[i]);
+    char  *p = str;
+    char  *end;
+    size_t n;
+
+    while (*p != '\0'){
+        if ((n = xml_chardata_span(p)) > 0){
+            cbuf_append_buf(cb, p, n);
+            p += n;
         }
-        else
-        switch (str[i]){
+        switch (*p){
         case '&':
             cbuf_append_str(cb, "&amp;");
+            p++;
+            break;
+        case '>':
+            cbuf_append_str(cb, "&gt;");
+            p++;
             break;
         case '<':
-            if (strncmp(&str[i], "<![CDATA[", strlen("<![CDATA[")) == 0){
-                cbuf_append(cb, str[i]);
-                cdata++;
-                break;
+            if (strncmp(p, "<![CDATA[", strlen("<![CDATA[")) == 0){
+                /* Copy until and including ]]>, or rest if not terminated */
+                if ((end = strstr(p + strlen("<![CDATA["), "]]>")) != NULL)
+                    n = end + strlen("]]>") - p;
+                else
+                    n = strlen(p);
+                cbuf_append_buf(cb, p, n);
+                p += n;
+            }
+            else{
+                cbuf_append_str(cb, "&lt;");
+                p++;
             }
-            cbuf_append_str(cb, "&lt;");
             break;
-        case '>':
-            cbuf_append_str(cb, "&gt;");
+        default: /* \0 */
             break;
-        default:
-            cbuf_append(cb, str[i]);
         }
     }
-    retval = 0;
-    // done:
-    return retval;
+    return 0;
+}
+
+/*! Escape characters according to JSON string definition and append to cbuf
+ *
+ * Runs of characters not needing escaping are appended in bulk.
+ * @param[in]   cb     CLIgen buf
+ * @param[in]   str    Not-encoded input string
+ * @retdata     0      OK
+ * @see json_str_span
+ */
+int
+json_str_escape_cbuf_append(cbuf *cb,
+                            char *str)
+{
+    char  *p = str;
+    size_t n;
+
+    while (*p != '\0'){
+        if ((n = json_str_span(p)) > 0){
+            cbuf_append_buf(cb, p, n);
+            p += n;
+        }
+        switch (*p){
+        case '\"':
+            cbuf_append_str(cb, "\\\"");
+            break;
+        case '\\':
+            cbuf_append_str(cb, "\\\\");
+            break;
+        case '\b':
+            cbuf_append_str(cb, "\\b");
+            break;
+        case '\f':
+            cbuf_append_str(cb, "\\f");
+            break;
+        case '\n':
+            cbuf_append_str(cb, "\\n");
+            break;
+        case '\r':
+            cbuf_append_str(cb, "\\r");
+            break;
+        case '\t':
+            cbuf_append_str(cb, "\\t");
+            break;
+        default: /* \0 */
+            continue;
+        }
+        p++;
+    }
+    return 0;
 }
 
 /*! xml decode &...; 
@@ -483,10 +483,23 @@ clixon_text2file(FILE             *f,
     cxobj *xc;
     int    leafl = 0;
     char  *leaflname = NULL;
+    cbuf  *cb = NULL;
 
     if (fn == NULL)
         fn = fprintf;
-    if (skiptop){
+    if (fn == fprintf){ /* Plain stdio: print to buffer and write in one chunk */
+        if ((cb = cbuf_new()) == NULL){
+            clicon_err(OE_UNIX, errno, "cbuf_new");
+            goto done;
+        }
+        if (clixon_text2cbuf(cb, xn, level, skiptop, autocliext) < 0)
+            goto done;
+        if (fwrite(cbuf_get(cb), 1, cbuf_len(cb), f) != cbuf_len(cb)){
+            clicon_err(OE_UNIX, errno, "fwrite");
+            goto done;
+        }
+    }
+    else if (skiptop){
         xc = NULL;
         while ((xc = xml_child_each(xn, xc, CX_ELMNT)) != NULL)
             if (text2file(xc, fn, f, level, autocliext, &leafl, &leaflname) < 0)
@@ -498,6 +511,8 @@ clixon_text2file(FILE             *f,
     }
     retval = 0;
  done:
+    if (cb)
+        cbuf_free(cb);
     return retval;
 }
 
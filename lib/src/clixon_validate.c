@@ -49,7 +49,9 @@
 #include <syslog.h>
 #include <fcntl.h>
 #include <arpa/inet.h>
+#include <signal.h>
 #include <sys/param.h>
+#include <sys/wait.h>
 #include <netinet/in.h>
 
 /* cligen */
@@ -79,11 +81,15 @@
 #include "clixon_xml_default.h"
 #include "clixon_xml_map.h"
 #include "clixon_xml_bind.h"
+#include "clixon_xml_sort.h"
 #include "clixon_validate_minmax.h"
+#include "clixon_validate_deps.h"
+#include "clixon_leafref.h"
 #include "clixon_validate.h"
 
 /*! Validate xml node of type leafref, ensure the value is one of that path's reference
  *
+ * @param[in]  h     Clixon handle, for leafref index
  * @param[in]  xt    XML leaf node of type leafref
  * @param[in]  ys    Yang spec of leaf
  * @param[in]  ytype Yang type statement belonging to the XML node
@@ -116,21 +122,17 @@
  * 
  */
 static int
-validate_leafref(cxobj     *xt,
-                 yang_stmt *ys,
-                 yang_stmt *ytype,
-                 cxobj    **xret)
+validate_leafref(clicon_handle h,
+                 cxobj        *xt,
+                 yang_stmt    *ys,
+                 yang_stmt    *ytype,
+                 cxobj       **xret)
 {
     int          retval = -1;
     yang_stmt   *ypath;
     yang_stmt   *yreqi;
-    cxobj      **xvec = NULL;
-    cxobj       *x;
-    int          i;
-    size_t       xlen = 0;
+    int          ret;
     char        *leafrefbody;
-    char        *leafbody;
-    cvec        *nsc = NULL;
     cbuf        *cberr = NULL;
     char        *path_arg;
     yang_stmt   *ymod;
@@ -163,18 +165,9 @@ validate_leafref(cxobj     *xt,
     }
     if ((leafrefbody = xml_body(xt)) == NULL)
         goto ok;
-    if (xml_nsctx_yang(ys, &nsc) < 0)
-        goto done;
-    if (xpath_vec(xt, nsc, "%s", &xvec, &xlen, path_arg) < 0)
+    if ((ret = leafref_target_find(h, xt, ys, path_arg, leafrefbody)) < 0)
         goto done;
-    for (i = 0; i < xlen; i++) {
-        x = xvec[i];
-        if ((leafbody = xml_body(x)) == NULL)
-            continue;
-        if (strcmp(leafbody, leafrefbody) == 0)
-            break;
-    }
-    if (i==xlen){
+    if (ret == 0){
         if ((cberr = cbuf_new()) == NULL){
             clicon_err(OE_UNIX, errno, "cbuf_new");
             goto done;
@@ -194,10 +187,6 @@ validate_leafref(cxobj     *xt,
  done:
     if (cberr)
         cbuf_free(cberr);
-    if (nsc)
-        xml_nsctx_free(nsc);
-    if (xvec)
-        free(xvec);
     return retval;
  fail:
     retval = 0;
@@ -1163,7 +1152,7 @@ xml_yang_validate_leaf_union(clicon_handle h,
         restype = ytype?yang_argument_get(ytype):NULL;
         ret = 1; /* If not leafref/identityref it is valid on this level */
         if (strcmp(restype, "leafref") == 0){
-            if ((ret = validate_leafref(xt, yt, ytype, &xret1)) < 0) // XXX
+            if ((ret = validate_leafref(h, xt, yt, ytype, &xret1)) < 0) // XXX
                 goto done;
         }
         else if (strcmp(restype, "identityref") == 0){
@@ -1198,30 +1187,22 @@ xml_yang_validate_leaf_union(clicon_handle h,
     goto done;
 }
 
-/*! Validate a single XML node with yang specification for all (not only added) entries
+/*! Validate a single XML node, and optionally its descendants, for all entries
  *
- * 1. Check leafrefs. Eg you delete a leaf and a leafref references it.
- * @param[in]  xt  XML node to be validated
- * @param[out] xret  Error XML tree (if retval=0). Free with xml_free after use
- * @retval     1     Validation OK
- * @retval     0     Validation failed (cbret set)
- * @retval    -1     Error
- * @code
- *   cxobj *x;
- *   cbuf *xret = NULL;
- *   if ((ret = xml_yang_validate_all(h, x, &xret)) < 0)
- *      err;
- *   if (ret == 0)
- *      fail;
- *   xml_free(xret);
- * @endcode
- * @see xml_yang_validate_add
- * @see xml_yang_validate_rpc
+ * @param[in]  h       Clixon handle
+ * @param[in]  xt      XML node to be validated
+ * @param[in]  recurse If 0, only validate xt itself, not children and unique/min/max
+ * @param[out] xret    Error XML tree (if retval=0). Free with xml_free after use
+ * @retval     1       Validation OK
+ * @retval     0       Validation failed (xret set)
+ * @retval    -1       Error
+ * @see xml_yang_validate_all
  */
-int
-xml_yang_validate_all(clicon_handle h,
-                      cxobj        *xt,
-                      cxobj       **xret)
+static int
+xml_yang_validate_all1(clicon_handle h,
+                       cxobj        *xt,
+                       int           recurse,
+                       cxobj       **xret)
 {
     int        retval = -1;
     yang_stmt *yt;  /* yang node associated with xt */
@@ -1306,7 +1287,7 @@ xml_yang_validate_all(clicon_handle h,
             if (yang_type_get(yt, NULL, &yc, NULL, NULL, NULL, NULL, NULL) < 0)
                 goto done;
             if (strcmp(yang_argument_get(yc), "leafref") == 0){
-                if ((ret = validate_leafref(xt, yt, yc, xret)) < 0)
+                if ((ret = validate_leafref(h, xt, yt, yc, xret)) < 0)
                     goto done;
                 if (ret == 0)
                     goto fail;
@@ -1361,9 +1342,11 @@ xml_yang_validate_all(clicon_handle h,
             }
         }
     }
+    if (!recurse)
+        goto ok;
     x = NULL;
     while ((x = xml_child_each(xt, x, CX_ELMNT)) != NULL) {
-        if ((ret = xml_yang_validate_all(h, x, xret)) < 0)
+        if ((ret = xml_yang_validate_all1(h, x, 1, xret)) < 0)
             goto done;
         if (ret == 0)
             goto fail;
@@ -1389,8 +1372,481 @@ xml_yang_validate_all(clicon_handle h,
     goto done;
 }
 
+/*! Validate a single XML node with yang specification for all (not only added) entries
+ *
+ * 1. Check leafrefs. Eg you delete a leaf and a leafref references it.
+ * @param[in]  xt  XML node to be validated
+ * @param[out] xret  Error XML tree (if retval=0). Free with xml_free after use
+ * @retval     1     Validation OK
+ * @retval     0     Validation failed (cbret set)
+ * @retval    -1     Error
+ * @code
+ *   cxobj *x;
+ *   cbuf *xret = NULL;
+ *   if ((ret = xml_yang_validate_all(h, x, &xret)) < 0)
+ *      err;
+ *   if (ret == 0)
+ *      fail;
+ *   xml_free(xret);
+ * @endcode
+ * @see xml_yang_validate_add
+ * @see xml_yang_validate_rpc
+ */
+int
+xml_yang_validate_all(clicon_handle h,
+                      cxobj        *xt,
+                      cxobj       **xret)
+{
+    return xml_yang_validate_all1(h, xt, 1, xret);
+}
+
+/*
+ * Parallel validation
+ * The tree is split into work units in document order. Units validating whole subtrees
+ * are partitioned into contiguous ranges, each validated by a forked worker process on
+ * its (copy-on-write) copy of the tree. Remaining units are validated by the caller.
+ * Each party reports its first failing unit, and the failure with the lowest unit index
+ * is returned, ie the same as sequential validation.
+ * Processes are used instead of threads since validation uses global error state and
+ * non-reentrant caches in the XML and YANG trees.
+ */
+
+/* Kind of validation work unit */
+enum validate_unit_kind{
+    VU_SUBTREE,    /* Node and all its descendants */
+    VU_NODE,       /* Node only */
+    VU_MINMAX,     /* Unique and min/max-elements of children of node */
+    VU_MINMAX_TOP, /* Unique and min/max-elements of top-level */
+};
+
+/* Validation work unit */
+struct validate_unit{
+    enum validate_unit_kind vu_kind;
+    cxobj                  *vu_x;    /* XML node */
+    size_t                  vu_size; /* Number of nodes validated */
+};
+
+/* Vector of validation work units */
+struct validate_units{
+    struct validate_unit *vs_vec;
+    int                   vs_len;
+    int                   vs_max;
+};
+
+/*! Number of elements in XML subtree, including the top
+ */
+static size_t
+xml_subtree_nr(cxobj *xt)
+{
+    size_t nr = 1;
+    cxobj *x;
+
+    x = NULL;
+    while ((x = xml_child_each(xt, x, CX_ELMNT)) != NULL)
+        nr += xml_subtree_nr(x);
+    return nr;
+}
+
+/*! Append a validation work unit
+ */
+static int
+validate_unit_add(struct validate_units  *vs,
+                  enum validate_unit_kind kind,
+                  cxobj                  *x,
+                  size_t                  size)
+{
+    int                   retval = -1;
+    struct validate_unit *vu;
+
+    if (vs->vs_len >= vs->vs_max){
+        vs->vs_max = vs->vs_max ? 2*vs->vs_max : 64;
+        if ((vu = realloc(vs->vs_vec, vs->vs_max*sizeof(*vu))) == NULL){
+            clicon_err(OE_UNIX, errno, "realloc");
+            goto done;
+        }
+        vs->vs_vec = vu;
+    }
+    vu = &vs->vs_vec[vs->vs_len++];
+    vu->vu_kind = kind;
+    vu->vu_x = x;
+    vu->vu_size = size;
+    retval = 0;
+ done:
+    return retval;
+}
+
+/*! Split XML subtree into validation work units of at most target size if possible
+ *
+ * Config containers and lists larger than target are split into the node itself, its
+ * children, and the unique/min/max check of its children, in the same order as
+ * xml_yang_validate_all1
+ * @param[in]  x       XML subtree
+ * @param[in]  target  Split subtrees larger than this
+ * @param[out] vs      Work units
+ */
+static int
+validate_units_split(cxobj                 *x,
+                     size_t                 target,
+                     struct validate_units *vs)
+{
+    int        retval = -1;
+    yang_stmt *y;
+    size_t     size;
+    cxobj     *xc;
+
+    size = xml_subtree_nr(x);
+    if (size > target &&
+        (y = xml_spec(x)) != NULL &&
+        yang_config(y) != 0 &&
+        (yang_keyword_get(y) == Y_CONTAINER || yang_keyword_get(y) == Y_LIST)){
+        if (validate_unit_add(vs, VU_NODE, x, 1) < 0)
+            goto done;
+        xc = NULL;
+        while ((xc = xml_child_each(x, xc, CX_ELMNT)) != NULL)
+            if (validate_units_split(xc, target, vs) < 0)
+                goto done;
+        if (validate_unit_add(vs, VU_MINMAX, x, 0) < 0)
+            goto done;
+    }
+    else if (validate_unit_add(vs, VU_SUBTREE, x, size) < 0)
+        goto done;
+    retval = 0;
+ done:
+    return retval;
+}
+
+/*! Validate a range of work units and write the first failure, if any, to cb
+ *
+ * Format is a line: "<index> <ret> <errno> <suberrno>" followed by error XML if ret is 0
+ * or error reason if ret is -1
+ * @param[in]  h       Clixon handle
+ * @param[in]  vs      Work units
+ * @param[in]  i0      First unit
+ * @param[in]  i1      Last unit + 1
+ * @param[in]  subtree If set validate VU_SUBTREE units only, otherwise all others
+ * @param[out] cb      Empty if all units valid
+ */
+static int
+validate_units_run(clicon_handle          h,
+                   struct validate_units *vs,
+                   int                    i0,
+                   int                    i1,
+                   int                    subtree,
+                   cbuf                  *cb)
+{
+    int                   retval = -1;
+    struct validate_unit *vu;
+    cxobj                *xerr = NULL;
+    int                   ret = 1;
+    int                   i;
+
+    for (i=i0; i<i1; i++){
+        vu = &vs->vs_vec[i];
+        if ((vu->vu_kind == VU_SUBTREE) != subtree)
+            continue;
+        switch (vu->vu_kind){
+        case VU_SUBTREE:
+            ret = xml_yang_validate_all1(h, vu->vu_x, 1, &xerr);
+            break;
+        case VU_NODE:
+            ret = xml_yang_validate_all1(h, vu->vu_x, 0, &xerr);
+            break;
+        case VU_MINMAX:
+            ret = xml_yang_minmax_recurse(vu->vu_x, 1, &xerr);
+            break;
+        case VU_MINMAX_TOP:
+            ret = xml_yang_minmax_recurse(vu->vu_x, 0, &xerr);
+            break;
+        }
+        if (ret < 1)
+            break;
+    }
+    if (ret < 1){
+        cprintf(cb, "%d %d %d %d\n", i, ret, clicon_errno, clicon_suberrno);
+        if (ret < 0)
+            cprintf(cb, "%s", clicon_err_reason);
+        else if (xerr && clixon_xml2cbuf(cb, xerr, 0, 0, NULL, -1, 1) < 0)
+            goto done;
+    }
+    retval = 0;
+ done:
+    if (xerr)
+        xml_free(xerr);
+    return retval;
+}
+
+/*! Fork a worker process validating a range of subtree units
+ *
+ * @param[in]  h    Clixon handle
+ * @param[in]  vs   Work units
+ * @param[in]  i0   First unit
+ * @param[in]  i1   Last unit + 1
+ * @param[out] pid  Process id of worker
+ * @param[out] fd   Read end of pipe where the worker writes its result
+ */
+static int
+validate_worker_fork(clicon_handle          h,
+                     struct validate_units *vs,
+                     int                    i0,
+                     int                    i1,
+                     pid_t                 *pid,
+                     int                   *fd)
+{
+    int    retval = -1;
+    int    p[2];
+    cbuf  *cb;
+    char  *buf;
+    size_t len;
+    ssize_t n;
+
+    if (pipe(p) < 0){
+        clicon_err(OE_UNIX, errno, "pipe");
+        goto done;
+    }
+    if ((*pid = fork()) < 0){
+        clicon_err(OE_UNIX, errno, "fork");
+        close(p[0]);
+        close(p[1]);
+        goto done;
+    }
+    if (*pid == 0){ /* child */
+        close(p[0]);
+        if ((cb = cbuf_new()) == NULL)
+            _exit(1);
+        if (validate_units_run(h, vs, i0, i1, 1, cb) < 0){
+            cbuf_reset(cb);
+            cprintf(cb, "%d -1 %d %d\n%s", i0, clicon_errno, clicon_suberrno, clicon_err_reason);
+        }
+        buf = cbuf_get(cb);
+        len = cbuf_len(cb);
+        while (len > 0){
+            if ((n = write(p[1], buf, len)) < 0){
+                if (errno == EINTR)
+                    continue;
+                _exit(1);
+            }
+            buf += n;
+            len -= n;
+        }
+        _exit(0);
+    }
+    close(p[1]);
+    *fd = p[0];
+    retval = 0;
+ done:
+    return retval;
+}
+
+/*! Read result of a worker until end-of-file and reap it
+ *
+ * @param[in]  pid  Process id of worker
+ * @param[in]  fd   Read end of pipe, closed here
+ * @param[out] cb   Result as written by validate_units_run
+ */
+static int
+validate_worker_wait(pid_t pid,
+                     int   fd,
+                     cbuf *cb)
+{
+    int     retval = -1;
+    char    buf[4096];
+    ssize_t n;
+    int     status = 0;
+
+    while ((n = read(fd, buf, sizeof(buf))) != 0){
+        if (n < 0){
+            if (errno == EINTR)
+                continue;
+            clicon_err(OE_UNIX, errno, "read");
+            goto done;
+        }
+        cbuf_append_buf(cb, buf, n);
+    }
+    while (waitpid(pid, &status, 0) < 0){
+        if (errno != EINTR){
+            clicon_err(OE_UNIX, errno, "waitpid");
+            goto done;
+        }
+    }
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0){
+        clicon_err(OE_UNIX, 0, "Validation worker %d failed with status %#x", pid, status);
+        goto done;
+    }
+    retval = 0;
+ done:
+    close(fd);
+    return retval;
+}
+
+/*! Translate the failure of a work unit to return value and xret
+ *
+ * @param[in]  str   Result as written by validate_units_run
+ * @param[out] xret  Error XML tree
+ * @retval     0     Validation failed (xret set)
+ * @retval    -1     Error
+ */
+static int
+validate_result_get(char   *str,
+                    cxobj **xret)
+{
+    int   retval = -1;
+    int   i;
+    int   ret;
+    int   err;
+    int   suberr;
+    char *body;
+
+    if (sscanf(str, "%d %d %d %d", &i, &ret, &err, &suberr) != 4 ||
+        (body = strchr(str, '\n')) == NULL){
+        clicon_err(OE_XML, 0, "Malformed validation worker result");
+        goto done;
+    }
+    body++;
+    if (ret < 0){
+        clicon_err(err, suberr, "%s", body);
+        goto done;
+    }
+    if (xret && strlen(body)){
+        if (*xret == NULL){
+            if ((*xret = xml_new("rpc-reply", NULL, CX_ELMNT)) == NULL)
+                goto done;
+            if (xml_add_attr(*xret, "xmlns", NETCONF_BASE_NAMESPACE, NULL, NULL) < 0)
+                goto done;
+        }
+        else if (xml_name_set(*xret, "rpc-reply") < 0)
+            goto done;
+        if (clixon_xml_parse_string(body, YB_NONE, NULL, xret, NULL) < 0)
+            goto done;
+    }
+    retval = 0;
+ done:
+    return retval;
+}
+
+/*! Validate top-level XML in parallel using worker processes
+ *
+ * @param[in]  h       Clixon handle
+ * @param[in]  xt      Top-level XML tree
+ * @param[in]  workers Number of worker processes
+ * @param[out] xret    Error XML tree (if ret == 0). Free with xml_free after use
+ * @retval     1       Validation OK
+ * @retval     0       Validation failed (xret set)
+ * @retval    -1       Error
+ * @see xml_yang_validate_all_top  Sequential variant
+ */
+static int
+xml_yang_validate_all_parallel(clicon_handle h,
+                               cxobj        *xt,
+                               int           workers,
+                               cxobj       **xret)
+{
+    int                   retval = -1;
+    struct validate_units vs = {0,};
+    size_t                total;
+    size_t                target;
+    size_t                acc;
+    cxobj                *x;
+    pid_t                *pids = NULL;
+    int                  *fds = NULL;
+    cbuf                **cbs = NULL;
+    int                   nw = 0;
+    int                   i;
+    int                   i0;
+    int                   w;
+    int                   best = -1;
+    int                   index;
+    char                 *str = NULL;
+
+    /* Aim at a few units per worker to even out the load */
+    total = xml_subtree_nr(xt);
+    target = total / (workers * 4) + 1;
+    x = NULL;
+    while ((x = xml_child_each(xt, x, CX_ELMNT)) != NULL)
+        if (validate_units_split(x, target, &vs) < 0)
+            goto done;
+    if (validate_unit_add(&vs, VU_MINMAX_TOP, xt, 0) < 0)
+        goto done;
+    if ((pids = calloc(workers, sizeof(*pids))) == NULL ||
+        (fds = calloc(workers, sizeof(*fds))) == NULL ||
+        (cbs = calloc(workers+1, sizeof(*cbs))) == NULL){
+        clicon_err(OE_UNIX, errno, "calloc");
+        goto done;
+    }
+    for (w=0; w<workers+1; w++)
+        if ((cbs[w] = cbuf_new()) == NULL){
+            clicon_err(OE_UNIX, errno, "cbuf_new");
+            goto done;
+        }
+    /* Partition subtree units in contiguous ranges of roughly equal size */
+    total = 0;
+    for (i=0; i<vs.vs_len; i++)
+        total += vs.vs_vec[i].vu_size;
+    acc = 0;
+    i0 = 0;
+    for (i=0; i<vs.vs_len && nw < workers; i++){
+        acc += vs.vs_vec[i].vu_size;
+        if (i == vs.vs_len-1 || acc >= (total*(nw+1))/workers){
+            if (validate_worker_fork(h, &vs, i0, i+1, &pids[nw], &fds[nw]) < 0)
+                goto done;
+            nw++;
+            i0 = i+1;
+        }
+    }
+    /* Validate node and unique/min/max units here while workers run */
+    if (validate_units_run(h, &vs, 0, vs.vs_len, 0, cbs[workers]) < 0)
+        goto done;
+    for (w=0; w<nw; w++){
+        if (validate_worker_wait(pids[w], fds[w], cbs[w]) < 0){
+            pids[w] = 0;
+            goto done;
+        }
+        pids[w] = 0;
+    }
+    /* Report the failure with the lowest unit index */
+    for (w=0; w<workers+1; w++){
+        if (cbuf_len(cbs[w]) == 0)
+            continue;
+        if (sscanf(cbuf_get(cbs[w]), "%d", &index) != 1)
+            index = 0;
+        if (best == -1 || index < best){
+            best = index;
+            str = cbuf_get(cbs[w]);
+        }
+    }
+    if (best == -1)
+        retval = 1;
+    else if (validate_result_get(str, xret) < 0)
+        goto done;
+    else
+        retval = 0;
+ done:
+    for (w=0; w<nw; w++){
+        if (pids[w] == 0)
+            continue;
+        kill(pids[w], SIGKILL);
+        close(fds[w]);
+        waitpid(pids[w], NULL, 0);
+    }
+    if (cbs){
+        for (w=0; w<workers+1; w++)
+            if (cbs[w])
+                cbuf_free(cbs[w]);
+        free(cbs);
+    }
+    if (pids)
+        free(pids);
+    if (fds)
+        free(fds);
+    if (vs.vs_vec)
+        free(vs.vs_vec);
+    return retval;
+}
+
 /*! Validate a single XML node with yang specification
  *
+ * If CLICON_VALIDATE_WORKERS is larger than one, validation is made in parallel by
+ * worker processes, see xml_yang_validate_all_parallel
+ * Leafref targets are indexed during validation, see leafref_index_begin
  * @param[in]  h     Clixon handle
  * @param[out] xret   Error XML tree (if ret == 0). Free with xml_free after use
  * @retval     1      Validation OK
@@ -1402,17 +1858,276 @@ xml_yang_validate_all_top(clicon_handle h,
                           cxobj        *xt,
                           cxobj       **xret)
 {
+    int    retval = -1;
     int    ret;
     cxobj *x;
+    int    workers;
+    int    lrindex;
+
+    if ((lrindex = leafref_index_begin(h)) < 0)
+        goto done;
+    workers = clicon_option_int(h, "CLICON_VALIDATE_WORKERS");
+    if (workers > 1 &&
+        xml_child_nr_type(xt, CX_ELMNT) > 0 &&
+        !clicon_option_bool(h, "CLICON_YANG_SCHEMA_MOUNT")){
+        retval = xml_yang_validate_all_parallel(h, xt, workers, xret);
+        goto done;
+    }
+    x = NULL;
+    while ((x = xml_child_each(xt, x, CX_ELMNT)) != NULL) {
+        if ((ret = xml_yang_validate_all(h, x, xret)) < 1){
+            retval = ret;
+            goto done;
+        }
+    }
+    if ((ret = xml_yang_minmax_recurse(xt, 0, xret)) < 1){
+        retval = ret;
+        goto done;
+    }
+    retval = 1;
+ done:
+    if (lrindex == 1)
+        leafref_index_end(h);
+    return retval;
+}
+
+/*! Find node in target tree corresponding to a node in source tree
+ *
+ * @param[in]  xt  Top of target tree
+ * @param[in]  xs  Node in source tree
+ * @param[out] xp  Corresponding target node, or NULL if not found
+ */
+static int
+validate_incr_target(cxobj  *xt,
+                     cxobj  *xs,
+                     cxobj **xp)
+{
+    cxobj *xparent;
+
+    *xp = NULL;
+    if ((xparent = xml_parent(xs)) == NULL){
+        *xp = xt;
+        return 0;
+    }
+    if (validate_incr_target(xt, xparent, &xparent) < 0)
+        return -1;
+    if (xparent == NULL)
+        return 0;
+    return match_base_child(xparent, xs, xml_spec(xs), xp);
+}
+
+/*! Mark constraints depending on nodes in an added or deleted subtree
+ */
+static int
+validate_incr_subtree(validate_deps *vd,
+                      cxobj         *xt,
+                      yang_stmt   ***yvec,
+                      int           *ylen)
+{
+    cxobj *x;
+
+    if (validate_deps_mark(vd, xml_name(xt), 1, yvec, ylen) < 0)
+        return -1;
+    x = NULL;
+    while ((x = xml_child_each(xt, x, CX_ELMNT)) != NULL)
+        if (validate_incr_subtree(vd, x, yvec, ylen) < 0)
+            return -1;
+    return 0;
+}
+
+/*! Mark node and its ancestors as changed, excluding top
+ *
+ * Marked nodes are flagged with XML_FLAG_MARK and appended to xvec, constraints depending
+ * on their values are marked with YANG_FLAG_TMP and appended to yvec
+ */
+static int
+validate_incr_ancestors(validate_deps *vd,
+                        cxobj         *x,
+                        cxobj       ***xvec,
+                        int           *xlen,
+                        yang_stmt   ***yvec,
+                        int           *ylen)
+{
+    for (; x != NULL && xml_parent(x) != NULL; x = xml_parent(x)){
+        if (xml_flag(x, XML_FLAG_MARK))
+            break;
+        xml_flag_set(x, XML_FLAG_MARK);
+        if (cxvec_append(x, xvec, xlen) < 0)
+            return -1;
+        if (validate_deps_mark(vd, xml_name(x), 0, yvec, ylen) < 0)
+            return -1;
+    }
+    return 0;
+}
+
+/*! Collect instances of data nodes marked with YANG_FLAG_TMP
+ *
+ * Only descend into nodes whose YANG is an ancestor of a marked data node, ie marked with
+ * YANG_FLAG_MARK
+ */
+static int
+validate_incr_instances(cxobj   *xt,
+                        cxobj ***xvec,
+                        int     *xlen)
+{
+    cxobj     *x;
+    yang_stmt *y;
 
     x = NULL;
     while ((x = xml_child_each(xt, x, CX_ELMNT)) != NULL) {
-        if ((ret = xml_yang_validate_all(h, x, xret)) < 1)
-            return ret;
+        if ((y = xml_spec(x)) == NULL)
+            continue;
+        if (yang_flag_get(y, YANG_FLAG_TMP) &&
+            cxvec_append(x, xvec, xlen) < 0)
+            return -1;
+        if (yang_flag_get(y, YANG_FLAG_MARK) &&
+            validate_incr_instances(x, xvec, xlen) < 0)
+            return -1;
+    }
+    return 0;
+}
+
+/*! Validate changed parts of a tree, assuming the tree was valid before the change
+ *
+ * Validates added and changed subtrees, ancestors of all changes including unique and
+ * min/max-elements of their children, and instances of data nodes whose must, when or
+ * leafref constraints reference names of added, deleted or changed nodes, see
+ * validate_deps_get.
+ * Falls back to validating the whole tree if schema mount is enabled.
+ * @param[in]  h     Clixon handle
+ * @param[in]  xt    Top of target tree
+ * @param[in]  avec  Added subtrees in target
+ * @param[in]  alen  Length of avec
+ * @param[in]  dvec  Deleted subtrees in source
+ * @param[in]  dlen  Length of dvec
+ * @param[in]  tcvec Changed nodes in target
+ * @param[in]  clen  Length of tcvec
+ * @param[out] xret  Error XML tree (if ret == 0). Free with xml_free after use
+ * @retval     1     Validation OK
+ * @retval     0     Validation failed (xret set)
+ * @retval    -1     Error
+ * @see xml_yang_validate_all_top
+ */
+int
+xml_yang_validate_incr(clicon_handle h,
+                       cxobj        *xt,
+                       cxobj       **avec,
+                       int           alen,
+                       cxobj       **dvec,
+                       int           dlen,
+                       cxobj       **tcvec,
+                       int           clen,
+                       cxobj       **xret)
+{
+    int            retval = -1;
+    validate_deps *vd = NULL;
+    yang_stmt    **yvec = NULL;
+    int            ylen = 0;
+    cxobj        **xanc = NULL; /* Changed ancestors */
+    int            anclen = 0;
+    cxobj        **xdep = NULL; /* Dependent instances */
+    int            deplen = 0;
+    yang_stmt     *y;
+    cxobj         *x;
+    int            ret;
+    int            i;
+    int            lrindex = 0;
+
+    if (clicon_option_bool(h, "CLICON_YANG_SCHEMA_MOUNT"))
+        return xml_yang_validate_all_top(h, xt, xret);
+    if ((lrindex = leafref_index_begin(h)) < 0)
+        goto done;
+    if (validate_deps_get(h, clicon_dbspec_yang(h), &vd) < 0)
+        goto done;
+    /* 1. Collect changed nodes and mark dependent constraints */
+    if (validate_deps_mark_global(vd, &yvec, &ylen) < 0)
+        goto done;
+    for (i=0; i<alen; i++){
+        if (validate_incr_subtree(vd, avec[i], &yvec, &ylen) < 0)
+            goto done;
+        if (validate_incr_ancestors(vd, xml_parent(avec[i]), &xanc, &anclen, &yvec, &ylen) < 0)
+            goto done;
     }
-    if ((ret = xml_yang_minmax_recurse(xt, 0, xret)) < 1)
-        return ret;
-    return 1;
+    for (i=0; i<dlen; i++){
+        if (validate_incr_subtree(vd, dvec[i], &yvec, &ylen) < 0)
+            goto done;
+        if (validate_incr_target(xt, xml_parent(dvec[i]), &x) < 0)
+            goto done;
+        if (x == NULL){ /* Should not happen, fall back to full validation */
+            retval = xml_yang_validate_all_top(h, xt, xret);
+            goto done;
+        }
+        if (validate_incr_ancestors(vd, x, &xanc, &anclen, &yvec, &ylen) < 0)
+            goto done;
+    }
+    for (i=0; i<clen; i++)
+        if (validate_incr_ancestors(vd, tcvec[i], &xanc, &anclen, &yvec, &ylen) < 0)
+            goto done;
+    /* 2. Find instances of dependent constraints */
+    for (i=0; i<ylen; i++)
+        for (y = yang_parent_get(yvec[i]); y != NULL; y = yang_parent_get(y)){
+            if (yang_flag_get(y, YANG_FLAG_MARK))
+                break;
+            yang_flag_set(y, YANG_FLAG_MARK);
+        }
+    ret = validate_incr_instances(xt, &xdep, &deplen);
+    for (i=0; i<ylen; i++)
+        for (y = yang_parent_get(yvec[i]); y != NULL; y = yang_parent_get(y)){
+            if (!yang_flag_get(y, YANG_FLAG_MARK))
+                break;
+            yang_flag_reset(y, YANG_FLAG_MARK);
+        }
+    if (ret < 0)
+        goto done;
+    clixon_debug(CLIXON_DBG_DETAIL, "%s: %d added %d deleted %d changed %d ancestors %d dependent",
+                 __FUNCTION__, alen, dlen, clen, anclen, deplen);
+    /* 3. Validate */
+    for (i=0; i<alen; i++){
+        if ((ret = xml_yang_validate_all(h, avec[i], xret)) < 1){
+            retval = ret;
+            goto done;
+        }
+    }
+    for (i=0; i<anclen; i++){
+        x = xanc[i];
+        if ((ret = xml_yang_validate_all1(h, x, 0, xret)) < 1){
+            retval = ret;
+            goto done;
+        }
+        if ((y = xml_spec(x)) != NULL && yang_config(y) != 0 &&
+            (ret = xml_yang_minmax_recurse(x, 1, xret)) < 1){
+            retval = ret;
+            goto done;
+        }
+    }
+    for (i=0; i<deplen; i++){
+        x = xdep[i];
+        if (xml_flag(x, XML_FLAG_MARK)) /* Validated as ancestor */
+            continue;
+        if ((ret = xml_yang_validate_all1(h, x, 0, xret)) < 1){
+            retval = ret;
+            goto done;
+        }
+    }
+    if ((ret = xml_yang_minmax_recurse(xt, 0, xret)) < 1){
+        retval = ret;
+        goto done;
+    }
+    retval = 1;
+ done:
+    if (lrindex == 1)
+        leafref_index_end(h);
+    for (i=0; i<ylen; i++)
+        yang_flag_reset(yvec[i], YANG_FLAG_TMP);
+    for (i=0; i<anclen; i++)
+        xml_flag_reset(xanc[i], XML_FLAG_MARK);
+    if (xanc)
+        free(xanc);
+    if (xdep)
+        free(xdep);
+    if (yvec)
+        free(yvec);
+    return retval;
 }
 
 /*! Check validity of outgoing RPC
@@ -0,0 +1,516 @@
+/*
+ *
+  ***** BEGIN LICENSE BLOCK *****
+ 
+  Copyright (C) 2009-2016 Olof Hagsand and Benny Holmgren
+  Copyright (C) 2017-2019 Olof Hagsand
+  Copyright (C) 2020-2022 Olof Hagsand and Rubicon Communications, LLC(Netgate)
+
+  This file is part of CLIXON.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  Alternatively, the contents of this file may be used under the terms of
+  the GNU General Public License Version 3 or later (the "GPL"),
+  in which case the provisions of the GPL are applicable instead
+  of those above. If you wish to allow use of your version of this file only
+  under the terms of the GPL, and not to allow others to
+  use your version of this file under the terms of Apache License version 2, 
+  indicate your decision by deleting the provisions above and replace them with
+  the  notice and other provisions required by the GPL. If you do not delete
+  the provisions above, a recipient may use your version of this file under
+  the terms of any one of the Apache License version 2 or the GPL.
+
+  ***** END LICENSE BLOCK *****
+
+ *
+ * Dependency index from YANG must, when and leafref expressions to the names of the
+ * data nodes they reference.
+ * Used by incremental validation to find constraints that need to be re-evaluated when
+ * nodes with a given name are added, deleted or changed, see xml_yang_validate_incr.
+ * Names are local names without namespace, which may give false positives but never
+ * misses a dependency. An expression whose result may depend on any node, such as one using
+ * wildcards, node() or deref(), is global and always re-evaluated.
+ */
+#ifdef HAVE_CONFIG_H
+#include "clixon_config.h" /* generated by config & autoconf */
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <string.h>
+#include <syslog.h>
+
+/* cligen */
+#include <cligen/cligen.h>
+
+/* clicon */
+#include "clixon_string.h"
+#include "clixon_queue.h"
+#include "clixon_hash.h"
+#include "clixon_handle.h"
+#include "clixon_err.h"
+#include "clixon_log.h"
+#include "clixon_yang.h"
+#include "clixon_xml.h"
+#include "clixon_data.h"
+#include "clixon_xpath_ctx.h"
+#include "clixon_xpath.h"
+#include "clixon_yang_type.h"
+#include "clixon_validate_deps.h"
+
+/* Name of dependency index in clixon handle */
+#define VALIDATE_DEPS_NAME "validate_deps"
+
+/* Reference from a constraint to a node name */
+struct validate_dep{
+    char      *vd_name;  /* Local name of referenced node */
+    int        vd_final; /* Name is last step of a location path, ie node value is used */
+    yang_stmt *vd_ys;    /* Data node with must, when or leafref constraint */
+};
+
+/* Dependency index, sorted on name */
+struct validate_deps{
+    struct validate_dep *vd_vec;
+    int                  vd_len;
+    int                  vd_max;
+    yang_stmt          **vd_global;  /* Data nodes with constraints depending on any node */
+    int                  vd_glen;
+    yang_stmt           *vd_yspec;   /* YANG spec the index is built from */
+};
+
+/*! Append yang node to vector
+ */
+static int
+validate_deps_yvec_add(yang_stmt  *ys,
+                       yang_stmt ***yvec,
+                       int         *ylen)
+{
+    yang_stmt **yv;
+
+    if ((yv = realloc(*yvec, (*ylen+1)*sizeof(*yv))) == NULL){
+        clicon_err(OE_UNIX, errno, "realloc");
+        return -1;
+    }
+    yv[(*ylen)++] = ys;
+    *yvec = yv;
+    return 0;
+}
+
+/*! Add a reference from a constraint of ys to nodes with name
+ */
+static int
+validate_deps_add(validate_deps *vd,
+                  yang_stmt     *ys,
+                  char          *name,
+                  int            final)
+{
+    int                  retval = -1;
+    struct validate_dep *dep;
+
+    if (vd->vd_len >= vd->vd_max){
+        vd->vd_max = vd->vd_max ? 2*vd->vd_max : 64;
+        if ((dep = realloc(vd->vd_vec, vd->vd_max*sizeof(*dep))) == NULL){
+            clicon_err(OE_UNIX, errno, "realloc");
+            goto done;
+        }
+        vd->vd_vec = dep;
+    }
+    dep = &vd->vd_vec[vd->vd_len];
+    if ((dep->vd_name = strdup(name)) == NULL){
+        clicon_err(OE_UNIX, errno, "strdup");
+        goto done;
+    }
+    dep->vd_final = final;
+    dep->vd_ys = ys;
+    vd->vd_len++;
+    retval = 0;
+ done:
+    return retval;
+}
+
+/*! Collect node names referenced by a parsed XPath expression
+ *
+ * @param[in]  vd     Dependency index
+ * @param[in]  ys     Data node with the constraint
+ * @param[in]  xs     XPath parse tree
+ * @param[in]  final  Set if xs is, or ends, the last step of a location path
+ * @param[out] global Set if the expression may depend on any node
+ */
+static int
+validate_deps_xpath(validate_deps *vd,
+                    yang_stmt     *ys,
+                    xpath_tree    *xs,
+                    int            final,
+                    int           *global)
+{
+    int         retval = -1;
+    xpath_tree *xn;
+    char       *name;
+
+    if (xs == NULL)
+        goto ok;
+    switch (xs->xs_type){
+    case XP_RELLOCPATH:
+    case XP_PATHEXPR:
+        /* Only the last step of a path is final, eg a in a/b only selects b */
+        if (validate_deps_xpath(vd, ys, xs->xs_c0, xs->xs_c1?0:final, global) < 0)
+            goto done;
+        if (validate_deps_xpath(vd, ys, xs->xs_c1, final, global) < 0)
+            goto done;
+        break;
+    case XP_STEP:
+        if ((xn = xs->xs_c0) == NULL){ /* . or .. */
+            /* Value of parent depends on its other children */
+            if (final && xs->xs_int == A_PARENT)
+                *global = 1;
+        }
+        else if (xn->xs_type == XP_NODE){
+            name = xn->xs_s1;
+            if (name == NULL || strcmp(name, "*") == 0)
+                *global = 1;
+            else if (validate_deps_add(vd, ys, name, final) < 0)
+                goto done;
+        }
+        else if (xs->xs_int != A_SELF && (final || xs->xs_int != A_PARENT))
+            *global = 1; /* node(), text(), etc */
+        /* Predicates are expressions of their own */
+        if (validate_deps_xpath(vd, ys, xs->xs_c1, 1, global) < 0)
+            goto done;
+        break;
+    case XP_ABSPATH:
+        if (xs->xs_c0 == NULL && final) /* Value of root */
+            *global = 1;
+        if (validate_deps_xpath(vd, ys, xs->xs_c0, final, global) < 0)
+            goto done;
+        break;
+    case XP_PRIME_FN:
+        if (xs->xs_s0 && strcmp(xs->xs_s0, "deref") == 0)
+            *global = 1;
+        /* fall thru */
+    default:
+        if (validate_deps_xpath(vd, ys, xs->xs_c0, final, global) < 0)
+            goto done;
+        if (validate_deps_xpath(vd, ys, xs->xs_c1, final, global) < 0)
+            goto done;
+        break;
+    }
+ ok:
+    retval = 0;
+ done:
+    return retval;
+}
+
+/*! Add references of an XPath expression of a constraint of a data node
+ */
+static int
+validate_deps_expr(validate_deps *vd,
+                   yang_stmt     *ys,
+                   char          *xpath)
+{
+    int         retval = -1;
+    xpath_tree *xs = NULL;
+    int         global = 0;
+
+    if (xpath_parse(xpath, &xs) < 0)
+        goto done;
+    if (validate_deps_xpath(vd, ys, xs, 1, &global) < 0)
+        goto done;
+    if (global &&
+        validate_deps_yvec_add(ys, &vd->vd_global, &vd->vd_glen) < 0)
+        goto done;
+    retval = 0;
+ done:
+    if (xs)
+        xpath_tree_free(xs);
+    return retval;
+}
+
+/*! Add references of leafref paths of a (resolved) type, including union members
+ */
+static int
+validate_deps_type(validate_deps *vd,
+                   yang_stmt     *ys,
+                   yang_stmt     *yrestype)
+{
+    int        retval = -1;
+    char      *restype;
+    yang_stmt *ypath;
+    yang_stmt *ytsub = NULL;
+    yang_stmt *ytype;
+
+    if (yrestype == NULL)
+        goto ok;
+    restype = yang_argument_get(yrestype);
+    if (strcmp(restype, "leafref") == 0){
+        if ((ypath = yang_find(yrestype, Y_PATH, NULL)) != NULL &&
+            validate_deps_expr(vd, ys, yang_argument_get(ypath)) < 0)
+            goto done;
+    }
+    else if (strcmp(restype, "union") == 0){
+        while ((ytsub = yn_each(yrestype, ytsub)) != NULL){
+            if (yang_keyword_get(ytsub) != Y_TYPE)
+                continue;
+            if (yang_type_resolve(ys, ys, ytsub, &ytype, NULL, NULL, NULL, NULL, NULL) < 0)
+                goto done;
+            if (validate_deps_type(vd, ys, ytype) < 0)
+                goto done;
+        }
+    }
+ ok:
+    retval = 0;
+ done:
+    return retval;
+}
+
+/*! Add references of all constraints of config data nodes under yn recursively
+ */
+static int
+validate_deps_yang(validate_deps *vd,
+                   yang_stmt     *yn)
+{
+    int        retval = -1;
+    yang_stmt *ys = NULL;
+    yang_stmt *yc;
+    yang_stmt *yrestype;
+    char      *xpath;
+
+    while ((ys = yn_each(yn, ys)) != NULL){
+        switch (yang_keyword_get(ys)){
+        case Y_CHOICE:
+        case Y_CASE:
+            if (validate_deps_yang(vd, ys) < 0)
+                goto done;
+            continue;
+        case Y_CONTAINER:
+        case Y_LIST:
+        case Y_LEAF:
+        case Y_LEAF_LIST:
+        case Y_ANYDATA:
+        case Y_ANYXML:
+            if (yang_config(ys) == 0)
+                continue;
+            break;
+        default: /* Groupings, augments, etc are already expanded */
+            continue;
+        }
+        yc = NULL;
+        while ((yc = yn_each(ys, yc)) != NULL){
+            if (yang_keyword_get(yc) != Y_MUST && yang_keyword_get(yc) != Y_WHEN)
+                continue;
+            if (validate_deps_expr(vd, ys, yang_argument_get(yc)) < 0)
+                goto done;
+        }
+        /* when inherited from uses or augment */
+        if ((xpath = yang_when_xpath_get(ys)) != NULL &&
+            validate_deps_expr(vd, ys, xpath) < 0)
+            goto done;
+        switch (yang_keyword_get(ys)){
+        case Y_LEAF:
+        case Y_LEAF_LIST:
+            if (yang_type_get(ys, NULL, &yrestype, NULL, NULL, NULL, NULL, NULL) < 0)
+                goto done;
+            if (validate_deps_type(vd, ys, yrestype) < 0)
+                goto done;
+            break;
+        case Y_CONTAINER:
+        case Y_LIST:
+            if (validate_deps_yang(vd, ys) < 0)
+                goto done;
+            break;
+        default:
+            break;
+        }
+    }
+    retval = 0;
+ done:
+    return retval;
+}
+
+static int
+validate_deps_cmp(const void *a,
+                  const void *b)
+{
+    const struct validate_dep *da = a;
+    const struct validate_dep *db = b;
+    int                        eq;
+
+    if ((eq = strcmp(da->vd_name, db->vd_name)) != 0)
+        return eq;
+    if (da->vd_ys != db->vd_ys)
+        return da->vd_ys < db->vd_ys ? -1 : 1;
+    return 0;
+}
+
+static void
+validate_deps_free1(validate_deps *vd)
+{
+    int i;
+
+    for (i=0; i<vd->vd_len; i++)
+        free(vd->vd_vec[i].vd_name);
+    if (vd->vd_vec)
+        free(vd->vd_vec);
+    if (vd->vd_global)
+        free(vd->vd_global);
+    free(vd);
+}
+
+/*! Get dependency index of a YANG spec, build it on first call
+ *
+ * The index is kept in the handle until validate_deps_free, which is also called when
+ * modules are added to a YANG spec. An index of another YANG spec is replaced.
+ * @param[in]  h     Clixon handle
+ * @param[in]  yspec YANG spec
+ * @param[out] vdp   Dependency index
+ * @retval     0     OK
+ * @retval    -1     Error
+ */
+int
+validate_deps_get(clicon_handle   h,
+                  yang_stmt      *yspec,
+                  validate_deps **vdp)
+{
+    int            retval = -1;
+    validate_deps *vd = NULL;
+    yang_stmt     *ymod = NULL;
+    int            i;
+    int            j;
+
+    if (clicon_ptr_get(h, VALIDATE_DEPS_NAME, (void**)&vd) == 0 && vd != NULL){
+        if (vd->vd_yspec == yspec){
+            *vdp = vd;
+            return 0;
+        }
+        validate_deps_free(h);
+    }
+    if ((vd = calloc(1, sizeof(*vd))) == NULL){
+        clicon_err(OE_UNIX, errno, "calloc");
+        goto done;
+    }
+    vd->vd_yspec = yspec;
+    while ((ymod = yn_each(yspec, ymod)) != NULL){
+        if (yang_keyword_get(ymod) != Y_MODULE && yang_keyword_get(ymod) != Y_SUBMODULE)
+            continue;
+        if (validate_deps_yang(vd, ymod) < 0)
+            goto done;
+    }
+    /* Sort on name and merge duplicates */
+    qsort(vd->vd_vec, vd->vd_len, sizeof(*vd->vd_vec), validate_deps_cmp);
+    for (i=0, j=0; i<vd->vd_len; i++){
+        if (j > 0 && validate_deps_cmp(&vd->vd_vec[j-1], &vd->vd_vec[i]) == 0){
+            vd->vd_vec[j-1].vd_final |= vd->vd_vec[i].vd_final;
+            free(vd->vd_vec[i].vd_name);
+            continue;
+        }
+        vd->vd_vec[j++] = vd->vd_vec[i];
+    }
+    vd->vd_len = j;
+    clixon_debug(CLIXON_DBG_DEFAULT, "%s: %d references, %d global", __FUNCTION__,
+                 vd->vd_len, vd->vd_glen);
+    if (clicon_ptr_set(h, VALIDATE_DEPS_NAME, vd) < 0)
+        goto done;
+    *vdp = vd;
+    vd = NULL;
+    retval = 0;
+ done:
+    if (vd)
+        validate_deps_free1(vd);
+    return retval;
+}
+
+/*! Mark data nodes with constraints depending on nodes with name
+ *
+ * Data nodes are marked with YANG_FLAG_TMP and appended to yvec unless already marked.
+ * Caller resets the flags.
+ * @param[in]     vd    Dependency index
+ * @param[in]     name  Local name of added, deleted or changed node
+ * @param[in]     exist If set, node was added or deleted, otherwise only its value changed
+ * @param[in,out] yvec  Vector of marked data nodes
+ * @param[in,out] ylen  Length of yvec
+ * @retval        0     OK
+ * @retval       -1     Error
+ */
+int
+validate_deps_mark(validate_deps *vd,
+                   const char    *name,
+                   int            exist,
+                   yang_stmt   ***yvec,
+                   int           *ylen)
+{
+    int                  lo = 0;
+    int                  hi = vd->vd_len;
+    int                  mid;
+    struct validate_dep *dep;
+
+    while (lo < hi){
+        mid = (lo + hi)/2;
+        if (strcmp(vd->vd_vec[mid].vd_name, name) < 0)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    for (; lo < vd->vd_len; lo++){
+        dep = &vd->vd_vec[lo];
+        if (strcmp(dep->vd_name, name) != 0)
+            break;
+        if (!exist && !dep->vd_final)
+            continue;
+        if (yang_flag_get(dep->vd_ys, YANG_FLAG_TMP))
+            continue;
+        yang_flag_set(dep->vd_ys, YANG_FLAG_TMP);
+        if (validate_deps_yvec_add(dep->vd_ys, yvec, ylen) < 0)
+            return -1;
+    }
+    return 0;
+}
+
+/*! Mark data nodes with constraints that may depend on any node
+ *
+ * @see validate_deps_mark
+ */
+int
+validate_deps_mark_global(validate_deps *vd,
+                          yang_stmt   ***yvec,
+                          int           *ylen)
+{
+    int        i;
+    yang_stmt *ys;
+
+    for (i=0; i<vd->vd_glen; i++){
+        ys = vd->vd_global[i];
+        if (yang_flag_get(ys, YANG_FLAG_TMP))
+            continue;
+        yang_flag_set(ys, YANG_FLAG_TMP);
+        if (validate_deps_yvec_add(ys, yvec, ylen) < 0)
+            return -1;
+    }
+    return 0;
+}
+
+/*! Free dependency index of handle
+ *
+ * @param[in]  h     Clixon handle
+ */
+int
+validate_deps_free(clicon_handle h)
+{
+    validate_deps *vd = NULL;
+
+    if (clicon_ptr_get(h, VALIDATE_DEPS_NAME, (void**)&vd) == 0 && vd != NULL){
+        validate_deps_free1(vd);
+        clicon_ptr_del(h, VALIDATE_DEPS_NAME);
+    }
+    return 0;
+}
@@ -87,6 +87,13 @@
 #define XML_CHILDVEC_SIZE_START_ELMNT 16
 #define XML_CHILDVEC_SIZE_THRESHOLD 65536
 
+#ifdef XML_CHILDVEC_CHUNKED
+/* Number of children when a flat child vector is converted to a chunked vector */
+#define XML_CHILDVEC_CHUNK_THRESHOLD 8192
+/* Max number of children in one chunk */
+#define XML_CHILDVEC_CHUNK_MAX 1024
+#endif
+
 /* Intention of these macros is to guard against access of type-specific fields 
  * As debug they can contain an assert.
  */
@@ -126,6 +133,36 @@ struct search_index{
 };
 #endif
 
+#ifdef XML_CHILDVEC_CHUNKED
+/* Chunked child vector replacing the flat x_childvec of a node with many children
+ *
+ * The children are stored in order in a sequence of chunks of at most XML_CHILDVEC_CHUNK_MAX
+ * entries. cc_offset[k] is the position of the first child of chunk k.
+ * Child i is found by a binary search on cc_offset (or directly via the cc_hint of the last
+ * accessed chunk for sequential access). An insert or remove moves entries within one chunk and
+ * adjusts the offsets of the following chunks, instead of moving all following children.
+ *
+ *           cc_offset: 0      3      5
+ *                    +------+------+------+
+ *          cc_chunk: |  .   |  .   |  .   |
+ *                    +--|---+--|---+--|---+
+ *                       v      v      v
+ *                     a b c   d e    f g h
+ */
+struct xml_chunk{
+    int          ch_len;    /* Number of children in chunk */
+    struct xml  *ch_vec[XML_CHILDVEC_CHUNK_MAX];
+};
+
+struct xml_chunkvec{
+    struct xml_chunk **cc_chunk;  /* Vector of chunks */
+    int               *cc_offset; /* Position of first child of each chunk */
+    int                cc_len;    /* Number of chunks */
+    int                cc_max;    /* Allocated length of cc_chunk and cc_offset */
+    int                cc_hint;   /* Last accessed chunk */
+};
+#endif
+
 /*! xml tree node, with name, type, parent, children, etc 
  *
  * Note that this is a private type not visible from externally, use
@@ -180,6 +217,9 @@ struct xml{
     struct xml      **x_childvec;   /* vector of children nodes (XXX: use clixon_vec ) */
     int               x_childvec_len;/* Number of children */
     int               x_childvec_max;/* Length of allocated vector */
+#ifdef XML_CHILDVEC_CHUNKED
+    struct xml_chunkvec *x_chunkvec; /* If set, children are chunked and x_childvec is NULL */
+#endif
 
     cvec             *x_ns_cache;   /* Cached vector of namespaces (set by bind-yang) */
     yang_stmt        *x_spec;       /* Pointer to specification, eg yang, 
@@ -269,6 +309,12 @@ xml_stats_one(cxobj    *x,
     case CX_ELMNT:
         sz += sizeof(struct xml);
         sz += x->x_childvec_max*sizeof(struct xml*);
+#ifdef XML_CHILDVEC_CHUNKED
+        if (x->x_chunkvec)
+            sz += sizeof(struct xml_chunkvec) +
+                x->x_chunkvec->cc_max*(sizeof(struct xml_chunk*)+sizeof(int)) +
+                x->x_chunkvec->cc_len*sizeof(struct xml_chunk);
+#endif
         if (x->x_ns_cache)
             sz += cvec_size(x->x_ns_cache);
         if (x->x_cv)
@@ -896,6 +942,328 @@ xml_type_set(cxobj          *xn,
     return old;
 }
 
+#ifdef XML_CHILDVEC_CHUNKED
+/*! Find chunk of child at position i
+ *
+ * @param[in]  cc    Chunked child vector
+ * @param[in]  i     Child position, must be less than number of children
+ * @retval     k     Chunk index
+ */
+static int
+xml_chunk_find(struct xml_chunkvec *cc,
+               int                  i)
+{
+    int k;
+    int low;
+    int upper;
+    int mid;
+
+    /* Same or next chunk as last access, typically xml_child_each */
+    k = cc->cc_hint;
+    if (k < cc->cc_len && i >= cc->cc_offset[k]){
+        if (i < cc->cc_offset[k] + cc->cc_chunk[k]->ch_len)
+            return k;
+        k++;
+        if (k < cc->cc_len && i < cc->cc_offset[k] + cc->cc_chunk[k]->ch_len){
+            cc->cc_hint = k;
+            return k;
+        }
+    }
+    low = 0;
+    upper = cc->cc_len - 1;
+    while (low < upper){
+        mid = (low + upper + 1) / 2;
+        if (cc->cc_offset[mid] <= i)
+            low = mid;
+        else
+            upper = mid - 1;
+    }
+    cc->cc_hint = low;
+    return low;
+}
+
+/*! Insert a new empty chunk at chunk index k
+ *
+ * @param[in]  cc     Chunked child vector
+ * @param[in]  k      Chunk index
+ * @param[in]  offset Position of first child of chunk
+ * @retval     ch     New chunk
+ * @retval     NULL   Error
+ */
+static struct xml_chunk *
+xml_chunk_add(struct xml_chunkvec *cc,
+              int                  k,
+              int                  offset)
+{
+    struct xml_chunk *ch;
+
+    if (cc->cc_len == cc->cc_max){
+        cc->cc_max = cc->cc_max ? 2*cc->cc_max : 16;
+        if ((cc->cc_chunk = realloc(cc->cc_chunk, cc->cc_max*sizeof(struct xml_chunk*))) == NULL){
+            clicon_err(OE_XML, errno, "realloc");
+            return NULL;
+        }
+        if ((cc->cc_offset = realloc(cc->cc_offset, cc->cc_max*sizeof(int))) == NULL){
+            clicon_err(OE_XML, errno, "realloc");
+            return NULL;
+        }
+    }
+    if ((ch = malloc(sizeof(*ch))) == NULL){
+        clicon_err(OE_XML, errno, "malloc");
+        return NULL;
+    }
+    ch->ch_len = 0;
+    memmove(&cc->cc_chunk[k+1], &cc->cc_chunk[k], (cc->cc_len-k)*sizeof(struct xml_chunk*));
+    memmove(&cc->cc_offset[k+1], &cc->cc_offset[k], (cc->cc_len-k)*sizeof(int));
+    cc->cc_chunk[k] = ch;
+    cc->cc_offset[k] = offset;
+    cc->cc_len++;
+    return ch;
+}
+
+/*! Free chunked child vector, not the children
+ */
+static int
+xml_chunk_free(struct xml_chunkvec *cc)
+{
+    int k;
+
+    for (k=0; k<cc->cc_len; k++)
+        free(cc->cc_chunk[k]);
+    if (cc->cc_chunk)
+        free(cc->cc_chunk);
+    if (cc->cc_offset)
+        free(cc->cc_offset);
+    free(cc);
+    return 0;
+}
+
+/*! Convert the flat child vector of an XML node to a chunked child vector
+ *
+ * Chunks are filled to half to leave room for inserts
+ * @param[in]  x     XML node
+ * @retval     0     OK
+ * @retval    -1     Error, x is unchanged
+ */
+static int
+xml_chunk_convert(cxobj *x)
+{
+    int                  retval = -1;
+    struct xml_chunkvec *cc;
+    struct xml_chunk    *ch;
+    int                  i;
+    int                  n;
+
+    if ((cc = calloc(1, sizeof(*cc))) == NULL){
+        clicon_err(OE_XML, errno, "calloc");
+        goto done;
+    }
+    for (i=0; i<x->x_childvec_len; i+=n){
+        n = x->x_childvec_len - i;
+        if (n > XML_CHILDVEC_CHUNK_MAX/2)
+            n = XML_CHILDVEC_CHUNK_MAX/2;
+        if ((ch = xml_chunk_add(cc, cc->cc_len, i)) == NULL)
+            goto done;
+        memcpy(ch->ch_vec, &x->x_childvec[i], n*sizeof(cxobj*));
+        ch->ch_len = n;
+    }
+    if (x->x_childvec)
+        free(x->x_childvec);
+    x->x_childvec = NULL;
+    x->x_childvec_max = 0;
+    x->x_chunkvec = cc;
+    cc = NULL;
+    retval = 0;
+ done:
+    if (cc)
+        xml_chunk_free(cc);
+    return retval;
+}
+
+/*! Convert the chunked child vector of an XML node back to a flat child vector
+ *
+ * @param[in]  x     XML node
+ * @retval     0     OK
+ * @retval    -1     Error, x is unchanged
+ */
+static int
+xml_chunk_flatten(cxobj *x)
+{
+    struct xml_chunkvec *cc = x->x_chunkvec;
+    struct xml_chunk    *ch;
+    cxobj              **vec = NULL;
+    int                  i = 0;
+    int                  k;
+
+    if (x->x_childvec_len &&
+        (vec = malloc(x->x_childvec_len*sizeof(cxobj*))) == NULL){
+        clicon_err(OE_XML, errno, "malloc");
+        return -1;
+    }
+    for (k=0; k<cc->cc_len; k++){
+        ch = cc->cc_chunk[k];
+        memcpy(&vec[i], ch->ch_vec, ch->ch_len*sizeof(cxobj*));
+        i += ch->ch_len;
+    }
+    x->x_childvec = vec;
+    x->x_childvec_max = x->x_childvec_len;
+    x->x_chunkvec = NULL;
+    xml_chunk_free(cc);
+    return 0;
+}
+
+/*! Insert child xc at position i in chunked child vector
+ *
+ * A full chunk is split in two, except when appending where a new chunk is started
+ * @param[in]  xp    XML parent node with chunked child vector
+ * @param[in]  xc    XML child node
+ * @param[in]  i     Position, at most number of children
+ * @retval     0     OK
+ * @retval    -1     Error
+ */
+static int
+xml_chunk_insert(cxobj *xp,
+                 cxobj *xc,
+                 int    i)
+{
+    struct xml_chunkvec *cc = xp->x_chunkvec;
+    struct xml_chunk    *ch;
+    struct xml_chunk    *ch1;
+    int                  k;
+    int                  j;
+    int                  half;
+
+    if (cc->cc_len == 0){
+        if (xml_chunk_add(cc, 0, 0) == NULL)
+            return -1;
+        k = 0;
+    }
+    else if (i == xp->x_childvec_len)
+        k = cc->cc_len - 1;
+    else
+        k = xml_chunk_find(cc, i);
+    ch = cc->cc_chunk[k];
+    if (ch->ch_len == XML_CHILDVEC_CHUNK_MAX){
+        if (i == xp->x_childvec_len){
+            if ((ch = xml_chunk_add(cc, k+1, i)) == NULL)
+                return -1;
+            k++;
+        }
+        else{
+            half = XML_CHILDVEC_CHUNK_MAX/2;
+            if ((ch1 = xml_chunk_add(cc, k+1, cc->cc_offset[k] + half)) == NULL)
+                return -1;
+            memcpy(ch1->ch_vec, &ch->ch_vec[half], (XML_CHILDVEC_CHUNK_MAX-half)*sizeof(cxobj*));
+            ch1->ch_len = XML_CHILDVEC_CHUNK_MAX - half;
+            ch->ch_len = half;
+            if (i >= cc->cc_offset[k+1]){
+                ch = ch1;
+                k++;
+            }
+        }
+    }
+    j = i - cc->cc_offset[k];
+    memmove(&ch->ch_vec[j+1], &ch->ch_vec[j], (ch->ch_len-j)*sizeof(cxobj*));
+    ch->ch_vec[j] = xc;
+    ch->ch_len++;
+    cc->cc_hint = k;
+    for (k++; k<cc->cc_len; k++)
+        cc->cc_offset[k]++;
+    xp->x_childvec_len++;
+    return 0;
+}
+
+/*! Remove child at position i from chunked child vector, an empty chunk is freed
+ *
+ * @param[in]  xp    XML parent node with chunked child vector
+ * @param[in]  i     Position, less than number of children
+ */
+static int
+xml_chunk_rm(cxobj *xp,
+             int    i)
+{
+    struct xml_chunkvec *cc = xp->x_chunkvec;
+    struct xml_chunk    *ch;
+    int                  k;
+    int                  j;
+
+    k = xml_chunk_find(cc, i);
+    ch = cc->cc_chunk[k];
+    j = i - cc->cc_offset[k];
+    memmove(&ch->ch_vec[j], &ch->ch_vec[j+1], (ch->ch_len-j-1)*sizeof(cxobj*));
+    ch->ch_len--;
+    for (j=k+1; j<cc->cc_len; j++)
+        cc->cc_offset[j]--;
+    if (ch->ch_len == 0){
+        free(ch);
+        cc->cc_len--;
+        memmove(&cc->cc_chunk[k], &cc->cc_chunk[k+1], (cc->cc_len-k)*sizeof(struct xml_chunk*));
+        memmove(&cc->cc_offset[k], &cc->cc_offset[k+1], (cc->cc_len-k)*sizeof(int));
+        cc->cc_hint = 0;
+    }
+    xp->x_childvec_len--;
+    return 0;
+}
+#endif /* XML_CHILDVEC_CHUNKED */
+
+/*! Get child at position i of an element node, the position must be less than number of children
+ */
+static inline cxobj *
+xml_childvec_i(cxobj *x,
+               int    i)
+{
+#ifdef XML_CHILDVEC_CHUNKED
+    struct xml_chunkvec *cc;
+    int                  k;
+
+    if ((cc = x->x_chunkvec) != NULL){
+        k = xml_chunk_find(cc, i);
+        return cc->cc_chunk[k]->ch_vec[i - cc->cc_offset[k]];
+    }
+#endif
+    return x->x_childvec[i];
+}
+
+/*! Remove child at position i of an element node from child vector
+ */
+static int
+xml_childvec_rm(cxobj *xp,
+                int    i)
+{
+#ifdef XML_CHILDVEC_CHUNKED
+    if (xp->x_chunkvec)
+        return xml_chunk_rm(xp, i);
+#endif
+    xp->x_childvec[i] = NULL;
+    xp->x_childvec_len--;
+    if (i<xp->x_childvec_len)
+        memmove(&xp->x_childvec[i], &xp->x_childvec[i+1], (xp->x_childvec_len-i)*sizeof(cxobj*));
+    return 0;
+}
+
+/*! Get position of child in parent
+ *
+ * First try the position where the child was last inserted or iterated, see xml_child_each
+ * @param[in]  xp    XML parent node
+ * @param[in]  xc    XML child node
+ * @retval     i     Position of xc
+ * @retval    -1     xc is not a child of xp
+ */
+static int
+xml_child_pos(cxobj *xp,
+              cxobj *xc)
+{
+    int i;
+
+    i = xc->_x_vector_i;
+    if (i >= 0 && i < xp->x_childvec_len && xml_childvec_i(xp, i) == xc)
+        return i;
+    for (i=0; i<xp->x_childvec_len; i++)
+        if (xml_childvec_i(xp, i) == xc)
+            return i;
+    return -1;
+}
+
 /*! Get number of children
  *
  * @param[in]  xn    xml node
@@ -979,7 +1347,7 @@ xml_child_i(cxobj *xn,
     if (!is_element(xn))
         return NULL;
     if (i < xn->x_childvec_len)
-        return xn->x_childvec[i];
+        return xml_childvec_i(xn, i);
     return NULL;
 }
 
@@ -1022,8 +1390,19 @@ xml_child_i_set(cxobj *xt,
 {
     if (!is_element(xt))
         return NULL;
-    if (i < xt->x_childvec_len)
+    if (i < xt->x_childvec_len){
+#ifdef XML_CHILDVEC_CHUNKED
+        if (xt->x_chunkvec){
+            struct xml_chunkvec *cc = xt->x_chunkvec;
+            int                  k;
+
+            k = xml_chunk_find(cc, i);
+            cc->cc_chunk[k]->ch_vec[i - cc->cc_offset[k]] = xc;
+            return 0;
+        }
+#endif
         xt->x_childvec[i] = xc;
+    }
     return 0;
 }
 
@@ -1099,7 +1478,7 @@ xml_child_each(cxobj           *xparent,
     if (!is_element(xparent))
         return NULL;
     for (i=xprev?xprev->_x_vector_i+1:0; i<xparent->x_childvec_len; i++){
-        xn = xparent->x_childvec[i];
+        xn = xml_childvec_i(xparent, i);
         if (xn == NULL)
             continue;
         if (type != CX_ERROR && xml_type(xn) != type)
@@ -1136,7 +1515,7 @@ xml_child_each_attr(cxobj  *xparent,
     if (!is_element(xparent))
         return NULL;
     for (i=xprev?xprev->_x_vector_i+1:0; i<xparent->x_childvec_len; i++){
-        xn = xparent->x_childvec[i];
+        xn = xml_childvec_i(xparent, i);
         if (xn == NULL)
             continue;
         if (xml_type(xn) != CX_ATTR){
@@ -1171,6 +1550,11 @@ xml_child_append(cxobj *xp,
      */
     if (xml_type(xc) == CX_ELMNT)
         start = XML_CHILDVEC_SIZE_START_ELMNT;
+    xc->_x_vector_i = xp->x_childvec_len;
+#ifdef XML_CHILDVEC_CHUNKED
+    if (xp->x_chunkvec)
+        return xml_chunk_insert(xp, xc, xp->x_childvec_len);
+#endif
     xp->x_childvec_len++;
     if (xp->x_childvec_len > xp->x_childvec_max){
         if (xp->x_childvec_len < XML_CHILDVEC_SIZE_THRESHOLD)
@@ -1183,6 +1567,7 @@ xml_child_append(cxobj *xp,
             return -1;
         }
     }
+    /* Appending is amortized constant also in a flat vector, see xml_child_insert_pos */
     xp->x_childvec[xp->x_childvec_len-1] = xc;
     return 0;
 }
@@ -1201,6 +1586,11 @@ xml_child_insert_pos(cxobj *xp,
 
     if (!is_element(xp))
         return 0;
+    xc->_x_vector_i = i;
+#ifdef XML_CHILDVEC_CHUNKED
+    if (xp->x_chunkvec)
+        return xml_chunk_insert(xp, xc, i);
+#endif
     xp->x_childvec_len++;
     if (xp->x_childvec_len > xp->x_childvec_max){
         if (xp->x_childvec_len < XML_CHILDVEC_SIZE_THRESHOLD)
@@ -1216,6 +1606,11 @@ xml_child_insert_pos(cxobj *xp,
     size = (xml_child_nr(xp) - i - 1)*sizeof(cxobj *);
     memmove(&xp->x_childvec[i+1], &xp->x_childvec[i], size);
     xp->x_childvec[i] = xc;
+#ifdef XML_CHILDVEC_CHUNKED
+    /* Not when appending, eg bulk mode where the children are sorted after */
+    if (xp->x_childvec_len > XML_CHILDVEC_CHUNK_THRESHOLD && i < xp->x_childvec_len - 1)
+        return xml_chunk_convert(xp);
+#endif
     return 0;
 }
 
@@ -1233,6 +1628,12 @@ xml_childvec_set(cxobj *x,
 {
     if (!is_element(x))
         return 0;
+#ifdef XML_CHILDVEC_CHUNKED
+    if (x->x_chunkvec){
+        xml_chunk_free(x->x_chunkvec);
+        x->x_chunkvec = NULL;
+    }
+#endif
     x->x_childvec_len = len;
     x->x_childvec_max = len;
     if (x->x_childvec)
@@ -1245,15 +1646,100 @@ xml_childvec_set(cxobj *x,
 }
 
 /*! Get the children of an XML node as an XML vector
+ *
+ * @param[in]  x     XML node
+ * @retval     xv    Vector of children, valid until children are added or removed
+ * @retval     NULL  No children, or error
+ * @note A chunked child vector (many children) is converted to a flat vector, which is
+ *       linear in the number of children, and stays flat until the next insert that is not
+ *       an append. Use xml_child_i(), xml_child_each() or xml_childvec_sort() instead on
+ *       nodes that may have many children, the library does not call this on such nodes.
  */
 cxobj **
 xml_childvec_get(cxobj *x)
 {
     if (!is_element(x))
         return NULL;
+#ifdef XML_CHILDVEC_CHUNKED
+    if (x->x_chunkvec){
+        clixon_debug(CLIXON_DBG_DETAIL, "%s: flattening %d children of %s",
+                     __FUNCTION__, x->x_childvec_len, x->x_name);
+        if (xml_chunk_flatten(x) < 0)
+            return NULL;
+    }
+#endif
     return x->x_childvec;
 }
 
+/*! Sort the children of an XML node
+ *
+ * A chunked child vector is sorted without converting it to a flat vector: each chunk is
+ * sorted in place, and only if the chunks are then out of order all children are sorted
+ * and written back to the same chunks.
+ * @param[in]  x     XML node
+ * @param[in]  cmp   Compare function as in qsort(3), on pointers to cxobj pointers
+ * @retval     0     OK
+ * @retval    -1     Error
+ */
+int
+xml_childvec_sort(cxobj *x,
+                  int  (*cmp)(const void *, const void *))
+{
+    int                  retval = -1;
+#ifdef XML_CHILDVEC_CHUNKED
+    struct xml_chunkvec *cc;
+    struct xml_chunk    *ch;
+    cxobj              **vec = NULL;
+    int                  i;
+    int                  k;
+#endif
+
+    if (!is_element(x) || x->x_childvec_len == 0)
+        goto ok;
+#ifdef XML_CHILDVEC_CHUNKED
+    if ((cc = x->x_chunkvec) != NULL){
+        for (k=0; k<cc->cc_len; k++){
+            ch = cc->cc_chunk[k];
+            qsort(ch->ch_vec, ch->ch_len, sizeof(cxobj *), cmp);
+        }
+        for (k=1; k<cc->cc_len; k++){
+            ch = cc->cc_chunk[k-1];
+            if (cmp(&ch->ch_vec[ch->ch_len-1], &cc->cc_chunk[k]->ch_vec[0]) > 0)
+                break;
+        }
+        if (k == cc->cc_len)
+            goto ok;
+        if ((vec = malloc(x->x_childvec_len*sizeof(cxobj *))) == NULL){
+            clicon_err(OE_XML, errno, "malloc");
+            goto done;
+        }
+        i = 0;
+        for (k=0; k<cc->cc_len; k++){
+            ch = cc->cc_chunk[k];
+            memcpy(&vec[i], ch->ch_vec, ch->ch_len*sizeof(cxobj *));
+            i += ch->ch_len;
+        }
+        qsort(vec, x->x_childvec_len, sizeof(cxobj *), cmp);
+        i = 0;
+        for (k=0; k<cc->cc_len; k++){
+            ch = cc->cc_chunk[k];
+            memcpy(ch->ch_vec, &vec[i], ch->ch_len*sizeof(cxobj *));
+            i += ch->ch_len;
+        }
+        goto ok;
+    }
+#endif
+    qsort(x->x_childvec, x->x_childvec_len, sizeof(cxobj *), cmp);
+ ok:
+    retval = 0;
+#ifdef XML_CHILDVEC_CHUNKED
+ done:
+    if (vec)
+        free(vec);
+#endif
+    return retval;
+}
+
 /*! Given an XML object and a vector of children xvec, append the children to the object
  *
  * @param[in]  x   XML node
@@ -1605,12 +2091,8 @@ xml_purge(cxobj *xc)
     cxobj    *xp;
 
     if ((xp = xml_parent(xc)) != NULL){
-        /* Find child order i in parent*/
-        for (i=0; i<xml_child_nr(xp); i++)
-            if (xml_child_i(xp, i) == xc)
-                break;
-        /* Remove xc from parent */
-        if (i < xml_child_nr(xp))
+        /* Find child order i in parent and remove xc from parent */
+        if ((i = xml_child_pos(xp, xc)) >= 0)
             if (xml_child_rm(xp, i) < 0)
                 goto done;
     }
@@ -1644,10 +2126,7 @@ xml_child_rm(cxobj *xp,
         goto done;
     }
     xml_parent_set(xc, NULL);
-    xp->x_childvec[i] = NULL;
-    xp->x_childvec_len--;
-    if (i<xp->x_childvec_len)
-        memmove(&xp->x_childvec[i], &xp->x_childvec[i+1], (xp->x_childvec_len-i)*sizeof(cxobj*));
+    xml_childvec_rm(xp, i);
 #ifdef XML_EXPLICIT_INDEX
     if (xml_type(xc) == CX_ELMNT){
         if (xml_search_index_p(xc))
@@ -1673,19 +2152,12 @@ xml_rm(cxobj *xc)
 {
     int    retval = -1;
     cxobj *xp;
-    cxobj *x;
     int    i;
 
     if ((xp = xml_parent(xc)) == NULL)
         goto ok;
-    /* Find child in parent XXX: search? */
-    x = NULL; i = 0;
-    while ((x = xml_child_each(xp, x, -1)) != NULL) {
-        if (x == xc)
-            break;
-        i++;
-    }
-    if (x != NULL)
+    /* Find child in parent */
+    if ((i = xml_child_pos(xp, xc)) >= 0)
         if (xml_child_rm(xp, i) < 0)
             goto done;
  ok:
@@ -2095,6 +2567,16 @@ xml_free(cxobj *x)
         free(x->x_prefix);
     switch (xml_type(x)){
     case CX_ELMNT:
+#ifdef XML_CHILDVEC_CHUNKED
+        if (x->x_chunkvec){
+            for (i=0; i<x->x_childvec_len; i++)
+                if ((xc = xml_childvec_i(x, i)) != NULL)
+                    xml_free(xc);
+            x->x_childvec_len = 0;
+            xml_chunk_free(x->x_chunkvec);
+            x->x_chunkvec = NULL;
+        }
+#endif
         for (i=0; i<x->x_childvec_len; i++){
             if ((xc = x->x_childvec[i]) != NULL){
                 xml_free(xc);
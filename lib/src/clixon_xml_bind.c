@@ -138,6 +138,22 @@ strip_body_objects(cxobj *xt)
     return 0;
 }
 
+/*! Insert parent of XML node bound from its parent in search index, if node is an index
+ *
+ * Must be made when xt, ie its body, is complete.
+ * @param[in]   xt     XML node bound with populate_self_parent
+ * @see xml_search_child_insert
+ */
+static int
+bind_search_index(cxobj *xt)
+{
+#ifdef XML_EXPLICIT_INDEX
+    if (xml_search_index_p(xt))
+        xml_search_child_insert(xml_parent(xt), xt);
+#endif
+    return 0;
+}
+
 /*! Associate XML node x with x:s parents yang:s matching child
  *
  * @param[in]   xt     XML tree node
@@ -149,6 +165,7 @@ strip_body_objects(cxobj *xt)
  * @retval      0      Yang assigment not made and xerr set
  * @retval     -1      Error
  * @note retval = 2 is special
+ * @note xt is not inserted in search index, see bind_search_index
  * @see populate_self_top
  */
 static int
@@ -235,10 +252,6 @@ populate_self_parent(cxobj     *xt,
     }
  set:
     xml_spec_set(xt, y);
-#ifdef XML_EXPLICIT_INDEX
-    if (xml_search_index_p(xt))
-        xml_search_child_insert(xp, xt);
-#endif
     retval = 1;
  done:
     if (cb)
@@ -453,6 +466,8 @@ xml_bind_yang0_opt(clicon_handle h,
         goto fail;
     else if (ret == 2)     /* ret=2 for anyxml from parent^ */
         goto ok;
+    if (yb == YB_PARENT)
+        bind_search_index(xt);
     strip_body_objects(xt);
     ybc = YB_PARENT;
     if (h && clicon_option_bool(h, "CLICON_YANG_SCHEMA_MOUNT")){
@@ -563,6 +578,8 @@ xml_bind_yang0(clicon_handle h,
         goto fail;
     else if (ret == 2)     /* ret=2 for anyxml from parent^ */
         goto ok;
+    if (yb == YB_PARENT)
+        bind_search_index(xt);
     strip_body_objects(xt);
     xc = NULL;     /* Apply on children */
     while ((xc = xml_child_each(xt, xc, CX_ELMNT)) != NULL) {
@@ -580,6 +597,64 @@ xml_bind_yang0(clicon_handle h,
     goto done;
 }
 
+/*! Bind yang to a single XML node when its start tag has been parsed
+ *
+ * Streaming variant of xml_bind_yang0, used when binding while parsing: xt and its
+ * attributes are parsed, but not its children, and the parent of xt is bound.
+ * Call xml_bind_yang_end when xt is complete.
+ * @param[in]   xt       XML node
+ * @param[in]   yb       YB_MODULE: bind as top-level symbol, YB_PARENT: bind from parent
+ * @param[in]   yspec    Yang spec
+ * @param[in]   xsibling Previous sibling of xt with same name and prefix, or NULL
+ * @param[out]  xerr     Reason for failure, or NULL
+ * @retval      2        OK, children of xt should not be bound, eg anydata
+ * @retval      1        OK yang assignment made
+ * @retval      0        Yang assigment not made and xerr set
+ * @retval     -1        Error
+ * @see xml_bind_yang0   Bind a complete tree
+ */
+int
+xml_bind_yang_start(cxobj        *xt,
+                    yang_bind     yb,
+                    yang_stmt    *yspec,
+                    cxobj        *xsibling,
+                    cxobj       **xerr)
+{
+    int retval = -1;
+
+    switch (yb){
+    case YB_MODULE:
+        retval = populate_self_top(xt, yspec, xerr);
+        break;
+    case YB_PARENT:
+        retval = populate_self_parent(xt, xsibling, yspec, xerr);
+        break;
+    default:
+        clicon_err(OE_XML, EINVAL, "Invalid yang binding: %d", yb);
+        break;
+    }
+    return retval;
+}
+
+/*! Finish binding of a single XML node when it has been completely parsed
+ *
+ * Bodies of containers and lists are stripped, and index variables are inserted in the
+ * search index.
+ * @param[in]   xt       XML node bound with xml_bind_yang_start
+ * @param[in]   yb       Binding used in xml_bind_yang_start
+ * @retval      0        OK
+ * @see xml_bind_yang_start
+ */
+int
+xml_bind_yang_end(cxobj        *xt,
+                  yang_bind     yb)
+{
+    if (yb == YB_PARENT)
+        bind_search_index(xt);
+    strip_body_objects(xt);
+    return 0;
+}
+
 /*! RPC-specific
  *
  * @param[in]   h      Clixon handle
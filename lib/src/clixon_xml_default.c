@@ -65,6 +65,7 @@
 #include "clixon_err.h"
 #include "clixon_yang.h"
 #include "clixon_xml.h"
+#include "clixon_xml_vec.h"
 #include "clixon_xpath_ctx.h"
 #include "clixon_xpath.h"
 #include "clixon_data.h"
@@ -74,7 +75,7 @@
 #include "clixon_xml_default.h"
 
 /* Forward */
-static int xml_default(yang_stmt *yt, cxobj *xt, int state);
+static int xml_default(yang_stmt *yt, cxobj *xt, int state, clixon_xvec *xvc);
 
 /*!
  */
@@ -166,9 +167,10 @@ xml_default_create(yang_stmt *y,
  *   is present 
  */
 static int
-xml_default_choice(yang_stmt *yc,
-                   cxobj     *xt,
-                   int        state)
+xml_default_choice(yang_stmt   *yc,
+                   cxobj       *xt,
+                   int          state,
+                   clixon_xvec *xvc)
 {
     int        retval = -1;
     cxobj     *x = NULL;
@@ -200,7 +202,7 @@ xml_default_choice(yang_stmt *yc,
             yca = NULL;
     }
     if (yca)
-        if (xml_default(yca, xt, state) < 0)
+        if (xml_default(yca, xt, state, xvc) < 0)
             goto done;
     retval = 0;
  done:
@@ -277,15 +279,17 @@ xml_nopresence_try(yang_stmt *yt,
  * @param[in]   yt      Yang spec, usually spec of xt but always (eg Y_CASE)
  * @param[in]   xt      XML tree (with yt as spec of xt, informally)
  * @param[in]   state   Set if global state, otherwise config
+ * @param[out]  xvc     If given, append XML nodes created directly under xt, or NULL
  * @retval      0       OK
  * @retval     -1       Error
  * XXX If state, should not add config defaults             
  *      if (state && yang_config(yc)) 
  */
 static int
-xml_default(yang_stmt *yt,
-            cxobj     *xt,
-            int        state)
+xml_default(yang_stmt   *yt,
+            cxobj       *xt,
+            int          state,
+            clixon_xvec *xvc)
 {
     int        retval = -1;
     yang_stmt *yc;
@@ -335,6 +339,9 @@ xml_default(yang_stmt *yt,
                         /* No such child exist, create this leaf */
                         if (xml_default_create(yc, xt, top) < 0)
                             goto done;
+                        if (xvc &&
+                            clixon_xvec_append(xvc, xml_find_type(xt, NULL, yang_argument_get(yc), CX_ELMNT)) < 0)
+                            goto done;
                         xml_sort(xt);
                     }
                 }
@@ -359,16 +366,18 @@ xml_default(yang_stmt *yt,
                              * container */
                             if (xml_default_create1(yc, xt, &xc) < 0)
                                 goto done;
+                            if (xvc && clixon_xvec_append(xvc, xc) < 0)
+                                goto done;
                             xml_sort(xt);
                             /* Then call it recursively */
-                            if (xml_default(yc, xc, state) < 0)
+                            if (xml_default(yc, xc, state, NULL) < 0)
                                 goto done;
                         }
                     }
                 }
                 break;
             case Y_CHOICE:{
-                if (xml_default_choice(yc, xt, state) < 0)
+                if (xml_default_choice(yc, xt, state, xvc) < 0)
                     goto done;
                 break;
             }
@@ -403,7 +412,7 @@ xml_default_recurse(cxobj *xn,
     yang_stmt *y;
 
     if ((yn = (yang_stmt*)xml_spec(xn)) != NULL)
-        if (xml_default(yn, xn, state) < 0)
+        if (xml_default(yn, xn, state, NULL) < 0)
             goto done;
     x = NULL;
     while ((x = xml_child_each(xn, x, CX_ELMNT)) != NULL) {
@@ -419,6 +428,34 @@ xml_default_recurse(cxobj *xn,
     return retval;
 }
 
+/*! Fill in default values on the children of one single XML node
+ *
+ * Not recursive, except for non-presence containers created to host default values.
+ * Nodes created directly under xn are appended to xvc so that a caller can remove them
+ * again without traversing the rest of the tree.
+ * @param[in]   xn      XML node, bound to YANG
+ * @param[in]   state   If set expand defaults also for state data, otherwise only config
+ * @param[out]  xvc     Created child nodes are appended to this vector, or NULL
+ * @retval      0       OK
+ * @retval     -1       Error
+ * @see xml_default_recurse
+ */
+int
+xml_default_node(cxobj       *xn,
+                 int          state,
+                 clixon_xvec *xvc)
+{
+    int        retval = -1;
+    yang_stmt *yn;
+
+    if ((yn = (yang_stmt*)xml_spec(xn)) != NULL)
+        if (xml_default(yn, xn, state, xvc) < 0)
+            goto done;
+    retval = 0;
+ done:
+    return retval;
+}
+
 /*! Expand and set default values of global top-level on XML tree
  *
  * Not recursive, except in one case with one or several non-presence containers
@@ -441,7 +478,7 @@ xml_global_defaults_create(cxobj     *xt,
         goto done;
     }
     while ((ymod = yn_each(yspec, ymod)) != NULL)
-        if (xml_default(ymod, xt, state) < 0)
+        if (xml_default(ymod, xt, state, NULL) < 0)
             goto done;
     retval = 0;
  done:
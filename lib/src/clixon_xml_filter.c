@@ -0,0 +1,423 @@
+/*
+ *
+  ***** BEGIN LICENSE BLOCK *****
+ 
+  Copyright (C) 2009-2016 Olof Hagsand and Benny Holmgren
+  Copyright (C) 2017-2019 Olof Hagsand
+  Copyright (C) 2020-2022 Olof Hagsand and Rubicon Communications, LLC (Netgate)
+
+  This file is part of CLIXON.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  Alternatively, the contents of this file may be used under the terms of
+  the GNU General Public License Version 3 or later (the "GPL"),
+  in which case the provisions of the GPL are applicable instead
+  of those above. If you wish to allow use of your version of this file only
+  under the terms of the GPL, and not to allow others to
+  use your version of this file under the terms of Apache License version 2, 
+  indicate your decision by deleting the provisions above and replace them with
+  the  notice and other provisions required by the GPL. If you do not delete
+  the provisions above, a recipient may use your version of this file under
+  the terms of any one of the Apache License version 2 or the GPL.
+
+  ***** END LICENSE BLOCK *****
+
+ *
+ * NETCONF subtree filtering, RFC 6241 Section 6
+ * A subtree filter is translated to an XPath selecting a superset of the result, which
+ * is used to retrieve data from the datastore and state callbacks, see xml_filter2xpath.
+ * The result is then pruned according to the subtree filter, see xml_filter.
+ */
+#ifdef HAVE_CONFIG_H
+#include "clixon_config.h" /* generated by config & autoconf */
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <string.h>
+#include <syslog.h>
+
+/* cligen */
+#include <cligen/cligen.h>
+
+/* clicon */
+#include "clixon_queue.h"
+#include "clixon_hash.h"
+#include "clixon_handle.h"
+#include "clixon_err.h"
+#include "clixon_log.h"
+#include "clixon_yang.h"
+#include "clixon_xml.h"
+#include "clixon_xml_nsctx.h"
+#include "clixon_xml_filter.h"
+
+/* xf specifices a filter, and xn is an xml tree.
+ * Select the part of xn that matches xf and return it.
+ * Change xn destructively by removing the parts of the sub-tree that does 
+ * not match.
+ * Match according to Section 6 of RFC 4741.
+    NO_FILTER,       select all 
+    EMPTY_FILTER,    select nothing 
+    ATTRIBUTE_MATCH, select if attribute match 
+    SELECTION,       select this node 
+    CONTENT_MATCH,   select all siblings with matching content 
+    CONTAINMENT      select 
+ */
+
+/* return a string containing leafs value, NULL if no leaf or no value */
+static char*
+leafstring(cxobj *x)
+{
+    cxobj *c;
+
+    if (xml_type(x) != CX_ELMNT)
+        return NULL;
+    if (xml_child_nr(x) != 1)
+        return NULL;
+    c = xml_child_i(x, 0);
+    if (xml_child_nr(c) != 0)
+        return NULL;
+    if (xml_type(c) != CX_BODY)
+        return NULL;
+    return xml_value(c);
+}
+
+/*! Check attribute match of filter node
+ *
+ * Namespace declarations are matched against the namespace of the node, not its
+ * attributes, since only top-level data nodes have namespace declarations
+ * @retval  1  Match
+ * @retval  0  No match
+ * @retval -1  Error
+ */
+static int
+xml_filter_attr(cxobj *xfilter,
+                cxobj *xparent)
+{
+    cxobj *attr;
+    char  *an;
+    char  *af;
+    char  *prefix;
+    char  *ns;
+
+    attr = NULL;
+    while ((attr = xml_child_each(xfilter, attr, CX_ATTR)) != NULL) {
+        af = xml_value(attr);
+        prefix = xml_prefix(attr);
+        if (prefix && strcmp(prefix, "xmlns") == 0)
+            continue;
+        if (prefix == NULL && strcmp(xml_name(attr), "xmlns") == 0){
+            if (xml2ns(xparent, xml_prefix(xparent), &ns) < 0)
+                return -1;
+            if (af && ns && strcmp(af, ns) != 0)
+                return 0;
+            continue;
+        }
+        an = xml_find_value(xparent, xml_name(attr));
+        if (af && an && strcmp(af, an)==0)
+            ; // match
+        else
+            return 0;
+    }
+    return 1;
+}
+
+static int xml_filter_recursive(cxobj *xfilter, cxobj *xparent, int *remove_me);
+
+/*! Prune children of configuration node that do not match children of filter node
+ */
+static int
+xml_filter_children(cxobj *xfilter,
+                    cxobj *xparent)
+{
+    cxobj *s;
+    cxobj *sprev;
+    cxobj *f;
+    int    remove_s;
+
+    sprev = s = NULL;
+    while ((s = xml_child_each(xparent, s, CX_ELMNT)) != NULL) {
+        if ((f = xml_find(xfilter, xml_name(s))) == NULL){
+            xml_purge(s);
+            s = sprev;
+            continue;
+        }
+        if (leafstring(f)){
+            sprev = s;
+            continue; // unsure?sk=lf
+        }
+        // XXX: s can be removed itself in the recursive call !
+        remove_s = 0;
+        if (xml_filter_recursive(f, s, &remove_s) < 0)
+            return -1;
+        if (remove_s){
+            xml_purge(s);
+            s = sprev;
+        }
+        sprev = s;
+    }
+    return 0;
+}
+
+/*! Internal recursive part where configuration xml tree is pruned from filter
+ *
+ * assume parent has been selected and filter match (same name) as parent
+ * parent is pruned according to selection.
+ * @param[in]  xfilter  Filter xml
+ * @param[out] xconf    Configuration xml
+ * @retval     0        OK
+ * @retval    -1        Error
+ */
+static int
+xml_filter_recursive(cxobj *xfilter,
+                     cxobj *xparent,
+                     int   *remove_me)
+{
+    cxobj *s;
+    cxobj *f;
+    char  *fstr;
+    char  *sstr;
+    int    containments;
+    int    ret;
+
+    *remove_me = 0;
+    /* 1. Check selection */
+    if (xml_child_nr(xfilter) == 0)
+        goto match;
+
+    /* Count containment/selection nodes in filter */
+    f = NULL;
+    containments = 0;
+    while ((f = xml_child_each(xfilter, f, CX_ELMNT)) != NULL) {
+        if (leafstring(f))
+            continue;
+        containments++;
+    }
+
+    /* 2. Check attribute match */
+    if ((ret = xml_filter_attr(xfilter, xparent)) < 0)
+        return -1;
+    if (ret == 0)
+        goto nomatch;
+    /* 3. Check content match */
+    f = NULL;
+    while ((f = xml_child_each(xfilter, f, CX_ELMNT)) != NULL) {
+        if ((fstr = leafstring(f)) == NULL)
+            continue;
+        if ((s = xml_find(xparent, xml_name(f))) == NULL)
+            goto nomatch;
+        if ((sstr = leafstring(s)) == NULL)
+            continue;
+        if (strcmp(fstr, sstr))
+            goto nomatch;
+    }
+    /* If filter has no further specifiers, accept */
+    if (!containments)
+        goto match;
+    /* Check recursively the rest of the siblings */
+    if (xml_filter_children(xfilter, xparent) < 0)
+        return -1;
+  match:
+    return 0;
+  nomatch: /* prune this parent node (maybe only children?) */
+    *remove_me = 1;
+    return 0;
+}
+
+/*! Remove parts of configuration xml tree that does not match filter xml tree
+ *
+ * @param[in]  xfilter  Filter xml, eg <filter type="subtree">
+ * @param[out] xconf    Configuration xml, eg <data>
+ * @retval  0  OK
+ * @retval -1  Error
+ * This is the top-level function, calls a recursive variant.
+ * Attributes of the top-level filter element, such as type, are not matched.
+ * An empty filter selects everything.
+ */
+int
+xml_filter(cxobj *xfilter,
+           cxobj *xconfig)
+{
+    if (xml_child_nr_type(xfilter, CX_ELMNT) == 0)
+        return 0;
+    return xml_filter_children(xfilter, xconfig);
+}
+
+/*! Append prefixed name of filter node to xpath
+ *
+ * A prefix is added to the namespace context for each new namespace
+ * @retval  1  OK
+ * @retval  0  Node has no namespace
+ * @retval -1  Error
+ */
+static int
+xml_filter2xpath_name(cxobj *xf,
+                      cbuf  *cb,
+                      cvec  *nsc)
+{
+    char *ns = NULL;
+    char *prefix = NULL;
+    char  pbuf[16];
+
+    if (xml2ns(xf, xml_prefix(xf), &ns) < 0)
+        return -1;
+    if (ns == NULL)
+        return 0;
+    if (xml_nsctx_get_prefix(nsc, ns, &prefix) == 0 || prefix == NULL){
+        snprintf(pbuf, sizeof(pbuf), "f%d", cvec_len(nsc));
+        if (xml_nsctx_add(nsc, pbuf, ns) < 0)
+            return -1;
+        prefix = pbuf;
+    }
+    cprintf(cb, "%s:%s", prefix, xml_name(xf));
+    return 1;
+}
+
+/*! Translate filter node and its children to location paths
+ *
+ * @param[in]     xf      Filter node
+ * @param[in,out] cbpath  Location path of parent, restored on return
+ * @param[in,out] cb      XPath union
+ * @param[in]     nsc     Namespace context
+ * @retval        1       OK
+ * @retval        0       Filter cannot be translated
+ * @retval       -1       Error
+ */
+static int
+xml_filter2xpath_recurse(cxobj *xf,
+                         cbuf  *cbpath,
+                         cbuf  *cb,
+                         cvec  *nsc)
+{
+    int    retval = -1;
+    size_t len;
+    size_t len1;
+    cxobj *xc;
+    char  *value;
+    int    containments = 0;
+    int    ret;
+
+    len = cbuf_len(cbpath);
+    cprintf(cbpath, "/");
+    if ((ret = xml_filter2xpath_name(xf, cbpath, nsc)) < 1){
+        retval = ret;
+        goto done;
+    }
+    /* Content match nodes are predicates, which may use list key indexes */
+    xc = NULL;
+    while ((xc = xml_child_each(xf, xc, CX_ELMNT)) != NULL) {
+        if ((value = leafstring(xc)) == NULL){
+            containments++;
+            continue;
+        }
+        cprintf(cbpath, "[");
+        if ((ret = xml_filter2xpath_name(xc, cbpath, nsc)) < 1){
+            retval = ret;
+            goto done;
+        }
+        if (strchr(value, '\'') == NULL)
+            cprintf(cbpath, "='%s']", value);
+        else if (strchr(value, '"') == NULL)
+            cprintf(cbpath, "=\"%s\"]", value);
+        else
+            goto fail;
+    }
+    if (containments == 0){
+        cprintf(cb, "%s%s", cbuf_len(cb)?" | ":"", cbuf_get(cbpath));
+        goto ok;
+    }
+    xc = NULL;
+    while ((xc = xml_child_each(xf, xc, CX_ELMNT)) != NULL) {
+        if (leafstring(xc) == NULL){
+            if ((ret = xml_filter2xpath_recurse(xc, cbpath, cb, nsc)) < 1){
+                retval = ret;
+                goto done;
+            }
+        }
+        else { /* Content match nodes are part of the result */
+            len1 = cbuf_len(cbpath);
+            cprintf(cbpath, "/");
+            if (xml_filter2xpath_name(xc, cbpath, nsc) < 0)
+                goto done;
+            cprintf(cb, "%s%s", cbuf_len(cb)?" | ":"", cbuf_get(cbpath));
+            cbuf_trunc(cbpath, len1);
+        }
+    }
+ ok:
+    retval = 1;
+ done:
+    cbuf_trunc(cbpath, len);
+    return retval;
+ fail:
+    retval = 0;
+    goto done;
+}
+
+/*! Translate subtree filter to an XPath selecting a superset of the filter result
+ *
+ * Each path from the top of the filter to a selection node, a content match node or a
+ * containment node without containment children becomes a location path in an XPath
+ * union. Content match nodes are also predicates of their parent step.
+ * Attribute match is not translated, apply xml_filter on the XPath result.
+ * @param[in]  xfilter  Filter xml, eg <filter type="subtree">
+ * @param[out] cb       XPath
+ * @param[out] nscp     Namespace context of XPath, free with xml_nsctx_free
+ * @retval     1        OK
+ * @retval     0        Filter cannot be translated, eg node without namespace
+ * @retval    -1        Error
+ * @code
+ *   <filter type="subtree"><a xmlns="urn:x"><b><k>1</k><c/></b></a></filter>
+ *   -->  /f0:a/f0:b[f0:k='1']/f0:c | /f0:a/f0:b[f0:k='1']/f0:k
+ * @endcode
+ */
+int
+xml_filter2xpath(cxobj *xfilter,
+                 cbuf  *cb,
+                 cvec **nscp)
+{
+    int    retval = -1;
+    cvec  *nsc = NULL;
+    cbuf  *cbpath = NULL;
+    cxobj *xf;
+    int    ret;
+
+    if ((nsc = xml_nsctx_init(NULL, NULL)) == NULL)
+        goto done;
+    if ((cbpath = cbuf_new()) == NULL){
+        clicon_err(OE_UNIX, errno, "cbuf_new");
+        goto done;
+    }
+    xf = NULL;
+    while ((xf = xml_child_each(xfilter, xf, CX_ELMNT)) != NULL) {
+        if ((ret = xml_filter2xpath_recurse(xf, cbpath, cb, nsc)) < 1){
+            retval = ret;
+            goto done;
+        }
+    }
+    if (cbuf_len(cb) == 0)
+        goto fail;
+    *nscp = nsc;
+    nsc = NULL;
+    retval = 1;
+ done:
+    if (cbpath)
+        cbuf_free(cbpath);
+    if (nsc)
+        xml_nsctx_free(nsc);
+    return retval;
+ fail:
+    retval = 0;
+    goto done;
+}
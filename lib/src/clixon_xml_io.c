@@ -80,10 +80,265 @@
 /* Size of xml read buffer */
 #define BUFLEN 1024
 
+/* Write buffered xml output to file when it exceeds this size, see clixon_xml2file */
+#define XML_OUTBUF_FLUSH (64*1024)
+
+/*
+ * Local variables
+ */
+/* Use hand-written XML parser instead of yacc parser, see CLICON_XML_FAST_PARSER */
+static int _xml_parse_fast = 0;
+
 /*------------------------------------------------------------------------
  * XML printing functions. Output a parse tree to file, string cligen buf
  *------------------------------------------------------------------------*/
 
+/*! Append indentation spaces to a cligen buffer, as cprintf(cb, "%*s", n, "")
+ *
+ * @param[in,out] cb  Cligen buffer to write to
+ * @param[in]     n   Number of spaces
+ */
+static void
+xml_outbuf_indent(cbuf *cb,
+                  int   n)
+{
+    static char spaces[] = "                                "; /* 32 */
+    int         len;
+
+    if (n < 0){ /* Left-justified width, keep cprintf semantics */
+        cprintf(cb, "%*s", n, "");
+        return;
+    }
+    while (n > 0){
+        len = n < sizeof(spaces)-1 ? n : sizeof(spaces)-1;
+        cbuf_append_buf(cb, spaces, len);
+        n -= len;
+    }
+}
+
+/*! Write a cligen buffer to file and reset it
+ *
+ * @param[in]     f   Output file
+ * @param[in,out] cb  Cligen buffer
+ * @retval        0   OK
+ * @retval       -1   Error
+ */
+static int
+xml_outbuf_flush(FILE *f,
+                 cbuf *cb)
+{
+    size_t len;
+
+    if ((len = cbuf_len(cb)) == 0)
+        return 0;
+    if (fwrite(cbuf_get(cb), 1, len, f) != len){
+        clicon_err(OE_UNIX, errno, "fwrite");
+        return -1;
+    }
+    cbuf_reset(cb);
+    return 0;
+}
+
+/*! Internal: print XML attribute to a cligen buffer
+ *
+ * @param[in,out] cb       Cligen buffer to write to
+ * @param[in]     xa       XML attribute
+ */
+static void
+xml_attr2cbuf(cbuf  *cb,
+              cxobj *xa)
+{
+    char *namespace;
+    char *val;
+
+    cbuf_append_str(cb, " ");
+    if ((namespace = xml_prefix(xa)) != NULL){
+        cbuf_append_str(cb, namespace);
+        cbuf_append_str(cb, ":");
+    }
+    cbuf_append_str(cb, xml_name(xa));
+    cbuf_append_str(cb, "=\"");
+    if ((val = xml_value(xa)) != NULL)
+        cbuf_append_str(cb, val);
+    cbuf_append_str(cb, "\"");
+}
+
+/*! Internal: print start tag of XML element, or the whole element if it has no children
+ *
+ * @param[in,out] cb       Cligen buffer to write to
+ * @param[in]     x        XML element
+ * @param[in]     level1   Indentation
+ * @param[in]     pretty   Insert \n and spaces to make the xml more readable.
+ * @param[in]     prefix   Add string to beginning of each line (if pretty)
+ * @param[out]    hasbody  Element has body, see xml_elmnt_end2cbuf
+ * @retval        1        Start tag printed, print children and then xml_elmnt_end2cbuf
+ * @retval        0        Element without children printed as <a/>
+ */
+static int
+xml_elmnt_start2cbuf(cbuf  *cb,
+                     cxobj *x,
+                     int    level1,
+                     int    pretty,
+                     char  *prefix,
+                     int   *hasbody)
+{
+    cxobj *xc;
+    char  *namespace;
+    int    haselement = 0;
+
+    if (pretty){
+        if (prefix)
+            cbuf_append_str(cb, prefix);
+        xml_outbuf_indent(cb, level1);
+    }
+    cbuf_append_str(cb, "<");
+    if ((namespace = xml_prefix(x)) != NULL){
+        cbuf_append_str(cb, namespace);
+        cbuf_append_str(cb, ":");
+    }
+    cbuf_append_str(cb, xml_name(x));
+    *hasbody = 0;
+    xc = NULL;
+    /* print attributes only */
+    while ((xc = xml_child_each(x, xc, -1)) != NULL)
+        switch (xml_type(xc)){
+        case CX_ATTR:
+            xml_attr2cbuf(cb, xc);
+            break;
+        case CX_BODY:
+            *hasbody = 1;
+            break;
+        case CX_ELMNT:
+            haselement = 1;
+            break;
+        default:
+            break;
+        }
+    /* Check for special case <a/> instead of <a></a> */
+    if (*hasbody==0 && haselement==0){
+        cbuf_append_str(cb, "/>");
+        if (pretty)
+            cbuf_append_str(cb, "\n");
+        return 0;
+    }
+    cbuf_append_str(cb, ">");
+    if (pretty && *hasbody == 0)
+        cbuf_append_str(cb, "\n");
+    return 1;
+}
+
+/*! Internal: print end tag of XML element after its children
+ *
+ * @param[in,out] cb       Cligen buffer to write to
+ * @param[in]     x        XML element
+ * @param[in]     level1   Indentation
+ * @param[in]     pretty   Insert \n and spaces to make the xml more readable.
+ * @param[in]     prefix   Add string to beginning of each line (if pretty)
+ * @param[in]     hasbody  Element has body, see xml_elmnt_start2cbuf
+ */
+static void
+xml_elmnt_end2cbuf(cbuf  *cb,
+                   cxobj *x,
+                   int    level1,
+                   int    pretty,
+                   char  *prefix,
+                   int    hasbody)
+{
+    char *namespace;
+
+    if (pretty && hasbody == 0){
+        if (prefix)
+            cbuf_append_str(cb, prefix);
+        xml_outbuf_indent(cb, level1);
+    }
+    cbuf_append_str(cb, "</");
+    if ((namespace = xml_prefix(x)) != NULL){
+        cbuf_append_str(cb, namespace);
+        cbuf_append_str(cb, ":");
+    }
+    cbuf_append_str(cb, xml_name(x));
+    cbuf_append_str(cb, ">");
+    if (pretty)
+        cbuf_append_str(cb, "\n");
+}
+
+/*! Internal: print  XML tree structure to a cligen buffer and encode chars "<>&"
+ *
+ * Names, attributes and indentation are appended without format parsing
+ * @param[in,out] cb       Cligen buffer to write to
+ * @param[in]     xn       Clixon xml tree
+ * @param[in]     level    Indentation level for prettyprint
+ * @param[in]     pretty   Insert \n and spaces to make the xml more readable.
+ * @param[in]     prefix   Add string to beginning of each line (if pretty)
+ * @param[in]     depth    Limit levels of child resources: -1 is all, 0 is none, 1 is node itself
+ * @param[in]     autocliext How to handle autocli extensions: 0: ignore 1: follow
+ * @param[in]     f        If set, write cb to this file when it exceeds XML_OUTBUF_FLUSH
+ * @retval        0        OK
+ * @retval       -1        Error
+ * @see xml_stream  Same printing made incrementally
+ */
+static int
+clixon_xml2cbuf1(cbuf   *cb,
+                 cxobj  *x,
+                 int     level,
+                 int     pretty,
+                 char   *prefix,
+                 int32_t depth,
+                 int     autocliext,
+                 FILE   *f)
+{
+    int        retval = -1;
+    cxobj     *xc;
+    int        hasbody;
+    char      *val;
+    int        level1;
+    int        exist = 0;
+    yang_stmt *y;
+
+    if (x == NULL || depth == 0)
+        goto ok;
+    level1 = level*PRETTYPRINT_INDENT;
+    if (prefix)
+        level1 -= strlen(prefix);
+    if (autocliext &&
+        (y = xml_spec(x)) != NULL){
+        if (yang_extension_value(y, "hide-show", CLIXON_AUTOCLI_NS, &exist, NULL) < 0)
+            goto done;
+        if (exist)
+            goto ok;
+    }
+    switch(xml_type(x)){
+    case CX_BODY:
+        if ((val = xml_value(x)) == NULL) /* incomplete tree */
+            break;
+        if (xml_chardata_cbuf_append(cb, val) < 0)
+            goto done;
+        break;
+    case CX_ATTR:
+        xml_attr2cbuf(cb, x);
+        break;
+    case CX_ELMNT:
+        if (xml_elmnt_start2cbuf(cb, x, level1, pretty, prefix, &hasbody) == 1){
+            xc = NULL;
+            while ((xc = xml_child_each(x, xc, -1)) != NULL)
+                if (xml_type(xc) != CX_ATTR)
+                    if (clixon_xml2cbuf1(cb, xc, level+1, pretty, prefix, depth-1, autocliext, f) < 0)
+                        goto done;
+            xml_elmnt_end2cbuf(cb, x, level1, pretty, prefix, hasbody);
+        }
+        if (f && cbuf_len(cb) >= XML_OUTBUF_FLUSH &&
+            xml_outbuf_flush(f, cb) < 0)
+            goto done;
+        break;
+    default:
+        break;
+    }/* switch */
+ ok:
+    retval = 0;
+ done:
+    return retval;
+}
+
 /*! Print an XML tree structure to an output stream and encode chars "<>&"
  *
  * @param[in]   f          UNIX output stream
@@ -96,9 +351,8 @@
  * @retval      0          OK
  * @retval     -1          Error
  * @see clixon_xml2cbuf
- * One can use clixon_xml2cbuf to get common code, but using fprintf is
- * much faster than using cbuf and then printing that,...
- *
+ * Used for other print functions than fprintf, eg cligen_output, fprintf output is
+ * buffered, see clixon_xml2file
  */
 static int
 xml2file_recurse(FILE             *f,
@@ -229,6 +483,8 @@ xml2file_recurse(FILE             *f,
  * @param[in]  autocliext How to handle autocli extensions: 0: ignore 1: follow
  * @retval     0       OK
  * @retval    -1       Error
+ * If fn is fprintf, output is made to a buffer which is written to f in chunks of
+ * XML_OUTBUF_FLUSH bytes, instead of one print call per tag and value
  * @see clixon_xml2cbuf print to a cbuf string
  * @note There is a slight "layer violation" with the autocli parameter: it should normally be set
  *       for CLI calls, but not for others.
@@ -245,10 +501,28 @@ clixon_xml2file(FILE             *f,
 {
     int   retval = 1;
     cxobj *xc;
+    cbuf  *cb = NULL;
 
     if (fn == NULL)
         fn = fprintf;
-    if (skiptop){
+    if (fn == fprintf){
+        /* Plain stdio: serialize to a buffer and write it in large chunks */
+        if ((cb = cbuf_new_alloc(2*XML_OUTBUF_FLUSH)) == NULL){
+            clicon_err(OE_XML, errno, "cbuf_new_alloc");
+            goto done;
+        }
+        if (skiptop){
+            xc = NULL;
+            while ((xc = xml_child_each(xn, xc, CX_ELMNT)) != NULL)
+                if (clixon_xml2cbuf1(cb, xc, level, pretty, prefix, -1, autocliext, f) < 0)
+                    goto done;
+        }
+        else if (clixon_xml2cbuf1(cb, xn, level, pretty, prefix, -1, autocliext, f) < 0)
+            goto done;
+        if (xml_outbuf_flush(f, cb) < 0)
+            goto done;
+    }
+    else if (skiptop){
         xc = NULL;
         while ((xc = xml_child_each(xn, xc, CX_ELMNT)) != NULL)
             if (xml2file_recurse(f, xc, level, pretty, prefix, fn, autocliext) < 0)
@@ -260,6 +534,8 @@ clixon_xml2file(FILE             *f,
     }
     retval = 0;
  done:
+    if (cb)
+        cbuf_free(cb);
     return retval;
 }
 
@@ -323,125 +599,6 @@ xml_dump(FILE  *f,
     return xml_dump1(f, x, 0);
 }
 
-/*! Internal: print  XML tree structure to a cligen buffer and encode chars "<>&"
- *
- * @param[in,out] cb       Cligen buffer to write to
- * @param[in]     xn       Clixon xml tree
- * @param[in]     level    Indentation level for prettyprint
- * @param[in]     pretty   Insert \n and spaces to make the xml more readable.
- * @param[in]     prefix   Add string to beginning of each line (if pretty)
- * @param[in]     depth    Limit levels of child resources: -1 is all, 0 is none, 1 is node itself
- * @retval        0        OK
- * @retval       -1        Error
- */
-static int
-clixon_xml2cbuf1(cbuf   *cb,
-                 cxobj  *x,
-                 int     level,
-                 int     pretty,
-                 char   *prefix,
-                 int32_t depth)
-{
-    int    retval = -1;
-    cxobj *xc;
-    char  *name;
-    int    hasbody;
-    int    haselement;
-    char  *namespace;
-    char  *val;
-    int    level1;
-
-    if (depth == 0)
-        goto ok;
-    level1 = level*PRETTYPRINT_INDENT;
-    if (prefix)
-        level1 -= strlen(prefix);
-    name = xml_name(x);
-    namespace = xml_prefix(x);
-    switch(xml_type(x)){
-    case CX_BODY:
-        if ((val = xml_value(x)) == NULL) /* incomplete tree */
-            break;
-        if (xml_chardata_cbuf_append(cb, val) < 0)
-            goto done;
-        break;
-    case CX_ATTR:
-        cbuf_append_str(cb, " ");
-        if (namespace){
-            cbuf_append_str(cb, namespace);
-            cbuf_append_str(cb, ":");
-        }
-        cprintf(cb, "%s=\"%s\"", name, xml_value(x));
-        break;
-    case CX_ELMNT:
-        if (pretty){
-            if (prefix)
-                cprintf(cb, "%s", prefix);
-            cprintf(cb, "%*s<", level1, "");
-        }
-        else
-            cbuf_append_str(cb, "<");
-        if (namespace){
-            cbuf_append_str(cb, namespace);
-            cbuf_append_str(cb, ":");
-        }
-        cbuf_append_str(cb, name);
-        hasbody = 0;
-        haselement = 0;
-        xc = NULL;
-        /* print attributes only */
-        while ((xc = xml_child_each(x, xc, -1)) != NULL)
-            switch (xml_type(xc)){
-            case CX_ATTR:
-                if (clixon_xml2cbuf1(cb, xc, level+1, pretty, prefix, -1) < 0)
-                    goto done;
-                break;
-            case CX_BODY:
-                hasbody=1;
-                break;
-            case CX_ELMNT:
-                haselement=1;
-                break;
-            default:
-                break;
-            }
-        /* Check for special case <a/> instead of <a></a> */
-        if (hasbody==0 && haselement==0)
-            cbuf_append_str(cb, "/>");
-        else{
-            cbuf_append_str(cb, ">");
-            if (pretty && hasbody == 0)
-                cbuf_append_str(cb, "\n");
-            xc = NULL;
-            while ((xc = xml_child_each(x, xc, -1)) != NULL)
-                if (xml_type(xc) != CX_ATTR)
-                    if (clixon_xml2cbuf1(cb, xc, level+1, pretty, prefix, depth-1) < 0)
-                        goto done;
-            if (pretty && hasbody == 0){
-                if (prefix)
-                    cprintf(cb, "%s", prefix);
-                cprintf(cb, "%*s", level1, "");
-            }
-            cbuf_append_str(cb, "</");
-            if (namespace){
-                cbuf_append_str(cb, namespace);
-                cbuf_append_str(cb, ":");
-            }
-            cbuf_append_str(cb, name);
-            cbuf_append_str(cb, ">");
-        }
-        if (pretty)
-            cbuf_append_str(cb, "\n");
-        break;
-    default:
-        break;
-    }/* switch */
- ok:
-    retval = 0;
- done:
-    return retval;
-}
-
 /*! Print an XML tree structure to a cligen buffer and encode chars "<>&"
  *
  * @param[in,out] cb      Cligen buffer to write to
@@ -478,11 +635,11 @@ clixon_xml2cbuf(cbuf   *cb,
     if (skiptop){
         xc = NULL;
         while ((xc = xml_child_each(xn, xc, CX_ELMNT)) != NULL)
-            if (clixon_xml2cbuf1(cb, xc, level, pretty, prefix, depth) < 0)
+            if (clixon_xml2cbuf1(cb, xc, level, pretty, prefix, depth, 0, NULL) < 0)
                 goto done;
     }
     else {
-        if (clixon_xml2cbuf1(cb, xn, level, pretty, prefix, depth) < 0)
+        if (clixon_xml2cbuf1(cb, xn, level, pretty, prefix, depth, 0, NULL) < 0)
             goto done;
     }
     retval = 0;
@@ -490,6 +647,179 @@ clixon_xml2cbuf(cbuf   *cb,
     return retval;
 }
 
+/*! State of one XML element while it is printed incrementally, see xml_stream
+ */
+struct xml_frame{
+    cxobj *xf_x;       /* XML element */
+    int    xf_level;   /* Indentation level */
+    int    xf_hasbody; /* Element has body, see xml_elmnt_start2cbuf */
+    int    xf_i;       /* Index of next child */
+};
+
+/*! Incremental printing of XML trees
+ *
+ * The XML trees are traversed with an explicit stack of frames instead of recursion, so that
+ * printing can be suspended when enough XML is produced and resumed later.
+ * @see clixon_xml_stream_new
+ */
+struct xml_stream{
+    cxobj           **xs_vec;      /* Vector of top-level XML trees */
+    size_t            xs_veclen;   /* Length of xs_vec */
+    size_t            xs_veci;     /* Index of next tree in xs_vec */
+    int               xs_pretty;   /* Insert \n and spaces to make the xml more readable */
+    struct xml_frame *xs_stack;    /* Stack of frames, one per level of XML tree */
+    int               xs_depth;    /* Number of frames on stack */
+    int               xs_maxdepth; /* Allocated frames */
+};
+
+/*! Print XML node, and if it is an element with children push it on xml stream stack
+ *
+ * @param[in]  xs      XML stream
+ * @param[out] cb      Cligen buffer to write to
+ * @param[in]  x       XML node (not attribute)
+ * @param[in]  level   Indentation level
+ * @retval     0       OK
+ * @retval    -1       Error
+ */
+static int
+xml_stream_push(xml_stream *xs,
+                cbuf       *cb,
+                cxobj      *x,
+                int         level)
+{
+    int               retval = -1;
+    struct xml_frame *xf;
+    struct xml_frame *stack;
+    int               maxdepth;
+    int               hasbody;
+    char             *val;
+
+    switch (xml_type(x)){
+    case CX_BODY:
+        if ((val = xml_value(x)) != NULL && /* incomplete tree */
+            xml_chardata_cbuf_append(cb, val) < 0)
+            goto done;
+        break;
+    case CX_ELMNT:
+        if (xml_elmnt_start2cbuf(cb, x, level*PRETTYPRINT_INDENT, xs->xs_pretty, NULL, &hasbody) == 0)
+            break;
+        if (xs->xs_depth == xs->xs_maxdepth){
+            maxdepth = xs->xs_maxdepth ? 2*xs->xs_maxdepth : 16;
+            if ((stack = realloc(xs->xs_stack, maxdepth*sizeof(*stack))) == NULL){
+                clicon_err(OE_UNIX, errno, "realloc");
+                goto done;
+            }
+            xs->xs_stack = stack;
+            xs->xs_maxdepth = maxdepth;
+        }
+        xf = &xs->xs_stack[xs->xs_depth++];
+        xf->xf_x = x;
+        xf->xf_level = level;
+        xf->xf_hasbody = hasbody;
+        xf->xf_i = 0;
+        break;
+    default:
+        break;
+    }
+    retval = 0;
+ done:
+    return retval;
+}
+
+/*! Create an incremental printing of XML trees
+ *
+ * Gives the same XML as clixon_xml2cbuf(cb, vec[i], 0, pretty, NULL, -1, 0) for each tree in
+ * the vector, but in parts using clixon_xml_stream_read, so that large trees can be sent
+ * without the whole XML text in memory.
+ * @param[in]  vec     Vector of XML trees, must remain until stream is freed
+ * @param[in]  veclen  Length of vector
+ * @param[in]  pretty  Insert \n and spaces to make the xml more readable.
+ * @retval     xs      XML stream, free with clixon_xml_stream_free
+ * @retval     NULL    Error
+ * @see clixon_json_stream_new  JSON corresponding function
+ */
+xml_stream *
+clixon_xml_stream_new(cxobj **vec,
+                      size_t  veclen,
+                      int     pretty)
+{
+    xml_stream *xs;
+
+    if ((xs = malloc(sizeof(*xs))) == NULL){
+        clicon_err(OE_UNIX, errno, "malloc");
+        return NULL;
+    }
+    memset(xs, 0, sizeof(*xs));
+    xs->xs_vec = vec;
+    xs->xs_veclen = veclen;
+    xs->xs_pretty = pretty;
+    return xs;
+}
+
+/*! Print next part of XML trees
+ *
+ * Printing stops after the XML node where at least len bytes have been added to cb
+ * @param[in]  xs      XML stream
+ * @param[out] cb      Cligen buffer to write to
+ * @param[in]  len     Number of bytes to print (approximately)
+ * @retval     1       OK, more to print
+ * @retval     0       OK, printing done
+ * @retval    -1       Error
+ */
+int
+clixon_xml_stream_read(xml_stream *xs,
+                       cbuf       *cb,
+                       size_t      len)
+{
+    int               retval = -1;
+    size_t            len0 = cbuf_len(cb);
+    struct xml_frame *xf;
+    cxobj            *xc;
+
+    while (cbuf_len(cb) - len0 < len){
+        if (xs->xs_depth == 0){
+            if (xs->xs_veci == xs->xs_veclen)
+                break;
+            if ((xc = xs->xs_vec[xs->xs_veci++]) != NULL &&
+                xml_stream_push(xs, cb, xc, 0) < 0)
+                goto done;
+            continue;
+        }
+        xf = &xs->xs_stack[xs->xs_depth-1];
+        xc = NULL;
+        while (xf->xf_i < xml_child_nr(xf->xf_x)){
+            xc = xml_child_i(xf->xf_x, xf->xf_i++);
+            if (xml_type(xc) != CX_ATTR)
+                break;
+            xc = NULL;
+        }
+        if (xc != NULL){
+            if (xml_stream_push(xs, cb, xc, xf->xf_level+1) < 0)
+                goto done;
+            continue;
+        }
+        xml_elmnt_end2cbuf(cb, xf->xf_x, xf->xf_level*PRETTYPRINT_INDENT, xs->xs_pretty, NULL,
+                           xf->xf_hasbody);
+        xs->xs_depth--;
+    }
+    retval = xs->xs_depth > 0 || xs->xs_veci < xs->xs_veclen;
+ done:
+    return retval;
+}
+
+/*! Free incremental printing of XML trees, the XML trees are not freed
+ *
+ * @param[in]  xs      XML stream
+ */
+int
+clixon_xml_stream_free(xml_stream *xs)
+{
+    if (xs->xs_stack)
+        free(xs->xs_stack);
+    free(xs);
+    return 0;
+}
+
 /*! Print actual xml tree datastructures (not xml), mainly for debugging
  *
  * @param[in,out] cb          Cligen buffer to write to
@@ -533,6 +863,19 @@ xmltree2cbuf(cbuf  *cb,
 /*--------------------------------------------------------------------
  * XML parsing functions. Create XML parse tree from string and file.
  *--------------------------------------------------------------------*/
+/*! Kludge to select the hand-written XML parser instead of the yacc parser
+ *
+ * The problem with this is that its global and should be bound to a handle
+ * @param[in] val  If set, use clixon_xml_parse_fast
+ * @see CLICON_XML_FAST_PARSER
+ */
+int
+clixon_xml_parse_fast_set(int val)
+{
+    _xml_parse_fast = val;
+    return 0;
+}
+
 /*! Common internal xml parsing function string to parse-tree
  *
  * Given a string containing XML, parse into existing XML tree and return
@@ -588,10 +931,22 @@ _xml_parse(const char *str,
     xy.xy_xtop = xt;
     xy.xy_xparent = xt;
     xy.xy_yspec = yspec;
-    if (clixon_xml_parsel_init(&xy) < 0)
-        goto done;
-    if (clixon_xml_parseparse(&xy) != 0)  /* yacc returns 1 on error */
-        goto done;
+    if (_xml_parse_fast){
+        /* Bind yang while parsing */
+        if (yb == YB_MODULE || yb == YB_PARENT){
+            xy.xy_yb = yb;
+            xy.xy_xerr = xerr;
+        }
+        if (clixon_xml_parse_fast(&xy) < 0)
+            goto done;
+        failed = xy.xy_failed;
+    }
+    else {
+        if (clixon_xml_parsel_init(&xy) < 0)
+            goto done;
+        if (clixon_xml_parseparse(&xy) != 0)  /* yacc returns 1 on error */
+            goto done;
+    }
     /* Purge all top-level body objects */
     x = NULL;
     while ((x = xml_find_type(xt, NULL, "body", CX_BODY)) != NULL)
@@ -604,6 +959,8 @@ _xml_parse(const char *str,
             goto done;
         /* Populate, ie associate xml nodes with yang specs
          */
+        if (xy.xy_yb != YB_NONE) /* Bound while parsing */
+            continue;
         switch (yb){
         case YB_NONE:
             break;
@@ -652,7 +1009,8 @@ _xml_parse(const char *str,
             goto done;
     retval = 1;
   done:
-    clixon_xml_parsel_exit(&xy);
+    if (xy.xy_lexbuf)
+        clixon_xml_parsel_exit(&xy);
     if (xy.xy_parse_string != NULL)
         free(xy.xy_parse_string);
     if (xy.xy_xvec)
@@ -699,7 +1057,6 @@ clixon_xml_parse_file(FILE      *fp,
     int   retval = -1;
     int   ret;
     int   len = 0;
-    char  ch;
     char *xmlbuf = NULL;
     char *ptr;
     int   xmlbuflen = BUFLEN; /* start size */
@@ -721,12 +1078,11 @@ clixon_xml_parse_file(FILE      *fp,
     memset(xmlbuf, 0, xmlbuflen);
     ptr = xmlbuf;
     while (1){
-        if ((ret = fread(&ch, 1, 1, fp)) < 0){
-            clicon_err(OE_XML, errno, "read");
-            break;
-        }
-        if (ret != 0){
-            xmlbuf[len++] = ch;
+        ret = fread(xmlbuf+len, 1, xmlbuflen-1-len, fp);
+        len += ret;
+        if (ret == 0 && ferror(fp)){
+            clicon_err(OE_XML, errno, "fread");
+            goto done;
         }
         if (ret == 0) {
             if (*xt == NULL)
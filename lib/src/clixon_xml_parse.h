@@ -55,6 +55,10 @@ struct clixon_xml_parse_yacc {
     int         xy_lex_state;    /* lex return state */
     cxobj     **xy_xvec;         /* Vector of created top-level nodes (to know which are created) */
     int         xy_xlen;         /* Length of xy_xvec */
+    yang_bind   xy_yb;           /* Bind yang while parsing if YB_MODULE or YB_PARENT (fast parser) */
+    cxobj     **xy_xerr;         /* Reason for failed yang binding while parsing */
+    cxobj      *xy_xskip;        /* Do not bind yang within this element */
+    int         xy_failed;       /* Number of top-level elements where yang binding failed */
 };
 typedef struct clixon_xml_parse_yacc clixon_xml_yacc;
 
@@ -73,4 +77,6 @@ int clixon_xml_parsel_linenr(void);
 int clixon_xml_parselex(void *);
 int clixon_xml_parseparse(void *);
 
+int clixon_xml_parse_fast(clixon_xml_yacc *xy);
+
 #endif  /* _CLIXON_XML_PARSE_H_ */
@@ -0,0 +1,641 @@
+/*
+ *
+  ***** BEGIN LICENSE BLOCK *****
+ 
+  Copyright (C) 2009-2016 Olof Hagsand and Benny Holmgren
+  Copyright (C) 2017-2019 Olof Hagsand
+  Copyright (C) 2020-2022 Olof Hagsand and Rubicon Communications, LLC(Netgate)
+
+  This file is part of CLIXON.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  Alternatively, the contents of this file may be used under the terms of
+  the GNU General Public License Version 3 or later (the "GPL"),
+  in which case the provisions of the GPL are applicable instead
+  of those above. If you wish to allow use of your version of this file only
+  under the terms of the GPL, and not to allow others to
+  use your version of this file under the terms of Apache License version 2, 
+  indicate your decision by deleting the provisions above and replace them with
+  the  notice and other provisions required by the GPL. If you do not delete
+  the provisions above, a recipient may use your version of this file under
+  the terms of any one of the Apache License version 2 or the GPL.
+
+  ***** END LICENSE BLOCK *****
+
+ * Hand-written XML parser, alternative to the flex/bison parser in clixon_xml_parse.[ly]
+ * The parse string is tokenized in a single pass and in place: names and attribute values
+ * are NUL-terminated where they are, and character data is entity-decoded by compacting it
+ * within the string. No per-token strings are allocated.
+ * The resulting XML tree, and the accepted syntax, are the same as with the yacc parser, ie:
+ * - Named entities are decoded, character references (&#nn;) are kept as is
+ * - CDATA sections are kept including delimiters, CR and CR LF are translated to LF
+ * - Attribute values are not decoded
+ * - Bodies of elements with element children are removed
+ * Namespaces are checked after parsing in _xml_parse(), as with the yacc parser.
+ * If xy_yb is YB_MODULE or YB_PARENT, yang is bound to each element as it is parsed, using
+ * xml_bind_yang_start when its start tag is parsed and xml_bind_yang_end at its end tag,
+ * instead of traversing the tree after parsing.
+ * @see https://www.w3.org/TR/2008/REC-xml-20081126
+ *      https://www.w3.org/TR/2009/REC-xml-names-20091208
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <strings.h>
+#include <errno.h>
+#include <stdlib.h>
+
+/* cligen */
+#include <cligen/cligen.h>
+
+/* clicon */
+#include "clixon_err.h"
+#include "clixon_log.h"
+#include "clixon_queue.h"
+#include "clixon_hash.h"
+#include "clixon_string.h"
+#include "clixon_handle.h"
+#include "clixon_yang.h"
+#include "clixon_xml.h"
+#include "clixon_xml_bind.h"
+#include "clixon_xml_parse.h"
+
+/* NCName characters, same as namestart and namechar in clixon_xml_parse.l */
+#define XF_NAMESTART(c) (((c)>='a' && (c)<='z') || ((c)>='A' && (c)<='Z') || (c)=='_')
+#define XF_NAMECHAR(c)  (XF_NAMESTART(c) || ((c)>='0' && (c)<='9') || (c)=='-' || (c)=='.')
+#define XF_WHITESPACE(c) ((c)==' ' || (c)=='\t' || (c)=='\n' || (c)=='\r')
+
+/* Named entities decoded in character data, @see xml_chardata_encode */
+static const struct {
+    const char *xe_name;
+    size_t      xe_len;
+    char        xe_ch;
+} xf_entities[] = {
+    {"amp;",  4, '&'},
+    {"lt;",   3, '<'},
+    {"gt;",   3, '>'},
+    {"apos;", 5, '\''},
+    {"quot;", 5, '\"'},
+    {NULL,    0, '\0'}
+};
+
+/*! Report parse error with line number, same format as yacc parser
+ *
+ * @param[in]  xy   XML parser handler struct
+ * @param[in]  s    Position in parse string
+ * @param[in]  msg  Error message
+ */
+static void
+xf_error(clixon_xml_yacc *xy,
+         char            *s,
+         char            *msg)
+{
+    char *p;
+
+    xy->xy_linenum = 0;
+    for (p = xy->xy_parse_string; p < s && *p; p++)
+        if (*p == '\n')
+            xy->xy_linenum++;
+    clicon_err(OE_XML, XMLPARSE_ERRNO, "xml_parse: line %d: %s: at or before: %.16s",
+               xy->xy_linenum, msg, s);
+}
+
+static char *
+xf_skipws(char *s)
+{
+    while (XF_WHITESPACE(*s))
+        s++;
+    return s;
+}
+
+/*! Scan NCName
+ *
+ * @param[in]  s    Start of name
+ * @retval     e    End of name (first char after)
+ * @retval     NULL Not a name
+ */
+static char *
+xf_name(char *s)
+{
+    if (!XF_NAMESTART(*s))
+        return NULL;
+    s++;
+    while (XF_NAMECHAR(*s))
+        s++;
+    return s;
+}
+
+/*! Scan qualified name: [prefix:]name, whitespace allowed between as in yacc parser
+ *
+ * The prefix, if any, is NUL-terminated in place. The name is not, since the character
+ * after it is needed by the caller
+ * @param[in]  xy      XML parser handler struct
+ * @param[in]  s       Start of qname
+ * @param[out] prefix  Prefix or NULL
+ * @param[out] name    Name
+ * @param[out] ne      End of name
+ * @retval     s       Position after qname (and trailing whitespace)
+ * @retval     NULL    Error
+ */
+static char *
+xf_qname(clixon_xml_yacc *xy,
+         char            *s,
+         char           **prefix,
+         char           **name,
+         char           **ne)
+{
+    char *e;
+
+    if ((e = xf_name(s)) == NULL){
+        xf_error(xy, s, "syntax error");
+        return NULL;
+    }
+    *prefix = NULL;
+    *name = s;
+    *ne = e;
+    s = xf_skipws(e);
+    if (*s == ':'){
+        *e = '\0';
+        *prefix = *name;
+        s = xf_skipws(s+1);
+        if ((e = xf_name(s)) == NULL){
+            xf_error(xy, s, "syntax error");
+            return NULL;
+        }
+        *name = s;
+        *ne = e;
+        s = xf_skipws(e);
+    }
+    return s;
+}
+
+/*! Scan quoted string and NUL-terminate it in place
+ *
+ * @param[in]  xy      XML parser handler struct
+ * @param[in]  s       Start of string, at quote character
+ * @param[out] str     String contents
+ * @retval     s       Position after closing quote
+ * @retval     NULL    Error
+ */
+static char *
+xf_quoted(clixon_xml_yacc *xy,
+          char            *s,
+          char           **str)
+{
+    char *e;
+
+    if (*s != '\"' && *s != '\''){
+        xf_error(xy, s, "syntax error");
+        return NULL;
+    }
+    if ((e = strchr(s+1, *s)) == NULL){
+        xf_error(xy, s, "syntax error");
+        return NULL;
+    }
+    *e = '\0';
+    *str = s+1;
+    return e+1;
+}
+
+/*! Parse XML declaration: <?xml version=".." encoding=".." standalone=".." ?>
+ *
+ * @param[in]  xy      XML parser handler struct
+ * @param[in]  s       Position after "<?xml"
+ * @retval     s       Position after declaration
+ * @retval     NULL    Error
+ */
+static char *
+xf_xmldecl(clixon_xml_yacc *xy,
+           char            *s)
+{
+    char *val;
+
+    s = xf_skipws(s);
+    if (strncmp(s, "version", 7) != 0 ||
+        *(s = xf_skipws(s+7)) != '=' ||
+        (s = xf_quoted(xy, xf_skipws(s+1), &val)) == NULL){
+        if (s != NULL)
+            xf_error(xy, s, "syntax error");
+        return NULL;
+    }
+    if (strcmp(val, "1.0")){
+        clicon_err(OE_XML, XMLPARSE_ERRNO, "Unsupported XML version: %s expected 1.0", val);
+        return NULL;
+    }
+    s = xf_skipws(s);
+    if (strncmp(s, "encoding", 8) == 0){
+        if (*(s = xf_skipws(s+8)) != '=' ||
+            (s = xf_quoted(xy, xf_skipws(s+1), &val)) == NULL){
+            if (s != NULL)
+                xf_error(xy, s, "syntax error");
+            return NULL;
+        }
+        if (strcasecmp(val, "UTF-8")){
+            clicon_err(OE_XML, XMLPARSE_ERRNO, "Unsupported XML encoding: %s expected UTF-8", val);
+            return NULL;
+        }
+        s = xf_skipws(s);
+    }
+    if (strncmp(s, "standalone", 10) == 0){
+        if (*(s = xf_skipws(s+10)) != '=' ||
+            (s = xf_quoted(xy, xf_skipws(s+1), &val)) == NULL){
+            if (s != NULL)
+                xf_error(xy, s, "syntax error");
+            return NULL;
+        }
+        s = xf_skipws(s);
+    }
+    if (strncmp(s, "?>", 2) != 0){
+        xf_error(xy, s, "syntax error");
+        return NULL;
+    }
+    return s+2;
+}
+
+/*! Parse character data up to next tag, decode it in place and append it to body
+ *
+ * Character data is compacted within the parse string as entities and line-ends are
+ * translated. CDATA sections are included as is.
+ * @param[in]     xy      XML parser handler struct
+ * @param[in]     s       Start of character data
+ * @param[in]     skip    Decode but do not add to tree
+ * @param[in,out] xbody   Body object to append to, created if NULL
+ * @retval        s       Position of next tag or end of string
+ * @retval        NULL    Error
+ */
+static char *
+xf_chardata(clixon_xml_yacc *xy,
+            char            *s,
+            int              skip,
+            cxobj          **xbody)
+{
+    char  *w = s;      /* Write position, w <= s */
+    char  *s0 = s;
+    char  *e;
+    size_t n;
+    char   c;
+    int    i;
+
+    while (1){
+        n = strcspn(s, "<&\r");
+        if (w != s)
+            memmove(w, s, n);
+        w += n;
+        s += n;
+        if (*s == '\0')
+            break;
+        else if (*s == '\r'){ /* CR LF -> LF, CR -> LF */
+            *w++ = '\n';
+            if (*++s == '\n')
+                s++;
+        }
+        else if (*s == '&'){
+            for (i=0; xf_entities[i].xe_name; i++)
+                if (strncmp(s+1, xf_entities[i].xe_name, xf_entities[i].xe_len) == 0)
+                    break;
+            if (xf_entities[i].xe_name){
+                *w++ = xf_entities[i].xe_ch;
+                s += 1 + xf_entities[i].xe_len;
+                continue;
+            }
+            /* Character reference, kept as is */
+            e = s+1;
+            if (*e++ != '#'){
+                xf_error(xy, s, "syntax error");
+                return NULL;
+            }
+            if (*e == 'x')
+                for (e++; (*e>='0' && *e<='9') || (*e>='a' && *e<='f') || (*e>='A' && *e<='F'); e++);
+            else
+                for (; *e>='0' && *e<='9'; e++);
+            if (*e != ';' || e[-1] == '#' || e[-1] == 'x'){
+                xf_error(xy, s, "syntax error");
+                return NULL;
+            }
+            n = e+1-s;
+            memmove(w, s, n);
+            w += n;
+            s += n;
+        }
+        else if (strncmp(s, "<![CDATA[", 9) == 0){
+            if ((e = strstr(s+9, "]]>")) == NULL){
+                xf_error(xy, s, "syntax error");
+                return NULL;
+            }
+            n = e+3-s;
+            if (w != s)
+                memmove(w, s, n);
+            w += n;
+            s += n;
+        }
+        else
+            break;
+    }
+    if (w > s0 && !skip){
+        if (*xbody == NULL &&
+            (*xbody = xml_new("body", xy->xy_xparent, CX_BODY)) == NULL)
+            return NULL;
+        c = *w;
+        *w = '\0';
+        if (xml_value_append(*xbody, s0) < 0)
+            return NULL;
+        *w = c;
+    }
+    return s;
+}
+
+/*! Bind yang to element when its start tag has been parsed
+ *
+ * Elements are bound as in xml_bind_yang0: if binding fails, the rest of the top-level
+ * element is not bound, and children of anydata are not bound.
+ * @param[in]  xy   XML parser handler struct
+ * @param[in]  x    Element
+ * @retval     0    OK
+ * @retval    -1    Error
+ */
+static int
+xf_bind_start(clixon_xml_yacc *xy,
+              cxobj           *x)
+{
+    int        retval = -1;
+    cxobj     *xp;
+    cxobj     *xs = NULL;
+    yang_bind  yb;
+    int        ret;
+    int        i;
+
+    if (xy->xy_xskip != NULL)
+        goto ok;
+    xp = xml_parent(x);
+    if (xp == xy->xy_xtop)
+        yb = xy->xy_yb;
+    else {
+        yb = YB_PARENT;
+        /* Use previous sibling with same name as role model, x is last child */
+        for (i = xml_child_nr(xp) - 2; i >= 0; i--){
+            xs = xml_child_i(xp, i);
+            if (xml_type(xs) != CX_BODY)
+                break;
+        }
+        if (i < 0 || xml_type(xs) != CX_ELMNT ||
+            xml_spec(xs) == NULL ||
+            clicon_strcmp(xml_name(xs), xml_name(x)) ||
+            clicon_strcmp(xml_prefix(xs), xml_prefix(x)))
+            xs = NULL;
+    }
+    if ((ret = xml_bind_yang_start(x, yb, xy->xy_yspec, xs, xy->xy_xerr)) < 0)
+        goto done;
+    if (ret == 0){ /* Skip rest of top-level element */
+        xy->xy_failed++;
+        for (xy->xy_xskip = x;
+             xml_parent(xy->xy_xskip) != xy->xy_xtop;
+             xy->xy_xskip = xml_parent(xy->xy_xskip))
+            ;
+    }
+    else if (ret == 2)
+        xy->xy_xskip = x;
+ ok:
+    retval = 0;
+ done:
+    return retval;
+}
+
+/*! Finish yang binding of element when it has been parsed
+ *
+ * @param[in]  xy   XML parser handler struct
+ * @param[in]  x    Element
+ * @retval     0    OK
+ * @retval    -1    Error
+ */
+static int
+xf_bind_end(clixon_xml_yacc *xy,
+            cxobj           *x)
+{
+    if (xml_spec(x) != NULL &&
+        xml_bind_yang_end(x, xml_parent(x) == xy->xy_xtop ? xy->xy_yb : YB_PARENT) < 0)
+        return -1;
+    if (xy->xy_xskip == x)
+        xy->xy_xskip = NULL;
+    return 0;
+}
+
+/*! Parse start tag and attributes, create element
+ *
+ * @param[in]  xy      XML parser handler struct
+ * @param[in]  s       Position after "<"
+ * @retval     s       Position after tag
+ * @retval     NULL    Error
+ */
+static char *
+xf_starttag(clixon_xml_yacc *xy,
+            char            *s)
+{
+    cxobj *x;
+    cxobj *xa;
+    cxobj *xp = xy->xy_xparent;
+    char  *prefix;
+    char  *name;
+    char  *ne;
+    char  *val;
+    char   c;
+
+    if ((s = xf_qname(xy, xf_skipws(s), &prefix, &name, &ne)) == NULL)
+        return NULL;
+    c = *ne;
+    *ne = '\0';
+    if ((x = xml_new(name, xp, CX_ELMNT)) == NULL)
+        return NULL;
+    *ne = c;
+    if (xml_prefix_set(x, prefix) < 0)
+        return NULL;
+    if (xp == xy->xy_xtop &&
+        cxvec_append(x, &xy->xy_xvec, &xy->xy_xlen) < 0)
+        return NULL;
+    while (1){
+        if (*s == '>' || (*s == '/' && s[1] == '>')){
+            if (xy->xy_yb != YB_NONE && xf_bind_start(xy, x) < 0)
+                return NULL;
+            if (*s == '>'){
+                xy->xy_xparent = x;
+                return s+1;
+            }
+            if (xy->xy_yb != YB_NONE && xf_bind_end(xy, x) < 0)
+                return NULL;
+            return s+2;
+        }
+        if ((s = xf_qname(xy, s, &prefix, &name, &ne)) == NULL)
+            return NULL;
+        if (*s != '='){
+            xf_error(xy, s, "syntax error");
+            return NULL;
+        }
+        *ne = '\0';
+        if ((s = xf_quoted(xy, xf_skipws(s+1), &val)) == NULL)
+            return NULL;
+        if ((xa = xml_find_type(x, prefix, name, CX_ATTR)) == NULL){
+            if ((xa = xml_new(name, x, CX_ATTR)) == NULL)
+                return NULL;
+            if (xml_prefix_set(xa, prefix) < 0)
+                return NULL;
+        }
+        if (xml_value_set(xa, val) < 0)
+            return NULL;
+        s = xf_skipws(s);
+    }
+}
+
+/*! Parse end tag, check it matches the start tag and close element
+ *
+ * Strip pretty-print bodies as in the yacc parser, see xml_parse_bslash
+ * @param[in]  xy      XML parser handler struct
+ * @param[in]  s       Position after "</"
+ * @retval     s       Position after tag
+ * @retval     NULL    Error
+ */
+static char *
+xf_endtag(clixon_xml_yacc *xy,
+          char            *s)
+{
+    cxobj *x = xy->xy_xparent;
+    char  *prefix;
+    char  *name;
+    char  *ne;
+
+    if ((s = xf_qname(xy, xf_skipws(s), &prefix, &name, &ne)) == NULL)
+        return NULL;
+    if (*s != '>' || x == xy->xy_xtop){
+        xf_error(xy, s, "syntax error");
+        return NULL;
+    }
+    *ne = '\0';
+    if (clicon_strcmp(xml_name(x), name) ||
+        clicon_strcmp(xml_prefix(x), prefix)){
+        clicon_err(OE_XML, XMLPARSE_ERRNO, "Sanity check failed: %s%s%s vs %s%s%s",
+                   xml_prefix(x)?xml_prefix(x):"", xml_prefix(x)?":":"", xml_name(x),
+                   prefix?prefix:"", prefix?":":"", name);
+        return NULL;
+    }
+    if (xml_child_each(x, NULL, CX_ELMNT) != NULL &&
+        xml_rm_children(x, CX_BODY) < 0)
+        return NULL;
+    if (xy->xy_yb != YB_NONE && xf_bind_end(xy, x) < 0)
+        return NULL;
+    xy->xy_xparent = xml_parent(x);
+    return s+1;
+}
+
+/*! Parse XML string into tree using hand-written parser
+ *
+ * Same interface as clixon_xml_parseparse(): the string in xy_parse_string is parsed into
+ * xy_xtop and created top-level nodes are added to xy_xvec. The string is modified.
+ * @param[in]  xy   XML parser handler struct
+ * @retval     0    OK
+ * @retval    -1    Error with clicon_err called
+ * @see clixon_xml_parse.y
+ */
+int
+clixon_xml_parse_fast(clixon_xml_yacc *xy)
+{
+    int    retval = -1;
+    char  *s;
+    cxobj *xbody = NULL; /* Current body, appended to until next tag */
+    int    start = 1;    /* As lex START state: whitespace skipped, no chardata */
+    int    decl = 0;     /* XML declaration: single top element */
+    int    skip;
+    char  *t;
+
+    s = xf_skipws(xy->xy_parse_string);
+    if (strncmp(s, "<?xml", 5) == 0){
+        if (!XF_WHITESPACE(s[5])){
+            xf_error(xy, s, "syntax error");
+            goto done;
+        }
+        if ((s = xf_xmldecl(xy, s+5)) == NULL)
+            goto done;
+        decl++;
+    }
+    while (1){
+        if (start)
+            s = xf_skipws(s);
+        else if ((*s != '<' && *s != '\0') || strncmp(s, "<![CDATA[", 9) == 0){
+            /* Bodies of elements with element children are removed, so are top-level */
+            skip = xy->xy_xparent == xy->xy_xtop ||
+                xml_child_each(xy->xy_xparent, NULL, CX_ELMNT) != NULL;
+            if (decl && xy->xy_xparent == xy->xy_xtop){ /* Only whitespace after top */
+                t = xf_skipws(s);
+                if (*t != '\0' && (*t != '<' || strncmp(t, "<![CDATA[", 9) == 0)){
+                    xf_error(xy, t, "syntax error");
+                    goto done;
+                }
+            }
+            if ((s = xf_chardata(xy, s, skip, &xbody)) == NULL)
+                goto done;
+        }
+        if (*s == '\0')
+            break;
+        if (*s != '<'){
+            xf_error(xy, s, "syntax error");
+            goto done;
+        }
+        if (s[1] == '/'){
+            if ((s = xf_endtag(xy, s+2)) == NULL)
+                goto done;
+            xbody = NULL;
+            start = 0;
+        }
+        else if (strncmp(s, "<!--", 4) == 0){
+            if ((s = strstr(s+4, "-->")) == NULL){
+                xf_error(xy, xy->xy_parse_string + strlen(xy->xy_parse_string), "syntax error");
+                goto done;
+            }
+            s += 3;
+            start = 1;
+        }
+        else if (s[1] == '?'){ /* Processing instruction, <?xml only allowed first */
+            if (start && strncmp(s, "<?xml", 5) == 0){
+                xf_error(xy, s, "syntax error");
+                goto done;
+            }
+            if (xf_name(s+2) == NULL || (t = strstr(s+2, "?>")) == NULL){
+                xf_error(xy, s, "syntax error");
+                goto done;
+            }
+            s = t+2;
+            start = 1;
+        }
+        else if (s[1] == '!'){ /* CDATA not allowed here */
+            xf_error(xy, s, "syntax error");
+            goto done;
+        }
+        else {
+            if (decl && xy->xy_xparent == xy->xy_xtop && xy->xy_xlen){
+                xf_error(xy, s, "syntax error");
+                goto done;
+            }
+            if ((s = xf_starttag(xy, s+1)) == NULL)
+                goto done;
+            xbody = NULL;
+            start = 0;
+        }
+    }
+    if (xy->xy_xparent != xy->xy_xtop ||
+        (decl && xy->xy_xlen == 0)){
+        xf_error(xy, s, "syntax error");
+        goto done;
+    }
+    retval = 0;
+ done:
+    return retval;
+}
@@ -421,10 +421,79 @@ xml_sort(cxobj *x)
         return 1;
 #endif
     xml_enumerate_children(x); /* This is to make sorting "stable", ie not change existing order */
-    qsort(xml_childvec_get(x), xml_child_nr(x), sizeof(cxobj *), xml_cmp_qsort);
+    if (xml_childvec_sort(x, xml_cmp_qsort) < 0)
+        return -1;
     return 0;
 }
 
+/*! Merge children appended in bulk mode into the sorted children of an XML node
+ *
+ * Children marked with XML_FLAG_BULK (see xml_insert) are sorted once and merged linearly
+ * with the other, already sorted, children. This is used when many children are added,
+ * instead of a binary search and vector insert per child.
+ * Existing children are placed before equal new children, and new ordered-by user
+ * children are kept in the order they were added.
+ * @param[in]  xp   XML parent node, XML_FLAG_BULK is reset
+ * @retval     0    OK
+ * @retval    -1    Error
+ * @see xml_insert
+ */
+int
+xml_sort_merge(cxobj *xp)
+{
+    int     retval = -1;
+    cxobj **xnew = NULL;
+    cxobj  *x;
+    cxobj  *xo;
+    int     n;
+    int     nold = 0;
+    int     nnew = 0;
+    int     i;
+    int     j;
+    int     k;
+
+    xml_flag_reset(xp, XML_FLAG_BULK);
+    if ((n = xml_child_nr(xp)) == 0)
+        goto ok;
+    xml_enumerate_children(xp); /* Stable: keep existing order and order added */
+    if ((xnew = malloc(n*sizeof(cxobj *))) == NULL){
+        clicon_err(OE_XML, errno, "malloc");
+        goto done;
+    }
+    /* Split into old children, compacted in place, and new children.
+     * Access by position, not xml_childvec_get() which would flatten a chunked vector */
+    for (i=0; i<n; i++){
+        x = xml_child_i(xp, i);
+        if (xml_flag(x, XML_FLAG_BULK)){
+            xml_flag_reset(x, XML_FLAG_BULK);
+            xnew[nnew++] = x;
+        }
+        else
+            xml_child_i_set(xp, nold++, x);
+    }
+    if (nnew == 0)
+        goto ok;
+    qsort(xnew, nnew, sizeof(cxobj *), xml_cmp_qsort);
+    /* Merge from the end so that old children can be moved within the child vector */
+    i = nold - 1;
+    j = nnew - 1;
+    k = n - 1;
+    while (j >= 0){
+        if (i >= 0 && xml_cmp((xo = xml_child_i(xp, i)), xnew[j], 1, 0, NULL) > 0){
+            xml_child_i_set(xp, k--, xo);
+            i--;
+        }
+        else
+            xml_child_i_set(xp, k--, xnew[j--]);
+    }
+ ok:
+    retval = 0;
+ done:
+    if (xnew)
+        free(xnew);
+    return retval;
+}
+
 /*! Recursively sort a tree 
  *
  * Alt to use xml_apply
@@ -520,8 +589,7 @@ xml_find_keys_notsorted(cxobj   *xp,
 
 /*! Find more equal objects in a vector up and down in the array of the present
  *
- * @param[in]  childvec  Vector of children of parent
- * @param[in]  childlen  Length of child vector
+ * @param[in]  xp        Parent XML node
  * @param[in]  x1        XML node to match
  * @param[in]  yangi     Yang order number (according to spec)
  * @param[in]  mid       Where to start from (may be in middle of interval)
@@ -530,8 +598,7 @@ xml_find_keys_notsorted(cxobj   *xp,
  * @retval    -1         Error
  */
 static int
-search_multi_equals(cxobj  **childvec,
-                    size_t   childlen,
+search_multi_equals(cxobj   *xp,
                     cxobj   *x1,
                     int      yangi,
                     int      mid,
@@ -545,7 +612,7 @@ search_multi_equals(cxobj  **childvec,
     int        yi;
 
     for (i=mid-1; i>=0; i--){ /* First decrement */
-        xc = childvec[i];
+        xc = xml_child_i(xp, i);
         yc = xml_spec(xc);
         if ((yi = yang_order(yc)) < -1)
             goto done;
@@ -556,8 +623,8 @@ search_multi_equals(cxobj  **childvec,
         if (clixon_xvec_prepend(xvec, xc) < 0)
             goto done;
     }
-    for (i=mid+1; i<childlen; i++){ /* Then increment */
-        xc = childvec[i];
+    for (i=mid+1; i<xml_child_nr(xp); i++){ /* Then increment */
+        xc = xml_child_i(xp, i);
         yc = xml_spec(xc);
         if ((yi = yang_order(yc)) < -1)
             goto done;
@@ -793,8 +860,7 @@ xml_search_binary(cxobj   *xp,
         if (clixon_xvec_append(xvec, xc) < 0)
             goto done;
         /* there may be more? */
-        if (search_multi_equals(xml_childvec_get(xp), xml_child_nr(xp),
-                                x1, yangi, mid, skip1, xvec) < 0)
+        if (search_multi_equals(xp, x1, yangi, mid, skip1, xvec) < 0)
             goto done;
     }
     else if (cmp < 0)
@@ -1093,6 +1159,13 @@ xml_insert(cxobj           *xp,
         clicon_err(OE_XML, 0, "No spec found %s", xml_name(xi));
         goto done;
     }
+    if (ins == INS_LAST && xml_flag(xp, XML_FLAG_BULK)){
+        /* Bulk merge: append unsorted and merge all at once in xml_sort_merge */
+        if (xml_child_insert_pos(xp, xi, xml_child_nr(xp)) < 0)
+            goto done;
+        xml_flag_set(xi, XML_FLAG_BULK);
+        goto ok;
+    }
     upper = xml_child_nr(xp);
     /* Assume if there are any attributes, they are first in the list, mask
        them by raising low to skip them */
@@ -1115,6 +1188,7 @@ xml_insert(cxobj           *xp,
         goto done;
     if (xml_child_insert_pos(xp, xi, i) < 0)
         goto done;
+ ok:
     xml_parent_set(xi, xp);
     /* clear namespace context cache of child */
     nscache_clear(xi);
@@ -1614,3 +1688,210 @@ clixon_xml_find_pos(cxobj        *xp,
  done:
     return retval;
 }
+
+/*! Lower bound of children of xp with yang order at least yi
+ *
+ * @param[in]  xp     Parent xml node.
+ * @param[in]  yi     Yang order
+ * @param[in]  low    Lower index of search interval
+ * @param[in]  upper  Upper index of search interval (not included)
+ * @retval     i      Index of first child with yang order >= yi, or upper
+ * @retval    -1      Unbound child, cannot search
+ */
+static int
+xml_search_order_lower(cxobj *xp,
+                       int    yi,
+                       int    low,
+                       int    upper)
+{
+    int        mid;
+    cxobj     *xc;
+    yang_stmt *y;
+
+    while (low < upper){
+        mid = (low + upper) / 2;
+        xc = xml_child_i(xp, mid);
+        if ((y = xml_spec(xc)) == NULL)
+            return -1;
+        if (yang_order(y) < yi)
+            low = mid + 1;
+        else
+            upper = mid;
+    }
+    return low;
+}
+
+/*! Find the interval of list or leaf-list entries among the (sorted) children of xp
+ *
+ * Entries of the same list are contiguous in the child vector, ordered either by key or
+ * by user. The interval is found by binary search on yang order, so the number of entries
+ * and an entry at a given position are found without traversing the list.
+ * @param[in]  xp     Parent xml node.
+ * @param[in]  yc     Yang spec of list or leaf-list child
+ * @param[out] lowp   Index of first entry in child vector
+ * @param[out] upperp Index after last entry in child vector
+ * @retval     1      OK, entries are xml_child_i(xp, i) for lowp <= i < upperp
+ * @retval     0      Children of xp are not bound to yang, use another method
+ * @retval    -1      Error
+ * @see clixon_xml_find_pos  For a linear variant
+ */
+int
+clixon_xml_find_range(cxobj     *xp,
+                      yang_stmt *yc,
+                      int       *lowp,
+                      int       *upperp)
+{
+    int    retval = -1;
+    cxobj *xa;
+    int    low;
+    int    upper;
+    int    yi;
+
+    if (xp == NULL || yc == NULL){
+        clicon_err(OE_XML, EINVAL, "xp or yc is NULL");
+        goto done;
+    }
+    upper = xml_child_nr(xp);
+    /* Attributes are first in the child vector */
+    for (low=0; low<upper; low++)
+        if ((xa = xml_child_i(xp, low)) == NULL || xml_type(xa) != CX_ATTR)
+            break;
+    if ((yi = yang_order(yc)) < -1)
+        goto done;
+    if ((low = xml_search_order_lower(xp, yi, low, upper)) < 0)
+        goto fail;
+    if ((upper = xml_search_order_lower(xp, yi+1, low, upper)) < 0)
+        goto fail;
+    *lowp = low;
+    *upperp = upper;
+    retval = 1;
+ done:
+    return retval;
+ fail:
+    retval = 0;
+    goto done;
+}
+
+/* Sort element used by clixon_xml_sort_by */
+struct sort_by_elem {
+    cxobj  *sb_x;    /* List or leaf-list entry */
+    cxobj  *sb_node; /* Node sorted by, or NULL if not present */
+    cg_var *sb_cv;   /* Cached typed value of sb_node, if yang bound */
+    size_t  sb_i;    /* Original position, makes sort stable */
+};
+
+/*! qsort comparison function for clixon_xml_sort_by
+ *
+ * Missing values are sorted last, typed values are compared with cv_cmp
+ */
+static int
+xml_sort_by_qsort(const void *arg1,
+                  const void *arg2)
+{
+    struct sort_by_elem *sb1 = (struct sort_by_elem *)arg1;
+    struct sort_by_elem *sb2 = (struct sort_by_elem *)arg2;
+    char                *b1;
+    char                *b2;
+    int                  equal = 0;
+
+    if (sb1->sb_node == NULL && sb2->sb_node == NULL)
+        ;
+    else if (sb1->sb_node == NULL)
+        equal = 1;
+    else if (sb2->sb_node == NULL)
+        equal = -1;
+    else if (sb1->sb_cv && sb2->sb_cv)
+        equal = cv_cmp(sb1->sb_cv, sb2->sb_cv);
+    else {
+        b1 = xml_body(sb1->sb_node);
+        b2 = xml_body(sb2->sb_node);
+        equal = strcmp(b1?b1:"", b2?b2:"");
+    }
+    if (equal == 0)
+        equal = (sb1->sb_i < sb2->sb_i) ? -1 : (sb1->sb_i > sb2->sb_i);
+    return equal;
+}
+
+/*! Find a descendant node given by a schema node identifier, prefixes are ignored
+ *
+ * @param[in]  x       XML node
+ * @param[in]  nodeid  Descendant node identifier, eg "es:stats/es:joined", or NULL for x itself
+ * @retval     xn      Descendant node
+ * @retval     NULL    Not found
+ */
+static cxobj *
+xml_sort_by_node(cxobj      *x,
+                 const char *nodeid)
+{
+    const char *s;
+    const char *e;
+    const char *p;
+    size_t      len;
+    cxobj      *xc;
+
+    if (nodeid == NULL)
+        return x;
+    s = nodeid;
+    while (x != NULL && *s != '\0'){
+        if ((e = strchr(s, '/')) == NULL)
+            e = s + strlen(s);
+        if ((p = memchr(s, ':', e - s)) != NULL)
+            s = p + 1;
+        len = e - s;
+        xc = NULL;
+        while ((xc = xml_child_each(x, xc, CX_ELMNT)) != NULL)
+            if (strncmp(xml_name(xc), s, len) == 0 && xml_name(xc)[len] == '\0')
+                break;
+        x = xc;
+        s = *e ? e + 1 : e;
+    }
+    return x;
+}
+
+/*! Stable sort of a vector of list or leaf-list entries on the value of a descendant node
+ *
+ * Sort in ascending order as defined by list-pagination "sort-by". Entries that do not
+ * have the node are sorted last, entries with equal values keep their relative order.
+ * @param[in,out] xvec    Vector of list or leaf-list entries
+ * @param[in]     xlen    Length of xvec
+ * @param[in]     nodeid  Descendant node identifier, eg "stats/joined", NULL sorts on the
+ *                        (leaf-list) entry value itself
+ * @retval        0       OK
+ * @retval       -1       Error
+ */
+int
+clixon_xml_sort_by(cxobj     **xvec,
+                   size_t      xlen,
+                   const char *nodeid)
+{
+    int                  retval = -1;
+    struct sort_by_elem *sbv = NULL;
+    struct sort_by_elem *sb;
+    size_t               i;
+
+    if (xlen < 2)
+        goto ok;
+    if ((sbv = calloc(xlen, sizeof(*sbv))) == NULL){
+        clicon_err(OE_UNIX, errno, "calloc");
+        goto done;
+    }
+    for (i=0; i<xlen; i++){
+        sb = &sbv[i];
+        sb->sb_x = xvec[i];
+        sb->sb_i = i;
+        if ((sb->sb_node = xml_sort_by_node(xvec[i], nodeid)) == NULL)
+            continue;
+        if (xml_spec(sb->sb_node) != NULL &&
+            xml_cv_cache(sb->sb_node, &sb->sb_cv) < 0)
+            goto done;
+    }
+    qsort(sbv, xlen, sizeof(*sbv), xml_sort_by_qsort);
+    for (i=0; i<xlen; i++)
+        xvec[i] = sbv[i].sb_x;
+ ok:
+    retval = 0;
+ done:
+    if (sbv)
+        free(sbv);
+    return retval;
+}
@@ -68,13 +68,15 @@
 #include "clixon_xpath_ctx.h"
 #include "clixon_xpath.h"
 #include "clixon_xpath_optimize.h"
-
 #ifdef XPATH_LIST_OPTIMIZE
 static xpath_tree *_xmtop = NULL; /* pattern match tree top */
 static xpath_tree *_xm = NULL;
 static xpath_tree *_xe = NULL;
+static xpath_tree *_xdtop = NULL; /* leaf-list pattern match tree top */
+static xpath_tree *_xd = NULL;
 static int _optimize_enable = 1;
 static int _optimize_hits = 0;
+static xpath_optimize_stats _optimize_stats = {0,};
 #endif /* XPATH_LIST_OPTIMIZE */
 
 /* XXX development in clixon_xpath_eval */
@@ -88,6 +90,30 @@ xpath_list_optimize_stats(int *hits)
     return 0;
 }
 
+/*! Get statistics of the xpath index planner, per search plan
+ *
+ * Counters are global for the process and independent of xpath_list_optimize_stats.
+ * A search is counted in one of keys, prefix, index or leaflist, and additionally in
+ * nested and state if it applies to a list within a list or to state data.
+ * Scan counts list predicates where no search was possible
+ * @param[out] xos    Statistics
+ * @param[in]  reset  If set, reset counters after reading them
+ * @retval     0      OK
+ */
+int
+xpath_optimize_stats_get(xpath_optimize_stats *xos,
+                         int                   reset)
+{
+#ifdef XPATH_LIST_OPTIMIZE
+    *xos = _optimize_stats;
+    if (reset)
+        memset(&_optimize_stats, 0, sizeof(_optimize_stats));
+#else
+    memset(xos, 0, sizeof(*xos));
+#endif
+    return 0;
+}
+
 /*! Enable xpath optimize
  *
  * Cant replace this with option since there is no handle in xpath functions,...
@@ -107,18 +133,27 @@ xpath_optimize_exit(void)
 #ifdef XPATH_LIST_OPTIMIZE
     if (_xmtop)
         xpath_tree_free(_xmtop);
+    if (_xdtop)
+        xpath_tree_free(_xdtop);
+    _xmtop = _xm = _xe = NULL;
+    _xdtop = _xd = NULL;
 #endif
 }
 
 #ifdef XPATH_LIST_OPTIMIZE
 /*! Initialize xpath module
  *
+ * Two predicate patterns are used: _y='_z' for list keys and .='_z' for leaf-list values
  * XXX move to clixon_xpath.c 
+ * @param[out] xm  Step pattern: _x[...]
+ * @param[out] xe  Predicate expression pattern: _y='_z'
+ * @param[out] xd  Predicate expression pattern: .='_z'
  * @see loop_preds
  */
 int
 xpath_optimize_init(xpath_tree **xm,
-                    xpath_tree **xe)
+                    xpath_tree **xe,
+                    xpath_tree **xd)
 {
     int         retval = -1;
     xpath_tree *xs;
@@ -144,33 +179,76 @@ xpath_optimize_init(xpath_tree **xm,
         /* get keyname (_y) */
         if ((xs = xpath_tree_traverse(_xe, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -1)) == NULL)
             goto done;
-        xs->xs_match++; /* in loop_preds get name in xs_s1 XXX: leaf-list is different */
+        xs->xs_match++; /* in loop_preds get name in xs_s1 */
         /* get keyval (_z) */
         if ((xs = xpath_tree_traverse(_xe, 0, 0, 1, 0, 0, 0, 0, -1)) == NULL)
             goto done;
         xs->xs_match++; /* in loop_preds get value in xs_s0 or xs_strnr */
     }
+    if (_xd == NULL){
+        /* Leaf-list: self step "." is matched as is, only the value is variable */
+        if (xpath_parse("_x[.='_z']", &_xdtop) < 0)
+            goto done;
+        if ((_xd = xpath_tree_traverse(_xdtop, 0, 0, 1, 1, -1)) == NULL)
+            goto done;
+        /* get value (_z) */
+        if ((xs = xpath_tree_traverse(_xd, 0, 0, 1, 0, 0, 0, 0, -1)) == NULL)
+            goto done;
+        xs->xs_match++;
+    }
     *xm = _xm;
     *xe = _xe;
+    *xd = _xd;
     retval = 0;
  done:
     return retval;
 }
 
+/*! Add a <name>:<value> pair to a cvec, value taken from a literal xpath node
+ *
+ * @param[in]  cvk   Vector of <keyname>:<keyval> pairs
+ * @param[in]  name  Key name
+ * @param[in]  xv    XPath literal node, string or number
+ * @retval     0     OK
+ * @retval    -1     Error
+ */
+static int
+loop_preds_add(cvec       *cvk,
+               char       *name,
+               xpath_tree *xv)
+{
+    cg_var *cvi;
+
+    if ((cvi = cvec_add(cvk, CGV_STRING)) == NULL){
+        clicon_err(OE_XML, errno, "cvec_add");
+        return -1;
+    }
+    cv_name_set(cvi, name);
+    if (xv->xs_type == XP_PRIME_NR)
+        cv_string_set(cvi, xv->xs_strnr);
+    else
+        cv_string_set(cvi, xv->xs_s0);
+    return 0;
+}
 
 /*! Recursive function to loop over all EXPR and pattern match them
  *
+ * Only leading predicates are collected, the first predicate not matching any pattern
+ * stops the loop, since positional predicates such as [1] after it depend on the
+ * complete node-set.
  * @param[in]  xt    XPath tree of type PRED
- * @param[in]  xepat Pattern matching XPath tree of type EXPR
- * @param[out] cvk   Vector of <keyname>:<keyval> pairs
- * @retval     1     Match
- * @retval     0     No match
+ * @param[in]  xepat Pattern matching XPath tree of type EXPR: _y='_z'
+ * @param[in]  xdpat Pattern matching XPath tree of type EXPR: .='_z'
+ * @param[out] cvk   Vector of <keyname>:<keyval> pairs, keyname is "." for leaf-list values
+ * @retval     1     All predicates match
+ * @retval     0     Stopped at a predicate not matching, cvk contains the leading matches
  * @retval    -1     Error
  * @see xpath_optimize_init
  */
 static int
 loop_preds(xpath_tree *xt,
            xpath_tree *xepat,
+           xpath_tree *xdpat,
            cvec       *cvk)
 {
     int          retval = -1;
@@ -178,10 +256,9 @@ loop_preds(xpath_tree *xt,
     xpath_tree  *xe;
     xpath_tree **vec = NULL;
     size_t       veclen = 0;
-    cg_var      *cvi;
 
     if (xt->xs_type == XP_PRED && xt->xs_c0){
-        if ((ret = loop_preds(xt->xs_c0, xepat, cvk)) < 0)
+        if ((ret = loop_preds(xt->xs_c0, xepat, xdpat, cvk)) < 0)
             goto done;
         if (ret == 0)
             goto ok;
@@ -189,19 +266,19 @@ loop_preds(xpath_tree *xt,
     if ((xe = xt->xs_c1) && (xe->xs_type == XP_EXP)){
         if ((ret = xpath_tree_eq(xepat, xe, &vec, &veclen)) < 0)
             goto done;
-        if (ret == 0)
-            goto ok;
-        if (veclen != 2)
-            goto ok;
-        if ((cvi = cvec_add(cvk, CGV_STRING)) == NULL){
-            clicon_err(OE_XML, errno, "cvec_add");
-            goto done;
+        if (ret == 1 && veclen == 2){
+            if (loop_preds_add(cvk, vec[0]->xs_s1, vec[1]) < 0)
+                goto done;
+        }
+        else {
+            veclen = 0;
+            if ((ret = xpath_tree_eq(xdpat, xe, &vec, &veclen)) < 0)
+                goto done;
+            if (ret == 0 || veclen != 1)
+                goto ok;
+            if (loop_preds_add(cvk, ".", vec[0]) < 0)
+                goto done;
         }
-        cv_name_set(cvi, vec[0]->xs_s1);
-        if (vec[1]->xs_type == XP_PRIME_NR)
-            cv_string_set(cvi, vec[1]->xs_strnr);
-        else
-            cv_string_set(cvi, vec[1]->xs_s0);
     }
     retval = 1;
  done:
@@ -213,19 +290,92 @@ loop_preds(xpath_tree *xt,
     goto done;
 }
 
+/* Search plans of the xpath index planner, see xpath_optimize_stats */
+enum xo_plan {XO_SCAN = 0, XO_KEYS, XO_PREFIX, XO_INDEX, XO_LEAFLIST};
+
+/*! Plan a list search: all keys, leading keys or explicit index variable
+ *
+ * @param[in]  yc     Yang list
+ * @param[in]  sorted List is sorted (not ordered-by user)
+ * @param[in]  cvk    Equality predicates as <name>:<value>
+ * @param[out] cvp    Search keys in yang key order, or explicit index variable
+ * @param[out] plan   XO_KEYS, XO_PREFIX, XO_INDEX, or XO_SCAN if no search is possible
+ * @retval     0      OK
+ * @retval    -1      Error
+ * Leading keys are only usable if the list is sorted, an unsorted search only returns
+ * the first match
+ */
+static int
+xpath_list_plan(yang_stmt    *yc,
+                int           sorted,
+                cvec         *cvk,
+                cvec         *cvp,
+                enum xo_plan *plan)
+{
+    int        retval = -1;
+    cvec      *cvv;
+    cg_var    *cvi;
+    int        n;
+    int        i;
+#ifdef XML_EXPLICIT_INDEX
+    yang_stmt *yi;
+#endif
+
+    *plan = XO_SCAN;
+    cvv = yang_cvec_get(yc);
+    n = 0;
+    cvi = NULL;
+    while ((cvi = cvec_each(cvv, cvi)) != NULL &&
+           cvec_find(cvk, cv_string_get(cvi)) != NULL)
+        n++;
+    if (n && (n == cvec_len(cvv) || sorted)){
+        for (i=0; i<n; i++){
+            cvi = cvec_find(cvk, cv_string_get(cvec_i(cvv, i)));
+            if (cvec_append_var(cvp, cvi) == NULL){
+                clicon_err(OE_YANG, errno, "cvec_append_var");
+                goto done;
+            }
+        }
+        *plan = (n == cvec_len(cvv)) ? XO_KEYS : XO_PREFIX;
+        goto ok;
+    }
+#ifdef XML_EXPLICIT_INDEX
+    cvi = NULL;
+    while ((cvi = cvec_each(cvk, cvi)) != NULL) {
+        if ((yi = yang_find_datanode(yc, cv_name_get(cvi))) != NULL &&
+            yang_flag_get(yi, YANG_FLAG_INDEX) != 0){
+            if (cvec_append_var(cvp, cvi) == NULL){
+                clicon_err(OE_YANG, errno, "cvec_append_var");
+                goto done;
+            }
+            *plan = XO_INDEX;
+            break;
+        }
+    }
+#endif
+ ok:
+    retval = 0;
+ done:
+    return retval;
+}
+
 /*! Pattern matching to find fastpath
  *
  * @param[in]  xt     XPath tree
  * @param[in]  xv     XML base node
  * @param[out] xvec   Array of found nodes
- * @param[out] xlen   Len of xvec
- * @param[out] key
- * @param[out] keyval
  * @retval     1      Match
  * @retval     0      No match - use non-optimized lookup
  * @retval    -1      Error
  *  XPath:
- *  y[k=3] # corresponds to: <name>[<keyname>=<keyval>]
+ *  y[k=3]               # all keys: <name>[<keyname>=<keyval>]
+ *  y[k1=3]              # leading keys of y with keys k1 k2, sorted lists only
+ *  y[i=3]               # explicit index variable i, see XML_EXPLICIT_INDEX
+ *  y[.=3]               # leaf-list value
+ * This applies also to lists within lists and to state data if sorted, see
+ * STATE_ORDERED_BY_SYSTEM
+ * The search result may be a superset, since the predicates are evaluated on the result
+ * in xp_eval_step
  */
 static int
 xpath_list_optimize_fn(xpath_tree  *xt,
@@ -235,36 +385,29 @@ xpath_list_optimize_fn(xpath_tree  *xt,
     int          retval = -1;
     xpath_tree  *xm = NULL;
     xpath_tree  *xem = NULL;
+    xpath_tree  *xdm = NULL;
     char        *name;
     yang_stmt   *yp;
     yang_stmt   *yc;
-    cvec        *cvv = NULL;
     xpath_tree **vec = NULL;
     size_t       veclen = 0;
-    xpath_tree  *xtp;
     int          ret;
-    cvec        *cvk = NULL; /* vector of index keys */
+    cvec        *cvk = NULL; /* vector of predicate name:value */
+    cvec        *cvp = NULL; /* vector of index keys */
     cg_var      *cvi;
-    int          i;
+    enum xo_plan plan;
+    int          sorted;
+    int          state;
     yang_stmt   *ypp;
 
     /* revert to non-optimized if no yang */
-    if ((yp = xml_spec(xv)) == NULL)
+    if ((yp = xml_spec(xv)) == NULL || yang_keyword_get(yp) == Y_SPEC)
         goto ok;
-    /* or if not config data (state data should not be ordered) */
-    if (yang_config_ancestor(yp) == 0)
-        goto ok;
-    /* Check that there is no "outer" list. */
-    ypp = yp;
-    do {
-        if (yang_keyword_get(ypp) == Y_LIST)
-            goto ok;
-    } while((ypp = yang_parent_get(ypp)) != NULL);
-    /* Check yang and that only a list with key as index is a special case can do bin search 
-     * That is, ONLY check optimize cases of this type:_x[_y='_z']
-     * Should we extend this simple example and have more cases (all cases?)
+    /* Check yang and that only a list or leaf-list with index predicates can do bin search 
+     * That is, ONLY check optimize cases of this type: _x[_y='_z'] and _x[.='_z']
      */
-    xpath_optimize_init(&xm, &xem);
+    if (xpath_optimize_init(&xm, &xem, &xdm) < 0)
+        goto done;
     /* Here is where pattern is checked for equality and where variable binding is made (if
      * equal) */
     if ((ret = xpath_tree_eq(xm, xt, &vec, &veclen)) < 0)
@@ -274,36 +417,67 @@ xpath_list_optimize_fn(xpath_tree  *xt,
     if (veclen != 2)
         goto ok;
     name = vec[0]->xs_s1;
-    /* Extract variables */
-    if ((yc = yang_find(yp, Y_LIST, name)) == NULL)
-#ifdef NOTYET /* leaf-list is not detected by xpath optimize detection */
-        if ((yc = yang_find(yp, Y_LEAF_LIST, name)) == NULL) /* XXX */
-#endif
-            goto ok;
-    /* Validate keys */
-    if ((cvv = yang_cvec_get(yc)) == NULL)
+    if ((yc = yang_find_datanode(yp, name)) == NULL)
+        goto ok;
+    if (yang_keyword_get(yc) != Y_LIST && yang_keyword_get(yc) != Y_LEAF_LIST)
+        goto ok;
+    /* State data is only sorted if STATE_ORDERED_BY_SYSTEM */
+    state = (yang_config_ancestor(yc) == 0);
+#ifndef STATE_ORDERED_BY_SYSTEM
+    if (state)
         goto ok;
-    xtp = vec[1];
-    if ((cvk = cvec_new(0)) == NULL){
+#endif
+    sorted = (yang_find(yc, Y_ORDERED_BY, "user") == NULL);
+    if ((cvk = cvec_new(0)) == NULL ||
+        (cvp = cvec_new(0)) == NULL){
         clicon_err(OE_YANG, errno, "cvec_new");
         goto done;
     }
-    if ((ret = loop_preds(xtp, xem, cvk)) < 0)
+    if (loop_preds(vec[1], xem, xdm, cvk) < 0)
         goto done;
-    if (ret == 0)
+    if (cvec_len(cvk) == 0)
         goto ok;
-
-    if (cvec_len(cvv) != cvec_len(cvk))
+    plan = XO_SCAN;
+    if (yang_keyword_get(yc) == Y_LIST){
+        if (xpath_list_plan(yc, sorted, cvk, cvp, &plan) < 0)
+            goto done;
+    }
+    else if ((cvi = cvec_find(cvk, ".")) != NULL &&
+             (sorted || !state)){ /* Unsorted state leaf-list values may be non-unique */
+        if (cvec_append_var(cvp, cvi) == NULL){
+            clicon_err(OE_YANG, errno, "cvec_append_var");
+            goto done;
+        }
+        plan = XO_LEAFLIST;
+    }
+    switch (plan){
+    case XO_SCAN:
+        _optimize_stats.xo_scan++;
         goto ok;
-    i = 0;
-    cvi = NULL;
-    while ((cvi = cvec_each(cvk, cvi)) != NULL) {
-        if (strcmp(cv_name_get(cvi), cv_string_get(cvec_i(cvv,i))))
-            goto ok;
-        i++;
+    case XO_KEYS:
+        _optimize_stats.xo_keys++;
+        break;
+    case XO_PREFIX:
+        _optimize_stats.xo_prefix++;
+        break;
+    case XO_INDEX:
+        _optimize_stats.xo_index++;
+        break;
+    case XO_LEAFLIST:
+        _optimize_stats.xo_leaflist++;
+        break;
     }
-    /* Use 2a form since yc allready given to compute cvk */
-    if (clixon_xml_find_index(xv, yp, NULL, name, cvk, xvec) < 0)
+    if (state)
+        _optimize_stats.xo_state++;
+    ypp = yp;
+    do {
+        if (yang_keyword_get(ypp) == Y_LIST){
+            _optimize_stats.xo_nested++;
+            break;
+        }
+    } while((ypp = yang_parent_get(ypp)) != NULL);
+    /* Use 2a form since yc allready given to compute cvp */
+    if (clixon_xml_find_index(xv, yp, NULL, name, cvp, xvec) < 0)
         goto done;
     retval = 1; /* match */
  done:
@@ -311,6 +485,8 @@ xpath_list_optimize_fn(xpath_tree  *xt,
         free(vec);
     if (cvk)
         cvec_free(cvk);
+    if (cvp)
+        cvec_free(cvp);
     return retval;
  ok: /* no match, not special case */
     retval = 0;
@@ -320,6 +496,10 @@ xpath_list_optimize_fn(xpath_tree  *xt,
 
 /*! Identify XPath special cases and if match, use binary search.
  *
+ * @param[in]     xs     XPath step
+ * @param[in]     xv     XML context node
+ * @param[in,out] xvec0  Found nodes are appended
+ * @param[in,out] xlen0  Length of xvec0
  * @retval  1  Optimization made, special case, use x (found if != NULL)
  * @retval  0  Dont optimize: not special case, do normal processing
  * @retval -1  Error
@@ -334,6 +514,7 @@ xpath_optimize_check(xpath_tree *xs,
 #ifdef XPATH_LIST_OPTIMIZE
     int          ret;
     clixon_xvec *xvec = NULL;
+    int          i;
 
     if (!_optimize_enable)
         return 0; /* use regular code */
@@ -343,8 +524,12 @@ xpath_optimize_check(xpath_tree *xs,
     if ((ret = xpath_list_optimize_fn(xs, xv, xvec)) < 0)
         return -1;
     if (ret == 1){
-        if (clixon_xvec_extract(xvec, xvec0, xlen0, NULL) < 0)
-            return -1;
+        /* Append, xvec0 may contain results of previous context nodes, eg list entries */
+        for (i=0; i<clixon_xvec_len(xvec); i++)
+            if (cxvec_append(clixon_xvec_i(xvec, i), xvec0, xlen0) < 0){
+                clixon_xvec_free(xvec);
+                return -1;
+            }
         clixon_xvec_free(xvec);
         _optimize_hits++;
         return 1; /* Optimized */
@@ -357,4 +542,3 @@ xpath_optimize_check(xpath_tree *xs,
     return 0; /* use regular code */
 #endif
 }
-
@@ -172,9 +172,32 @@ static const map_str2int ykmap[] = {
     {NULL,               -1}
 };
 
+#ifdef YANG_CHILD_INDEX
+/* Build a child index for yang nodes with at least this many children or data nodes */
+#define YANG_INDEX_THRESHOLD 16
+
+/*! Hashed index of the children of a yang node
+ *
+ * Two hash tables keyed on argument, with open addressing and linear probing:
+ * - yi_stmt: all children with an argument, for yang_find()
+ * - yi_data: data nodes, also via choice/case/input/output, for yang_find_datanode()
+ * Entries are never removed, so entries with same argument are probed in insertion order,
+ * ie the first match is the same as in a linear search.
+ * The index is freed if the node (or a choice/case/input/output child) is changed
+ */
+struct yang_index{
+    uint32_t    yi_mask;  /* Table size minus one, size is a power of two */
+    yang_stmt **yi_stmt;  /* Children */
+    yang_stmt **yi_data;  /* Data node descendants */
+};
+#endif
+
 /* Forward static */
 static int yang_type_cache_free(yang_type_cache *ycache);
 static int yang_type_cache_cp(yang_stmt *ynew, yang_stmt *yold);
+#ifdef YANG_CHILD_INDEX
+static int yang_index_free(yang_stmt *ys);
+#endif
 
 /* Access functions
  */
@@ -251,6 +274,9 @@ yang_argument_set(yang_stmt *ys,
                   char      *arg)
 {
     ys->ys_argument = arg; /* not strdup/copied */
+#ifdef YANG_CHILD_INDEX
+    yang_index_invalidate(ys->ys_parent);
+#endif
     return 0;
 }
 
@@ -573,6 +599,10 @@ yang_stats_one(yang_stmt *y,
         sz += cvec_size(y->ys_when_nsc);
     if (y->ys_filename)
         sz += strlen(y->ys_filename) + 1;
+#ifdef YANG_CHILD_INDEX
+    if (y->ys_index)
+        sz += sizeof(struct yang_index) + 2*(y->ys_index->yi_mask+1)*sizeof(yang_stmt *);
+#endif
     if (szp)
         *szp = sz;
     return 0;
@@ -703,6 +733,9 @@ ys_free1(yang_stmt *ys,
         free(ys->ys_stmt);
     if (ys->ys_filename)
         free(ys->ys_filename);
+#ifdef YANG_CHILD_INDEX
+    yang_index_free(ys);
+#endif
     while((rc = ys->ys_action_cb) != NULL) {
         DELQ(rc, ys->ys_action_cb, rpc_callback_t *);
         if (rc->rc_namespace)
@@ -737,6 +770,9 @@ ys_prune(yang_stmt *yp,
 
     if (i >= yp->ys_len)
         goto done;
+#ifdef YANG_CHILD_INDEX
+    yang_index_invalidate(yp);
+#endif
     yc = yp->ys_stmt[i];
     if (i < yp->ys_len - 1){
         size = (yp->ys_len - i - 1)*sizeof(struct yang_stmt *);
@@ -796,6 +832,9 @@ ys_freechildren(yang_stmt *ys)
     yang_stmt *yc;
     int        i;
 
+#ifdef YANG_CHILD_INDEX
+    yang_index_invalidate(ys);
+#endif
     for (i=0; i<ys->ys_len; i++){
         if ((yc = ys->ys_stmt[i]) != NULL)
             ys_free(yc);
@@ -827,6 +866,9 @@ ys_free(yang_stmt *ys)
 static int
 yn_realloc(yang_stmt *yn)
 {
+#ifdef YANG_CHILD_INDEX
+    yang_index_invalidate(yn);
+#endif
     yn->ys_len++;
 
     if ((yn->ys_stmt = realloc(yn->ys_stmt, (yn->ys_len)*sizeof(yang_stmt *))) == 0){
@@ -863,6 +905,9 @@ ys_cp(yang_stmt *ynew,
 
     memcpy(ynew, yold, sizeof(*yold));
     ynew->ys_parent = NULL;
+#ifdef YANG_CHILD_INDEX
+    ynew->ys_index = NULL;
+#endif
     if (yold->ys_stmt)
         if ((ynew->ys_stmt = calloc(yold->ys_len, sizeof(yang_stmt *))) == NULL){
             clicon_err(OE_YANG, errno, "calloc");
@@ -965,6 +1010,9 @@ ys_replace(yang_stmt *yorig,
     yang_stmt *yc; /* child */
 
     yp = yang_parent_get(yorig);
+#ifdef YANG_CHILD_INDEX
+    yang_index_invalidate(yp);
+#endif
     /* Remove old yangs all children */
     yc = NULL;
     while ((yc = yn_each(yorig, yc)) != NULL)
@@ -1055,6 +1103,224 @@ yn_each(yang_stmt *yparent,
     return yc;
 }
 
+#ifdef YANG_CHILD_INDEX
+/*! FNV-1a hash of yang argument
+ */
+static uint32_t
+yang_index_hash(const char *str)
+{
+    uint32_t h = 2166136261U;
+
+    while (*str){
+        h ^= (uint8_t)*str++;
+        h *= 16777619U;
+    }
+    return h;
+}
+
+/*! Add yang statement to hash table
+ *
+ * @param[in]  tab     Hash table
+ * @param[in]  mask    Table size minus one
+ * @param[in]  ys      Yang statement with argument
+ * @param[in]  unique  If set, do not add if there is already an entry with same argument
+ */
+static int
+yang_index_add(yang_stmt **tab,
+               uint32_t    mask,
+               yang_stmt  *ys,
+               int         unique)
+{
+    uint32_t i;
+
+    i = yang_index_hash(ys->ys_argument) & mask;
+    while (tab[i] != NULL){
+        if (unique && strcmp(tab[i]->ys_argument, ys->ys_argument) == 0)
+            return 0;
+        i = (i + 1) & mask;
+    }
+    tab[i] = ys;
+    return 0;
+}
+
+/*! Lookup first yang statement in hash table
+ *
+ * @param[in]  tab      Hash table
+ * @param[in]  mask     Table size minus one
+ * @param[in]  keyword  If 0 match any keyword
+ * @param[in]  argument Argument
+ * @retval     ys       First matching yang statement
+ * @retval     NULL     Not found
+ */
+static yang_stmt *
+yang_index_lookup(yang_stmt **tab,
+                  uint32_t    mask,
+                  int         keyword,
+                  const char *argument)
+{
+    yang_stmt *ys;
+    uint32_t   i;
+
+    i = yang_index_hash(argument) & mask;
+    while ((ys = tab[i]) != NULL){
+        if ((keyword == 0 || ys->ys_keyword == keyword) &&
+            strcmp(argument, ys->ys_argument) == 0)
+            return ys;
+        i = (i + 1) & mask;
+    }
+    return NULL;
+}
+
+/*! Count or add data nodes of yang node in the same order as yang_find_datanode
+ *
+ * @param[in]  yn    Yang node
+ * @param[in]  yi    Index to add to, or NULL to only count
+ * @retval     n     Number of data nodes
+ */
+static int
+yang_index_data(yang_stmt         *yn,
+                struct yang_index *yi)
+{
+    yang_stmt *ys;
+    yang_stmt *yc;
+    int        n = 0;
+    int        i;
+    int        j;
+
+    for (i=0; i<yn->ys_len; i++){
+        if ((ys = yn->ys_stmt[i]) == NULL)
+            continue;
+        if (ys->ys_keyword == Y_CHOICE){
+            for (j=0; j<ys->ys_len; j++){
+                if ((yc = ys->ys_stmt[j]) == NULL)
+                    continue;
+                if (yc->ys_keyword == Y_CASE)
+                    n += yang_index_data(yc, yi);
+                else if (yang_datanode(yc) && yc->ys_argument){
+                    if (yi)
+                        yang_index_add(yi->yi_data, yi->yi_mask, yc, 1);
+                    n++;
+                }
+            }
+        }
+        else if (ys->ys_keyword == Y_INPUT || ys->ys_keyword == Y_OUTPUT)
+            n += yang_index_data(ys, yi);
+        else if (yang_datanode(ys) && ys->ys_argument){
+            if (yi)
+                yang_index_add(yi->yi_data, yi->yi_mask, ys, 1);
+            n++;
+        }
+    }
+    return n;
+}
+
+/*! Free hashed child index of yang node
+ */
+static int
+yang_index_free(yang_stmt *ys)
+{
+    struct yang_index *yi;
+
+    if ((yi = ys->ys_index) != NULL){
+        if (yi->yi_stmt)
+            free(yi->yi_stmt);
+        if (yi->yi_data)
+            free(yi->yi_data);
+        free(yi);
+        ys->ys_index = NULL;
+    }
+    return 0;
+}
+
+/*! Invalidate hashed child index of a changed yang node
+ *
+ * Also ancestors that flatten the node in their data node index, ie via choice/case/input/output
+ * Call this if the child vector is changed directly, not via eg yn_insert or ys_prune
+ * @param[in]  ys   Yang node whose children are changed
+ */
+int
+yang_index_invalidate(yang_stmt *ys)
+{
+    for (; ys != NULL; ys = ys->ys_parent){
+        yang_index_free(ys);
+        if (ys->ys_keyword != Y_CHOICE && ys->ys_keyword != Y_CASE &&
+            ys->ys_keyword != Y_INPUT && ys->ys_keyword != Y_OUTPUT)
+            break;
+    }
+    return 0;
+}
+
+/*! Build hashed child index of single yang node, if it has many children
+ */
+static int
+yang_index_build1(yang_stmt *yn)
+{
+    int                retval = -1;
+    struct yang_index *yi = NULL;
+    yang_stmt         *ys;
+    uint32_t           size;
+    int                nstmt = 0;
+    int                ndata;
+    int                i;
+
+    for (i=0; i<yn->ys_len; i++)
+        if ((ys = yn->ys_stmt[i]) != NULL && ys->ys_argument)
+            nstmt++;
+    ndata = yang_index_data(yn, NULL);
+    if (nstmt < YANG_INDEX_THRESHOLD && ndata < YANG_INDEX_THRESHOLD)
+        goto ok;
+    for (size = 2; size < 2*(nstmt>ndata?nstmt:ndata); size <<= 1);
+    if ((yi = calloc(1, sizeof(*yi))) == NULL){
+        clicon_err(OE_YANG, errno, "calloc");
+        goto done;
+    }
+    yi->yi_mask = size - 1;
+    if ((yi->yi_stmt = calloc(size, sizeof(yang_stmt *))) == NULL ||
+        (yi->yi_data = calloc(size, sizeof(yang_stmt *))) == NULL){
+        clicon_err(OE_YANG, errno, "calloc");
+        goto done;
+    }
+    for (i=0; i<yn->ys_len; i++)
+        if ((ys = yn->ys_stmt[i]) != NULL && ys->ys_argument)
+            yang_index_add(yi->yi_stmt, yi->yi_mask, ys, 0);
+    yang_index_data(yn, yi);
+    yn->ys_index = yi;
+    yi = NULL;
+ ok:
+    retval = 0;
+ done:
+    if (yi){
+        if (yi->yi_stmt)
+            free(yi->yi_stmt);
+        free(yi);
+    }
+    return retval;
+}
+
+/*! Build hashed child indexes recursively for yang nodes with many children
+ *
+ * Nodes that already have an index are kept, an index is freed when a node is changed.
+ * Lookups on nodes without index (eg changed after this call) use a linear search.
+ * @param[in]  yn   Yang node, typically yang spec
+ * @retval     0    OK
+ * @retval    -1    Error
+ * @see yang_find
+ * @see yang_find_datanode
+ */
+int
+yang_index_build(yang_stmt *yn)
+{
+    int i;
+
+    if (yn->ys_index == NULL && yang_index_build1(yn) < 0)
+        return -1;
+    for (i=0; i<yn->ys_len; i++)
+        if (yn->ys_stmt[i] != NULL && yang_index_build(yn->ys_stmt[i]) < 0)
+            return -1;
+    return 0;
+}
+#endif /* YANG_CHILD_INDEX */
+
 /*! Find first child yang_stmt with matching keyword and argument
  *
  * @param[in]  yn         Yang node, current context node.
@@ -1078,6 +1344,11 @@ yang_find(yang_stmt  *yn,
     yang_stmt *yspec;
     yang_stmt *ym;
 
+#ifdef YANG_CHILD_INDEX
+    if (yn->ys_index != NULL && argument != NULL)
+        yret = yang_index_lookup(yn->ys_index->yi_stmt, yn->ys_index->yi_mask, keyword, argument);
+    else
+#endif
     for (i=0; i<yn->ys_len; i++){
         ys = yn->ys_stmt[i];
         if (keyword == 0 || ys->ys_keyword == keyword){
@@ -1161,6 +1432,14 @@ yang_find_datanode(yang_stmt *yn,
     yang_stmt *ysmatch = NULL;
     char      *name;
 
+#ifdef YANG_CHILD_INDEX
+    if (yn->ys_index != NULL && argument != NULL){
+        if ((ysmatch = yang_index_lookup(yn->ys_index->yi_data, yn->ys_index->yi_mask,
+                                         0, argument)) != NULL)
+            goto done;
+        goto submodules;
+    }
+#endif
     ys = NULL;
     while ((ys = yn_each(yn, ys)) != NULL){
         if (yang_keyword_get(ys) == Y_CHOICE){ /* Look for its children */
@@ -1192,6 +1471,9 @@ yang_find_datanode(yang_stmt *yn,
                 goto done; // maybe break?
         }
     }
+#ifdef YANG_CHILD_INDEX
+ submodules:
+#endif
     /* Special case: if not match and yang node is module or submodule, extend
      * search to include submodules */
     if (ysmatch == NULL &&
@@ -3035,6 +3317,9 @@ yang_features(clicon_handle h,
                 case 0: /* disabled: remove ys */
                     /* Change datanodes YANG to ANYDATA, other nodes are removed
                      */
+#ifdef YANG_CHILD_INDEX
+                    yang_index_invalidate(yt);
+#endif
                     if (yang_datanode(ys) && yang_config_ancestor(ys)){
                         ys->ys_keyword = Y_ANYDATA;
                         ys_freechildren(ys);
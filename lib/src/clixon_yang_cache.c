@@ -0,0 +1,899 @@
+/*
+ *
+  ***** BEGIN LICENSE BLOCK *****
+
+  Copyright (C) 2009-2016 Olof Hagsand and Benny Holmgren
+  Copyright (C) 2017-2019 Olof Hagsand
+  Copyright (C) 2020-2022 Olof Hagsand and Rubicon Communications, LLC(Netgate)
+
+  This file is part of CLIXON.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  Alternatively, the contents of this file may be used under the terms of
+  the GNU General Public License Version 3 or later (the "GPL"),
+  in which case the provisions of the GPL are applicable instead
+  of those above. If you wish to allow use of your version of this file only
+  under the terms of the GPL, and not to allow others to
+  use your version of this file under the terms of Apache License version 2,
+  indicate your decision by deleting the provisions above and replace them with
+  the  notice and other provisions required by the GPL. If you do not delete
+  the provisions above, a recipient may use your version of this file under
+  the terms of any one of the Apache License version 2 or the GPL.
+
+  ***** END LICENSE BLOCK *****
+
+ * Serialized YANG schema cache, see CLICON_YANG_CACHE_DIR
+ *
+ * A fully parsed and post-processed top-level YANG spec (after grouping expansion,
+ * augments, deviations, type resolution, etc) is written to a binary file. A daemon
+ * starting with the same YANG sources and options mmaps the file and rebuilds the
+ * spec directly, skipping parsing and yang_parse_post().
+ * The file is shared by all Clixon daemons with an equal cache key.
+ *
+ * File layout (host byte order):
+ *   magic[8] key:u64 nnodes:u32 nfiles:u32 {path:str mtime:u64 size:u64}*nfiles
+ *   node* in preorder, where node 0 is the yang spec itself (only its child count)
+ * Node references (my module, resolved type, extension instances) are node ids.
+ * Compiled regexps are not stored, they are compiled lazily on first validate.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "clixon_config.h" /* generated by config & autoconf */
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <sys/param.h>
+
+/* cligen */
+#include <cligen/cligen.h>
+
+/* clixon */
+#include "clixon_log.h"
+#include "clixon_err.h"
+#include "clixon_queue.h"
+#include "clixon_hash.h"
+#include "clixon_handle.h"
+#include "clixon_yang.h"
+#include "clixon_xml.h"
+#include "clixon_yang_module.h"
+#include "clixon_plugin.h"
+#include "clixon_data.h"
+#include "clixon_options.h"
+#include "clixon_yang_internal.h"
+#include "clixon_yang_cache.h"
+
+/* Magic including file format version, bump on any layout change */
+#define YANG_CACHE_MAGIC "CLXYC001"
+
+/*! Pointer to node id map entry, sorted on pointer for bsearch */
+struct ycache_map{
+    yang_stmt *ym_ys;
+    uint32_t   ym_id;
+};
+
+/*! Cache writer state */
+struct ycache_wr{
+    FILE              *yw_f;
+    struct ycache_map *yw_map;    /* Sorted on pointer */
+    uint32_t           yw_len;
+    int                yw_fail;   /* Tree can not be serialized */
+};
+
+/*! Cache reader state, a cursor over the mmap'ed file */
+struct ycache_rd{
+    const uint8_t *yr_p;
+    const uint8_t *yr_end;
+    yang_stmt    **yr_vec;        /* Nodes indexed by id, id 0 is yang spec */
+    uint32_t       yr_len;
+    uint32_t       yr_next;       /* Next node id to read */
+    int            yr_bad;        /* Malformed or truncated file */
+};
+
+static int ycache_r_children(struct ycache_rd *yr, yang_stmt *yp, uint32_t len);
+
+/*! FNV-1a hash of a string, accumulated onto previous hash value
+ */
+static uint64_t
+yang_cache_hash(uint64_t    hash,
+                const char *str)
+{
+    if (str)
+        while (*str){
+            hash ^= (uint8_t)*str++;
+            hash *= 0x100000001b3ULL;
+        }
+    hash ^= 0xff; /* separator */
+    hash *= 0x100000001b3ULL;
+    return hash;
+}
+
+/*! Compute YANG cache key
+ *
+ * The key covers everything that decides which YANG files are found and how they are
+ * processed: Clixon version, all CLICON_YANG_* and CLICON_FEATURE options, the
+ * modification times of the YANG directories and the names of plugins with
+ * extension or yang-patch callbacks.
+ * The contents of the source files themselves are checked separately on load.
+ * @param[in]  h    Clixon handle
+ * @param[out] key  Hash key
+ * @retval     0    OK
+ * @retval    -1    Error
+ */
+static int
+yang_cache_key(clicon_handle h,
+               uint64_t     *key)
+{
+    int                retval = -1;
+    uint64_t           hash = 0xcbf29ce484222325ULL;
+    cbuf              *cb = NULL;
+    cxobj             *x = NULL;
+    char              *name;
+    char              *body;
+    struct stat        st;
+    clixon_plugin_t   *cp = NULL;
+    clixon_plugin_api *api;
+
+    if ((cb = cbuf_new()) == NULL){
+        clicon_err(OE_UNIX, errno, "cbuf_new");
+        goto done;
+    }
+    cprintf(cb, "%s %s %zu", CLIXON_VERSION_STRING, YANG_CACHE_MAGIC, sizeof(void*));
+    hash = yang_cache_hash(hash, cbuf_get(cb));
+    while ((x = xml_child_each(clicon_conf_xml(h), x, CX_ELMNT)) != NULL){
+        name = xml_name(x);
+        if (strncmp(name, "CLICON_YANG", strlen("CLICON_YANG")) != 0 &&
+            strcmp(name, "CLICON_FEATURE") != 0)
+            continue;
+        body = xml_body(x);
+        cbuf_reset(cb);
+        cprintf(cb, "%s=%s", name, body?body:"");
+        /* Adding or removing a file in a yang dir changes its mtime */
+        if (body &&
+            (strcmp(name, "CLICON_YANG_DIR") == 0 || strcmp(name, "CLICON_YANG_MAIN_DIR") == 0) &&
+            stat(body, &st) == 0)
+            cprintf(cb, " %lld", (long long)st.st_mtime);
+        hash = yang_cache_hash(hash, cbuf_get(cb));
+    }
+    while ((cp = clixon_plugin_each(h, cp)) != NULL){
+        api = clixon_plugin_api_get(cp);
+        if (api->ca_extension == NULL && api->ca_yang_patch == NULL)
+            continue;
+        hash = yang_cache_hash(hash, clixon_plugin_name_get(cp));
+    }
+    *key = hash;
+    retval = 0;
+ done:
+    if (cb)
+        cbuf_free(cb);
+    return retval;
+}
+
+/*! Compute YANG cache filename and key
+ *
+ * @param[in]  h        Clixon handle
+ * @param[out] filename Cache file name
+ * @param[in]  len      Length of filename buffer
+ * @param[out] key      Cache key
+ * @retval     1        OK, filename and key set
+ * @retval     0        Cache not enabled
+ * @retval    -1        Error
+ */
+static int
+yang_cache_filename(clicon_handle h,
+                    char         *filename,
+                    size_t        len,
+                    uint64_t     *key)
+{
+    char *dir;
+
+    if ((dir = clicon_option_str(h, "CLICON_YANG_CACHE_DIR")) == NULL)
+        return 0;
+    /* Mount-points refer to yang specs created at runtime */
+    if (clicon_option_bool(h, "CLICON_YANG_SCHEMA_MOUNT"))
+        return 0;
+    if (yang_cache_key(h, key) < 0)
+        return -1;
+    snprintf(filename, len, "%s/yang-%016" PRIx64 ".cache", dir, *key);
+    return 1;
+}
+
+static int
+ycache_map_cmp(const void *a,
+               const void *b)
+{
+    const struct ycache_map *ma = a;
+    const struct ycache_map *mb = b;
+
+    if (ma->ym_ys < mb->ym_ys)
+        return -1;
+    return ma->ym_ys > mb->ym_ys;
+}
+
+/*! Map node pointer to id+1, or 0 if NULL. Mark writer as failed if not found
+ */
+static uint32_t
+ycache_w_id(struct ycache_wr *yw,
+            yang_stmt        *ys)
+{
+    struct ycache_map  key;
+    struct ycache_map *m;
+
+    if (ys == NULL)
+        return 0;
+    key.ym_ys = ys;
+    if ((m = bsearch(&key, yw->yw_map, yw->yw_len, sizeof(key), ycache_map_cmp)) == NULL){
+        yw->yw_fail++; /* Refers to node outside of spec */
+        return 0;
+    }
+    return m->ym_id + 1;
+}
+
+static void
+ycache_w_u32(struct ycache_wr *yw,
+             uint32_t          u)
+{
+    fwrite(&u, sizeof(u), 1, yw->yw_f);
+}
+
+static void
+ycache_w_u64(struct ycache_wr *yw,
+             uint64_t          u)
+{
+    fwrite(&u, sizeof(u), 1, yw->yw_f);
+}
+
+/*! Write string as length+1 followed by bytes, 0 means NULL
+ */
+static void
+ycache_w_str(struct ycache_wr *yw,
+             const char       *str)
+{
+    uint32_t len;
+
+    if (str == NULL){
+        ycache_w_u32(yw, 0);
+        return;
+    }
+    len = strlen(str);
+    ycache_w_u32(yw, len + 1);
+    fwrite(str, 1, len, yw->yw_f);
+}
+
+/*! Write cligen variable: type, flags, name and value
+ */
+static int
+ycache_w_cv(struct ycache_wr *yw,
+            cg_var           *cv)
+{
+    int           retval = -1;
+    enum cv_type  type;
+    char         *str = NULL;
+
+    type = cv_type_get(cv);
+    ycache_w_u32(yw, type);
+    ycache_w_u32(yw, cv_flag(cv, 0xff));
+    ycache_w_str(yw, cv_name_get(cv));
+    if (type == CGV_VOID)
+        ycache_w_u32(yw, ycache_w_id(yw, cv_void_get(cv)));
+    else if (cv_isstring(type))
+        ycache_w_str(yw, cv_string_get(cv));
+    else if (type != CGV_EMPTY && type != CGV_ERR){
+        if (type == CGV_DEC64)
+            ycache_w_u32(yw, cv_dec64_n_get(cv));
+        if ((str = cv2str_dup(cv)) == NULL){
+            clicon_err(OE_UNIX, errno, "cv2str_dup");
+            goto done;
+        }
+        ycache_w_str(yw, str);
+    }
+    retval = 0;
+ done:
+    if (str)
+        free(str);
+    return retval;
+}
+
+/*! Write cligen variable vector as length+1 followed by variables, 0 means NULL
+ */
+static int
+ycache_w_cvec(struct ycache_wr *yw,
+              cvec             *cvv)
+{
+    cg_var *cv = NULL;
+
+    if (cvv == NULL){
+        ycache_w_u32(yw, 0);
+        return 0;
+    }
+    ycache_w_u32(yw, cvec_len(cvv) + 1);
+    while ((cv = cvec_each(cvv, cv)) != NULL)
+        if (ycache_w_cv(yw, cv) < 0)
+            return -1;
+    return 0;
+}
+
+/*! Write one yang node and its children recursively in preorder
+ */
+static int
+ycache_w_node(struct ycache_wr *yw,
+              yang_stmt        *ys)
+{
+    int              retval = -1;
+    yang_type_cache *yc;
+    int              i;
+
+    ycache_w_u32(yw, ys->ys_keyword);
+    ycache_w_u32(yw, ys->ys_flags);
+    ycache_w_u32(yw, (uint32_t)ys->ys_linenum);
+    ycache_w_u32(yw, (uint32_t)ys->ys_len);
+    ycache_w_u32(yw, ycache_w_id(yw, ys->ys_mymodule));
+    ycache_w_str(yw, ys->ys_argument);
+    ycache_w_str(yw, ys->ys_filename);
+    ycache_w_str(yw, ys->ys_when_xpath);
+    ycache_w_u32(yw, ys->ys_cv != NULL);
+    if (ys->ys_cv && ycache_w_cv(yw, ys->ys_cv) < 0)
+        goto done;
+    if (ycache_w_cvec(yw, ys->ys_cvec) < 0)
+        goto done;
+    if (ycache_w_cvec(yw, ys->ys_when_nsc) < 0)
+        goto done;
+    if ((yc = ys->ys_typecache) == NULL)
+        ycache_w_u32(yw, 0);
+    else {
+        ycache_w_u32(yw, 1);
+        ycache_w_u32(yw, yc->yc_options);
+        ycache_w_u32(yw, yc->yc_fraction);
+        ycache_w_u32(yw, ycache_w_id(yw, yc->yc_resolved));
+        if (ycache_w_cvec(yw, yc->yc_cvv) < 0)
+            goto done;
+        if (ycache_w_cvec(yw, yc->yc_patterns) < 0)
+            goto done;
+    }
+    for (i=0; i<ys->ys_len; i++)
+        if (ycache_w_node(yw, ys->ys_stmt[i]) < 0)
+            goto done;
+    retval = 0;
+ done:
+    return retval;
+}
+
+/*! Collect nodes in preorder into a pointer/id map
+ */
+static int
+ycache_collect(yang_stmt          *ys,
+               struct ycache_map **map,
+               uint32_t           *len,
+               uint32_t           *max)
+{
+    int i;
+
+    if (*len == *max){
+        *max = *max ? *max * 2 : 1024;
+        if ((*map = realloc(*map, *max * sizeof(**map))) == NULL){
+            clicon_err(OE_UNIX, errno, "realloc");
+            return -1;
+        }
+    }
+    (*map)[*len].ym_ys = ys;
+    (*map)[*len].ym_id = *len;
+    (*len)++;
+    for (i=0; i<ys->ys_len; i++)
+        if (ycache_collect(ys->ys_stmt[i], map, len, max) < 0)
+            return -1;
+    return 0;
+}
+
+/*! Write a fully loaded top-level yang spec to the cache
+ *
+ * Written to a temporary file which is renamed, so that concurrent daemons never
+ * see a partial file.
+ * Failure to write is not fatal, the cache is then just not updated.
+ * @param[in]  h      Clixon handle
+ * @param[in]  yspec  Top-level yang spec
+ * @retval     0      OK, or cache not enabled or not written
+ * @retval    -1      Error
+ */
+int
+yang_cache_save(clicon_handle h,
+                yang_stmt    *yspec)
+{
+    int               retval = -1;
+    char              filename[MAXPATHLEN];
+    char              tmpfile[MAXPATHLEN];
+    struct ycache_wr  yw = {0,};
+    uint32_t          max = 0;
+    uint32_t          nfiles = 0;
+    uint32_t          i;
+    yang_stmt        *ys;
+    struct stat       st;
+    uint64_t          key;
+    int               ret;
+
+    if ((ret = yang_cache_filename(h, filename, sizeof(filename), &key)) < 0)
+        goto done;
+    if (ret == 0 || yang_len_get(yspec) == 0)
+        goto ok;
+    if (ycache_collect(yspec, &yw.yw_map, &yw.yw_len, &max) < 0)
+        goto done;
+    for (i=0; i<yw.yw_len; i++)
+        if (yw.yw_map[i].ym_ys->ys_filename)
+            nfiles++;
+    snprintf(tmpfile, sizeof(tmpfile), "%s.%d", filename, getpid());
+    if ((yw.yw_f = fopen(tmpfile, "w")) == NULL){
+        clixon_debug(CLIXON_DBG_DEFAULT, "%s fopen(%s): %s", __FUNCTION__, tmpfile, strerror(errno));
+        goto ok;
+    }
+    fwrite(YANG_CACHE_MAGIC, 1, strlen(YANG_CACHE_MAGIC), yw.yw_f);
+    ycache_w_u64(&yw, key);
+    ycache_w_u32(&yw, yw.yw_len);
+    ycache_w_u32(&yw, nfiles);
+    /* Source files, in preorder so the map can be sorted afterwards */
+    for (i=0; i<yw.yw_len; i++){
+        ys = yw.yw_map[i].ym_ys;
+        if (ys->ys_filename == NULL)
+            continue;
+        if (stat(ys->ys_filename, &st) < 0){
+            memset(&st, 0, sizeof(st));
+            yw.yw_fail++;
+        }
+        ycache_w_str(&yw, ys->ys_filename);
+        ycache_w_u64(&yw, (uint64_t)st.st_mtime);
+        ycache_w_u64(&yw, (uint64_t)st.st_size);
+    }
+    qsort(yw.yw_map, yw.yw_len, sizeof(*yw.yw_map), ycache_map_cmp);
+    /* The yang spec itself: only children */
+    ycache_w_u32(&yw, (uint32_t)yspec->ys_len);
+    for (i=0; i<(uint32_t)yspec->ys_len; i++)
+        if (ycache_w_node(&yw, yspec->ys_stmt[i]) < 0)
+            goto done;
+    if (yw.yw_fail || ferror(yw.yw_f)){
+        clixon_debug(CLIXON_DBG_DEFAULT, "%s %s: not written", __FUNCTION__, filename);
+        fclose(yw.yw_f);
+        yw.yw_f = NULL;
+        unlink(tmpfile);
+        goto ok;
+    }
+    ret = fclose(yw.yw_f);
+    yw.yw_f = NULL;
+    if (ret != 0 || rename(tmpfile, filename) < 0){
+        clixon_debug(CLIXON_DBG_DEFAULT, "%s %s: %s", __FUNCTION__, filename, strerror(errno));
+        unlink(tmpfile);
+    }
+    clixon_debug(CLIXON_DBG_DEFAULT, "%s %s: %u nodes", __FUNCTION__, filename, yw.yw_len);
+ ok:
+    retval = 0;
+ done:
+    if (yw.yw_f){
+        fclose(yw.yw_f);
+        unlink(tmpfile);
+    }
+    if (yw.yw_map)
+        free(yw.yw_map);
+    return retval;
+}
+
+static uint32_t
+ycache_r_u32(struct ycache_rd *yr)
+{
+    uint32_t u;
+
+    if (yr->yr_end - yr->yr_p < (ptrdiff_t)sizeof(u)){
+        yr->yr_bad++;
+        return 0;
+    }
+    memcpy(&u, yr->yr_p, sizeof(u));
+    yr->yr_p += sizeof(u);
+    return u;
+}
+
+static uint64_t
+ycache_r_u64(struct ycache_rd *yr)
+{
+    uint64_t u;
+
+    if (yr->yr_end - yr->yr_p < (ptrdiff_t)sizeof(u)){
+        yr->yr_bad++;
+        return 0;
+    }
+    memcpy(&u, yr->yr_p, sizeof(u));
+    yr->yr_p += sizeof(u);
+    return u;
+}
+
+/*! Read string
+ *
+ * @param[in]  yr    Reader
+ * @param[out] str   Malloced string or NULL
+ * @retval     0     OK
+ * @retval    -1     Error
+ */
+static int
+ycache_r_str(struct ycache_rd *yr,
+             char            **str)
+{
+    uint32_t len;
+
+    *str = NULL;
+    if ((len = ycache_r_u32(yr)) == 0)
+        return 0;
+    len--;
+    if (yr->yr_end - yr->yr_p < (ptrdiff_t)len){
+        yr->yr_bad++;
+        return 0;
+    }
+    if ((*str = malloc(len + 1)) == NULL){
+        clicon_err(OE_UNIX, errno, "malloc");
+        return -1;
+    }
+    memcpy(*str, yr->yr_p, len);
+    (*str)[len] = '\0';
+    yr->yr_p += len;
+    return 0;
+}
+
+/*! Map id+1 to node, 0 is NULL
+ */
+static yang_stmt *
+ycache_r_node(struct ycache_rd *yr)
+{
+    uint32_t id;
+
+    if ((id = ycache_r_u32(yr)) == 0)
+        return NULL;
+    if (id > yr->yr_len){
+        yr->yr_bad++;
+        return NULL;
+    }
+    return yr->yr_vec[id-1];
+}
+
+/*! Read cligen variable
+ *
+ * @param[in]  yr    Reader
+ * @param[in]  cv    Variable of the stored type, see ycache_r_cvtype
+ * @retval     0     OK, yr_bad may be set
+ * @retval    -1     Error
+ */
+static int
+ycache_r_cvvalue(struct ycache_rd *yr,
+                 cg_var           *cv)
+{
+    int          retval = -1;
+    enum cv_type type;
+    char        *name = NULL;
+    char        *str = NULL;
+    char        *reason = NULL;
+
+    type = cv_type_get(cv);
+    cv_flag_set(cv, ycache_r_u32(yr));
+    if (ycache_r_str(yr, &name) < 0)
+        goto done;
+    if (name && cv_name_set(cv, name) == NULL){
+        clicon_err(OE_UNIX, errno, "cv_name_set");
+        goto done;
+    }
+    if (type == CGV_VOID)
+        cv_void_set(cv, ycache_r_node(yr));
+    else if (cv_isstring(type)){
+        if (ycache_r_str(yr, &str) < 0)
+            goto done;
+        if (str && cv_string_set(cv, str) == NULL){
+            clicon_err(OE_UNIX, errno, "cv_string_set");
+            goto done;
+        }
+    }
+    else if (type != CGV_EMPTY && type != CGV_ERR){
+        if (type == CGV_DEC64)
+            cv_dec64_n_set(cv, ycache_r_u32(yr));
+        if (ycache_r_str(yr, &str) < 0)
+            goto done;
+        if (str == NULL)
+            yr->yr_bad++;
+        else if (cv_parse1(str, cv, &reason) < 0)
+            goto done;
+        if (reason)
+            yr->yr_bad++;
+    }
+    retval = 0;
+ done:
+    if (name)
+        free(name);
+    if (str)
+        free(str);
+    if (reason)
+        free(reason);
+    return retval;
+}
+
+/*! Read cligen variable vector
+ *
+ * @param[in]  yr    Reader
+ * @param[out] cvvp  Vector or NULL
+ * @retval     0     OK, yr_bad may be set
+ * @retval    -1     Error
+ */
+static int
+ycache_r_cvec(struct ycache_rd *yr,
+              cvec            **cvvp)
+{
+    uint32_t n;
+    uint32_t i;
+    cg_var  *cv;
+
+    if ((n = ycache_r_u32(yr)) == 0)
+        return 0;
+    if ((*cvvp = cvec_new(0)) == NULL){
+        clicon_err(OE_UNIX, errno, "cvec_new");
+        return -1;
+    }
+    for (i=0; i<n-1 && !yr->yr_bad; i++){
+        if ((cv = cvec_add(*cvvp, ycache_r_u32(yr))) == NULL){
+            clicon_err(OE_UNIX, errno, "cvec_add");
+            return -1;
+        }
+        if (ycache_r_cvvalue(yr, cv) < 0)
+            return -1;
+    }
+    return 0;
+}
+
+/*! Read one yang node and its children recursively in preorder
+ *
+ * @param[in]  yr    Reader
+ * @param[in]  ys    Pre-allocated node to fill in
+ * @retval     0     OK, yr_bad may be set
+ * @retval    -1     Error
+ */
+static int
+ycache_r_ys(struct ycache_rd *yr,
+            yang_stmt        *ys)
+{
+    int              retval = -1;
+    yang_type_cache *yc;
+    uint32_t         len;
+
+    ys->ys_keyword = ycache_r_u32(yr);
+    ys->ys_flags = ycache_r_u32(yr);
+    ys->ys_linenum = (int)ycache_r_u32(yr);
+    len = ycache_r_u32(yr);
+    ys->ys_mymodule = ycache_r_node(yr);
+    if (ycache_r_str(yr, &ys->ys_argument) < 0 ||
+        ycache_r_str(yr, &ys->ys_filename) < 0 ||
+        ycache_r_str(yr, &ys->ys_when_xpath) < 0)
+        goto done;
+    if (ycache_r_u32(yr)){
+        if ((ys->ys_cv = cv_new(ycache_r_u32(yr))) == NULL){
+            clicon_err(OE_UNIX, errno, "cv_new");
+            goto done;
+        }
+        if (ycache_r_cvvalue(yr, ys->ys_cv) < 0)
+            goto done;
+    }
+    if (ycache_r_cvec(yr, &ys->ys_cvec) < 0)
+        goto done;
+    if (ycache_r_cvec(yr, &ys->ys_when_nsc) < 0)
+        goto done;
+    if (ycache_r_u32(yr)){
+        if ((yc = malloc(sizeof(*yc))) == NULL){
+            clicon_err(OE_UNIX, errno, "malloc");
+            goto done;
+        }
+        memset(yc, 0, sizeof(*yc));
+        ys->ys_typecache = yc;
+        yc->yc_options = ycache_r_u32(yr);
+        yc->yc_fraction = ycache_r_u32(yr);
+        yc->yc_resolved = ycache_r_node(yr);
+        if (ycache_r_cvec(yr, &yc->yc_cvv) < 0 ||
+            ycache_r_cvec(yr, &yc->yc_patterns) < 0)
+            goto done;
+    }
+    if (yr->yr_bad)
+        goto ok;
+    if (ycache_r_children(yr, ys, len) < 0)
+        goto done;
+ ok:
+    retval = 0;
+ done:
+    return retval;
+}
+
+/*! Read children of a node
+ *
+ * Children are the next nodes in id order since the file is in preorder
+ */
+static int
+ycache_r_children(struct ycache_rd *yr,
+                  yang_stmt        *yp,
+                  uint32_t          len)
+{
+    uint32_t   i;
+    yang_stmt *yc;
+
+    if (len > yr->yr_len - yr->yr_next){
+        yr->yr_bad++;
+        return 0;
+    }
+    if (len == 0)
+        return 0;
+    if ((yp->ys_stmt = calloc(len, sizeof(yang_stmt *))) == NULL){
+        clicon_err(OE_UNIX, errno, "calloc");
+        return -1;
+    }
+    for (i=0; i<len && !yr->yr_bad; i++){
+        yc = yr->yr_vec[yr->yr_next++];
+        yc->ys_parent = yp;
+        yp->ys_stmt[yp->ys_len++] = yc;
+        if (ycache_r_ys(yr, yc) < 0)
+            return -1;
+    }
+    return 0;
+}
+
+/*! Check that the source files of the cache are unchanged
+ *
+ * @retval  1  All files unchanged
+ * @retval  0  Some file changed or removed
+ * @retval -1  Error
+ */
+static int
+ycache_r_files(struct ycache_rd *yr)
+{
+    uint32_t    n;
+    uint32_t    i;
+    char       *path = NULL;
+    uint64_t    mtime;
+    uint64_t    size;
+    struct stat st;
+    int         changed = 0;
+
+    n = ycache_r_u32(yr);
+    for (i=0; i<n && !yr->yr_bad && !changed; i++){
+        if (ycache_r_str(yr, &path) < 0)
+            return -1;
+        mtime = ycache_r_u64(yr);
+        size = ycache_r_u64(yr);
+        if (path == NULL ||
+            stat(path, &st) < 0 ||
+            (uint64_t)st.st_mtime != mtime ||
+            (uint64_t)st.st_size != size){
+            clixon_debug(CLIXON_DBG_DEFAULT, "yang cache: %s changed", path?path:"");
+            changed++;
+        }
+        if (path){
+            free(path);
+            path = NULL;
+        }
+    }
+    return !changed && !yr->yr_bad;
+}
+
+/*! Load a top-level yang spec from the cache
+ *
+ * @param[in]  h      Clixon handle
+ * @param[in]  yspec  Empty top-level yang spec
+ * @retval     1      OK, yspec is loaded
+ * @retval     0      Not in cache, or cache not enabled; yspec is unchanged
+ * @retval    -1      Error
+ * @note Plugin extension callbacks are not called for cached nodes, the cache key only
+ *       covers the names of such plugins. Clear the cache when a plugin changes.
+ */
+int
+yang_cache_load(clicon_handle h,
+                yang_stmt    *yspec)
+{
+    int               retval = -1;
+    char              filename[MAXPATHLEN];
+    int               fd = -1;
+    struct stat       st;
+    void             *map = MAP_FAILED;
+    struct ycache_rd  yr = {0,};
+    uint64_t          key;
+    uint32_t          i;
+    uint32_t          len;
+    int               ret;
+
+    if (yang_len_get(yspec) != 0)
+        goto miss;
+    if ((ret = yang_cache_filename(h, filename, sizeof(filename), &key)) < 0)
+        goto done;
+    if (ret == 0)
+        goto miss;
+    if ((fd = open(filename, O_RDONLY)) < 0){
+        if (errno == ENOENT)
+            goto miss;
+        clicon_err(OE_UNIX, errno, "open(%s)", filename);
+        goto done;
+    }
+    if (fstat(fd, &st) < 0){
+        clicon_err(OE_UNIX, errno, "fstat(%s)", filename);
+        goto done;
+    }
+    if (st.st_size < (off_t)strlen(YANG_CACHE_MAGIC))
+        goto miss;
+    if ((map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0)) == MAP_FAILED){
+        clicon_err(OE_UNIX, errno, "mmap(%s)", filename);
+        goto done;
+    }
+    if (memcmp(map, YANG_CACHE_MAGIC, strlen(YANG_CACHE_MAGIC)) != 0)
+        goto miss;
+    yr.yr_p = (uint8_t*)map + strlen(YANG_CACHE_MAGIC);
+    yr.yr_end = (uint8_t*)map + st.st_size;
+    if (ycache_r_u64(&yr) != key)
+        goto miss;
+    yr.yr_len = ycache_r_u32(&yr);
+    if ((ret = ycache_r_files(&yr)) < 0)
+        goto done;
+    if (ret == 0 || yr.yr_len == 0)
+        goto miss;
+    /* Sanity: each node needs at least a few bytes */
+    if (yr.yr_len > (yr.yr_end - yr.yr_p) / sizeof(uint32_t))
+        goto miss;
+    if ((yr.yr_vec = calloc(yr.yr_len, sizeof(yang_stmt *))) == NULL){
+        clicon_err(OE_UNIX, errno, "calloc");
+        goto done;
+    }
+    yr.yr_vec[0] = yspec;
+    for (i=1; i<yr.yr_len; i++)
+        if ((yr.yr_vec[i] = ys_new(Y_SPEC)) == NULL)
+            goto done;
+    yr.yr_next = 1;
+    len = ycache_r_u32(&yr);
+    if (ycache_r_children(&yr, yspec, len) < 0)
+        goto done;
+    if (yr.yr_bad || yr.yr_next != yr.yr_len || yr.yr_p != yr.yr_end){
+        clixon_debug(CLIXON_DBG_DEFAULT, "%s %s: malformed", __FUNCTION__, filename);
+        goto miss;
+    }
+#ifdef YANG_CHILD_INDEX
+    if (yang_index_build(yspec) < 0)
+        goto done;
+#endif
+    clixon_debug(CLIXON_DBG_DEFAULT, "%s %s: %u nodes", __FUNCTION__, filename, yr.yr_len);
+    retval = 1;
+ done:
+    if (retval != 1 && yr.yr_vec){
+        /* Nodes are freed one by one, not recursively, since all are in the vector.
+         * Keyword is reset since a partially read node may be inconsistent */
+        for (i=1; i<yr.yr_len; i++)
+            if (yr.yr_vec[i]){
+                yr.yr_vec[i]->ys_keyword = Y_SPEC;
+                ys_free1(yr.yr_vec[i], 1);
+            }
+        if (yspec->ys_stmt)
+            free(yspec->ys_stmt);
+        yspec->ys_stmt = NULL;
+        yspec->ys_len = 0;
+    }
+    if (yr.yr_vec)
+        free(yr.yr_vec);
+    if (map != MAP_FAILED)
+        munmap(map, st.st_size);
+    if (fd != -1)
+        close(fd);
+    return retval;
+ miss:
+    retval = 0;
+    goto done;
+}
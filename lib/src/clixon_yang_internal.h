@@ -107,6 +107,9 @@ struct yang_stmt{
     char              *ys_filename;   /* For debug/errors: filename (only (sub)modules) */
     int                ys_linenum;    /* For debug/errors: line number (in ys_filename) */
     rpc_callback_t    *ys_action_cb;  /* Action callback list, only for Y_ACTION */
+#ifdef YANG_CHILD_INDEX
+    struct yang_index *ys_index;      /* Hashed child index, see yang_index_build() */
+#endif
     /* Internal use */
     int               _ys_vector_i;   /* internal use: yn_each */
 };
@@ -909,6 +909,7 @@ yang_lib2yspec(clicon_handle h,
 #endif
     retval = 1;
  done:
+    yang_file_index_free(h);
     if (vec)
         free(vec);
     return retval;
@@ -67,6 +67,7 @@
 #include <fcntl.h>
 #include <syslog.h>
 #include <sys/stat.h>
+#include <sys/time.h>
 #include <sys/param.h>
 #include <netinet/in.h>
 #include <libgen.h>
@@ -95,10 +96,12 @@
 #include "clixon_yang_type.h"
 #include "clixon_yang_parse.h"
 #include "clixon_yang_cardinality.h"
+#include "clixon_validate_deps.h"
 #include "clixon_plugin.h"
 #include "clixon_yang_internal.h"
 #include "clixon_yang_sub_parse.h"
 #include "clixon_yang_parse_lib.h"
+#include "clixon_yang_cache.h"
 
 /* Size of json read buffer when reading from file*/
 #define BUFLEN 1024
@@ -695,6 +698,10 @@ yang_expand_uses_node(yang_stmt *yn,
         yang_flag_set(yg, YANG_FLAG_GROUPING);
         k++;
     }
+#ifdef YANG_CHILD_INDEX
+    /* Children are spliced into yn directly */
+    yang_index_invalidate(yn);
+#endif
     /* Remove the grouping copy */
     ygrouping2->ys_len = 0; /* Cant do with get access function */
     ys_free(ygrouping2);
@@ -852,36 +859,35 @@ yang_parse_file(FILE       *fp,
                 yang_stmt  *yspec)
 {
     char         *buf = NULL;
-    int           i;
-    char          c;
-    int           len;
+    size_t        i;
+    size_t        len;
+    size_t        ret;
     yang_stmt    *ymod = NULL;
-    int           ret;
 
     len = BUFLEN; /* any number is fine */
     if ((buf = malloc(len)) == NULL){
         clicon_err(OE_XML, errno, "malloc");
         goto done;
     }
-    memset(buf, 0, len);
     i = 0; /* position in buf */
-    while (1){ /* read the whole file */
-        if ((ret = fread(&c, 1, 1, fp)) < 0){
-            clicon_err(OE_XML, errno, "read");
-            break;
-        }
-        if (ret == 0)
-            break; /* eof */
+    while (1){ /* read the whole file, block-wise */
         if (i == len-1){
             if ((buf = realloc(buf, 2*len)) == NULL){
                 clicon_err(OE_XML, errno, "realloc");
                 goto done;
             }
-            memset(buf+len, 0, len);
             len *= 2;
         }
-        buf[i++] = (char)(c&0xff);
-    } /* read a line */
+        if ((ret = fread(buf+i, 1, len-1-i, fp)) == 0){
+            if (ferror(fp)){
+                clicon_err(OE_XML, errno, "read");
+                goto done;
+            }
+            break; /* eof */
+        }
+        i += ret;
+    }
+    buf[i] = '\0';
     if ((ymod = yang_parse_str(buf, name, yspec)) < 0)
         goto done;
   done:
@@ -931,6 +937,194 @@ filename2revision(const char *filename,
     return retval;
 }
 
+/*! Add all YANG files in a directory to a file index
+ *
+ * @param[in]  dir       Directory
+ * @param[in]  recursive If set, also index sub-directories
+ * @param[in]  hash      File index: <module> -> cvec of (filename, path)
+ * @retval     0         OK
+ * @retval    -1         Error
+ */
+static int
+yang_file_index_dir(const char    *dir,
+                    int            recursive,
+                    clicon_hash_t *hash)
+{
+    int            retval = -1;
+    DIR           *dirp = NULL;
+    struct dirent *dent;
+    char           path[MAXPATHLEN];
+    struct stat    st;
+    char          *base = NULL;
+    char          *p;
+    cvec         **cvvp;
+    cvec          *cvv;
+    size_t         len;
+
+    if ((dirp = opendir(dir)) == NULL)
+        goto ok; /* Dir does not exist -> no entries */
+    while ((dent = readdir(dirp)) != NULL) {
+        snprintf(path, MAXPATHLEN-1, "%s/%s", dir, dent->d_name);
+        if (dent->d_type == DT_DIR) {
+            if (!recursive ||
+                strcmp(dent->d_name, ".") == 0 || strcmp(dent->d_name, "..") == 0)
+                continue;
+            if (yang_file_index_dir(path, recursive, hash) < 0)
+                goto done;
+            continue;
+        }
+        if (recursive && dent->d_type != DT_REG)
+            continue;
+        len = strlen(dent->d_name);
+        if (len <= 5 || strcmp(dent->d_name+len-5, ".yang") != 0)
+            continue;
+        if (lstat(path, &st) != 0){
+            clicon_err(OE_UNIX, errno, "lstat");
+            goto done;
+        }
+        if ((st.st_mode & S_IFREG) == 0)
+            continue;
+        /* Index on module name, ie strip [+ @rev ] + .yang */
+        if ((base = strdup(dent->d_name)) == NULL){
+            clicon_err(OE_UNIX, errno, "strdup");
+            goto done;
+        }
+        if ((p = index(base, '@')) != NULL)
+            *p = '\0';
+        else
+            base[len-5] = '\0';
+        if ((cvvp = clicon_hash_value(hash, base, NULL)) != NULL)
+            cvv = *cvvp;
+        else {
+            if ((cvv = cvec_new(0)) == NULL){
+                clicon_err(OE_UNIX, errno, "cvec_new");
+                goto done;
+            }
+            if (clicon_hash_add(hash, base, &cvv, sizeof(cvv)) == NULL){
+                cvec_free(cvv);
+                goto done;
+            }
+        }
+        if (cvec_add_string(cvv, dent->d_name, path) < 0){
+            clicon_err(OE_UNIX, errno, "cvec_add_string");
+            goto done;
+        }
+        free(base);
+        base = NULL;
+    }
+ ok:
+    retval = 0;
+ done:
+    if (base)
+        free(base);
+    if (dirp)
+        closedir(dirp);
+    return retval;
+}
+
+/*! Get YANG files of a module in a directory using a per-directory file index
+ *
+ * The index is built on first access by scanning the directory once, instead of
+ * scanning the directory (recursively) for every module looked up.
+ * @param[in]  h         Clixon handle
+ * @param[in]  dir       Directory
+ * @param[in]  recursive If set, include sub-directories
+ * @param[in]  module    Module name
+ * @param[out] cvvp      Vector of (filename, path), or NULL if no files. Do not free.
+ * @retval     0         OK
+ * @retval    -1         Error
+ * @see yang_file_index_free
+ */
+static int
+yang_file_index_get(clicon_handle h,
+                    const char   *dir,
+                    int           recursive,
+                    const char   *module,
+                    cvec        **cvvp)
+{
+    int             retval = -1;
+    clicon_hash_t  *dirs = NULL;
+    clicon_hash_t **hashp;
+    clicon_hash_t  *hash;
+    cvec          **cvp;
+    cbuf           *cb = NULL;
+
+    if (clicon_ptr_get(h, "yang-file-index", (void**)&dirs) < 0 || dirs == NULL){
+        if ((dirs = clicon_hash_init()) == NULL)
+            goto done;
+        if (clicon_ptr_set(h, "yang-file-index", dirs) < 0)
+            goto done;
+    }
+    if ((cb = cbuf_new()) == NULL){
+        clicon_err(OE_UNIX, errno, "cbuf_new");
+        goto done;
+    }
+    cprintf(cb, "%c%s", recursive?'r':'m', dir);
+    if ((hashp = clicon_hash_value(dirs, cbuf_get(cb), NULL)) != NULL)
+        hash = *hashp;
+    else {
+        if ((hash = clicon_hash_init()) == NULL)
+            goto done;
+        if (clicon_hash_add(dirs, cbuf_get(cb), &hash, sizeof(hash)) == NULL){
+            clicon_hash_free(hash);
+            goto done;
+        }
+        if (yang_file_index_dir(dir, recursive, hash) < 0)
+            goto done;
+    }
+    *cvvp = (cvp = clicon_hash_value(hash, module, NULL)) != NULL ? *cvp : NULL;
+    retval = 0;
+ done:
+    if (cb)
+        cbuf_free(cb);
+    return retval;
+}
+
+/*! Free YANG file index
+ *
+ * Called after YANG loading so that files added later are seen by subsequent loads
+ * @param[in]  h   Clixon handle
+ * @retval     0   OK
+ * @see yang_file_index_get
+ */
+int
+yang_file_index_free(clicon_handle h)
+{
+    clicon_hash_t  *dirs = NULL;
+    clicon_hash_t **hashp;
+    cvec          **cvp;
+    char          **dkeys = NULL;
+    char          **mkeys = NULL;
+    size_t          dlen = 0;
+    size_t          mlen = 0;
+    int             i;
+    int             j;
+
+    if (h == NULL ||
+        clicon_ptr_get(h, "yang-file-index", (void**)&dirs) < 0 || dirs == NULL)
+        return 0;
+    if (clicon_hash_keys(dirs, &dkeys, &dlen) < 0)
+        dlen = 0;
+    for (i=0; i<dlen; i++){
+        if ((hashp = clicon_hash_value(dirs, dkeys[i], NULL)) == NULL)
+            continue;
+        mkeys = NULL;
+        if (clicon_hash_keys(*hashp, &mkeys, &mlen) < 0)
+            mlen = 0;
+        for (j=0; j<mlen; j++)
+            if ((cvp = clicon_hash_value(*hashp, mkeys[j], NULL)) != NULL)
+                cvec_free(*cvp);
+        if (mkeys)
+            free(mkeys);
+        clicon_hash_free(*hashp);
+    }
+    if (dkeys)
+        free(dkeys);
+    clicon_hash_free(dirs);
+    clicon_ptr_del(h, "yang-file-index");
+    return 0;
+}
+
 /*! No specific revision give. Match a yang file given module 
  *
  * @param[in]  h        CLICON handle
@@ -941,6 +1135,7 @@ filename2revision(const char *filename,
  * @retval     0        No matching entry found
  * @retval    -1        Error 
  * @note for bootstrapping, dir may have to be set.
+ * @note Directories are read via a file index, see yang_file_index_get
 */
 int
 yang_file_find_match(clicon_handle h,
@@ -956,6 +1151,11 @@ yang_file_find_match(clicon_handle h,
     cvec         *cvv = NULL;
     cg_var       *cv = NULL;
     cg_var       *bestcv = NULL;
+    regex_t       re;
+    int           recomp = 0;
+    int           res;
+    char          errbuf[128];
+    int           recursive;
 
     /* get clicon config file in xml form */
     if ((x = clicon_conf_xml(h)) == NULL)
@@ -973,70 +1173,52 @@ yang_file_find_match(clicon_handle h,
     else
         cprintf(regex, "^%s(@[0-9][0-9][0-9][0-9]-[0-9][0-9]-[0-9][0-9])?(.yang)$",
                 module);
+    if ((res = regcomp(&re, cbuf_get(regex), REG_EXTENDED)) != 0) {
+        regerror(res, &re, errbuf, sizeof(errbuf));
+        clicon_err(OE_DB, 0, "regcomp: %s", errbuf);
+        goto done;
+    }
+    recomp++;
     xc = NULL;
-
     while ((xc = xml_child_each(x, xc, CX_ELMNT)) != NULL) {
-        if (strcmp(xml_name(xc), "CLICON_YANG_MAIN_DIR") == 0){
-            struct dirent *dp = NULL;
-            int ndp;
-
-            dir = xml_body(xc);
-            /* get all matching files in this directory */
-            if ((ndp = clicon_file_dirent(dir,
-                                          &dp,
-                                          cbuf_get(regex),
-                                          S_IFREG)) < 0)
-                goto done;
-            /* Entries are sorted, last entry should be most recent date 
-             */
-            if (ndp != 0){
-                if (fbuf)
-                    cprintf(fbuf, "%s/%s", dir, dp[ndp-1].d_name);
-                if (dp)
-                    free(dp);
-                retval = 1;
-                goto done;
-            }
-            if (dp)
-                free(dp);
+        if (strcmp(xml_name(xc), "CLICON_YANG_MAIN_DIR") == 0)
+            recursive = 0;
+        else if (strcmp(xml_name(xc), "CLICON_YANG_DIR") == 0)
+            recursive = 1;
+        else
+            continue;
+        if ((dir = xml_body(xc)) == NULL)
+            continue;
+        /* get all files of module in this directory (recursively) */
+        if (yang_file_index_get(h, dir, recursive, module, &cvv) < 0)
+            goto done;
+        /* Entries come in a vector: <name,path>.
+         * Find latest name (most recent date) and use path as return value
+         */
+        if (cvv == NULL)
+            continue;
+        bestcv = NULL;
+        cv = NULL;
+        while ((cv = cvec_each(cvv, cv)) != NULL){
+            if (regexec(&re, cv_name_get(cv), (size_t)0, NULL, 0) != 0)
+                continue;
+            if (bestcv == NULL)
+                bestcv = cv;
+            else if (strcoll(cv_name_get(cv), cv_name_get(bestcv)) > 0)
+                bestcv = cv;
         }
-        else if (strcmp(xml_name(xc), "CLICON_YANG_DIR") == 0 &&
-                 (dir = xml_body(xc)) != NULL){
-            /* get all matching files in this directory recursively */
-            if ((cvv = cvec_new(0)) == NULL){
-                clicon_err(OE_UNIX, errno, "cvec_new");
-                goto done;
-            }
-            if (clicon_files_recursive(dir, cbuf_get(regex), cvv) < 0)
-                goto done;
-
-            /* Entries are not sorted and come in a vector: <name,path>.
-             * Find latest name and use path as return value
-             */
-            bestcv = NULL;
-            while ((cv = cvec_each(cvv, cv)) != NULL){
-                if (bestcv == NULL)
-                    bestcv = cv;
-                else if (strcoll(cv_name_get(cv), cv_name_get(bestcv)) > 0)
-                    bestcv = cv;
-            }
-            if (bestcv){
-                if (fbuf)
-                    cprintf(fbuf, "%s", cv_string_get(bestcv));      /* file path */
-                retval = 1; /* found */
-                goto done;
-            }
-            if (cvv){
-                cvec_free(cvv);
-                cvv = NULL;
-            }
+        if (bestcv){
+            if (fbuf)
+                cprintf(fbuf, "%s", cv_string_get(bestcv));      /* file path */
+            retval = 1; /* found */
+            goto done;
         }
     }
 ok:
     retval = 0;
 done:
-    if (cvv)
-        cvec_free(cvv);
+    if (recomp)
+        regfree(&re);
     if (regex)
         cbuf_free(regex);
     return retval;
@@ -1411,6 +1593,25 @@ yang_sort_modules(yang_stmt          *yspec,
     return retval;
 }
 
+/*! Log time of a yang_parse_post phase and restart timer
+ *
+ * @param[in]     phase  Phase name
+ * @param[in,out] t0     Start time of phase, set to now on return
+ */
+static void
+yang_parse_phase_time(const char     *phase,
+                      struct timeval *t0)
+{
+    struct timeval t1;
+    struct timeval dt;
+
+    gettimeofday(&t1, NULL);
+    timersub(&t1, t0, &dt);
+    clixon_debug(CLIXON_DBG_DEFAULT, "yang_parse_post phase %s: %lu.%06lus",
+                 phase, (unsigned long)dt.tv_sec, (unsigned long)dt.tv_usec);
+    *t0 = t1;
+}
+
 /*! Parse top yang module including all its sub-modules. Expand and populate yang tree
  *
  * Perform secondary actions after yang parsing. These actions cannot be made at
@@ -1443,11 +1644,13 @@ yang_parse_post(clicon_handle h,
     int                modmax;
     struct yang_stmt **ylist = NULL; /* Topology sorted modules */
     int                ylen = 0;     /* Length of ylist */
+    struct timeval     t0;
 
     if (modmin < 0){
         clicon_err(OE_YANG, EINVAL, "modmin negative");
         goto done;
     }
+    gettimeofday(&t0, NULL);
     /* 1: Parse from text to yang parse-tree. 
      * Iterate through modules and detect module/submodules to parse
      * NOTE: the list may grow on each iteration */
@@ -1455,6 +1658,7 @@ yang_parse_post(clicon_handle h,
         if (yang_parse_recurse(h, yang_child_i(yspec, i), yspec) < 0)
             goto done;
     modmax = yang_len_get(yspec);
+    yang_parse_phase_time("parse", &t0);
     /* The set of modules [modmin..maxmax] is here complete wrt imports/includes and is a DAG
      * Example: A imports B, C and D, and C and D imports B
      * In some operations below (eg augment) need to be in topology order, eg B first.
@@ -1462,6 +1666,7 @@ yang_parse_post(clicon_handle h,
      */
     if (yang_sort_modules(yspec, modmin, yang_len_get(yspec), &ylist, &ylen) < 0)
         goto done;
+    yang_parse_phase_time("sort", &t0);
 
     /* 2. Check cardinality a first time (done again last) */
     for (i=modmin; i<modmax; i++)
@@ -1471,12 +1676,14 @@ yang_parse_post(clicon_handle h,
     for (i=modmin; i<modmax; i++)
         if (yang_features(h, yang_child_i(yspec, i)) < 0)
             goto done;
+    yang_parse_phase_time("cardinality/features", &t0);
 
     /* 4: Go through parse tree and populate it with cv types */
     for (i=modmin; i<modmax; i++){
         if (yang_apply(yang_child_i(yspec, i), -1, ys_populate, 0, (void*)h) < 0)
             goto done;
     }
+    yang_parse_phase_time("populate", &t0);
 
     /* 5: Resolve all types: populate type caches. Requires eg length/range cvecs
      * from ys_populate step.
@@ -1485,6 +1692,7 @@ yang_parse_post(clicon_handle h,
     for (i=modmin; i<modmax; i++)
         if (yang_apply(yang_child_i(yspec, i), Y_TYPE, ys_resolve_type, 1, h) < 0)
             goto done;
+    yang_parse_phase_time("types", &t0);
 
     /* Up to here resolving is made in the context they are defined, rather 
      * than the context they are used (except for submodules being merged w 
@@ -1502,6 +1710,7 @@ yang_parse_post(clicon_handle h,
         if (yang_expand_grouping(ylist[i]) < 0)
             goto done;
     }
+    yang_parse_phase_time("grouping", &t0);
     /* 7: Top-level augmentation of all modules. 
      * Note: Clixon does not implement augment in USES 
      * Note: There is an ordering problem, where an augment in one module depends on an augment in
@@ -1510,6 +1719,7 @@ yang_parse_post(clicon_handle h,
     for (i=0; i<ylen; i++)
         if (yang_augment_module(h, ylist[i]) < 0)
             goto done;
+    yang_parse_phase_time("augment", &t0);
 
     /* 8: Check deviations: not-supported add/delete/replace statements 
      *    done late since eg groups must be expanded
@@ -1517,6 +1727,7 @@ yang_parse_post(clicon_handle h,
     for (i=modmin; i<modmax; i++) /* Really only under (sub)modules no need to traverse whole tree */
         if (yang_apply(yang_child_i(yspec, i), -1, yang_deviation, 1, (void*)h) < 0)
             goto done;
+    yang_parse_phase_time("deviation", &t0);
 
     /* 9: Go through parse tree and do 2nd step populate (eg default) 
      *    Note that augments in step 7 are not covered here since they apply to
@@ -1526,6 +1737,7 @@ yang_parse_post(clicon_handle h,
     for (i=0; i<ylen; i++)
         if (yang_apply(ylist[i], -1, ys_populate2, 1, (void*)h) < 0)
             goto done;
+    yang_parse_phase_time("populate2", &t0);
 
     /* 10: sanity checks of expanded yangs need more here */
     for (i=0; i<ylen; i++){
@@ -1537,8 +1749,19 @@ yang_parse_post(clicon_handle h,
     for (i=0; i<ylen; i++)
         if (yang_cardinality(h, ylist[i], yang_argument_get(ylist[i])) < 0)
             goto done;
+    yang_parse_phase_time("check", &t0);
+#ifdef YANG_CHILD_INDEX
+    /* 12. Build hashed child indexes of new nodes and of nodes changed by eg augment */
+    if (yang_index_build(yspec) < 0)
+        goto done;
+    yang_parse_phase_time("index", &t0);
+#endif
+    /* 13. Dependencies of validation constraints are rebuilt on next validation */
+    if (yspec == clicon_dbspec_yang(h) && validate_deps_free(h) < 0)
+        goto done;
     retval = 0;
  done:
+    yang_file_index_free(h);
     if (ylist)
         free(ylist);
     return retval;
@@ -1585,6 +1808,7 @@ yang_spec_parse_module(clicon_handle h,
  ok:
     retval = 0;
  done:
+    yang_file_index_free(h);
     if (base)
         free(base);
     return retval;
@@ -1632,6 +1856,7 @@ yang_spec_parse_file(clicon_handle h,
  ok:
     retval = 0;
  done:
+    yang_file_index_free(h);
     if (base)
         free(base);
     return retval;
@@ -1758,6 +1983,7 @@ yang_spec_load_dir(clicon_handle h,
  ok:
     retval = 0;
   done:
+    yang_file_index_free(h);
     if (dp)
         free(dp);
     if (base)
@@ -1767,6 +1993,49 @@ yang_spec_load_dir(clicon_handle h,
     return retval;
 }
 
+/*! Load the main yang modules of an application as given by options
+ *
+ * 1. Load a yang module as a specific absolute filename, CLICON_YANG_MAIN_FILE
+ * 2. Load a (single) main module, CLICON_YANG_MODULE_MAIN
+ * 3. Load all modules in a directory, CLICON_YANG_MAIN_DIR (will not overwrite 1 and 2)
+ * If CLICON_YANG_CACHE_DIR is set, the result is instead loaded from a serialized cache
+ * if it exists and is up-to-date, otherwise the cache is written after loading.
+ * @param[in]  h     Clicon handle
+ * @param[in]  yspec Modules are added to this yangspec
+ * @retval     0     OK
+ * @retval    -1     Error
+ * @see yang_cache_load
+ */
+int
+yang_spec_load_main(clicon_handle h,
+                    yang_stmt    *yspec)
+{
+    int   retval = -1;
+    char *str;
+    int   ret;
+
+    if ((ret = yang_cache_load(h, yspec)) < 0)
+        goto done;
+    if (ret == 1)
+        goto ok;
+    if ((str = clicon_yang_main_file(h)) != NULL)
+        if (yang_spec_parse_file(h, str, yspec) < 0)
+            goto done;
+    if ((str = clicon_yang_module_main(h)) != NULL)
+        if (yang_spec_parse_module(h, str, clicon_yang_module_revision(h),
+                                   yspec) < 0)
+            goto done;
+    if ((str = clicon_yang_main_dir(h)) != NULL)
+        if (yang_spec_load_dir(h, str, yspec) < 0)
+            goto done;
+    if (yang_cache_save(h, yspec) < 0)
+        goto done;
+ ok:
+    retval = 0;
+ done:
+    return retval;
+}
+
 /*! parse yang date-arg string and return a uint32 useful for arithmetics
  *
  * @param[in]  datearg  yang revision string as "YYYY-MM-DD"
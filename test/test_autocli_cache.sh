@@ -0,0 +1,181 @@
+#!/usr/bin/env bash
+# Autocli clispec cache across CLI startups, see CLICON_CLI_AUTOCLI_CACHE_DIR
+# First start generates and writes cache files, second start uses them, and a
+# YANG change causes regeneration
+# Also with grouping tree references, where the grouping trees are created on a cache hit
+
+# Magic line must be first in script (see README.md)
+s="$_" ; . ./lib.sh || if [ "$s" = $0 ]; then exit 0; else return 0; fi
+
+APPNAME=example
+
+# include err() and new() functions and creates $dir
+
+cfg=$dir/conf_yang.xml
+clispec=$dir/automode.cli
+fyang=$dir/clixon-example.yang
+cachedir=$dir/autocli-cache
+
+rm -rf $cachedir
+mkdir $cachedir
+
+cat <<EOF > $cfg
+<clixon-config xmlns="http://clicon.org/config">
+  <CLICON_CONFIGFILE>$cfg</CLICON_CONFIGFILE>
+  <CLICON_YANG_DIR>${YANG_INSTALLDIR}</CLICON_YANG_DIR>
+  <CLICON_YANG_MAIN_FILE>$fyang</CLICON_YANG_MAIN_FILE>
+  <CLICON_BACKEND_DIR>/usr/local/lib/$APPNAME/backend</CLICON_BACKEND_DIR>
+  <CLICON_CLI_MODE>$APPNAME</CLICON_CLI_MODE>
+  <CLICON_CLI_DIR>/usr/local/lib/$APPNAME/cli</CLICON_CLI_DIR>
+  <CLICON_CLISPEC_DIR>$dir</CLICON_CLISPEC_DIR>
+  <CLICON_CLI_AUTOCLI_CACHE_DIR>$cachedir</CLICON_CLI_AUTOCLI_CACHE_DIR>
+  <CLICON_SOCK>/usr/local/var/run/$APPNAME.sock</CLICON_SOCK>
+  <CLICON_BACKEND_PIDFILE>/usr/local/var/run/$APPNAME.pidfile</CLICON_BACKEND_PIDFILE>
+  <CLICON_XMLDB_DIR>$dir</CLICON_XMLDB_DIR>
+  <autocli>
+     <module-default>false</module-default>
+     <rule>
+       <name>include example</name>
+       <operation>enable</operation>
+       <module-name>clixon-example</module-name>
+     </rule>
+  </autocli>
+</clixon-config>
+EOF
+
+cat <<EOF > $fyang
+module clixon-example {
+    yang-version 1.1;
+    namespace "urn:example:clixon";
+    prefix ex;
+    container table{
+        list parameter{
+            key name;
+            leaf name{
+                type string;
+            }
+            leaf value{
+                type string;
+            }
+        }
+    }
+}
+EOF
+
+cat <<EOF > $clispec
+CLICON_MODE="example";
+CLICON_PROMPT="%U@%H %W> ";
+
+set @datamodel, cli_auto_set();
+delete("Delete a configuration item") @datamodel, cli_auto_del();
+show("Show a particular state of the system"){
+    configuration("Show configuration"), cli_show_auto_mode("candidate", "xml", false, false);
+}
+EOF
+
+new "test params: -f $cfg"
+if [ $BE -ne 0 ]; then
+    new "kill old backend"
+    sudo clixon_backend -z -f $cfg
+    if [ $? -ne 0 ]; then
+        err
+    fi
+    new "start backend -s init -f $cfg"
+    start_backend -s init -f $cfg
+fi
+
+new "wait backend"
+wait_backend
+
+new "First start: generate and set"
+expectpart "$($clixon_cli -1 -f $cfg set table parameter a value 42 2>&1)" 0 "^$"
+
+new "Check cache file created"
+nr=$(ls $cachedir/*-clixon-example.cli 2> /dev/null | wc -l)
+if [ $nr -ne 1 ]; then
+    err "1 cache file" "$nr"
+fi
+
+new "Second start: cached, set"
+expectpart "$($clixon_cli -1 -f $cfg set table parameter b value 43 2>&1)" 0 "^$"
+
+new "Check no new cache file"
+nr=$(ls $cachedir/*-clixon-example.cli | wc -l)
+if [ $nr -ne 1 ]; then
+    err "1 cache file" "$nr"
+fi
+
+new "Show config"
+expectpart "$($clixon_cli -1 -f $cfg show configuration)" 0 "<table xmlns=\"urn:example:clixon\"><parameter><name>a</name><value>42</value></parameter><parameter><name>b</name><value>43</value></parameter></table>"
+
+# Change yang: add a leaf, file mtime and size changes
+sleep 1
+sed -i 's/leaf value{/leaf extra{ type string; }\n            leaf value{/' $fyang
+
+new "YANG changed: regenerate, set new leaf"
+expectpart "$($clixon_cli -1 -f $cfg set table parameter a extra x 2>&1)" 0 "^$"
+
+new "Check new cache file"
+nr=$(ls $cachedir/*-clixon-example.cli | wc -l)
+if [ $nr -ne 2 ]; then
+    err "2 cache files" "$nr"
+fi
+
+# Grouping tree references: the grouping trees are not in the cached clispec
+new "Enable grouping-treeref"
+rm -rf $cachedir
+mkdir $cachedir
+sed -i 's|<module-default>false</module-default>|<module-default>false</module-default><grouping-treeref>true</grouping-treeref>|' $cfg
+
+cat <<EOF > $fyang
+module clixon-example {
+    yang-version 1.1;
+    namespace "urn:example:clixon";
+    prefix ex;
+    grouping pg {
+        leaf value{
+            type string;
+        }
+    }
+    container table{
+        list parameter{
+            key name;
+            leaf name{
+                type string;
+            }
+            uses pg;
+        }
+    }
+}
+EOF
+
+new "Treeref first start: generate and set"
+expectpart "$($clixon_cli -1 -f $cfg set table parameter c value 44 2>&1)" 0 "^$"
+
+new "Treeref second start: cached, set in grouping"
+expectpart "$($clixon_cli -1 -f $cfg set table parameter d value 45 2>&1)" 0 "^$"
+
+new "Treeref check no new cache file"
+nr=$(ls $cachedir/*-clixon-example.cli | wc -l)
+if [ $nr -ne 1 ]; then
+    err "1 cache file" "$nr"
+fi
+
+new "Treeref show config"
+expectpart "$($clixon_cli -1 -f $cfg show configuration)" 0 "<parameter><name>c</name><value>44</value></parameter><parameter><name>d</name><value>45</value></parameter>"
+
+if [ $BE -ne 0 ]; then
+    new "Kill backend"
+    # Check if premature kill
+    pid=$(pgrep -u root -f clixon_backend)
+    if [ -z "$pid" ]; then
+        err "backend already dead"
+    fi
+    # kill backend
+    stop_backend -f $cfg
+fi
+
+rm -rf $dir
+
+new "endtest"
+endtest
@@ -155,11 +155,13 @@ EOF
 
 # Args:
 # 1: grouping_treeref
+# 2: lazy: generate grouping trees on first reference (CLICON_CLI_AUTOCLI_LAZY)
 function testrun()
 {
     # Whether grouping treeref is enabled
     grouping_treeref=$1
-    echo "grouping_treeref=$1"
+    lazy=$2
+    echo "grouping_treeref=$1 lazy=$2"
     #    cat <<EOF > $cfd/autocli.xml # XXX
     cat <<EOF > $cfg
 <clixon-config xmlns="http://clicon.org/config">
@@ -177,6 +179,7 @@ function testrun()
   <CLICON_BACKEND_PIDFILE>/usr/local/var/run/$APPNAME.pidfile</CLICON_BACKEND_PIDFILE>
   <CLICON_XMLDB_DIR>$dir</CLICON_XMLDB_DIR>
   <CLICON_YANG_LIBRARY>false</CLICON_YANG_LIBRARY>
+  <CLICON_CLI_AUTOCLI_LAZY>${lazy}</CLICON_CLI_AUTOCLI_LAZY>
   <autocli>
     <module-default>false</module-default>
      <list-keyword-default>kw-nokey</list-keyword-default>
@@ -264,10 +267,13 @@ EOF
 }
 
 new "autocli grouping=true"
-testrun true
+testrun true false
+
+new "autocli grouping=true lazy=true"
+testrun true true
 
 new "autocli grouping=false"
-testrun false
+testrun false false
 
 rm -rf $dir
 
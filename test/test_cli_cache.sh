@@ -0,0 +1,126 @@
+#!/usr/bin/env bash
+# CLI config cache, see CLICON_CLI_CONFIG_CACHE
+# Check that expand and show within one CLI session see changes made by the
+# session itself and by other clients, ie that the cache is invalidated via the
+# backend datastore generation
+
+# Magic line must be first in script (see README.md)
+s="$_" ; . ./lib.sh || if [ "$s" = $0 ]; then exit 0; else return 0; fi
+
+APPNAME=example
+
+# include err() and new() functions and creates $dir
+
+cfg=$dir/conf_yang.xml
+fyang=$dir/clixon-example.yang
+clidir=$dir/clidir
+
+if [ ! -d $clidir ]; then
+    mkdir $clidir
+fi
+
+cat <<EOF > $cfg
+<clixon-config xmlns="http://clicon.org/config">
+  <CLICON_CONFIGFILE>$cfg</CLICON_CONFIGFILE>
+  <CLICON_YANG_DIR>${YANG_INSTALLDIR}</CLICON_YANG_DIR>
+  <CLICON_YANG_MAIN_FILE>$fyang</CLICON_YANG_MAIN_FILE>
+  <CLICON_BACKEND_DIR>/usr/local/lib/$APPNAME/backend</CLICON_BACKEND_DIR>
+  <CLICON_CLISPEC_DIR>$clidir</CLICON_CLISPEC_DIR>
+  <CLICON_CLI_DIR>/usr/local/lib/$APPNAME/cli</CLICON_CLI_DIR>
+  <CLICON_CLI_MODE>$APPNAME</CLICON_CLI_MODE>
+  <CLICON_CLI_CONFIG_CACHE>true</CLICON_CLI_CONFIG_CACHE>
+  <CLICON_SOCK>/usr/local/var/run/$APPNAME.sock</CLICON_SOCK>
+  <CLICON_BACKEND_PIDFILE>/usr/local/var/run/$APPNAME.pidfile</CLICON_BACKEND_PIDFILE>
+  <CLICON_XMLDB_DIR>$dir</CLICON_XMLDB_DIR>
+</clixon-config>
+EOF
+
+cat <<EOF > $fyang
+module clixon-example{
+  yang-version 1.1;
+  namespace "urn:example:clixon";
+  prefix ex;
+  list list1{
+      key  "key1";
+      leaf key1{
+         type string;
+      }
+   }
+}
+EOF
+
+cat <<EOF > $clidir/cli1.cli
+CLICON_MODE="example";
+CLICON_PROMPT="%U@%H %W> ";
+
+set @datamodel, cli_auto_set();
+delete("Delete a configuration item") {
+      @datamodel, cli_auto_del(); 
+      all("Delete whole candidate configuration"), delete_all("candidate");
+}
+commit("Commit the changes"), cli_commit();
+show("Show a particular state of the system"){
+    configuration("Show configuration"), cli_show_auto_mode("candidate", "xml", false, false);
+}
+EOF
+
+new "test params: -f $cfg"
+if [ $BE -ne 0 ]; then
+    new "kill old backend"
+    sudo clixon_backend -z -f $cfg
+    if [ $? -ne 0 ]; then
+        err
+    fi
+    new "start backend -s init -f $cfg"
+    start_backend -s init -f $cfg
+fi
+
+new "wait backend"
+wait_backend
+
+new "datastore-generation rpc"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><datastore-generation $LIBNS/></rpc>" "" "<rpc-reply $DEFAULTNS><generation $LIBNS>[0-9]*</generation></rpc-reply>"
+
+new "Add entry aaa"
+expectpart "$($clixon_cli -1 -f $cfg set list1 aaa)" 0 "^$"
+
+new "Show, set and show in same session"
+expectpart "$(cat <<EOF | $clixon_cli -f $cfg 2>&1
+show configuration
+set list1 bbb
+show configuration
+EOF
+)" 0 '<list1 xmlns="urn:example:clixon"><key1>aaa</key1></list1>' '<list1 xmlns="urn:example:clixon"><key1>aaa</key1></list1><list1 xmlns="urn:example:clixon"><key1>bbb</key1></list1>'
+
+new "Expand, delete and expand in same session"
+expectpart "$(cat <<EOF | $clixon_cli -f $cfg 2>&1
+set list1 ?
+delete list1 aaa
+set list1 ?
+EOF
+)" 0 aaa bbb
+
+new "Expand after delete"
+expectpart "$(echo "set list1 ?" | $clixon_cli -f $cfg 2>&1)" 0 bbb --not-- aaa
+
+new "Delete bbb with netconf"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><edit-config><target><candidate/></target><config><list1 xmlns=\"urn:example:clixon\" xmlns:nc=\"urn:ietf:params:xml:ns:netconf:base:1.0\" nc:operation=\"delete\"><key1>bbb</key1></list1></config></edit-config></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+new "Show after external change"
+expectpart "$($clixon_cli -1 -f $cfg show configuration)" 0 --not-- bbb
+
+if [ $BE -ne 0 ]; then
+    new "Kill backend"
+    # Check if premature kill
+    pid=$(pgrep -u root -f clixon_backend)
+    if [ -z "$pid" ]; then
+        err "backend already dead"
+    fi
+    # kill backend
+    stop_backend -f $cfg
+fi
+
+rm -rf $dir
+
+new "endtest"
+endtest
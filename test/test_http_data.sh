@@ -3,6 +3,7 @@
 # Create an html and css file
 # Get them via http and https
 # Send options and head request
+# Precompressed variants and conditional requests
 # Errors: not found, post, 
 # See RFC 7230
 
@@ -233,6 +234,37 @@ EOF
             err1 "$dir/foo.png $dir/www/data/example.css should be equal" "Not equal"
         fi
 
+        # Precompressed variant
+        gzip -c $dir/www/data/example.css > $dir/www/data/example.css.gz
+
+        new "WWW get css gzip accepted"
+        expectpart "$(curl $CURLOPTS -X GET -H 'Accept-Encoding: deflate, gzip' $proto://localhost/data/example.css)" 0 "HTTP/$HVER 200" "Content-Type: text/css" "Content-Encoding: gzip" "Vary: Accept-Encoding"
+
+        new "WWW get css gzip not accepted"
+        expectpart "$(curl $CURLOPTS -X GET -H 'Accept-Encoding: gzip;q=0' $proto://localhost/data/example.css)" 0 "HTTP/$HVER 200" "Content-Type: text/css" "Vary: Accept-Encoding" "display: inline;" --not-- "Content-Encoding"
+
+        new "WWW get css gzip decompressed"
+        curl $CURLOPTS2 --compressed -X GET $proto://localhost/data/example.css -o $dir/foo.css
+        cmp $dir/foo.css $dir/www/data/example.css
+        if [ $? -ne 0 ]; then
+            err1 "$dir/foo.css $dir/www/data/example.css should be equal" "Not equal"
+        fi
+        rm $dir/www/data/example.css.gz
+
+        # Conditional requests
+        ret=$(curl $CURLOPTS --head $proto://localhost/data/index.html)
+        etag=$(echo "$ret" | grep -i "^etag:" | awk '{print $2}' | tr -d '\r')
+        lastmod=$(echo "$ret" | grep -i "^last-modified:" | cut -d' ' -f2- | tr -d '\r')
+
+        new "WWW get If-None-Match"
+        expectpart "$(curl $CURLOPTS -X GET -H "If-None-Match: $etag" $proto://localhost/data/index.html)" 0 "HTTP/$HVER 304" "ETag: $etag" --not-- "<title>Welcome to Clixon!</title>"
+
+        new "WWW get If-None-Match not matching"
+        expectpart "$(curl $CURLOPTS -X GET -H 'If-None-Match: "0-0"' $proto://localhost/data/index.html)" 0 "HTTP/$HVER 200" "ETag: $etag" "<title>Welcome to Clixon!</title>"
+
+        new "WWW get If-Modified-Since"
+        expectpart "$(curl $CURLOPTS -X GET -H "If-Modified-Since: $lastmod" $proto://localhost/data/index.html)" 0 "HTTP/$HVER 304" "Last-Modified: $lastmod" --not-- "<title>Welcome to Clixon!</title>"
+
         # negative errors
         new "WWW get http not found"
         expectpart "$(curl $CURLOPTS -X GET -H 'Accept: text/html' $proto://localhost/data/notfound.html)" 0 "HTTP/$HVER 404" "Content-Type: text/html" "<title>404 Not Found</title>"
@@ -254,10 +286,10 @@ EOF
         if [ "$proto" = http -a -n "$netcat" ]; then    
             new "WWW get outside using .. netcat"
             expectpart "$(${netcat} 127.0.0.1 80 <<EOF
-GET /data/../../outside.html HTTP/1.1
-Host: localhost
-Accept: text_html
-
+GET /data/../../outside.html HTTP/1.1
+Host: localhost
+Accept: text_html
+
 EOF
 )" 0 "HTTP/1.1 403" "Forbidden"
         fi
@@ -0,0 +1,129 @@
+#!/usr/bin/env bash
+# Hand-written JSON parser, see CLICON_JSON_FAST_PARSER and clixon_json_parse_fast.c
+# Check that JSON is parsed into the same trees as with the yacc parser, with and without
+# yang, including namespace translation and identityref decoding, and that the same errors
+# are detected
+
+# Magic line must be first in script (see README.md)
+s="$_" ; . ./lib.sh || if [ "$s" = $0 ]; then exit 0; else return 0; fi
+
+: ${clixon_util_json:="clixon_util_json"}
+
+# Number of list entries in performance comparison
+: ${perfnr:=20000}
+
+fyang=$dir/json.yang
+fjson=$dir/fast.json
+
+cat <<EOF > $fyang
+module json{
+   prefix ex;
+   namespace "urn:example:clixon";
+   identity genre;
+   identity blues {
+      base genre;
+   }
+   container c{
+     leaf a{
+       type int32;
+     }
+     leaf s{
+       type string;
+     }
+     leaf g{
+       type identityref { base genre; }
+     }
+     leaf-list l{
+       type string;
+     }
+     list x{
+       key k;
+       leaf k{
+         type int32;
+       }
+       leaf g{
+         type identityref { base genre; }
+       }
+     }
+   }
+}
+EOF
+
+# Parse with both parsers and compare output and exit code
+# 1: JSON
+# 2: yang options (optional)
+function cmpparse()
+{
+    echo -n "$1" > $fjson
+    new "json parse $2 $1"
+    ret1=$($clixon_util_json $2 < $fjson 2>&1)
+    r1=$?
+    ret2=$($clixon_util_json -F $2 < $fjson 2>&1)
+    r2=$?
+    if [ $r1 -ne $r2 ]; then
+        err "exit code $r1" "$r2"
+    fi
+    # Error messages differ in token context
+    if [ $r1 -eq 0 -a "$ret1" != "$ret2" ]; then
+        err "$ret1" "$ret2"
+    fi
+}
+
+LF='
+'
+cmpparse '{"a":1}'
+cmpparse '{"a":{"b":"x","c":[1,2,3]}}'
+cmpparse '{"a":[{"b":1},{"b":2}]}'
+cmpparse '{"a":[]}'
+cmpparse '{"a":{}}'
+cmpparse '{}'
+cmpparse '{"a":true,"b":false,"c":null}'
+cmpparse '{"a":-1.5E+10,"b":.5,"c":1.,"d":-0}'
+cmpparse '{"a":1e5}'
+cmpparse '{"a":1.2.3}'
+cmpparse '{"a":"esc\"\\\/\b\f\n\r\t\u0041\u00e9"}'
+cmpparse '{"a":"\x"}'
+cmpparse '{"a":"\u00g1"}'
+cmpparse '{"a":"unterminated'
+cmpparse "{${LF}  \"a\" : 1 ,${LF}  \"b\":\"<&>\"${LF}}${LF}"
+cmpparse '{"a":1,}'
+cmpparse '{"a":1}x'
+cmpparse '{"a":truex}'
+cmpparse ''
+cmpparse '{"p:a":{"q:b":"r:c"}}'
+
+# With yang
+Y="-y $fyang"
+cmpparse '{"json:c":{"a":42,"s":"x:y","g":"json:blues","l":["a","b:c"]}}' "$Y"
+cmpparse '{"json:c":{"x":[{"k":1,"g":"json:blues"},{"k":2},{"k":3,"g":"json:genre"}]}}' "$Y"
+cmpparse '{"json:c":{"g":"foo:blues"}}' "$Y"
+cmpparse '{"c":{"a":42}}' "$Y"
+cmpparse '{"foo:c":{"a":42}}' "$Y"
+cmpparse '{"json:c":{"json:a":42,"foo:s":"x"}}' "$Y"
+cmpparse '{"json:c":{"a":42}, "foo:c":{"a":1}' "$Y"
+
+new "generate json with $perfnr list entries"
+echo -n '{"json:c":{"x":[' > $fjson
+for (( i=0; i<$perfnr; i++ )); do
+    if [ $i -ne 0 ]; then
+        echo -n ',' >> $fjson
+    fi
+    echo -n "{\"k\":$i,\"g\":\"json:blues\"}" >> $fjson
+done
+echo '],"s":"string"}}' >> $fjson
+
+new "json parse $perfnr entries yacc parser"
+{ time -p $clixon_util_json -n 10 $Y < $fjson > $dir/out1.xml ; } 2>&1 | awk '/real/ {print $2}'
+
+new "json parse $perfnr entries fast parser"
+{ time -p $clixon_util_json -F -n 10 $Y < $fjson > $dir/out2.xml ; } 2>&1 | awk '/real/ {print $2}'
+
+new "compare outputs"
+if ! cmp -s $dir/out1.xml $dir/out2.xml; then
+    err "$(head -c 200 $dir/out1.xml)" "$(head -c 200 $dir/out2.xml)"
+fi
+
+rm -rf $dir
+
+new "endtest"
+endtest
@@ -413,6 +413,47 @@ testlimit 6 0 0 ""
 new "A.3.7. limit=2 offset=2"
 testlimit 2 2 2 "11 7"
 
+# Keyset pagination using clixon-lib cursor annotation (Clixon extension)
+xpath="/es:members/es:member[es:member-id='alice']/es:favorites/es:uint8-numbers"
+function getcursor()
+{
+    cursor=$1
+    limit=$2
+    rpc=$(chunked_framing "<rpc $DEFAULTNS><get-config><source><running/></source><filter type=\"xpath\" select=\"$xpath\" xmlns:es=\"http://example.com/ns/example-social\"/><list-pagination xmlns=\"urn:ietf:params:xml:ns:yang:ietf-list-pagination-nc\" cl:cursor=\"$cursor\" xmlns:cl=\"http://clicon.org/lib\"><limit>$limit</limit></list-pagination></get-config></rpc>")
+    echo "$DEFAULTHELLO$rpc" | $clixon_netconf -qef $cfg
+}
+
+new "cursor first page NETCONF"
+expectpart "$(getcursor "" 2)" 0 ">17</uint8-numbers><uint8-numbers>13</uint8-numbers></favorites>" "lp:remaining=\"4\"" "cl:next-cursor=\"13\""
+
+new "cursor second page NETCONF"
+expectpart "$(getcursor 13 2)" 0 ">11</uint8-numbers><uint8-numbers>7</uint8-numbers></favorites>" "lp:remaining=\"2\"" "cl:next-cursor=\"7\""
+
+new "cursor last page NETCONF"
+expectpart "$(getcursor 7 5)" 0 ">5</uint8-numbers><uint8-numbers>3</uint8-numbers></favorites>" "lp:remaining=\"0\"" --not-- "next-cursor"
+
+new "cursor stale NETCONF"
+expectpart "$(getcursor 99 2)" 0 "<error-tag>bad-attribute</error-tag>" "Invalid or stale cursor"
+
+new "cursor second page RESTCONF xml"
+expectpart "$(curl $CURLOPTS -X GET -H "Accept: application/yang-data+xml-list" "$RCPROTO://localhost/restconf/data/example-social:members/member=alice/favorites/uint8-numbers?cursor=13&limit=2")" 0 "HTTP/$HVER 200" ">11</uint8-numbers><uint8-numbers xmlns=\"http://example.com/ns/example-social\">7</uint8-numbers></xml-list>" "cl:next-cursor=\"7\""
+
+new "cursor second page RESTCONF json"
+expectpart "$(curl $CURLOPTS -X GET -H "Accept: application/yang-data+json" "$RCPROTO://localhost/restconf/data/example-social:members/member=alice/favorites/uint8-numbers?cursor=13&limit=2")" 0 "HTTP/$HVER 200" "\"example-social:uint8-numbers\":\[11,7\]" "\"clixon-lib:next-cursor\":\"7\""
+
+# where, sort-by and direction on an ordered-by user leaf-list: 17 13 11 7 5 3
+new "sort-by leaf-list value RESTCONF"
+expectpart "$(curl $CURLOPTS -X GET -H "Accept: application/yang-data+xml-list" "$RCPROTO://localhost/restconf/data/example-social:members/member=alice/favorites/uint8-numbers?sort-by=uint8-numbers&limit=2")" 0 "HTTP/$HVER 200" ">3</uint8-numbers><uint8-numbers xmlns=\"http://example.com/ns/example-social\">5</uint8-numbers></xml-list>" "lp:remaining=\"4\""
+
+new "where on leaf-list value RESTCONF"
+expectpart "$(curl $CURLOPTS -X GET -H "Accept: application/yang-data+xml-list" "$RCPROTO://localhost/restconf/data/example-social:members/member=alice/favorites/uint8-numbers?where=.%3E10")" 0 "HTTP/$HVER 200" ">17</uint8-numbers><uint8-numbers xmlns=\"http://example.com/ns/example-social\">13</uint8-numbers><uint8-numbers xmlns=\"http://example.com/ns/example-social\">11</uint8-numbers></xml-list>"
+
+new "direction backwards RESTCONF"
+expectpart "$(curl $CURLOPTS -X GET -H "Accept: application/yang-data+xml-list" "$RCPROTO://localhost/restconf/data/example-social:members/member=alice/favorites/uint8-numbers?direction=backwards&limit=2")" 0 "HTTP/$HVER 200" ">3</uint8-numbers><uint8-numbers xmlns=\"http://example.com/ns/example-social\">5</uint8-numbers></xml-list>"
+
+new "sublist-limit on members RESTCONF"
+expectpart "$(curl $CURLOPTS -X GET -H "Accept: application/yang-data+xml-list" "$RCPROTO://localhost/restconf/data/example-social:members/member?where=member-id%3D%27alice%27&sublist-limit=1")" 0 "HTTP/$HVER 200" "<following lp:remaining=\"2\"" --not-- "<following>eric</following>" "<member-id>bob</member-id>"
+
 if [ $RC -ne 0 ]; then
     new "Kill restconf daemon"
     stop_restconf
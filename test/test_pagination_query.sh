@@ -0,0 +1,165 @@
+#!/usr/bin/env bash
+# List pagination where, sort-by, direction and sublist-limit parameters
+# See draft-ietf-netconf-list-pagination
+# Config list queries are made directly on the datastore cache, using search indexes
+# (clixon-config search_index extension) for sort-by and for where equality expressions if
+# possible. Otherwise the whole list is read and filtered/sorted.
+
+# Magic line must be first in script (see README.md)
+s="$_" ; . ./lib.sh || if [ "$s" = $0 ]; then exit 0; else return 0; fi
+
+APPNAME=example
+
+cfg=$dir/conf.xml
+fyang=$dir/query.yang
+
+cat <<EOF > $fyang
+module query{
+   yang-version 1.1;
+   namespace "urn:example:query";
+   prefix q;
+   import clixon-config {
+      prefix "cc";
+   }
+   container c {
+     list e {
+       key name;
+       leaf name {
+         type string;
+       }
+       leaf rank {
+         description "explicit index variable";
+         type uint32;
+         cc:search_index;
+       }
+       leaf color {
+         type string;
+       }
+       leaf size {
+         type uint32;
+         default 10;
+       }
+       leaf-list tag {
+         type string;
+         ordered-by user;
+       }
+       container stats {
+         leaf errors {
+           type uint32;
+         }
+       }
+     }
+   }
+}
+EOF
+
+cat <<EOF > $cfg
+<clixon-config xmlns="http://clicon.org/config">
+  <CLICON_CONFIGFILE>$cfg</CLICON_CONFIGFILE>
+  <CLICON_YANG_DIR>${YANG_INSTALLDIR}</CLICON_YANG_DIR>
+  <CLICON_YANG_DIR>$IETFRFC</CLICON_YANG_DIR>
+  <CLICON_YANG_MAIN_FILE>$fyang</CLICON_YANG_MAIN_FILE>
+  <CLICON_SOCK>/usr/local/var/run/$APPNAME.sock</CLICON_SOCK>
+  <CLICON_BACKEND_PIDFILE>/usr/local/var/run/$APPNAME.pidfile</CLICON_BACKEND_PIDFILE>
+  <CLICON_XMLDB_DIR>$dir</CLICON_XMLDB_DIR>
+</clixon-config>
+EOF
+
+cat <<EOF > $dir/startup_db
+<${DATASTORE_TOP}>
+  <c xmlns="urn:example:query">
+    <e><name>a</name><rank>3</rank><color>red</color><tag>x</tag><tag>y</tag><tag>z</tag><stats><errors>5</errors></stats></e>
+    <e><name>b</name><rank>1</rank><color>blue</color><stats><errors>50</errors></stats></e>
+    <e><name>c</name><rank>2</rank><color>red</color><size>20</size><stats><errors>7</errors></stats></e>
+    <e><name>d</name><color>green</color><stats><errors>1</errors></stats></e>
+    <e><name>e</name><rank>5</rank><color>blue</color></e>
+  </c>
+</${DATASTORE_TOP}>
+EOF
+
+# Get list /q:c/q:e with list-pagination parameters
+# 1: list-pagination parameters
+# 2: other get-config parameters (optional)
+function getquery()
+{
+    rpc=$(chunked_framing "<rpc $DEFAULTNS><get-config><source><running/></source><filter type=\"xpath\" select=\"/q:c/q:e\" xmlns:q=\"urn:example:query\"/>$2<list-pagination xmlns=\"urn:ietf:params:xml:ns:yang:ietf-list-pagination-nc\">$1</list-pagination></get-config></rpc>")
+    echo "$DEFAULTHELLO$rpc" | $clixon_netconf -qef $cfg
+}
+
+new "test params: -f $cfg"
+if [ $BE -ne 0 ]; then
+    new "kill old backend"
+    sudo clixon_backend -zf $cfg
+    if [ $? -ne 0 ]; then
+        err
+    fi
+    new "start backend -s startup -f $cfg"
+    start_backend -s startup -f $cfg
+fi
+
+new "wait backend"
+wait_backend
+
+new "sort-by indexed leaf, missing last"
+expectpart "$(getquery "<sort-by>rank</sort-by>")" 0 "<name>b</name>.*<name>c</name>.*<name>a</name>.*<name>e</name>.*<name>d</name>"
+
+new "sort-by indexed leaf, limit"
+expectpart "$(getquery "<sort-by>q:rank</sort-by><limit>3</limit>")" 0 "<name>b</name>.*<name>c</name>.*<name>a</name><rank>3</rank>" "lp:remaining=\"2\"" --not-- "<name>e</name>" "<name>d</name>"
+
+new "sort-by indexed leaf, offset and limit"
+expectpart "$(getquery "<sort-by>rank</sort-by><offset>1</offset><limit>2</limit>")" 0 "<name>c</name>.*<name>a</name>" "lp:remaining=\"2\"" --not-- "<name>b</name>" "<name>e</name>"
+
+new "sort-by indexed leaf backwards"
+expectpart "$(getquery "<sort-by>rank</sort-by><direction>backwards</direction>")" 0 "<name>d</name>.*<name>e</name>.*<name>a</name>.*<name>c</name>.*<name>b</name>"
+
+new "sort-by descendant leaf"
+expectpart "$(getquery "<sort-by>stats/errors</sort-by>")" 0 "<name>d</name>.*<name>a</name>.*<name>c</name>.*<name>b</name>.*<name>e</name>"
+
+new "direction backwards without sort-by"
+expectpart "$(getquery "<direction>backwards</direction><limit>2</limit>")" 0 "<name>e</name>.*<name>d</name>" --not-- "<name>c</name>"
+
+new "where equality on indexed leaf"
+expectpart "$(getquery "<where>rank = 2</where>")" 0 "<e><name>c</name><rank>2</rank>" --not-- "<name>a</name>" "<name>b</name>"
+
+new "where equality on key"
+expectpart "$(getquery "<where>name='e'</where>")" 0 "<e><name>e</name>" --not-- "<name>a</name>" "<name>d</name>"
+
+new "where on non-indexed leaf and sort-by"
+expectpart "$(getquery "<where>color='red'</where><sort-by>rank</sort-by>")" 0 "<name>c</name>.*<name>a</name>" --not-- "<name>b</name>" "<name>d</name>"
+
+new "where on default value, report-all"
+expectpart "$(getquery "<where>size=10</where>" "<with-defaults xmlns=\"urn:ietf:params:xml:ns:yang:ietf-netconf-with-defaults\">report-all</with-defaults>")" 0 "<name>a</name>.*<name>b</name>.*<name>d</name>.*<name>e</name><rank>5</rank><color>blue</color><size>10</size>" --not-- "<name>c</name>"
+
+new "where with prefix"
+expectpart "$(getquery "<where xmlns:qq=\"urn:example:query\">qq:stats/qq:errors &gt; 6</where>")" 0 "<name>b</name>.*<name>c</name>" --not-- "<name>a</name>" "<name>d</name>"
+
+new "where no match"
+expectpart "$(getquery "<where>rank = 99</where>")" 0 "<data/>\|<data></data>" --not-- "<name>"
+
+new "sublist-limit"
+expectpart "$(getquery "<where>name='a'</where><sublist-limit>1</sublist-limit>")" 0 "<tag lp:remaining=\"2\" xmlns:lp=\"urn:ietf:params:xml:ns:yang:ietf-list-pagination\">x</tag><stats>" --not-- "<tag>y</tag>"
+
+new "invalid sort-by"
+expectpart "$(getquery "<sort-by>nonexist</sort-by>")" 0 "<error-tag>invalid-value</error-tag>" "sort-by does not identify a descendant leaf"
+
+new "invalid direction"
+expectpart "$(getquery "<direction>sideways</direction>")" 0 "<rpc-error>"
+
+new "invalid where"
+expectpart "$(getquery "<where>rank = = </where>")" 0 "<error-tag>invalid-value</error-tag>" "where is not a valid XPath expression"
+
+if [ $BE -ne 0 ]; then
+    new "Kill backend"
+    # Check if premature kill
+    pid=$(pgrep -u root -f clixon_backend)
+    if [ -z "$pid" ]; then
+        err "backend already dead"
+    fi
+    # kill backend
+    stop_backend -f $cfg
+fi
+
+rm -rf $dir
+
+new "endtest"
+endtest
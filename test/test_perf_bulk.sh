@@ -0,0 +1,177 @@
+#!/usr/bin/env bash
+# Bulk load performance: large edit-config into an empty target, merge and replace.
+# New children are then sorted once and merged into existing children instead of
+# inserted one by one, see xml_sort_merge
+# Entries are written in reverse order to exercise sorting, and results are checked
+
+# Magic line must be first in script (see README.md)
+s="$_" ; . ./lib.sh || if [ "$s" = $0 ]; then exit 0; else return 0; fi
+
+# Number of list/leaf-list entries
+: ${perfnr:=20000}
+
+: ${TIMEFN:=time -p} # portability: 2>&1 | awk '/real/ {print $2}'
+if ! $TIMEFN true; then err "A working time function" "'$TIMEFN' does not work"; fi
+
+APPNAME=example
+
+cfg=$dir/perf-bulk-conf.xml
+fyang=$dir/scaling.yang
+fconfig=$dir/large.xml
+fexpect=$dir/expect.xml
+foutput=$dir/output.xml
+
+cat <<EOF > $fyang
+module scaling{
+   yang-version 1.1;
+   namespace "urn:example:clixon";
+   prefix ex;
+   container x {
+    list y {
+      key "a";
+      leaf a {
+        type int32;
+      }
+      leaf b {
+        type int32;
+      }
+    }
+    leaf-list c {
+       type int32;
+    }
+    list u {
+      ordered-by user;
+      key "a";
+      leaf a {
+        type int32;
+      }
+    }
+  }
+}
+EOF
+
+cat <<EOF > $cfg
+<clixon-config xmlns="http://clicon.org/config">
+  <CLICON_CONFIGFILE>$cfg</CLICON_CONFIGFILE>
+  <CLICON_YANG_DIR>$dir</CLICON_YANG_DIR>
+  <CLICON_YANG_DIR>${YANG_INSTALLDIR}</CLICON_YANG_DIR>
+  <CLICON_YANG_MAIN_FILE>$fyang</CLICON_YANG_MAIN_FILE>
+  <CLICON_SOCK>/usr/local/var/run/$APPNAME.sock</CLICON_SOCK>
+  <CLICON_BACKEND_PIDFILE>/usr/local/var/run/$APPNAME.pidfile</CLICON_BACKEND_PIDFILE>
+  <CLICON_XMLDB_DIR>$dir</CLICON_XMLDB_DIR>
+  <CLICON_XMLDB_PRETTY>false</CLICON_XMLDB_PRETTY>
+</clixon-config>
+EOF
+
+# Write edit-config of list entries in [$1,$2) in reverse order to $fconfig
+# 1: low
+# 2: high
+# 3: operation on container (optional)
+function genconfig()
+{
+    local op=""
+    if [ -n "$3" ]; then
+        op=" nc:operation=\"$3\" xmlns:nc=\"urn:ietf:params:xml:ns:netconf:base:1.0\""
+    fi
+    echo -n "$DEFAULTHELLO" > $fconfig
+    rpc="<rpc $DEFAULTNS><edit-config><target><candidate/></target><config><x xmlns=\"urn:example:clixon\"$op>"
+    for (( i=$2-1; i>=$1; i-- )); do
+        rpc+="<y><a>$i</a><b>$i</b></y><c>$i</c>"
+    done
+    for (( i=$2-1; i>=$1; i-- )); do
+        rpc+="<u><a>$i</a></u>"
+    done
+    rpc+="</x></config></edit-config></rpc>"
+    echo "$(chunked_framing "$rpc")" >> $fconfig
+}
+
+# Write expected get-config reply of entries in [$1,$2) and user-ordered in $3 to $fexpect
+# 1: low
+# 2: high
+# 3: user-ordered entries in order
+function genexpect()
+{
+    rpc="<rpc-reply $DEFAULTNS><data><x xmlns=\"urn:example:clixon\">"
+    for (( i=$1; i<$2; i++ )); do
+        rpc+="<y><a>$i</a><b>$i</b></y>"
+    done
+    for (( i=$1; i<$2; i++ )); do
+        rpc+="<c>$i</c>"
+    done
+    for i in $3; do
+        rpc+="<u><a>$i</a></u>"
+    done
+    rpc+="</x></data></rpc-reply>"
+    echo "$(chunked_framing "$rpc")" > $fexpect
+}
+
+# Compare candidate with $fexpect
+function checkcandidate()
+{
+    rpc=$(chunked_framing "<rpc $DEFAULTNS><get-config><source><candidate/></source></get-config></rpc>")
+    echo "$DEFAULTHELLO$rpc" | $clixon_netconf -qef $cfg > $foutput
+    ret=$(diff $fexpect $foutput)
+    if [ $? -ne 0 ]; then
+        err1 "Matching candidate with $fexpect"
+    fi
+}
+
+new "test params: -f $cfg"
+if [ $BE -ne 0 ]; then
+    new "kill old backend"
+    sudo clixon_backend -zf $cfg
+    if [ $? -ne 0 ]; then
+        err
+    fi
+
+    new "start backend -s init -f $cfg"
+    start_backend -s init -f $cfg
+fi
+
+new "wait backend"
+wait_backend
+
+half=$(( $perfnr / 2 ))
+
+new "netconf bulk load $half entries into empty candidate"
+genconfig $half $perfnr
+expecteof_file "time -p $clixon_netconf -qef $cfg" 0 "$fconfig" "^<rpc-reply $DEFAULTNS><ok/></rpc-reply>$" 2>&1 | awk '/real/ {print $2}'
+
+new "Check candidate sorted"
+genexpect $half $perfnr "$(seq $(( $perfnr - 1 )) -1 $half)"
+checkcandidate
+
+new "netconf bulk merge $half entries into existing"
+genconfig 0 $half
+expecteof_file "time -p $clixon_netconf -qef $cfg" 0 "$fconfig" "^<rpc-reply $DEFAULTNS><ok/></rpc-reply>$" 2>&1 | awk '/real/ {print $2}'
+
+new "Check candidate merged"
+genexpect 0 $perfnr "$(seq $(( $perfnr - 1 )) -1 $half) $(seq $(( $half - 1 )) -1 0)"
+checkcandidate
+
+new "netconf bulk replace with $perfnr entries"
+genconfig 0 $perfnr replace
+expecteof_file "time -p $clixon_netconf -qef $cfg" 0 "$fconfig" "^<rpc-reply $DEFAULTNS><ok/></rpc-reply>$" 2>&1 | awk '/real/ {print $2}'
+
+new "Check candidate replaced"
+genexpect 0 $perfnr "$(seq $(( $perfnr - 1 )) -1 0)"
+checkcandidate
+
+new "netconf commit large config"
+expecteof_netconf "time -p $clixon_netconf -qef $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><commit/></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>" 2>&1 | awk '/real/ {print $2}'
+
+if [ $BE -ne 0 ]; then
+    new "Kill backend"
+    # Check if premature kill
+    pid=$(pgrep -u root -f clixon_backend)
+    if [ -z "$pid" ]; then
+        err "backend already dead"
+    fi
+    # kill backend
+    stop_backend -f $cfg
+fi
+
+rm -rf $dir
+
+new "endtest"
+endtest
@@ -0,0 +1,142 @@
+#!/usr/bin/env bash
+# Performance and correctness of default values in small reads of a large datastore
+# Defaults are added along the xpath of a get-config and removed again, so the cost
+# of getting a single entry should not depend on the size of the datastore.
+# Checks that default values within list entries and non-presence containers are
+# returned when getting single entries.
+
+# Magic line must be first in script (see README.md)
+s="$_" ; . ./lib.sh || if [ "$s" = $0 ]; then exit 0; else return 0; fi
+
+# Number of list entries in datastore
+: ${perfnr:=20000}
+
+# Number of requests made
+: ${perfreq:=20}
+
+: ${TIMEFN:=time -p} # portability: 2>&1 | awk '/real/ {print $2}'
+if ! $TIMEFN true; then err "A working time function" "'$TIMEFN' does not work"; fi
+
+APPNAME=example
+
+cfg=$dir/conf_defaults.xml
+fyang=$dir/defaults.yang
+fconfig=$dir/config.xml
+
+cat <<EOF > $fyang
+module defaults{
+   yang-version 1.1;
+   namespace "urn:example:clixon";
+   prefix ex;
+   container x {
+     list y {
+       key "a";
+       leaf a {
+         type int32;
+       }
+       leaf b {
+         type int32;
+         default 42;
+       }
+       container c {
+         leaf d {
+           type string;
+           default "abc";
+         }
+       }
+     }
+     leaf z {
+       type int32;
+       default 17;
+     }
+   }
+}
+EOF
+
+cat <<EOF > $cfg
+<clixon-config xmlns="http://clicon.org/config">
+  <CLICON_CONFIGFILE>$cfg</CLICON_CONFIGFILE>
+  <CLICON_YANG_DIR>${YANG_INSTALLDIR}</CLICON_YANG_DIR>
+  <CLICON_YANG_MAIN_FILE>$fyang</CLICON_YANG_MAIN_FILE>
+  <CLICON_SOCK>/usr/local/var/run/$APPNAME.sock</CLICON_SOCK>
+  <CLICON_BACKEND_PIDFILE>/usr/local/var/run/$APPNAME.pidfile</CLICON_BACKEND_PIDFILE>
+  <CLICON_XMLDB_DIR>$dir</CLICON_XMLDB_DIR>
+  <CLICON_XMLDB_PRETTY>false</CLICON_XMLDB_PRETTY>
+</clixon-config>
+EOF
+
+new "generate config with $perfnr list entries"
+echo -n "<${DATASTORE_TOP}><x xmlns=\"urn:example:clixon\">" > $fconfig
+for (( i=0; i<$perfnr; i++ )); do
+    if [ $i -eq 11 ]; then # One entry with non-default value
+        echo -n "<y><a>$i</a><b>$i</b></y>" >> $fconfig
+    else
+        echo -n "<y><a>$i</a></y>" >> $fconfig
+    fi
+done
+echo "</x></${DATASTORE_TOP}>" >> $fconfig
+cp $fconfig $dir/startup_db
+
+new "test params: -f $cfg"
+if [ $BE -ne 0 ]; then
+    new "kill old backend"
+    sudo clixon_backend -zf $cfg
+    if [ $? -ne 0 ]; then
+        err
+    fi
+    new "start backend -s startup -f $cfg"
+    start_backend -s startup -f $cfg
+fi
+
+new "wait backend"
+wait_backend
+
+new "get default leaf in list entry"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get-config><source><running/></source><filter type=\"xpath\" select=\"/ex:x/ex:y[ex:a=7]/ex:b\" xmlns:ex=\"urn:example:clixon\"/></get-config></rpc>" "" "<rpc-reply $DEFAULTNS><data><x xmlns=\"urn:example:clixon\"><y><a>7</a><b>42</b></y></x></data></rpc-reply>"
+
+new "get default leaf in non-presence container in list entry"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get-config><source><running/></source><filter type=\"xpath\" select=\"/ex:x/ex:y[ex:a=8]/ex:c/ex:d\" xmlns:ex=\"urn:example:clixon\"/></get-config></rpc>" "" "<rpc-reply $DEFAULTNS><data><x xmlns=\"urn:example:clixon\"><y><a>8</a><c><d>abc</d></c></y></x></data></rpc-reply>"
+
+new "get list entry with defaults"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get-config><source><running/></source><filter type=\"xpath\" select=\"/ex:x/ex:y[ex:a=9]\" xmlns:ex=\"urn:example:clixon\"/></get-config></rpc>" "" "<rpc-reply $DEFAULTNS><data><x xmlns=\"urn:example:clixon\"><y><a>9</a><b>42</b><c><d>abc</d></c></y></x></data></rpc-reply>"
+
+new "get list entry with predicate on default leaf"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get-config><source><running/></source><filter type=\"xpath\" select=\"/ex:x/ex:y[ex:b=42][ex:a=7]\" xmlns:ex=\"urn:example:clixon\"/></get-config></rpc>" "" "<rpc-reply $DEFAULTNS><data><x xmlns=\"urn:example:clixon\"><y><a>7</a><b>42</b><c><d>abc</d></c></y></x></data></rpc-reply>"
+
+new "get default leaf below predicate on default leaf"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get-config><source><running/></source><filter type=\"xpath\" select=\"/ex:x/ex:y[ex:a=7][ex:b='42']/ex:c/ex:d\" xmlns:ex=\"urn:example:clixon\"/></get-config></rpc>" "" "<rpc-reply $DEFAULTNS><data><x xmlns=\"urn:example:clixon\"><y><a>7</a><c><d>abc</d></c></y></x></data></rpc-reply>"
+
+new "get list entry with non-default value using predicate on default leaf"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get-config><source><running/></source><filter type=\"xpath\" select=\"/ex:x/ex:y[ex:b!=42]\" xmlns:ex=\"urn:example:clixon\"/></get-config></rpc>" "" "<rpc-reply $DEFAULTNS><data><x xmlns=\"urn:example:clixon\"><y><a>11</a><b>11</b><c><d>abc</d></c></y></x></data></rpc-reply>"
+
+new "get global default leaf"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get-config><source><running/></source><filter type=\"xpath\" select=\"/ex:x/ex:z\" xmlns:ex=\"urn:example:clixon\"/></get-config></rpc>" "" "<rpc-reply $DEFAULTNS><data><x xmlns=\"urn:example:clixon\"><z>17</z></x></data></rpc-reply>"
+
+new "get entries with-defaults explicit"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get-config><source><running/></source><filter type=\"xpath\" select=\"/ex:x/ex:y[ex:a&lt;10]\" xmlns:ex=\"urn:example:clixon\"/><with-defaults xmlns=\"urn:ietf:params:xml:ns:yang:ietf-netconf-with-defaults\">explicit</with-defaults></get-config></rpc>" "" "<rpc-reply $DEFAULTNS><data><x xmlns=\"urn:example:clixon\"><y><a>0</a></y><y><a>1</a></y><y><a>2</a></y><y><a>3</a></y><y><a>4</a></y><y><a>5</a></y><y><a>6</a></y><y><a>7</a></y><y><a>8</a></y><y><a>9</a></y></x></data></rpc-reply>"
+
+new "netconf get $perfreq single default leafs"
+{ time -p for (( i=0; i<$perfreq; i++ )); do
+    rnd=$(( ( RANDOM % $perfnr ) ))
+    rpc=$(chunked_framing "<rpc $DEFAULTNS><get-config><source><running/></source><filter type=\"xpath\" select=\"/ex:x/ex:y[ex:a=$rnd]/ex:c/ex:d\" xmlns:ex=\"urn:example:clixon\"/></get-config></rpc>")
+    echo "$rpc"
+done | $clixon_netconf -qe1f $cfg > /dev/null; } 2>&1 | awk '/real/ {print $2}'
+
+new "netconf get full config with defaults"
+{ time -p expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get-config><source><running/></source></get-config></rpc>" "" "<rpc-reply $DEFAULTNS><data><x xmlns=\"urn:example:clixon\"><y><a>0</a><b>42</b><c><d>abc</d></c></y>" ; } 2>&1 | awk '/real/ {print $2}'
+
+if [ $BE -ne 0 ]; then
+    new "Kill backend"
+    # Check if premature kill
+    pid=$(pgrep -u root -f clixon_backend)
+    if [ -z "$pid" ]; then
+        err "backend already dead"
+    fi
+    # kill backend
+    stop_backend -f $cfg
+fi
+
+rm -rf $dir
+
+new "endtest"
+endtest
@@ -0,0 +1,158 @@
+#!/usr/bin/env bash
+# Leafref validation performance using the leafref target index, see clixon_leafref.c
+# Many references to a large list are validated with one lookup each.
+# Check also relative paths, where each context node has its own target values
+
+# Magic line must be first in script (see README.md)
+s="$_" ; . ./lib.sh || if [ "$s" = $0 ]; then exit 0; else return 0; fi
+
+# Number of list entries
+: ${perfnr:=20000}
+
+: ${TIMEFN:=time -p} # portability: 2>&1 | awk '/real/ {print $2}'
+if ! $TIMEFN true; then err "A working time function" "'$TIMEFN' does not work"; fi
+
+APPNAME=example
+
+cfg=$dir/conf_leafref.xml
+fyang=$dir/leafref.yang
+fconfig=$dir/large.xml
+
+cat <<EOF > $fyang
+module leafref{
+   yang-version 1.1;
+   namespace "urn:example:leafref";
+   prefix l;
+   container a {
+     list x {
+       key k;
+       leaf k {
+         type int32;
+       }
+       leaf ref {
+         type leafref {
+           path "/l:b/l:y/l:k";
+         }
+       }
+     }
+   }
+   container b {
+     list y {
+       key k;
+       leaf k {
+         type int32;
+       }
+     }
+   }
+   container c {
+     list g {
+       key name;
+       leaf name {
+         type string;
+       }
+       leaf-list member {
+         type string;
+       }
+       leaf sel {
+         type leafref {
+           path "../member";
+         }
+       }
+     }
+   }
+}
+EOF
+
+cat <<EOF > $cfg
+<clixon-config xmlns="http://clicon.org/config">
+  <CLICON_CONFIGFILE>$cfg</CLICON_CONFIGFILE>
+  <CLICON_YANG_DIR>${YANG_INSTALLDIR}</CLICON_YANG_DIR>
+  <CLICON_YANG_MAIN_FILE>$fyang</CLICON_YANG_MAIN_FILE>
+  <CLICON_SOCK>/usr/local/var/run/$APPNAME.sock</CLICON_SOCK>
+  <CLICON_BACKEND_PIDFILE>/usr/local/var/run/$APPNAME.pidfile</CLICON_BACKEND_PIDFILE>
+  <CLICON_XMLDB_DIR>$dir</CLICON_XMLDB_DIR>
+  <CLICON_XMLDB_PRETTY>false</CLICON_XMLDB_PRETTY>
+</clixon-config>
+EOF
+
+# Write edit-config replacing candidate with $perfnr references to $fconfig
+# 1: missing target (optional)
+function genconfig()
+{
+    echo -n "$DEFAULTHELLO" > $fconfig
+    rpc="<rpc $DEFAULTNS><edit-config><target><candidate/></target><default-operation>replace</default-operation><config><a xmlns=\"urn:example:leafref\">"
+    for (( i=0; i<$perfnr; i++ )); do
+        rpc+="<x><k>$i</k><ref>$(( $perfnr - $i - 1 ))</ref></x>"
+    done
+    rpc+="</a><b xmlns=\"urn:example:leafref\">"
+    for (( i=0; i<$perfnr; i++ )); do
+        if [ "$i" != "$1" ]; then
+            rpc+="<y><k>$i</k></y>"
+        fi
+    done
+    rpc+="</b></config></edit-config></rpc>"
+    echo "$(chunked_framing "$rpc")" >> $fconfig
+}
+
+new "test params: -f $cfg"
+if [ $BE -ne 0 ]; then
+    new "kill old backend"
+    sudo clixon_backend -zf $cfg
+    if [ $? -ne 0 ]; then
+        err
+    fi
+    new "start backend -s init -f $cfg"
+    start_backend -s init -f $cfg
+fi
+
+new "wait backend"
+wait_backend
+
+new "netconf edit $perfnr references"
+genconfig
+expecteof_file "$clixon_netconf -qef $cfg" 0 "$fconfig" "^<rpc-reply $DEFAULTNS><ok/></rpc-reply>$"
+
+new "netconf commit $perfnr references"
+expecteof_netconf "time -p $clixon_netconf -qef $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><commit/></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>" 2>&1 | awk '/real/ {print $2}'
+
+missing=$(( $perfnr / 2 ))
+new "netconf edit with missing target"
+genconfig $missing
+expecteof_file "$clixon_netconf -qef $cfg" 0 "$fconfig" "^<rpc-reply $DEFAULTNS><ok/></rpc-reply>$"
+
+new "netconf validate missing target"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><validate><source><candidate/></source></validate></rpc>" "<rpc-reply $DEFAULTNS><rpc-error><error-type>application</error-type><error-tag>bad-element</error-tag><error-info><bad-element>$missing</bad-element></error-info>" ""
+
+new "netconf discard-changes"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><discard-changes/></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+new "netconf edit relative references"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><edit-config><target><candidate/></target><config><c xmlns=\"urn:example:leafref\"><g><name>g1</name><member>m1</member><member>m2</member><sel>m2</sel></g><g><name>g2</name><member>m3</member><sel>m3</sel></g></c></config></edit-config></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+new "netconf validate relative references"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><validate><source><candidate/></source></validate></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+new "netconf edit relative reference to other entry"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><edit-config><target><candidate/></target><config><c xmlns=\"urn:example:leafref\"><g><name>g2</name><sel>m1</sel></g></c></config></edit-config></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+new "netconf validate relative reference to other entry"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><validate><source><candidate/></source></validate></rpc>" "<rpc-reply $DEFAULTNS><rpc-error><error-type>application</error-type><error-tag>bad-element</error-tag><error-info><bad-element>m1</bad-element></error-info>" ""
+
+new "netconf discard-changes"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><discard-changes/></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+if [ $BE -ne 0 ]; then
+    new "Kill backend"
+    # Check if premature kill
+    pid=$(pgrep -u root -f clixon_backend)
+    if [ -z "$pid" ]; then
+        err "backend already dead"
+    fi
+    # kill backend
+    stop_backend -f $cfg
+fi
+
+rm -rf $dir
+
+new "endtest"
+endtest
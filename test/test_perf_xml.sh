@@ -1,10 +1,14 @@
 #!/usr/bin/env bash
 # Test: XML performance test (CDATA test only)
 # See https://github.com/clicon/clixon/issues/96
+# Also check that long CDATA and escaped text are printed as parsed, parse throughput of the
+# yacc and hand-written parsers, and the escape scan kernels against a byte-at-a-time
+# reference, see clixon_util_escape
 # Magic line must be first in script (see README.md)
 s="$_" ; . ./lib.sh || if [ "$s" = $0 ]; then exit 0; else return 0; fi
 
 : ${clixon_util_xml:="clixon_util_xml"}
+: ${clixon_util_escape:="clixon_util_escape"}
 
 # Number of list/leaf-list entries in file
 : ${perfnr:=30000}
@@ -24,6 +28,63 @@ echo "]]></stdout></rpc-reply>" >> $fxml
 new "xml parse long CDATA"
 expecteof_file "time -p $clixon_util_xml" 0 "$fxml" 2>&1 | awk '/real/ {print $2}'
 
+new "xml parse long CDATA with hand-written parser"
+expecteof_file "time -p $clixon_util_xml -F" 0 "$fxml" 2>&1 | awk '/real/ {print $2}'
+
+new "xml parse and print long CDATA"
+{ time -p $clixon_util_xml -of $fxml > $dir/out.xml ; } 2>&1 | awk '/real/ {print $2}'
+if [ "$(cat $dir/out.xml)" != "$(cat $fxml)" ]; then
+    err "$fxml" "$(diff $dir/out.xml $fxml)"
+fi
+
+fxml2=$dir/escape.xml
+echo -n "<rpc-reply><stdout>" > $fxml2
+for (( i=0; i<$perfnr; i++ )); do  
+    echo -n "i10.0.0.$i&lt;32&gt; &amp; 10.255.0.20 " >> $fxml2
+done
+echo "</stdout></rpc-reply>" >> $fxml2
+
+new "xml parse and print long escaped text"
+{ time -p $clixon_util_xml -of $fxml2 > $dir/out.xml ; } 2>&1 | awk '/real/ {print $2}'
+if [ "$(cat $dir/out.xml)" != "$(cat $fxml2)" ]; then
+    err "$fxml2" "$(diff $dir/out.xml $fxml2)"
+fi
+
+fxml3=$dir/list.xml
+echo -n "<x>" > $fxml3
+for (( i=0; i<$perfnr; i++ )); do
+    echo "  <y a=\"$i\"><b>$i</b><c>text &amp; $i</c></y>" >> $fxml3
+done
+echo "</x>" >> $fxml3
+
+new "xml parse throughput yacc parser"
+{ time -p $clixon_util_xml -n 10 -of $fxml3 > $dir/out1.xml ; } 2>&1 | awk '/real/ {print $2}'
+
+new "xml parse throughput hand-written parser"
+{ time -p $clixon_util_xml -F -n 10 -of $fxml3 > $dir/out2.xml ; } 2>&1 | awk '/real/ {print $2}'
+if ! cmp -s $dir/out1.xml $dir/out2.xml; then
+    err "$dir/out1.xml" "$(diff $dir/out1.xml $dir/out2.xml | head)"
+fi
+
+for d in 0 1 7 64; do
+    new "xml escape scan density $d"
+    expectpart "$($clixon_util_escape -n 1000 -l 4099 -d $d)" 0 "xml len:4099 density:$d"
+
+    new "json escape scan density $d"
+    expectpart "$($clixon_util_escape -j -n 1000 -l 4099 -d $d)" 0 "json len:4099 density:$d"
+done
+
+# Strings not starting at an aligned address, the last character is special if len is 4098
+for o in $(seq 1 15); do
+    for l in 17 4098; do
+        new "xml escape scan offset $o len $l"
+        expectpart "$($clixon_util_escape -n 1 -l $l -d 3 -o $o)" 0 "xml len:$l density:3 offset:$o"
+
+        new "json escape scan offset $o len $l"
+        expectpart "$($clixon_util_escape -j -n 1 -l $l -d 3 -o $o)" 0 "json len:$l density:3 offset:$o"
+    done
+done
+
 rm -rf $dir
 
 new "endtest"
@@ -0,0 +1,105 @@
+#!/usr/bin/env bash
+# YANG startup performance: load a large set of YANG modules and report total
+# and per-phase times of yang_parse_post (see debug output "yang_parse_post phase")
+# The modules are in a CLICON_YANG_MAIN_DIR and import a common module found via
+# a (recursive) CLICON_YANG_DIR with many unrelated files
+
+# Magic line must be first in script (see README.md)
+s="$_" ; . ./lib.sh || if [ "$s" = $0 ]; then exit 0; else return 0; fi
+
+# Number of generated YANG modules
+: ${perfnr:=300}
+
+# Number of unrelated YANG files in yang dir
+: ${perfdirnr:=1000}
+
+APPNAME=example
+
+cfg=$dir/conf_yang.xml
+maindir=$dir/main
+depdir=$dir/deps
+
+mkdir -p $maindir $depdir/sub
+
+cat <<EOF > $cfg
+<clixon-config xmlns="http://clicon.org/config">
+  <CLICON_CONFIGFILE>$cfg</CLICON_CONFIGFILE>
+  <CLICON_YANG_DIR>${YANG_INSTALLDIR}</CLICON_YANG_DIR>
+  <CLICON_YANG_DIR>$depdir</CLICON_YANG_DIR>
+  <CLICON_YANG_MAIN_DIR>$maindir</CLICON_YANG_MAIN_DIR>
+  <CLICON_SOCK>/usr/local/var/run/$APPNAME.sock</CLICON_SOCK>
+  <CLICON_BACKEND_PIDFILE>/usr/local/var/run/$APPNAME.pidfile</CLICON_BACKEND_PIDFILE>
+  <CLICON_XMLDB_DIR>$dir</CLICON_XMLDB_DIR>
+  <CLICON_FEATURE>ietf-netconf:startup</CLICON_FEATURE>
+</clixon-config>
+EOF
+
+new "generate common module"
+cat <<EOF > $depdir/sub/common.yang
+module common {
+   namespace "urn:example:common";
+   prefix c;
+   grouping entry {
+      leaf name {
+         type string;
+      }
+      leaf value {
+         type uint32 {
+            range "0..1000";
+         }
+      }
+      container sub {
+         leaf-list a {
+            type string;
+         }
+      }
+   }
+}
+EOF
+
+new "generate $perfdirnr unrelated yang files"
+for (( i=0; i<$perfdirnr; i++ )); do
+    echo "module unrelated$i { namespace \"urn:example:u$i\"; prefix u$i; }" > $depdir/sub/unrelated$i.yang
+done
+
+new "generate $perfnr modules"
+for (( i=0; i<$perfnr; i++ )); do
+    cat <<EOF > $maindir/mod$i.yang
+module mod$i {
+   namespace "urn:example:mod$i";
+   prefix m$i;
+   import common {
+      prefix c;
+   }
+   container top$i {
+      list entry {
+         key name;
+         uses c:entry;
+      }
+   }
+   augment "/top$i" {
+      leaf extra {
+         type string;
+      }
+   }
+}
+EOF
+done
+
+if [ $BE -ne 0 ]; then
+    new "kill old backend"
+    sudo clixon_backend -zf $cfg
+    if [ $? -ne 0 ]; then
+        err
+    fi
+fi
+
+new "Startup with $perfnr modules, $perfdirnr files in yang dir"
+# Cannot use start_backend here due to timing
+{ time -p sudo $clixon_backend -F1 -D 1 -l e -s init -f $cfg 2> $dir/phases; } 2>&1 | awk '/real/ {print "total: " $2}'
+grep "yang_parse_post phase" $dir/phases | awk '{print $(NF-1), $NF}'
+
+rm -rf $dir
+
+new "endtest"
+endtest
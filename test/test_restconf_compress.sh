@@ -0,0 +1,165 @@
+#!/usr/bin/env bash
+# Restconf native response compression
+# See CLICON_RESTCONF_COMPRESS_LEVEL and CLICON_RESTCONF_COMPRESS_MIN_SIZE
+# Check gzip and deflate selection by Accept-Encoding, that small replies and clients not
+# accepting compression get uncompressed replies, and that decompressed replies are equal
+
+# Magic line must be first in script (see README.md)
+s="$_" ; . ./lib.sh || if [ "$s" = $0 ]; then exit 0; else return 0; fi
+
+# Does not work with fcgi, compression is made by reverse proxy
+if [ "${WITH_RESTCONF}" = "fcgi" ]; then
+    echo "...skipped: Must run with --with-restconf=native"
+    rm -rf $dir
+    if [ "$s" = $0 ]; then exit 0; else return 0; fi
+fi
+
+# Requires zlib
+if ! echo "$LIBS" | grep -q -- "-lz"; then
+    echo "...skipped: Not built with zlib"
+    rm -rf $dir
+    if [ "$s" = $0 ]; then exit 0; else return 0; fi
+fi
+
+APPNAME=example
+
+cfg=$dir/conf.xml
+fyang=$dir/compress.yang
+
+# Number of list entries
+: ${nr:=100}
+
+# Define default restconfig config: RESTCONFIG
+RESTCONFIG=$(restconf_config none false)
+
+cat <<EOF > $cfg
+<clixon-config xmlns="http://clicon.org/config">
+  <CLICON_FEATURE>clixon-restconf:allow-auth-none</CLICON_FEATURE> <!-- Use auth-type=none -->
+  <CLICON_CONFIGFILE>$cfg</CLICON_CONFIGFILE>
+  <CLICON_YANG_DIR>${YANG_INSTALLDIR}</CLICON_YANG_DIR>
+  <CLICON_YANG_MAIN_FILE>$fyang</CLICON_YANG_MAIN_FILE>
+  <CLICON_SOCK>/usr/local/var/run/$APPNAME.sock</CLICON_SOCK>
+  <CLICON_BACKEND_PIDFILE>$dir/restconf.pidfile</CLICON_BACKEND_PIDFILE>
+  <CLICON_XMLDB_DIR>$dir</CLICON_XMLDB_DIR>
+  <CLICON_RESTCONF_COMPRESS_LEVEL>6</CLICON_RESTCONF_COMPRESS_LEVEL>
+  <CLICON_RESTCONF_COMPRESS_MIN_SIZE>256</CLICON_RESTCONF_COMPRESS_MIN_SIZE>
+  $RESTCONFIG
+</clixon-config>
+EOF
+
+cat <<EOF > $fyang
+module compress{
+   yang-version 1.1;
+   namespace "urn:example:compress";
+   prefix ex;
+   container c{
+      list x{
+        key name;
+        leaf name{
+          type string;
+        }
+        leaf value{
+          type string;
+        }
+      }
+   }
+}
+EOF
+
+new "test params: -f $cfg"
+
+if [ $BE -ne 0 ]; then
+    new "kill old backend"
+    sudo clixon_backend -zf $cfg
+    if [ $? -ne 0 ]; then
+        err
+    fi
+    sudo pkill -f clixon_backend # to be sure
+
+    new "start backend -s init -f $cfg"
+    start_backend -s init -f $cfg
+fi
+
+new "wait backend"
+wait_backend
+
+if [ $RC -ne 0 ]; then
+    new "kill old restconf daemon"
+    stop_restconf_pre
+
+    new "start restconf daemon"
+    start_restconf -f $cfg
+fi
+
+new "wait restconf"
+wait_restconf
+
+new "generate $nr list entries"
+data='{"compress:c":{"x":['
+for (( i=0; i<$nr; i++ )); do
+    if [ $i -ne 0 ]; then
+        data="$data,"
+    fi
+    data="$data{\"name\":\"x$i\",\"value\":\"value of entry $i\"}"
+done
+data="$data]}}"
+
+new "restconf POST $nr entries"
+expectpart "$(curl $CURLOPTS -X POST -H "Content-Type: application/yang-data+json" -d "$data" $RCPROTO://localhost/restconf/data)" 0 "HTTP/$HVER 201"
+
+new "restconf GET not accepting compression"
+expectpart "$(curl $CURLOPTS -X GET $RCPROTO://localhost/restconf/data/compress:c)" 0 "HTTP/$HVER 200" "Vary: Accept-Encoding" '{"compress:c":{"x":\[{"name":"x0","value":"value of entry 0"}' --not-- "Content-Encoding"
+
+new "restconf GET gzip"
+expectpart "$(curl $CURLOPTS -X GET -H "Accept-Encoding: gzip" $RCPROTO://localhost/restconf/data/compress:c -o /dev/null -D -)" 0 "HTTP/$HVER 200" "Content-Encoding: gzip" "Vary: Accept-Encoding"
+
+new "restconf GET deflate"
+expectpart "$(curl $CURLOPTS -X GET -H "Accept-Encoding: deflate" $RCPROTO://localhost/restconf/data/compress:c -o /dev/null -D -)" 0 "HTTP/$HVER 200" "Content-Encoding: deflate"
+
+new "restconf GET gzip not acceptable"
+expectpart "$(curl $CURLOPTS -X GET -H "Accept-Encoding: gzip;q=0, br" $RCPROTO://localhost/restconf/data/compress:c)" 0 "HTTP/$HVER 200" '{"compress:c":{"x":\[{"name":"x0","value":"value of entry 0"}' --not-- "Content-Encoding"
+
+new "restconf GET small reply not compressed"
+expectpart "$(curl $CURLOPTS -X GET -H "Accept-Encoding: gzip" $RCPROTO://localhost/restconf/data/compress:c/x=x0)" 0 "HTTP/$HVER 200" '{"compress:x":\[{"name":"x0","value":"value of entry 0"}\]}' --not-- "Content-Encoding" "Vary"
+
+# Remove -i option to compare bodies
+CURLOPTS2=$(echo $CURLOPTS | sed 's/i//')
+curl $CURLOPTS2 -X GET $RCPROTO://localhost/restconf/data/compress:c -o $dir/plain.json
+
+new "restconf GET gzip decompressed equal"
+curl $CURLOPTS2 --compressed -X GET $RCPROTO://localhost/restconf/data/compress:c -o $dir/gzip.json
+if ! cmp -s $dir/plain.json $dir/gzip.json; then
+    err "$(head -c 200 $dir/plain.json)" "$(head -c 200 $dir/gzip.json)"
+fi
+
+if [ ${HAVE_HTTP1} = true ]; then
+    new "restconf GET gzip http/1"
+    expectpart "$(curl $CURLOPTS --http1.1 -X GET -H "Accept-Encoding: gzip" $RCPROTO://localhost/restconf/data/compress:c -o /dev/null -D -)" 0 "HTTP/1.1 200" "Content-Encoding: gzip" "Content-Length:"
+
+    new "restconf GET gzip http/1 decompressed equal"
+    curl $CURLOPTS2 --http1.1 --compressed -X GET $RCPROTO://localhost/restconf/data/compress:c -o $dir/gzip1.json
+    if ! cmp -s $dir/plain.json $dir/gzip1.json; then
+        err "$(head -c 200 $dir/plain.json)" "$(head -c 200 $dir/gzip1.json)"
+    fi
+fi
+
+if [ $RC -ne 0 ]; then
+    new "Kill restconf daemon"
+    stop_restconf
+fi
+
+if [ $BE -ne 0 ]; then
+    new "Kill backend"
+    # Check if premature kill
+    pid=$(pgrep -u root -f clixon_backend)
+    if [ -z "$pid" ]; then
+        err "backend already dead"
+    fi
+    # kill backend
+    stop_backend -f $cfg
+fi
+
+rm -rf $dir
+
+new "endtest"
+endtest
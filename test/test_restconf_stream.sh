@@ -0,0 +1,183 @@
+#!/usr/bin/env bash
+# Restconf GET replies are produced in parts when sent, see restconf_reply_send_stream
+# Check that large replies in JSON and XML are complete and equal over http/1 and http/2,
+# also several in parallel on one connection, compressed, and that HEAD gives the length
+
+# Magic line must be first in script (see README.md)
+s="$_" ; . ./lib.sh || if [ "$s" = $0 ]; then exit 0; else return 0; fi
+
+APPNAME=example
+
+cfg=$dir/conf.xml
+fyang=$dir/stream.yang
+
+# Number of list entries, reply should be several parts
+: ${nr:=5000}
+
+# Define default restconfig config: RESTCONFIG
+RESTCONFIG=$(restconf_config none false)
+
+cat <<EOF > $cfg
+<clixon-config xmlns="http://clicon.org/config">
+  <CLICON_FEATURE>clixon-restconf:allow-auth-none</CLICON_FEATURE> <!-- Use auth-type=none -->
+  <CLICON_CONFIGFILE>$cfg</CLICON_CONFIGFILE>
+  <CLICON_YANG_DIR>${YANG_INSTALLDIR}</CLICON_YANG_DIR>
+  <CLICON_YANG_MAIN_FILE>$fyang</CLICON_YANG_MAIN_FILE>
+  <CLICON_SOCK>/usr/local/var/run/$APPNAME.sock</CLICON_SOCK>
+  <CLICON_BACKEND_PIDFILE>$dir/restconf.pidfile</CLICON_BACKEND_PIDFILE>
+  <CLICON_XMLDB_DIR>$dir</CLICON_XMLDB_DIR>
+  $RESTCONFIG
+</clixon-config>
+EOF
+
+cat <<EOF > $fyang
+module stream{
+   yang-version 1.1;
+   namespace "urn:example:stream";
+   prefix ex;
+   container c{
+      list x{
+        key name;
+        leaf name{
+          type string;
+        }
+        leaf value{
+          type string;
+        }
+      }
+   }
+}
+EOF
+
+new "test params: -f $cfg"
+
+if [ $BE -ne 0 ]; then
+    new "kill old backend"
+    sudo clixon_backend -zf $cfg
+    if [ $? -ne 0 ]; then
+        err
+    fi
+    sudo pkill -f clixon_backend # to be sure
+
+    new "start backend -s init -f $cfg"
+    start_backend -s init -f $cfg
+fi
+
+new "wait backend"
+wait_backend
+
+if [ $RC -ne 0 ]; then
+    new "kill old restconf daemon"
+    stop_restconf_pre
+
+    new "start restconf daemon"
+    start_restconf -f $cfg
+fi
+
+new "wait restconf"
+wait_restconf
+
+new "generate $nr list entries"
+data='{"stream:c":{"x":['
+for (( i=0; i<$nr; i++ )); do
+    if [ $i -ne 0 ]; then
+        data="$data,"
+    fi
+    data="$data{\"name\":\"x$i\",\"value\":\"value of entry $i\"}"
+done
+data="$data]}}"
+
+new "restconf POST $nr entries"
+expectpart "$(curl $CURLOPTS -X POST -H "Content-Type: application/yang-data+json" -d "$data" $RCPROTO://localhost/restconf/data)" 0 "HTTP/$HVER 201"
+
+let last=$nr-1
+
+new "restconf GET json"
+expectpart "$(curl $CURLOPTS -X GET $RCPROTO://localhost/restconf/data/stream:c)" 0 "HTTP/$HVER 200" "Content-Type: application/yang-data+json" '{"stream:c":{"x":\[{"name":"x0","value":"value of entry 0"}' "{\"name\":\"x$last\",\"value\":\"value of entry $last\"}\]}}"
+
+new "restconf GET xml"
+expectpart "$(curl $CURLOPTS -X GET -H "Accept: application/yang-data+xml" $RCPROTO://localhost/restconf/data/stream:c)" 0 "HTTP/$HVER 200" "Content-Type: application/yang-data+xml" '<c xmlns="urn:example:stream"><x><name>x0</name><value>value of entry 0</value></x>' "<x><name>x$last</name><value>value of entry $last</value></x></c>"
+
+new "restconf GET xml data root"
+expectpart "$(curl $CURLOPTS -X GET -H "Accept: application/yang-data+xml" $RCPROTO://localhost/restconf/data)" 0 "HTTP/$HVER 200" '<data' "<x><name>x$last</name><value>value of entry $last</value></x></c>"
+
+new "restconf GET small reply"
+expectpart "$(curl $CURLOPTS -X GET $RCPROTO://localhost/restconf/data/stream:c/x=x0)" 0 "HTTP/$HVER 200" '{"stream:x":\[{"name":"x0","value":"value of entry 0"}\]}'
+
+# Remove -i option to compare bodies
+CURLOPTS2=$(echo $CURLOPTS | sed 's/i//')
+curl $CURLOPTS2 -X GET $RCPROTO://localhost/restconf/data/stream:c -o $dir/json1
+curl $CURLOPTS2 -X GET -H "Accept: application/yang-data+xml" $RCPROTO://localhost/restconf/data/stream:c -o $dir/xml1
+
+new "restconf GET json is valid"
+if ! python3 -m json.tool $dir/json1 > /dev/null; then
+    err "valid json" "$(tail -c 200 $dir/json1)"
+fi
+
+new "restconf GET pretty json is valid"
+curl $CURLOPTS2 -X GET $RCPROTO://localhost/restconf/data/stream:c?pretty=true -o $dir/pretty
+if ! python3 -m json.tool $dir/pretty > /dev/null; then
+    err "valid json" "$(tail -c 200 $dir/pretty)"
+fi
+
+if [ "${WITH_RESTCONF}" = "native" ]; then
+    if [ ${HVER} = 2 ]; then
+        new "restconf GET http/2 without Content-Length"
+        expectpart "$(curl $CURLOPTS -X GET $RCPROTO://localhost/restconf/data/stream:c -o /dev/null -D -)" 0 "HTTP/$HVER 200" --not-- "Content-Length"
+    fi
+
+    new "restconf HEAD Content-Length"
+    len=$(stat -c %s $dir/json1)
+    expectpart "$(curl $CURLOPTS -I $RCPROTO://localhost/restconf/data/stream:c)" 0 "HTTP/$HVER 200" "Content-Length: $len"
+
+    if echo "$LIBS" | grep -q -- "-lz"; then
+        new "restconf GET gzip decompressed equal"
+        curl $CURLOPTS2 --compressed -X GET $RCPROTO://localhost/restconf/data/stream:c -o $dir/gzip
+        if ! cmp -s $dir/json1 $dir/gzip; then
+            err "$(tail -c 200 $dir/json1)" "$(tail -c 200 $dir/gzip)"
+        fi
+    fi
+fi
+
+if [ ${HAVE_HTTP1} = true ]; then
+    new "restconf GET json http/1 equal"
+    curl $CURLOPTS2 --http1.1 -X GET $RCPROTO://localhost/restconf/data/stream:c -o $dir/json2
+    if ! cmp -s $dir/json1 $dir/json2; then
+        err "$(tail -c 200 $dir/json1)" "$(tail -c 200 $dir/json2)"
+    fi
+
+    new "restconf GET xml http/1 equal"
+    curl $CURLOPTS2 --http1.1 -X GET -H "Accept: application/yang-data+xml" $RCPROTO://localhost/restconf/data/stream:c -o $dir/xml2
+    if ! cmp -s $dir/xml1 $dir/xml2; then
+        err "$(tail -c 200 $dir/xml1)" "$(tail -c 200 $dir/xml2)"
+    fi
+fi
+
+new "restconf GET json in parallel equal"
+curl $CURLOPTS2 --parallel --parallel-immediate -X GET $RCPROTO://localhost/restconf/data/stream:c -o $dir/p1 $RCPROTO://localhost/restconf/data/stream:c -o $dir/p2 $RCPROTO://localhost/restconf/data/stream:c -o $dir/p3
+for p in p1 p2 p3; do
+    if ! cmp -s $dir/json1 $dir/$p; then
+        err "$(tail -c 200 $dir/json1)" "$(tail -c 200 $dir/$p)"
+    fi
+done
+
+if [ $RC -ne 0 ]; then
+    new "Kill restconf daemon"
+    stop_restconf
+fi
+
+if [ $BE -ne 0 ]; then
+    new "Kill backend"
+    # Check if premature kill
+    pid=$(pgrep -u root -f clixon_backend)
+    if [ -z "$pid" ]; then
+        err "backend already dead"
+    fi
+    # kill backend
+    stop_backend -f $cfg
+fi
+
+rm -rf $dir
+
+new "endtest"
+endtest
@@ -0,0 +1,117 @@
+#!/usr/bin/env bash
+# Netconf notification replay from the on-disk replay log, see CLICON_STREAM_REPLAY_DIR
+# Check that:
+# - events are appended to segment files
+# - a replay with startTime in the past is served from disk
+# - the log is re-indexed and replayed after a backend restart
+# @see test_netconf_notifications.sh
+
+# Magic line must be first in script (see README.md)
+s="$_" ; . ./lib.sh || if [ "$s" = $0 ]; then exit 0; else return 0; fi
+
+APPNAME=example
+
+NCWAIT=3
+
+cfg=$dir/conf.xml
+fyang=$dir/example.yang
+replaydir=$dir/replay
+
+cat <<EOF > $cfg
+<clixon-config xmlns="http://clicon.org/config">
+  <CLICON_CONFIGFILE>$cfg</CLICON_CONFIGFILE>
+  <CLICON_YANG_DIR>${YANG_INSTALLDIR}</CLICON_YANG_DIR>
+  <CLICON_YANG_MAIN_FILE>$fyang</CLICON_YANG_MAIN_FILE>
+  <CLICON_SOCK>/usr/local/var/run/$APPNAME.sock</CLICON_SOCK>
+  <CLICON_BACKEND_DIR>/usr/local/lib/$APPNAME/backend</CLICON_BACKEND_DIR>
+  <CLICON_BACKEND_REGEXP>example_backend.so$</CLICON_BACKEND_REGEXP>
+  <CLICON_BACKEND_PIDFILE>/usr/local/var/run/$APPNAME.pidfile</CLICON_BACKEND_PIDFILE>
+  <CLICON_XMLDB_DIR>/usr/local/var/$APPNAME</CLICON_XMLDB_DIR>
+  <CLICON_STREAM_RETENTION>3600</CLICON_STREAM_RETENTION>
+  <CLICON_STREAM_REPLAY_DIR>$replaydir</CLICON_STREAM_REPLAY_DIR>
+  <CLICON_STREAM_REPLAY_SEGMENT>5</CLICON_STREAM_REPLAY_SEGMENT>
+</clixon-config>
+EOF
+
+cat <<EOF > $fyang
+module example {
+   namespace "urn:example:clixon";
+   prefix ex;
+   notification event {
+      leaf event-class {
+         type string;
+      }
+      container reportingEntity {
+         leaf card {
+            type string;
+         }
+      }
+      leaf severity {
+         type string;
+      }
+   }
+}
+EOF
+
+# Start time before any event is generated
+START=$(date -u +"%Y-%m-%dT%H:%M:%SZ")
+
+new "test params: -f $cfg"
+
+if [ $BE -ne 0 ]; then
+    new "kill old backend"
+    sudo clixon_backend -zf $cfg
+    if [ $? -ne 0 ]; then
+        err
+    fi
+    sudo rm -rf $replaydir
+    new "start backend -s init -f $cfg -- -n"
+    start_backend -s init -f $cfg -- -n # create example notification stream
+fi
+
+new "wait backend"
+wait_backend
+
+new "Generate some events"
+sleep 12
+
+new "Check segment files"
+nr=$(sudo ls $replaydir/EXAMPLE | grep -c "\.log$")
+if [ $nr -lt 1 ]; then
+    err "at least one segment" "$nr"
+fi
+
+new "netconf EXAMPLE subscription with replay from disk"
+expectwait "$clixon_netconf -D $DBG -qef $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><create-subscription xmlns=\"urn:ietf:params:xml:ns:netmod:notification\"><stream>EXAMPLE</stream><startTime>$START</startTime></create-subscription></rpc>" $NCWAIT "<rpc-reply $DEFAULTNS><ok/></rpc-reply>" "<notification xmlns=\"urn:ietf:params:xml:ns:netconf:notification:1.0\"><eventTime>20" "<event xmlns=\"urn:example:clixon\"><event-class>fault</event-class>"
+
+if [ $BE -ne 0 ]; then
+    new "Restart backend"
+    stop_backend -f $cfg
+    start_backend -s init -f $cfg -- -n
+fi
+
+new "wait backend"
+wait_backend
+
+new "netconf EXAMPLE replay after restart"
+expectwait "$clixon_netconf -D $DBG -qef $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><create-subscription xmlns=\"urn:ietf:params:xml:ns:netmod:notification\"><stream>EXAMPLE</stream><startTime>$START</startTime></create-subscription></rpc>" $NCWAIT "<rpc-reply $DEFAULTNS><ok/></rpc-reply>" "<notification xmlns=\"urn:ietf:params:xml:ns:netconf:notification:1.0\"><eventTime>20" "<event xmlns=\"urn:example:clixon\"><event-class>fault</event-class>"
+
+new "netconf EXAMPLE replay after restart with filter on event body"
+expectwait "$clixon_netconf -D $DBG -qef $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><create-subscription xmlns=\"urn:ietf:params:xml:ns:netmod:notification\"><stream>EXAMPLE</stream><filter type=\"xpath\" select=\"event[event-class='fault']\"/><startTime>$START</startTime></create-subscription></rpc>" $NCWAIT "<rpc-reply $DEFAULTNS><ok/></rpc-reply>" "<notification xmlns=\"urn:ietf:params:xml:ns:netconf:notification:1.0\"><eventTime>20" "<event xmlns=\"urn:example:clixon\"><event-class>fault</event-class>"
+
+if [ $BE -ne 0 ]; then
+    new "Kill backend"
+    # Check if premature kill
+    pid=$(pgrep -u root -f clixon_backend)
+    if [ -z "$pid" ]; then
+        err "backend already dead"
+    fi
+    # kill backend
+    stop_backend -f $cfg
+fi
+
+sudo rm -rf $replaydir
+rm -rf $dir
+
+new "endtest"
+endtest
@@ -0,0 +1,178 @@
+#!/usr/bin/env bash
+# Incremental validation of commits, see CLICON_VALIDATE_INCREMENTAL
+# Only changes to running and constraints depending on them are validated.
+# Check that changes elsewhere in the tree violating leafref, must, when, mandatory, unique
+# and min-elements constraints of unchanged nodes are detected
+
+# Magic line must be first in script (see README.md)
+s="$_" ; . ./lib.sh || if [ "$s" = $0 ]; then exit 0; else return 0; fi
+
+APPNAME=example
+
+cfg=$dir/conf_incr.xml
+fyang=$dir/incr.yang
+
+cat <<EOF > $fyang
+module incr{
+   yang-version 1.1;
+   namespace "urn:example:incr";
+   prefix i;
+   container b {
+     list y {
+       key k;
+       leaf k {
+         type string;
+       }
+     }
+   }
+   container c {
+     leaf limit {
+       type int32;
+       default 100;
+     }
+     leaf enable {
+       type boolean;
+       default true;
+     }
+   }
+   container a {
+     list x {
+       key name;
+       min-elements 2;
+       unique port;
+       leaf name {
+         type string;
+       }
+       leaf ref {
+         type leafref {
+           path "/i:b/i:y/i:k";
+         }
+       }
+       leaf v {
+         type int32;
+         must ". <= /i:c/i:limit" {
+           error-message "v exceeds limit";
+         }
+       }
+       leaf port {
+         type uint16;
+       }
+       leaf mand {
+         type string;
+         mandatory true;
+       }
+     }
+   }
+   container d {
+     leaf e {
+       type string;
+       when "../../i:c/i:enable = 'true'";
+     }
+   }
+}
+EOF
+
+cat <<EOF > $cfg
+<clixon-config xmlns="http://clicon.org/config">
+  <CLICON_CONFIGFILE>$cfg</CLICON_CONFIGFILE>
+  <CLICON_YANG_DIR>${YANG_INSTALLDIR}</CLICON_YANG_DIR>
+  <CLICON_YANG_MAIN_FILE>$fyang</CLICON_YANG_MAIN_FILE>
+  <CLICON_SOCK>/usr/local/var/run/$APPNAME.sock</CLICON_SOCK>
+  <CLICON_BACKEND_PIDFILE>/usr/local/var/run/$APPNAME.pidfile</CLICON_BACKEND_PIDFILE>
+  <CLICON_XMLDB_DIR>$dir</CLICON_XMLDB_DIR>
+  <CLICON_VALIDATE_INCREMENTAL>true</CLICON_VALIDATE_INCREMENTAL>
+</clixon-config>
+EOF
+
+cat <<EOF > $dir/startup_db
+<${DATASTORE_TOP}>
+  <b xmlns="urn:example:incr">
+    <y><k>p</k></y>
+    <y><k>q</k></y>
+  </b>
+  <a xmlns="urn:example:incr">
+    <x><name>n1</name><ref>p</ref><v>50</v><port>1</port><mand>m</mand></x>
+    <x><name>n2</name><ref>q</ref><v>60</v><port>2</port><mand>m</mand></x>
+  </a>
+  <d xmlns="urn:example:incr">
+    <e>hello</e>
+  </d>
+</${DATASTORE_TOP}>
+EOF
+
+# Edit candidate, validate and discard changes
+# 1: edit-config config content
+# 2: expected validate reply (regexp)
+function editvalidate()
+{
+    new "netconf edit $1"
+    expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><edit-config><target><candidate/></target><config>$1</config></edit-config></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+    new "netconf validate"
+    expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><validate><source><candidate/></source></validate></rpc>" "$2" ""
+
+    new "netconf discard-changes"
+    expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><discard-changes/></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+}
+
+NCOP="xmlns:nc=\"urn:ietf:params:xml:ns:netconf:base:1.0\" nc:operation=\"delete\""
+
+new "test params: -f $cfg"
+if [ $BE -ne 0 ]; then
+    new "kill old backend"
+    sudo clixon_backend -zf $cfg
+    if [ $? -ne 0 ]; then
+        err
+    fi
+    new "start backend -s startup -f $cfg"
+    start_backend -s startup -f $cfg
+fi
+
+new "wait backend"
+wait_backend
+
+new "netconf edit valid change"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><edit-config><target><candidate/></target><config><a xmlns=\"urn:example:incr\"><x><name>n1</name><v>70</v></x><x><name>n3</name><ref>p</ref><port>3</port><mand>m</mand></x></a></config></edit-config></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+new "netconf commit valid change"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><commit/></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+# Leafref of unchanged entry n2 refers to deleted entry
+editvalidate "<b xmlns=\"urn:example:incr\"><y $NCOP><k>q</k></y></b>" "<error-tag>bad-element</error-tag><error-info><bad-element>q</bad-element></error-info>"
+
+# Must of unchanged entries refers to changed limit
+editvalidate "<c xmlns=\"urn:example:incr\"><limit>65</limit></c>" "<error-message>v exceeds limit</error-message>"
+
+# When of unchanged leaf refers to changed leaf
+editvalidate "<c xmlns=\"urn:example:incr\"><enable>false</enable></c>" "<error-message>Failed WHEN condition of e in module incr"
+
+# Mandatory leaf deleted
+editvalidate "<a xmlns=\"urn:example:incr\"><x><name>n2</name><mand $NCOP/></x></a>" "<error-tag>missing-element</error-tag>"
+
+# Unique violated by changed leaf
+editvalidate "<a xmlns=\"urn:example:incr\"><x><name>n2</name><port>1</port></x></a>" "<error-app-tag>data-not-unique</error-app-tag>"
+
+# min-elements violated by deleting entries
+editvalidate "<a xmlns=\"urn:example:incr\"><x $NCOP><name>n1</name></x><x $NCOP><name>n3</name></x></a>" "<error-app-tag>too-few-elements</error-app-tag>"
+
+new "netconf edit valid change after failures"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><edit-config><target><candidate/></target><config><c xmlns=\"urn:example:incr\"><limit>80</limit></c></config></edit-config></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+new "netconf commit"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><commit/></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+if [ $BE -ne 0 ]; then
+    new "Kill backend"
+    # Check if premature kill
+    pid=$(pgrep -u root -f clixon_backend)
+    if [ -z "$pid" ]; then
+        err "backend already dead"
+    fi
+    # kill backend
+    stop_backend -f $cfg
+fi
+
+rm -rf $dir
+
+new "endtest"
+endtest
@@ -0,0 +1,167 @@
+#!/usr/bin/env bash
+# Parallel validation using worker processes, see CLICON_VALIDATE_WORKERS
+# A large list is split among workers. Check that valid configs commit, and that
+# if several entries fail, the first in document order is reported, as in sequential
+# validation
+
+# Magic line must be first in script (see README.md)
+s="$_" ; . ./lib.sh || if [ "$s" = $0 ]; then exit 0; else return 0; fi
+
+# Number of list entries
+: ${perfnr:=10000}
+
+APPNAME=example
+
+cfg=$dir/conf_workers.xml
+fyang=$dir/workers.yang
+fconfig=$dir/large.xml
+
+cat <<EOF > $fyang
+module workers{
+   yang-version 1.1;
+   namespace "urn:example:workers";
+   prefix w;
+   container a {
+     list x {
+       key k;
+       leaf k {
+         type int32;
+       }
+       leaf ref {
+         type leafref {
+           path "/w:b/w:y/w:k";
+         }
+       }
+       leaf v {
+         type int32;
+         must ". < 1000" {
+           error-message "v too large";
+         }
+       }
+     }
+   }
+   container b {
+     list y {
+       key k;
+       leaf k {
+         type int32;
+       }
+     }
+     leaf w {
+       type int32;
+       must ". < 10" {
+         error-message "w too large";
+       }
+     }
+   }
+}
+EOF
+
+cat <<EOF > $cfg
+<clixon-config xmlns="http://clicon.org/config">
+  <CLICON_CONFIGFILE>$cfg</CLICON_CONFIGFILE>
+  <CLICON_YANG_DIR>${YANG_INSTALLDIR}</CLICON_YANG_DIR>
+  <CLICON_YANG_MAIN_FILE>$fyang</CLICON_YANG_MAIN_FILE>
+  <CLICON_SOCK>/usr/local/var/run/$APPNAME.sock</CLICON_SOCK>
+  <CLICON_BACKEND_PIDFILE>/usr/local/var/run/$APPNAME.pidfile</CLICON_BACKEND_PIDFILE>
+  <CLICON_XMLDB_DIR>$dir</CLICON_XMLDB_DIR>
+  <CLICON_XMLDB_PRETTY>false</CLICON_XMLDB_PRETTY>
+  <CLICON_VALIDATE_WORKERS>4</CLICON_VALIDATE_WORKERS>
+</clixon-config>
+EOF
+
+# Write edit-config replacing candidate with $perfnr entries to $fconfig
+# 1: entries with dangling leafref (optional)
+# 2: entry with too large value (optional)
+# 3: value of w (optional)
+function genconfig()
+{
+    echo -n "$DEFAULTHELLO" > $fconfig
+    rpc="<rpc $DEFAULTNS><edit-config><target><candidate/></target><default-operation>replace</default-operation><config><a xmlns=\"urn:example:workers\">"
+    for (( i=0; i<$perfnr; i++ )); do
+        rpc+="<x><k>$i</k><ref>$i</ref><v>1</v></x>"
+    done
+    rpc+="</a><b xmlns=\"urn:example:workers\">"
+    for (( i=0; i<$perfnr; i++ )); do
+        if [[ " $1 " != *" $i "* ]]; then
+            rpc+="<y><k>$i</k></y>"
+        fi
+    done
+    rpc+="<w>${3:-1}</w>"
+    rpc+="</b></config></edit-config></rpc>"
+    if [ -n "$2" ]; then
+        rpc=${rpc/<x><k>$2<\/k><ref>$2<\/ref><v>1<\/v>/<x><k>$2<\/k><ref>$2<\/ref><v>1000<\/v>}
+    fi
+    echo "$(chunked_framing "$rpc")" >> $fconfig
+}
+
+new "test params: -f $cfg"
+if [ $BE -ne 0 ]; then
+    new "kill old backend"
+    sudo clixon_backend -zf $cfg
+    if [ $? -ne 0 ]; then
+        err
+    fi
+    new "start backend -s init -f $cfg"
+    start_backend -s init -f $cfg
+fi
+
+new "wait backend"
+wait_backend
+
+new "netconf edit $perfnr valid entries"
+genconfig
+expecteof_file "$clixon_netconf -qef $cfg" 0 "$fconfig" "^<rpc-reply $DEFAULTNS><ok/></rpc-reply>$"
+
+new "netconf validate ok"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><validate><source><candidate/></source></validate></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+new "netconf commit"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><commit/></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+new "netconf edit with dangling leafrefs in two entries"
+genconfig "$(( $perfnr * 3 / 4 )) $(( $perfnr / 4 ))"
+expecteof_file "$clixon_netconf -qef $cfg" 0 "$fconfig" "^<rpc-reply $DEFAULTNS><ok/></rpc-reply>$"
+
+new "netconf validate reports first entry"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><validate><source><candidate/></source></validate></rpc>" "<rpc-reply $DEFAULTNS><rpc-error><error-type>application</error-type><error-tag>bad-element</error-tag><error-info><bad-element>$(( $perfnr / 4 ))</bad-element></error-info>" ""
+
+new "netconf edit with must failure before dangling leafref"
+genconfig "$(( $perfnr / 2 ))" "$(( $perfnr / 2 - 1 ))"
+expecteof_file "$clixon_netconf -qef $cfg" 0 "$fconfig" "^<rpc-reply $DEFAULTNS><ok/></rpc-reply>$"
+
+new "netconf validate reports must failure"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><validate><source><candidate/></source></validate></rpc>" "" "<rpc-reply $DEFAULTNS><rpc-error><error-type>application</error-type><error-tag>operation-failed</error-tag><error-severity>error</error-severity><error-message>v too large</error-message></rpc-error></rpc-reply>"
+
+new "netconf edit with must failure after dangling leafref"
+genconfig "$(( $perfnr - 1 ))" "" 10
+expecteof_file "$clixon_netconf -qef $cfg" 0 "$fconfig" "^<rpc-reply $DEFAULTNS><ok/></rpc-reply>$"
+
+new "netconf validate reports dangling leafref"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><validate><source><candidate/></source></validate></rpc>" "<rpc-reply $DEFAULTNS><rpc-error><error-type>application</error-type><error-tag>bad-element</error-tag><error-info><bad-element>$(( $perfnr - 1 ))</bad-element></error-info>" ""
+
+new "netconf edit with must failure in last subtree"
+genconfig "" "" 10
+expecteof_file "$clixon_netconf -qef $cfg" 0 "$fconfig" "^<rpc-reply $DEFAULTNS><ok/></rpc-reply>$"
+
+new "netconf validate reports must failure in last subtree"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><validate><source><candidate/></source></validate></rpc>" "" "<rpc-reply $DEFAULTNS><rpc-error><error-type>application</error-type><error-tag>operation-failed</error-tag><error-severity>error</error-severity><error-message>w too large</error-message></rpc-error></rpc-reply>"
+
+new "netconf discard-changes"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><discard-changes/></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+if [ $BE -ne 0 ]; then
+    new "Kill backend"
+    # Check if premature kill
+    pid=$(pgrep -u root -f clixon_backend)
+    if [ -z "$pid" ]; then
+        err "backend already dead"
+    fi
+    # kill backend
+    stop_backend -f $cfg
+fi
+
+rm -rf $dir
+
+new "endtest"
+endtest
@@ -0,0 +1,140 @@
+#!/usr/bin/env bash
+# Large list with inserts, deletes, searches and bulk merge across child vector chunks
+# The chunked child vector is enabled by XML_CHILDVEC_CHUNKED in clixon_custom.h
+# A list with more than 8192 entries is converted to chunks of 512 entries on the first
+# insert in the middle, entries around the chunk boundaries are checked after each change.
+
+# Magic line must be first in script (see README.md)
+s="$_" ; . ./lib.sh || if [ "$s" = $0 ]; then exit 0; else return 0; fi
+
+# Number of list entries in datastore, must be above chunk threshold (8192)
+: ${perfnr:=10000}
+
+APPNAME=example
+
+cfg=$dir/conf_chunk.xml
+fyang=$dir/chunk.yang
+fconfig=$dir/config.xml
+
+cat <<EOF > $fyang
+module chunk{
+   yang-version 1.1;
+   namespace "urn:example:clixon";
+   prefix ex;
+   container x {
+     list y {
+       key "a";
+       leaf a {
+         type int32;
+       }
+       leaf b {
+         type string;
+       }
+     }
+   }
+}
+EOF
+
+cat <<EOF > $cfg
+<clixon-config xmlns="http://clicon.org/config">
+  <CLICON_CONFIGFILE>$cfg</CLICON_CONFIGFILE>
+  <CLICON_YANG_DIR>${YANG_INSTALLDIR}</CLICON_YANG_DIR>
+  <CLICON_YANG_MAIN_FILE>$fyang</CLICON_YANG_MAIN_FILE>
+  <CLICON_SOCK>/usr/local/var/run/$APPNAME.sock</CLICON_SOCK>
+  <CLICON_BACKEND_PIDFILE>/usr/local/var/run/$APPNAME.pidfile</CLICON_BACKEND_PIDFILE>
+  <CLICON_XMLDB_DIR>$dir</CLICON_XMLDB_DIR>
+  <CLICON_XMLDB_PRETTY>false</CLICON_XMLDB_PRETTY>
+</clixon-config>
+EOF
+
+# Get entries with keys in the interval [$1, $2] from running
+function getrange()
+{
+    rpc=$(chunked_framing "<rpc $DEFAULTNS><get-config><source><running/></source><filter type=\"xpath\" select=\"/ex:x/ex:y[ex:a&gt;=$1 and ex:a&lt;=$2]/ex:a\" xmlns:ex=\"urn:example:clixon\"/></get-config></rpc>")
+    echo "$DEFAULTHELLO$rpc" | $clixon_netconf -qef $cfg
+}
+
+new "generate startup with $perfnr even keys in reverse order"
+echo -n "<${DATASTORE_TOP}><x xmlns=\"urn:example:clixon\">" > $fconfig
+for (( i=$perfnr-1; i>=0; i-- )); do
+    echo -n "<y><a>$((2*i))</a></y>" >> $fconfig
+done
+echo "</x></${DATASTORE_TOP}>" >> $fconfig
+cp $fconfig $dir/startup_db
+
+new "test params: -f $cfg"
+if [ $BE -ne 0 ]; then
+    new "kill old backend"
+    sudo clixon_backend -zf $cfg
+    if [ $? -ne 0 ]; then
+        err
+    fi
+    new "start backend -s startup -f $cfg"
+    start_backend -s startup -f $cfg
+fi
+
+new "wait backend"
+wait_backend
+
+new "startup sorted"
+expectpart "$(getrange 1020 1030)" 0 "<y><a>1020</a></y><y><a>1022</a></y><y><a>1024</a></y><y><a>1026</a></y><y><a>1028</a></y><y><a>1030</a></y></x>"
+
+new "insert single entry in the middle"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><edit-config><target><candidate/></target><config><x xmlns=\"urn:example:clixon\"><y><a>1023</a><b>mid</b></y></x></config></edit-config></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+new "insert many entries in one chunk"
+rpc="<rpc $DEFAULTNS><edit-config><target><candidate/></target><config><x xmlns=\"urn:example:clixon\">"
+for (( i=1; i<1200; i+=2 )); do
+    rpc+="<y><a>$i</a></y>"
+done
+rpc+="</x></config></edit-config></rpc>"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "$rpc" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+new "delete entries at chunk boundary"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><edit-config><target><candidate/></target><config><x xmlns=\"urn:example:clixon\" xmlns:nc=\"${BASENS}\"><y nc:operation=\"delete\"><a>1024</a></y><y nc:operation=\"delete\"><a>1025</a></y></x></config></edit-config></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+new "netconf commit"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><commit/></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+new "entries at chunk boundary after insert and delete"
+expectpart "$(getrange 1020 1030)" 0 "<y><a>1020</a></y><y><a>1021</a></y><y><a>1022</a></y><y><a>1023</a></y><y><a>1026</a></y><y><a>1027</a></y><y><a>1028</a></y><y><a>1029</a></y><y><a>1030</a></y></x>"
+
+new "get inserted entry"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get-config><source><running/></source><filter type=\"xpath\" select=\"/ex:x/ex:y[ex:a=1023]\" xmlns:ex=\"urn:example:clixon\"/></get-config></rpc>" "" "<rpc-reply $DEFAULTNS><data><x xmlns=\"urn:example:clixon\"><y><a>1023</a><b>mid</b></y></x></data></rpc-reply>"
+
+new "bulk merge of more entries than existing into chunks"
+rpc="<rpc $DEFAULTNS><edit-config><target><candidate/></target><config><x xmlns=\"urn:example:clixon\">"
+for (( i=$perfnr+600; i>0; i-- )); do
+    rpc+="<y><a>$((2*i+2*perfnr+1))</a></y>"
+done
+rpc+="<y><a>-1</a></y></x></config></edit-config></rpc>"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "$rpc" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+new "netconf commit"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><commit/></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+new "first entries after bulk merge"
+expectpart "$(getrange -1 2)" 0 "<y><a>-1</a></y><y><a>0</a></y><y><a>1</a></y><y><a>2</a></y></x>"
+
+last=$((2*perfnr-2))
+new "entries between old and new after bulk merge"
+expectpart "$(getrange $((last-2)) $((last+5)))" 0 "<y><a>$((last-2))</a></y><y><a>$last</a></y><y><a>$((last+5))</a></y></x>"
+
+new "entries at chunk boundary after bulk merge"
+expectpart "$(getrange 1020 1030)" 0 "<y><a>1020</a></y><y><a>1021</a></y><y><a>1022</a></y><y><a>1023</a></y><y><a>1026</a></y><y><a>1027</a></y><y><a>1028</a></y><y><a>1029</a></y><y><a>1030</a></y></x>"
+
+if [ $BE -ne 0 ]; then
+    new "Kill backend"
+    # Check if premature kill
+    pid=$(pgrep -u root -f clixon_backend)
+    if [ -z "$pid" ]; then
+        err "backend already dead"
+    fi
+    # kill backend
+    stop_backend -f $cfg
+fi
+
+rm -rf $dir
+
+new "endtest"
+endtest
@@ -0,0 +1,183 @@
+#!/usr/bin/env bash
+# Hand-written XML parser, see CLICON_XML_FAST_PARSER and clixon_xml_parse_fast.c
+# Check that XML is parsed into the same trees as with the yacc parser, and that the
+# same syntax errors are detected
+# With yang, the fast parser binds yang while parsing, check it binds as xml_bind_yang
+# RPCs are bound after parsing, check netconf RPCs via the backend with the fast parser
+
+# Magic line must be first in script (see README.md)
+s="$_" ; . ./lib.sh || if [ "$s" = $0 ]; then exit 0; else return 0; fi
+
+: ${clixon_util_xml:="clixon_util_xml"}
+
+fxml=$dir/fast.xml
+fyang=$dir/fast.yang
+ftop=$dir/top.xml
+
+cat <<EOF > $fyang
+module fast{
+   yang-version 1.1;
+   namespace "urn:example:fast";
+   prefix f;
+   container c{
+     list x{
+       key k;
+       leaf k{
+         type int32;
+       }
+       leaf v{
+         type string;
+       }
+     }
+     leaf-list l{
+       type string;
+     }
+     anydata d;
+     container e{
+       leaf w{
+         type string;
+       }
+     }
+   }
+}
+EOF
+
+# Parse with both parsers and compare output and exit code
+# 1: XML
+# 2: Extra options (optional)
+function cmpparse()
+{
+    echo -n "$1" > $fxml
+    new "xml parse $2 $1"
+    ret1=$($clixon_util_xml -o $2 -f $fxml 2> /dev/null)
+    r1=$?
+    ret2=$($clixon_util_xml -o -F $2 -f $fxml 2> /dev/null)
+    r2=$?
+    if [ $r1 -ne $r2 ]; then
+        err "exit code $r1" "$r2"
+    fi
+    if [ "$ret1" != "$ret2" ]; then
+        err "$ret1" "$ret2"
+    fi
+}
+
+LF='
+'
+cmpparse "<a><b/></a>"
+cmpparse "<_-><b0.><c-.-._/></b0.></_->"
+cmpparse "<-a/>"
+cmpparse "<a%/>"
+cmpparse "<x>ab${LF}c${LF}d</x>"
+cmpparse "<a><![CDATA[a text]]></a>"
+cmpparse "<a><![CDATA[]]]></a>"
+cmpparse "<a><data><![CDATA[This text contains a CEND ]]]]><![CDATA[>]]></data></a>"
+cmpparse "<a><![CDATA[x</a>"
+cmpparse "<m>Less than: &lt; , greater than: &gt; ampersand: &amp; </m>"
+cmpparse "<m>single &apos; double &quot;</m>"
+cmpparse "<m>&#123;x&#x1F;y</m>"
+cmpparse "<m>&amp;&lt;<![CDATA[&amp;]]>&gt;</m>"
+cmpparse "<m>&foo;</m>"
+cmpparse "<x a='t' b=\"q\"/>"
+cmpparse "<x a=\"1\" a=\"2\"/>"
+cmpparse "<x xmlns=\"urn:example:a\" xmlns:p=\"urn:example:p\"><p:y p:z=\"v\">t</p:y></x>"
+cmpparse "<x><p:y>t</p:y></x>"
+cmpparse "<?xml version=\"1.0\" encoding=\"UTF-8\"?>${LF}<a/>"
+cmpparse "<?xml version=\"2.0\"?><a/>"
+cmpparse "<?xml version=\"1.0\"?><a/><b/>"
+cmpparse "<a/>text<b/>"
+cmpparse "text<a/>"
+cmpparse "  <a>  </a>  "
+cmpparse "<a>${LF}  <b>x</b>${LF}  <c/>${LF}</a>"
+cmpparse "<a>x<b/>y</a>"
+cmpparse "<a>x<!-- c --></a>"
+cmpparse "<a>x<!-- c -->y</a>"
+cmpparse "<a><?pi foo?><b/></a>"
+cmpparse "<!-- top --><a/>"
+cmpparse "<a>"
+cmpparse "<a></b>"
+cmpparse "<p:a xmlns:p=\"urn:example:p\"></a>"
+cmpparse "<a></a></a>"
+cmpparse "< a b = \"c\" >x</ a >"
+
+# Yang binding while parsing
+Y="-y $fyang"
+NS="xmlns=\"urn:example:fast\""
+cmpparse "<c $NS><x><k>2</k><v>b</v></x><x><k>1</k></x><l>b</l><l>a</l></c>" "$Y"
+cmpparse "<c $NS>${LF}  <x>${LF}    <k>1</k>${LF}  </x>${LF}  <e> </e>${LF}</c>" "$Y"
+cmpparse "<c $NS><e>text</e></c>" "$Y"
+cmpparse "<f:c xmlns:f=\"urn:example:fast\"><f:x><f:k>1</f:k></f:x><f:e/></f:c>" "$Y"
+cmpparse "<c $NS><d><foo><bar>1</bar></foo></d></c>" "$Y"
+cmpparse "<c $NS><x><k>1</k><y/></x><x><k>2</k></x></c>" "$Y"
+cmpparse "<c $NS><y>1</y></c>" "$Y"
+cmpparse "<c $NS><y>1</y></c>" "$Y -u"
+cmpparse "<c xmlns=\"urn:example:other\"/>" "$Y"
+cmpparse "<c $NS><x xmlns=\"urn:example:other\"><k>1</k></x></c>" "$Y"
+cmpparse "<c $NS><x><k>1</k></x><x><k>1</k></x></c>" "$Y -v"
+cmpparse "<c $NS/><c $NS/>" "$Y"
+
+# Yang binding from parent
+echo "<c $NS/>" > $ftop
+T="-y $fyang -t $ftop -T /f:c"
+cmpparse "<x><k>2</k></x><x><k>1</k><v>a</v></x><l>a</l>" "$T"
+cmpparse "<e><w>1</w></e><y/>" "$T"
+
+# RPC binding (YB_RPC) in netconf client and backend
+APPNAME=example
+cfg=$dir/conf_fast.xml
+
+cat <<EOF > $cfg
+<clixon-config xmlns="http://clicon.org/config">
+  <CLICON_CONFIGFILE>$cfg</CLICON_CONFIGFILE>
+  <CLICON_YANG_DIR>${YANG_INSTALLDIR}</CLICON_YANG_DIR>
+  <CLICON_YANG_MAIN_FILE>$fyang</CLICON_YANG_MAIN_FILE>
+  <CLICON_SOCK>/usr/local/var/run/$APPNAME.sock</CLICON_SOCK>
+  <CLICON_BACKEND_PIDFILE>/usr/local/var/run/$APPNAME.pidfile</CLICON_BACKEND_PIDFILE>
+  <CLICON_XMLDB_DIR>$dir</CLICON_XMLDB_DIR>
+  <CLICON_XML_FAST_PARSER>true</CLICON_XML_FAST_PARSER>
+</clixon-config>
+EOF
+
+new "test params: -f $cfg"
+if [ $BE -ne 0 ]; then
+    new "kill old backend"
+    sudo clixon_backend -zf $cfg
+    if [ $? -ne 0 ]; then
+        err
+    fi
+    new "start backend -s init -f $cfg"
+    start_backend -s init -f $cfg
+fi
+
+new "wait backend"
+wait_backend
+
+new "netconf edit-config"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><edit-config><target><candidate/></target><config><c $NS><x><k>2</k><v>b&amp;c</v></x><x><k>1</k></x><l>b</l><l>a</l></c></config></edit-config></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+new "netconf edit-config unknown element in rpc"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><edit-config><target><candidate/></target><extra/><config/></edit-config></rpc>" "" "<rpc-reply $DEFAULTNS><rpc-error><error-type>application</error-type><error-tag>unknown-element</error-tag><error-info><bad-element>extra</bad-element></error-info><error-severity>error</error-severity><error-message>Failed to find YANG spec of XML node: extra with parent: edit-config in namespace: urn:ietf:params:xml:ns:netconf:base:1.0</error-message></rpc-error></rpc-reply>"
+
+new "netconf edit-config unknown element in config"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><edit-config><target><candidate/></target><config><c $NS><y>1</y></c></config></edit-config></rpc>" "" "<rpc-reply $DEFAULTNS><rpc-error><error-type>application</error-type><error-tag>unknown-element</error-tag><error-info><bad-element>y</bad-element></error-info><error-severity>error</error-severity><error-message>Failed to find YANG spec of XML node: y with parent: c in namespace: urn:example:fast</error-message></rpc-error></rpc-reply>"
+
+new "netconf commit"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><commit/></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+new "netconf get-config sorted"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get-config><source><running/></source></get-config></rpc>" "" "<rpc-reply $DEFAULTNS><data><c $NS><x><k>1</k></x><x><k>2</k><v>b&amp;c</v></x><l>a</l><l>b</l></c></data></rpc-reply>"
+
+if [ $BE -ne 0 ]; then
+    new "Kill backend"
+    # Check if premature kill
+    pid=$(pgrep -u root -f clixon_backend)
+    if [ -z "$pid" ]; then
+        err "backend already dead"
+    fi
+    # kill backend
+    stop_backend -f $cfg
+fi
+
+rm -rf $dir
+
+new "endtest"
+endtest
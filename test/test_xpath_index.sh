@@ -0,0 +1,133 @@
+#!/usr/bin/env bash
+# XPath index planner, see XPATH_LIST_OPTIMIZE and xpath_optimize_stats_get
+# Binary search is used for lists within lists, leading keys and leaf-list values.
+# Check that results are the same as without search, also with several parent list
+# entries and positional predicates, and that searches are counted in stats
+
+# Magic line must be first in script (see README.md)
+s="$_" ; . ./lib.sh || if [ "$s" = $0 ]; then exit 0; else return 0; fi
+
+APPNAME=example
+
+cfg=$dir/conf_index.xml
+fyang=$dir/index.yang
+
+cat <<EOF > $fyang
+module index{
+   yang-version 1.1;
+   namespace "urn:example:index";
+   prefix ex;
+   container a {
+     list x {
+       key "k1 k2";
+       leaf k1 {
+         type int32;
+       }
+       leaf k2 {
+         type int32;
+       }
+       leaf v {
+         type string;
+       }
+       list y {
+         key name;
+         leaf name {
+           type string;
+         }
+         leaf-list c {
+           type string;
+         }
+       }
+     }
+   }
+}
+EOF
+
+cat <<EOF > $cfg
+<clixon-config xmlns="http://clicon.org/config">
+  <CLICON_CONFIGFILE>$cfg</CLICON_CONFIGFILE>
+  <CLICON_YANG_DIR>${YANG_INSTALLDIR}</CLICON_YANG_DIR>
+  <CLICON_YANG_MAIN_FILE>$fyang</CLICON_YANG_MAIN_FILE>
+  <CLICON_SOCK>/usr/local/var/run/$APPNAME.sock</CLICON_SOCK>
+  <CLICON_BACKEND_PIDFILE>/usr/local/var/run/$APPNAME.pidfile</CLICON_BACKEND_PIDFILE>
+  <CLICON_XMLDB_DIR>$dir</CLICON_XMLDB_DIR>
+</clixon-config>
+EOF
+
+X11="<x><k1>1</k1><k2>1</k2><y><name>n1</name><c>a</c><c>b</c></y></x>"
+X12="<x><k1>1</k1><k2>2</k2><y><name>n1</name><c>b</c></y><y><name>n2</name></y></x>"
+X21="<x><k1>2</k1><k2>1</k2><v>w</v></x>"
+
+# Get candidate with xpath filter
+# 1: xpath
+# 2: expected content of a, or empty for no data
+function getxpath()
+{
+    if [ -n "$2" ]; then
+        data="<data><a xmlns=\"urn:example:index\">$2</a></data>"
+    else
+        data="<data/>"
+    fi
+    new "netconf get-config $1"
+    expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get-config><source><candidate/></source><filter type=\"xpath\" select=\"$1\" xmlns:ex=\"urn:example:index\"/></get-config></rpc>" "" "<rpc-reply $DEFAULTNS>$data</rpc-reply>"
+}
+
+new "test params: -f $cfg"
+if [ $BE -ne 0 ]; then
+    new "kill old backend"
+    sudo clixon_backend -zf $cfg
+    if [ $? -ne 0 ]; then
+        err
+    fi
+    new "start backend -s init -f $cfg"
+    start_backend -s init -f $cfg
+fi
+
+new "wait backend"
+wait_backend
+
+new "netconf edit config"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><edit-config><target><candidate/></target><config><a xmlns=\"urn:example:index\">$X21$X12$X11</a></config></edit-config></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+# All keys
+getxpath "/ex:a/ex:x[ex:k1='1'][ex:k2='2']" "$X12"
+
+# Leading key
+getxpath "/ex:a/ex:x[ex:k1='1']" "$X11$X12"
+
+# Leading key and non-key
+getxpath "/ex:a/ex:x[ex:k1='2'][ex:v='w']" "$X21"
+
+# Leading key and position
+getxpath "/ex:a/ex:x[ex:k1='1'][2]" "$X12"
+
+# Position before key is not searched
+getxpath "/ex:a/ex:x[1][ex:k1='2']" ""
+
+# List within list with several parent entries
+getxpath "/ex:a/ex:x/ex:y[ex:name='n1']" "<x><k1>1</k1><k2>1</k2><y><name>n1</name><c>a</c><c>b</c></y></x><x><k1>1</k1><k2>2</k2><y><name>n1</name><c>b</c></y></x>"
+
+# Leaf-list within lists
+getxpath "/ex:a/ex:x/ex:y/ex:c[.='b']" "<x><k1>1</k1><k2>1</k2><y><name>n1</name><c>b</c></y></x><x><k1>1</k1><k2>2</k2><y><name>n1</name><c>b</c></y></x>"
+
+# Non-existing leaf-list value
+getxpath "/ex:a/ex:x/ex:y/ex:c[.='c']" ""
+
+new "netconf stats xpath-index"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><stats $LIBNS/></rpc>" "<xpath-index><keys>[0-9]*</keys><prefix>[1-9][0-9]*</prefix><index>[0-9]*</index><leaf-list>[1-9][0-9]*</leaf-list><nested>[1-9][0-9]*</nested>" ""
+
+if [ $BE -ne 0 ]; then
+    new "Kill backend"
+    # Check if premature kill
+    pid=$(pgrep -u root -f clixon_backend)
+    if [ -z "$pid" ]; then
+        err "backend already dead"
+    fi
+    # kill backend
+    stop_backend -f $cfg
+fi
+
+rm -rf $dir
+
+new "endtest"
+endtest
@@ -0,0 +1,180 @@
+#!/usr/bin/env bash
+# Serialized YANG schema cache across daemon startups, see CLICON_YANG_CACHE_DIR
+# First backend start parses YANG and writes the cache, later backend and netconf starts
+# load it. Check that grouping, augment, types, defaults and identities survive the cache,
+# and that a YANG change causes a new cache file
+
+# Magic line must be first in script (see README.md)
+s="$_" ; . ./lib.sh || if [ "$s" = $0 ]; then exit 0; else return 0; fi
+
+APPNAME=example
+
+cfg=$dir/conf_yang.xml
+ydir=$dir/yang
+fyang=$ydir/example-cache.yang
+fyang2=$ydir/example-cache-aug.yang
+cachedir=$dir/yang-cache
+
+# Separate dir for YANG since the datastore dir changes on every start
+rm -rf $ydir $cachedir
+mkdir $ydir $cachedir
+
+cat <<EOF > $cfg
+<clixon-config xmlns="http://clicon.org/config">
+  <CLICON_CONFIGFILE>$cfg</CLICON_CONFIGFILE>
+  <CLICON_YANG_DIR>${YANG_INSTALLDIR}</CLICON_YANG_DIR>
+  <CLICON_YANG_DIR>$ydir</CLICON_YANG_DIR>
+  <CLICON_YANG_MAIN_DIR>$ydir</CLICON_YANG_MAIN_DIR>
+  <CLICON_YANG_CACHE_DIR>$cachedir</CLICON_YANG_CACHE_DIR>
+  <CLICON_SOCK>/usr/local/var/run/$APPNAME.sock</CLICON_SOCK>
+  <CLICON_BACKEND_PIDFILE>/usr/local/var/run/$APPNAME.pidfile</CLICON_BACKEND_PIDFILE>
+  <CLICON_XMLDB_DIR>$dir</CLICON_XMLDB_DIR>
+</clixon-config>
+EOF
+
+cat <<EOF > $fyang
+module example-cache {
+    yang-version 1.1;
+    namespace "urn:example:cache";
+    prefix ex;
+    identity base-color;
+    identity red {
+        base base-color;
+    }
+    typedef percent {
+        type uint8 {
+            range "0..100";
+        }
+    }
+    grouping params {
+        leaf name {
+            type string {
+                pattern '[a-z]+';
+            }
+        }
+        leaf load {
+            type percent;
+            default 50;
+        }
+        leaf ratio {
+            type decimal64 {
+                fraction-digits 2;
+            }
+            default 0.25;
+        }
+        leaf color {
+            type identityref {
+                base base-color;
+            }
+        }
+    }
+    container table {
+        list parameter {
+            key name;
+            uses params;
+        }
+    }
+}
+EOF
+
+cat <<EOF > $fyang2
+module example-cache-aug {
+    yang-version 1.1;
+    namespace "urn:example:cache-aug";
+    prefix aug;
+    import example-cache {
+        prefix ex;
+    }
+    augment "/ex:table/ex:parameter" {
+        leaf extra {
+            type string;
+        }
+    }
+}
+EOF
+
+new "test params: -f $cfg"
+if [ $BE -ne 0 ]; then
+    new "kill old backend"
+    sudo clixon_backend -z -f $cfg
+    if [ $? -ne 0 ]; then
+        err
+    fi
+    new "start backend -s init -f $cfg"
+    start_backend -s init -f $cfg
+
+    new "wait backend"
+    wait_backend
+
+    new "Check cache file created"
+    nr=$(ls $cachedir/yang-*.cache 2> /dev/null | wc -l)
+    if [ $nr -ne 1 ]; then
+        err "1 cache file" "$nr"
+    fi
+
+    new "Restart backend using cache"
+    stop_backend -f $cfg
+    start_backend -s init -f $cfg
+fi
+
+new "wait backend"
+wait_backend
+
+new "Check no new cache file"
+nr=$(ls $cachedir/yang-*.cache | wc -l)
+if [ $nr -ne 1 ]; then
+    err "1 cache file" "$nr"
+fi
+
+new "netconf edit with augmented leaf and identity"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><edit-config><target><candidate/></target><config><table xmlns=\"urn:example:cache\"><parameter><name>a</name><color>ex:red</color><extra xmlns=\"urn:example:cache-aug\">x</extra></parameter></table></config></edit-config></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+new "netconf commit"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><commit/></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+new "netconf get defaults"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get-config><source><running/></source><with-defaults xmlns=\"urn:ietf:params:xml:ns:yang:ietf-netconf-with-defaults\">report-all</with-defaults></get-config></rpc>" "" "<rpc-reply $DEFAULTNS><data><table xmlns=\"urn:example:cache\"><parameter><name>a</name><load>50</load><ratio>0.25</ratio><color>ex:red</color><extra xmlns=\"urn:example:cache-aug\">x</extra></parameter></table></data></rpc-reply>"
+
+new "netconf pattern error"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><edit-config><target><candidate/></target><config><table xmlns=\"urn:example:cache\"><parameter><name>A9</name></parameter></table></config></edit-config></rpc>" "" "<rpc-reply $DEFAULTNS><rpc-error><error-type>application</error-type><error-tag>invalid-value</error-tag>"
+
+new "netconf range error"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><edit-config><target><candidate/></target><config><table xmlns=\"urn:example:cache\"><parameter><name>b</name><load>101</load></parameter></table></config></edit-config></rpc>" "" "<rpc-reply $DEFAULTNS><rpc-error><error-type>application</error-type><error-tag>invalid-value</error-tag>"
+
+if [ $BE -ne 0 ]; then
+    new "Kill backend"
+    stop_backend -f $cfg
+
+    # Change yang: add a leaf, file mtime and size changes
+    sleep 1
+    sed -i 's/leaf extra {/leaf extra2 { type string; }\n        leaf extra {/' $fyang2
+
+    new "start backend with changed YANG"
+    start_backend -s running -f $cfg
+
+    new "wait backend"
+    wait_backend
+
+    new "Check new cache file"
+    nr=$(ls $cachedir/yang-*.cache | wc -l)
+    if [ $nr -ne 2 ]; then
+        err "2 cache files" "$nr"
+    fi
+
+    new "netconf edit new leaf"
+    expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><edit-config><target><candidate/></target><config><table xmlns=\"urn:example:cache\"><parameter><name>a</name><extra2 xmlns=\"urn:example:cache-aug\">y</extra2></parameter></table></config></edit-config></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+    new "Kill backend"
+    # Check if premature kill
+    pid=$(pgrep -u root -f clixon_backend)
+    if [ -z "$pid" ]; then
+        err "backend already dead"
+    fi
+    # kill backend
+    stop_backend -f $cfg
+fi
+
+rm -rf $dir
+
+new "endtest"
+endtest
@@ -0,0 +1,132 @@
+#!/usr/bin/env bash
+# Lookup of yang nodes in nodes with many children, which have a hashed child index
+# Nodes are added by uses/grouping expansion, in a choice, and by an augment from a
+# module loaded after the index of the main module is built.
+
+# Magic line must be first in script (see README.md)
+s="$_" ; . ./lib.sh || if [ "$s" = $0 ]; then exit 0; else return 0; fi
+
+APPNAME=example
+
+cfg=$dir/conf_yang.xml
+fyang=$dir/main.yang
+augdir=$dir/aug
+fyang2=$augdir/aug.yang
+
+test -d $augdir || mkdir -p $augdir
+
+cat <<EOF > $cfg
+<clixon-config xmlns="http://clicon.org/config">
+  <CLICON_CONFIGFILE>$cfg</CLICON_CONFIGFILE>
+  <CLICON_YANG_DIR>$dir</CLICON_YANG_DIR>
+  <CLICON_YANG_DIR>${YANG_INSTALLDIR}</CLICON_YANG_DIR>
+  <CLICON_YANG_MAIN_FILE>$fyang</CLICON_YANG_MAIN_FILE>
+  <CLICON_YANG_MAIN_DIR>$augdir</CLICON_YANG_MAIN_DIR>
+  <CLICON_SOCK>/usr/local/var/run/$APPNAME.sock</CLICON_SOCK>
+  <CLICON_BACKEND_PIDFILE>/usr/local/var/run/$APPNAME.pidfile</CLICON_BACKEND_PIDFILE>
+  <CLICON_XMLDB_DIR>$dir</CLICON_XMLDB_DIR>
+</clixon-config>
+EOF
+
+# More children than the index threshold (16)
+leafs=""
+for (( i=0; i<20; i++ )); do
+    leafs+="leaf l$i { type int32; }
+"
+done
+
+cat <<EOF > $fyang
+module main{
+   yang-version 1.1;
+   namespace "urn:example:clixon";
+   prefix m;
+   grouping g {
+     leaf ga {
+       type string;
+     }
+     container gc {
+       leaf gb {
+         type string;
+       }
+     }
+   }
+   grouping g2 {
+     leaf gx {
+       type string;
+     }
+   }
+   container c {
+     $leafs
+     uses g;
+     choice ch {
+       case x {
+         uses g2;
+       }
+     }
+   }
+}
+EOF
+
+cat <<EOF > $fyang2
+module aug{
+   yang-version 1.1;
+   namespace "urn:example:aug";
+   prefix a;
+   import main {
+     prefix m;
+   }
+   grouping g3 {
+     leaf ay {
+       type string;
+     }
+   }
+   augment "/m:c" {
+     uses g3;
+   }
+}
+EOF
+
+new "test params: -f $cfg"
+if [ $BE -ne 0 ]; then
+    new "kill old backend"
+    sudo clixon_backend -zf $cfg
+    if [ $? -ne 0 ]; then
+        err
+    fi
+    new "start backend -s init -f $cfg"
+    start_backend -s init -f $cfg
+fi
+
+new "wait backend"
+wait_backend
+
+new "edit leafs from yang, grouping, choice and augment"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><edit-config><target><candidate/></target><config><c xmlns=\"urn:example:clixon\"><ay xmlns=\"urn:example:aug\">y</ay><gx>x</gx><gc><gb>b</gb></gc><ga>a</ga><l19>19</l19><l0>0</l0></c></config></edit-config></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+new "netconf commit"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><commit/></rpc>" "" "<rpc-reply $DEFAULTNS><ok/></rpc-reply>"
+
+new "get config in yang order"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get-config><source><running/></source></get-config></rpc>" "" "<rpc-reply $DEFAULTNS><data><c xmlns=\"urn:example:clixon\"><l0>0</l0><l19>19</l19><ga>a</ga><gc><gb>b</gb></gc><gx>x</gx><ay xmlns=\"urn:example:aug\">y</ay></c></data></rpc-reply>"
+
+new "get grouping leaf with xpath"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><get-config><source><running/></source><filter type=\"xpath\" select=\"/m:c/m:gc/m:gb\" xmlns:m=\"urn:example:clixon\"/></get-config></rpc>" "" "<rpc-reply $DEFAULTNS><data><c xmlns=\"urn:example:clixon\"><gc><gb>b</gb></gc></c></data></rpc-reply>"
+
+new "edit unknown leaf in indexed container"
+expecteof_netconf "$clixon_netconf -qf $cfg" 0 "$DEFAULTHELLO" "<rpc $DEFAULTNS><edit-config><target><candidate/></target><config><c xmlns=\"urn:example:clixon\"><l20>20</l20></c></config></edit-config></rpc>" "" "<rpc-reply $DEFAULTNS><rpc-error><error-type>application</error-type><error-tag>unknown-element</error-tag><error-info><bad-element>l20</bad-element></error-info><error-severity>error</error-severity><error-message>Failed to find YANG spec of XML node: l20 with parent: c in namespace: urn:example:clixon</error-message></rpc-error></rpc-reply>"
+
+if [ $BE -ne 0 ]; then
+    new "Kill backend"
+    # Check if premature kill
+    pid=$(pgrep -u root -f clixon_backend)
+    if [ -z "$pid" ]; then
+        err "backend already dead"
+    fi
+    # kill backend
+    stop_backend -f $cfg
+fi
+
+rm -rf $dir
+
+new "endtest"
+endtest
@@ -0,0 +1,273 @@
+/*
+ *
+  ***** BEGIN LICENSE BLOCK *****
+ 
+  Copyright (C) 2009-2016 Olof Hagsand and Benny Holmgren
+  Copyright (C) 2017-2019 Olof Hagsand
+  Copyright (C) 2020-2022 Olof Hagsand and Rubicon Communications, LLC (Netgate)
+
+  This file is part of CLIXON.
+
+  Licensed under the Apache License, Version 2.0 (the "License");
+  you may not use this file except in compliance with the License.
+  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  Alternatively, the contents of this file may be used under the terms of
+  the GNU General Public License Version 3 or later (the "GPL"),
+  in which case the provisions of the GPL are applicable instead
+  of those above. If you wish to allow use of your version of this file only
+  under the terms of the GPL, and not to allow others to
+  use your version of this file under the terms of Apache License version 2, 
+  indicate your decision by deleting the provisions above and replace them with
+  the  notice and other provisions required by the GPL. If you do not delete
+  the provisions above, a recipient may use your version of this file under
+  the terms of any one of the Apache License version 2 or the GPL.
+
+  ***** END LICENSE BLOCK *****
+
+  * Microbenchmark and check of XML/JSON escaping using the scan kernels in clixon_string.c
+  * A string with special characters at a given density is escaped many times with the
+  * library function and with a byte-at-a-time reference, outputs are compared.
+  * Example:
+  *   clixon_util_escape -n 10000 -l 4096 -d 64
+  * The string can be placed at an offset from an aligned address to check unaligned scans
+  *   clixon_util_escape -n 1 -l 100 -d 7 -o 3
+  * @see xml_chardata_span, json_str_span
+  */
+#ifdef HAVE_CONFIG_H
+#include "clixon_config.h" /* generated by config & autoconf */
+#endif
+
+#include <unistd.h>
+#include <stdio.h>
+#include <errno.h>
+#include <string.h>
+#include <stdlib.h>
+#include <syslog.h>
+#include <sys/time.h>
+
+/* cligen */
+#include <cligen/cligen.h>
+
+/* clixon */
+#include "clixon/clixon.h"
+
+/*! Byte-at-a-time XML chardata escaping, reference for xml_chardata_cbuf_append
+ */
+static int
+escape_xml_ref(cbuf *cb,
+               char *str)
+{
+    char *s;
+
+    for (s = str; *s; s++)
+        switch (*s){
+        case '&':
+            cprintf(cb, "&amp;");
+            break;
+        case '<':
+            cprintf(cb, "&lt;");
+            break;
+        case '>':
+            cprintf(cb, "&gt;");
+            break;
+        default:
+            cbuf_append(cb, *s);
+            break;
+        }
+    return 0;
+}
+
+/*! Byte-at-a-time JSON string escaping, reference for json_str_escape_cbuf_append
+ */
+static int
+escape_json_ref(cbuf *cb,
+                char *str)
+{
+    char *s;
+
+    for (s = str; *s; s++)
+        switch (*s){
+        case '\"':
+            cprintf(cb, "\\\"");
+            break;
+        case '\\':
+            cprintf(cb, "\\\\");
+            break;
+        case '\b':
+            cprintf(cb, "\\b");
+            break;
+        case '\f':
+            cprintf(cb, "\\f");
+            break;
+        case '\n':
+            cprintf(cb, "\\n");
+            break;
+        case '\r':
+            cprintf(cb, "\\r");
+            break;
+        case '\t':
+            cprintf(cb, "\\t");
+            break;
+        default:
+            cbuf_append(cb, *s);
+            break;
+        }
+    return 0;
+}
+
+/*! Escape str nr times and return elapsed time in usecs, result of last run is in cb
+ */
+static int
+escape_run(int  (*fn)(cbuf *, char *),
+           cbuf  *cb,
+           char  *str,
+           int    nr,
+           long  *usecs)
+{
+    int            retval = -1;
+    struct timeval t0;
+    struct timeval t1;
+    struct timeval td;
+    int            i;
+
+    gettimeofday(&t0, NULL);
+    for (i=0; i<nr; i++){
+        cbuf_reset(cb);
+        if (fn(cb, str) < 0)
+            goto done;
+    }
+    gettimeofday(&t1, NULL);
+    timersub(&t1, &t0, &td);
+    *usecs = td.tv_sec*1000000 + td.tv_usec;
+    retval = 0;
+ done:
+    return retval;
+}
+
+static int
+usage(char *argv0)
+{
+    fprintf(stderr, "usage:%s [options]\n"
+            "where options are\n"
+            "\t-h \t\tHelp\n"
+            "\t-D <level>\tDebug\n"
+            "\t-n <nr>     \tIterations (default: 1000)\n"
+            "\t-l <len>    \tString length (default: 4096)\n"
+            "\t-d <nr>     \tEvery <nr>th character is special, 0: none (default: 64)\n"
+            "\t-o <offset> \tString starts at offset 0-15 from an aligned address (default: 0)\n"
+            "\t-j          \tJSON string escaping (default XML)\n",
+            argv0
+            );
+    exit(0);
+}
+
+int
+main(int    argc,
+     char **argv)
+{
+    int         retval = -1;
+    char       *argv0 = argv[0];
+    int         c;
+    int         nr = 1000;
+    int         len = 4096;
+    int         density = 64;
+    int         offset = 0;
+    int         json = 0;
+    int         dbg = 0;
+    char       *buf = NULL;
+    char       *str;
+    const char *special;
+    cbuf       *cb1 = NULL;
+    cbuf       *cb2 = NULL;
+    long        t1;
+    long        t2;
+    int         i;
+
+    optind = 1;
+    opterr = 0;
+    while ((c = getopt(argc, argv, "hD:n:l:d:o:j")) != -1)
+        switch (c) {
+        case 'h':
+            usage(argv0);
+            break;
+        case 'D':
+            if (sscanf(optarg, "%d", &dbg) != 1)
+                usage(argv0);
+            break;
+        case 'n': /* Number of iterations */
+            if ((nr = atoi(optarg)) <= 0)
+                usage(argv0);
+            break;
+        case 'l': /* String length */
+            if ((len = atoi(optarg)) < 0)
+                usage(argv0);
+            break;
+        case 'd': /* Density of special characters */
+            if ((density = atoi(optarg)) < 0)
+                usage(argv0);
+            break;
+        case 'o': /* Offset from aligned address */
+            if ((offset = atoi(optarg)) < 0 || offset > 15)
+                usage(argv0);
+            break;
+        case 'j': /* JSON */
+            json++;
+            break;
+        default:
+            usage(argv[0]);
+            break;
+        }
+    clicon_log_init(__FILE__, dbg?LOG_DEBUG:LOG_INFO, CLICON_LOG_STDERR);
+    clixon_debug_init(dbg, NULL);
+
+    special = json ? "\"\\\b\f\n\r\t" : "&<>";
+    /* malloc returns an address aligned for any type, at least 16 bytes on common platforms */
+    if ((buf = malloc(len+1+offset)) == NULL){
+        clicon_err(OE_UNIX, errno, "malloc");
+        goto done;
+    }
+    str = buf + offset;
+    for (i=0; i<len; i++){
+        if (density && i%density == density-1)
+            str[i] = special[(i/density)%strlen(special)];
+        else
+            str[i] = 'a' + i%26;
+    }
+    str[len] = '\0';
+    if ((cb1 = cbuf_new()) == NULL ||
+        (cb2 = cbuf_new()) == NULL){
+        clicon_err(OE_UNIX, errno, "cbuf_new");
+        goto done;
+    }
+    if (escape_run(json?json_str_escape_cbuf_append:xml_chardata_cbuf_append,
+                   cb1, str, nr, &t1) < 0)
+        goto done;
+    if (escape_run(json?escape_json_ref:escape_xml_ref,
+                   cb2, str, nr, &t2) < 0)
+        goto done;
+    if (strcmp(cbuf_get(cb1), cbuf_get(cb2)) != 0){
+        fprintf(stderr, "Escaped strings differ\n");
+        goto done;
+    }
+    fprintf(stdout, "%s len:%d density:%d offset:%d nr:%d\n", json?"json":"xml", len, density, offset, nr);
+    fprintf(stdout, "scan:      %ld.%06ld s\n", t1/1000000, t1%1000000);
+    fprintf(stdout, "reference: %ld.%06ld s\n", t2/1000000, t2%1000000);
+    retval = 0;
+ done:
+    if (buf)
+        free(buf);
+    if (cb1)
+        cbuf_free(cb1);
+    if (cb2)
+        cbuf_free(cb2);
+    return retval;
+}
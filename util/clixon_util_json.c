@@ -75,8 +75,10 @@ usage(char *argv0)
             "where options are\n"
             "\t-h \t\tHelp\n"
             "\t-D <level> \tDebug\n"
+            "\t-F \t\tUse hand-written JSON parser instead of yacc parser\n"
             "\t-j \t\tOutput as JSON (default is as XML)\n"
             "\t-l <s|e|o> \tLog on (s)yslog, std(e)rr, std(o)ut (stderr is default)\n"
+            "\t-n <nr> \tParse input nr times (for benchmarking)\n"
             "\t-p \t\tPretty-print output\n"
             "\t-y <filename> \tyang filename to parse (must be stand-alone)\n"      ,
             argv0);
@@ -99,10 +101,15 @@ main(int    argc,
     int        ret;
     int        pretty = 0;
     int        dbg = 0;
+    int        nr = 1;
+    int        i;
+    cbuf      *cbin = NULL;
+    char       buf[BUFSIZ];
+    size_t     len;
 
     optind = 1;
     opterr = 0;
-    while ((c = getopt(argc, argv, "hD:jl:py:")) != -1)
+    while ((c = getopt(argc, argv, "hD:Fjl:n:py:")) != -1)
         switch (c) {
         case 'h':
             usage(argv[0]);
@@ -111,6 +118,9 @@ main(int    argc,
             if (sscanf(optarg, "%d", &dbg) != 1)
                 usage(argv[0]);
             break;
+        case 'F':
+            clixon_json_parse_fast_set(1);
+            break;
         case 'j':
             json++;
             break;
@@ -118,6 +128,10 @@ main(int    argc,
             if ((logdst = clicon_log_opt(optarg[0])) < 0)
                 usage(argv[0]);
             break;
+        case 'n':
+            if ((nr = atoi(optarg)) < 1)
+                usage(argv[0]);
+            break;
         case 'p':
             pretty++;
             break;
@@ -139,8 +153,26 @@ main(int    argc,
             return -1;
         }
     }
-    if ((ret = clixon_json_parse_file(stdin, yspec?1:0, yspec?YB_MODULE:YB_NONE, yspec, &xt, &xerr)) < 0)
-        goto done;
+    if (nr == 1){
+        if ((ret = clixon_json_parse_file(stdin, yspec?1:0, yspec?YB_MODULE:YB_NONE, yspec, &xt, &xerr)) < 0)
+            goto done;
+    }
+    else { /* Read input into memory and parse it nr times */
+        if ((cbin = cbuf_new()) == NULL)
+            goto done;
+        while ((len = fread(buf, 1, sizeof(buf), stdin)) > 0)
+            cbuf_append_buf(cbin, buf, len);
+        for (i = 0; i < nr; i++){
+            if (xt){
+                xml_free(xt);
+                xt = NULL;
+            }
+            if ((ret = clixon_json_parse_string(cbuf_get(cbin), yspec?1:0, yspec?YB_MODULE:YB_NONE, yspec, &xt, &xerr)) < 1)
+                break;
+        }
+        if (ret < 0)
+            goto done;
+    }
     if (ret == 0){
         xml_print(stderr, xerr);
         goto done;
@@ -161,5 +193,7 @@ main(int    argc,
         xml_free(xt);
     if (cb)
         cbuf_free(cb);
+    if (cbin)
+        cbuf_free(cbin);
     return retval;
 }
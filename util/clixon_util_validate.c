@@ -67,7 +67,7 @@
 #include "clixon/clixon_backend.h"
 
 /* Command line options passed to getopt(3) */
-#define UTIL_COMMIT_OPTS "hD:f:cd:o:"
+#define UTIL_COMMIT_OPTS "hD:f:cd:o:t:"
 
 static int
 usage(char *argv0)
@@ -79,6 +79,7 @@ usage(char *argv0)
             "\t-f <file>\tClixon config file\n"
             "\t-d <file>\tDatabase name (if not candidate, must be in XMLDBDIR)\n"
             "\t-c \t\tValidate + commit, otherwise only validate\n"
+            "\t-t <nr>\tNumber of parallel validation workers (see CLICON_VALIDATE_WORKERS)\n"
             "\t-o \"<option>=<value>\"\tGive configuration option overriding config file (see clixon-config.yang)\n",
             argv0);
     exit(0);
@@ -96,9 +97,9 @@ main(int    argc,
     clicon_handle h;
     int           dbg = 0;
     char         *dir;
-    char         *str;
     int           ret;
     cbuf         *cb = NULL;
+    int           workers;
 
     /* In the startup, logs to stderr & debug flag set later */
     clicon_log_init(__FILE__, LOG_INFO, CLICON_LOG_STDERR);
@@ -128,6 +129,7 @@ main(int    argc,
         case 'c': /* commit (otherwise only validate) */
         case 'd': /* candidate database (if not candidate) */
         case 'o': /* Configuration option */
+        case 't': /* Validation workers */
             break; /* see next getopt */
         default:
             usage(argv[0]);
@@ -165,6 +167,11 @@ main(int    argc,
                 goto done;
             break;
         }
+        case 't': /* Validation workers */
+            if (sscanf(optarg, "%d", &workers) != 1 || workers < 0)
+                usage(argv[0]);
+            clicon_option_int_set(h, "CLICON_VALIDATE_WORKERS", workers);
+            break;
         default:
             usage(argv[0]);
             break;
@@ -188,20 +195,9 @@ main(int    argc,
         clixon_plugins_load(h, CLIXON_PLUGIN_INIT, dir,
                             clicon_option_str(h, "CLICON_BACKEND_REGEXP")) < 0)
         goto done;
-    /* Load Yang modules
-     * 1. Load a yang module as a specific absolute filename */
-    if ((str = clicon_yang_main_file(h)) != NULL)
-        if (yang_spec_parse_file(h, str, yspec) < 0)
-            goto done;
-    /* 2. Load a (single) main module */
-    if ((str = clicon_yang_module_main(h)) != NULL)
-        if (yang_spec_parse_module(h, str, clicon_yang_module_revision(h),
-                                   yspec) < 0)
-            goto done;
-    /* 3. Load all modules in a directory (will not overwrite file loaded ^) */
-    if ((str = clicon_yang_main_dir(h)) != NULL)
-        if (yang_spec_load_dir(h, str, yspec) < 0)
-            goto done;
+    /* Load main Yang modules, from cache if CLICON_YANG_CACHE_DIR is set */
+    if (yang_spec_load_main(h, yspec) < 0)
+        goto done;
     /* Load clixon lib yang module */
     if (yang_spec_parse_module(h, "clixon-lib", NULL, yspec) < 0)
         goto done;
@@ -67,7 +67,7 @@
 #include "clixon/clixon.h"
 
 /* Command line options passed to getopt(3) */
-#define UTIL_XML_OPTS "hD:f:JjXl:pvoy:Y:t:T:u"
+#define UTIL_XML_OPTS "hD:f:FJjXl:n:pvoy:Y:t:T:u"
 
 static int
 validate_tree(clicon_handle h,
@@ -116,6 +116,8 @@ usage(char *argv0)
             "\t-h \t\tHelp\n"
             "\t-D <level> \tDebug\n"
             "\t-f <file>\tXML input file (overrides stdin)\n"
+            "\t-F \t\tUse hand-written XML parser instead of yacc parser\n"
+            "\t-n <nr> \tParse XML input file <nr> times, for benchmarking (requires -f)\n"
             "\t-J \t\tInput as JSON\n"
             "\t-j \t\tOutput as JSON\n"
             "\t-X \t\tOutput as TEXT \n"
@@ -166,6 +168,9 @@ main(int    argc,
     cvec         *nsc = NULL;
     yang_bind     yb;
     int           dbg = 0;
+    int           nr = 1;
+    cxobj        *xb;
+    int           i;
 
     /* In the startup, logs to stderr & debug flag set later */
     clicon_log_init(__FILE__, LOG_INFO, CLICON_LOG_STDERR);
@@ -192,6 +197,13 @@ main(int    argc,
         case 'f':
             input_filename = optarg;
             break;
+        case 'F':
+            clixon_xml_parse_fast_set(1);
+            break;
+        case 'n':
+            if ((nr = atoi(optarg)) < 1)
+                usage(argv[0]);
+            break;
         case 'J':
             jsonin++;
             break;
@@ -240,6 +252,10 @@ main(int    argc,
         fprintf(stderr, "-v requires -y\n");
         usage(argv[0]);
     }
+    if (nr > 1 && (input_filename == NULL || top_input_filename || jsonin)){
+        fprintf(stderr, "-n requires -f and XML input without -t\n");
+        usage(argv[0]);
+    }
     if (top_input_filename && top_path == NULL){
         fprintf(stderr, "-t requires -T\n");
         usage(argv[0]);
@@ -315,6 +331,20 @@ main(int    argc,
             yb = YB_MODULE;
         else
             yb = YB_PARENT;
+        for (i=1; i<nr; i++){ /* Benchmark: parse and free all but last */
+            xb = NULL;
+            if ((ret = clixon_xml_parse_file(fp, yb, yspec, &xb, &xerr)) < 0){
+                fprintf(stderr, "xml parse error: %s\n", clicon_err_reason);
+                goto done;
+            }
+            if (xb)
+                xml_free(xb);
+            if (ret == 0){
+                clixon_netconf_error(h, xerr, "util_xml", NULL);
+                goto done;
+            }
+            rewind(fp);
+        }
         if ((ret = clixon_xml_parse_file(fp, yb, yspec, &xt, &xerr)) < 0){
             fprintf(stderr, "xml parse error: %s\n", clicon_err_reason);
             goto done;